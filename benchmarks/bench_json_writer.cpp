@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include "exchange/exchange.hpp"
+#include "server/request_handler.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    constexpr int kTrades = 10000;
+
+    // One book holding kTrades trades between two users
+    Exchange &GetExchange()
+    {
+        static std::unique_ptr<Exchange> exchange = []()
+        {
+            auto exchange = std::make_unique<Exchange>(std::vector<std::string>{"AAPL"});
+            for (int i = 0; i < kTrades; ++i)
+            {
+                exchange->HandleOrder("market_maker_0001", OrderType::ASK, 10, 100.0 + i % 7, "AAPL");
+                exchange->HandleOrder("momentum_fund_0042", OrderType::BID, 10, 100.0 + i % 7, "AAPL");
+            }
+            return exchange;
+        }();
+        return *exchange;
+    }
+
+    ParsedRequest MakePreviousTrades(int count)
+    {
+        ParsedRequest request;
+        request.action = RequestAction::GET_PREVIOUS_TRADES;
+        request.fields = ParsedRequest::FIELD_TICKER_HANDLE | ParsedRequest::FIELD_NUM_PREVIOUS_TRADES;
+        request.ticker_handle = 0;
+        request.num_previous_trades = count;
+        return request;
+    }
+}
+
+// -------------------------------------------------------------------
+// get_previous_trades response for N trades: streamed into a reused
+// buffer vs copied out, built as a DOM and dumped
+// -------------------------------------------------------------------
+static void BM_PreviousTradesWriter(benchmark::State &state)
+{
+    RequestHandler handler(GetExchange());
+    RequestHandler::TickerCache ticker_cache;
+    ParsedRequest request = MakePreviousTrades(static_cast<int>(state.range(0)));
+    std::string response;
+    for (auto _ : state)
+    {
+        handler.Handle(request, ticker_cache, response);
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PreviousTradesWriter)->Arg(10)->Arg(1000)->Arg(kTrades);
+
+static void BM_PreviousTradesDom(benchmark::State &state)
+{
+    Exchange &exchange = GetExchange();
+    int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        nlohmann::json response;
+        response["trades"] = nlohmann::json::array();
+        for (const Trade &trade : exchange.GetPreviousTrades(TickerHandle{0}, count))
+        {
+            response["trades"].push_back({{"bid_user_id", trade.bid_user_id},
+                                          {"ask_user_id", trade.ask_user_id},
+                                          {"price", trade.price},
+                                          {"volume", trade.volume},
+                                          {"timestamp", trade.timestamp}});
+        }
+        std::string serialized = response.dump();
+        benchmark::DoNotOptimize(serialized.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PreviousTradesDom)->Arg(10)->Arg(1000)->Arg(kTrades);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include "exchange/exchange.hpp"
+#include "ipc/market_data.hpp"
+#include "ipc/market_data_publisher.hpp"
+#include "ipc/market_data_reader.hpp"
+#include "ipc/shared_memory.hpp"
+#include "utils/order_type.hpp"
+
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    const std::vector<std::string> kTickers = {"AAPL"};
+
+    std::string ShmName()
+    {
+        return "/exchange_bench_md_" + std::to_string(getpid());
+    }
+
+    // Rests `levels` price levels on each side of AAPL
+    void BuildBook(Exchange &exchange, int levels)
+    {
+        for (int i = 0; i < levels; ++i)
+        {
+            exchange.HandleOrder("maker", OrderType::BID, 10, 99.0 - i, "AAPL");
+            exchange.HandleOrder("maker", OrderType::ASK, 10, 101.0 + i, "AAPL");
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+// Reader side: one consistent top-of-book/depth snapshot from shared memory
+// -------------------------------------------------------------------
+static void BM_SharedMemoryBookRead(benchmark::State &state)
+{
+    SharedMemory memory(ShmName(), sizeof(MarketDataRegion));
+    MarketDataPublisher publisher(CreateMarketDataRegion(memory, kTickers));
+    Exchange exchange(kTickers);
+    exchange.AddMarketDataListener(&publisher);
+    BuildBook(exchange, 16);
+
+    MarketDataReader reader(memory.GetName());
+    TickerHandle ticker = reader.ResolveTicker("AAPL");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(reader.GetBook(ticker));
+    }
+}
+BENCHMARK(BM_SharedMemoryBookRead);
+
+// -------------------------------------------------------------------
+// Engine side: add + cancel while publishing, flushing every Arg orders
+// (0 = no market data attached)
+// -------------------------------------------------------------------
+static void BM_AddCancelPublishing(benchmark::State &state)
+{
+    const int flush_every = static_cast<int>(state.range(0));
+    SharedMemory memory(ShmName(), sizeof(MarketDataRegion));
+    MarketDataPublisher publisher(CreateMarketDataRegion(memory, kTickers));
+    Exchange exchange(kTickers);
+    if (flush_every > 0)
+    {
+        exchange.AddMarketDataListener(&publisher);
+    }
+    BuildBook(exchange, 16);
+    TickerHandle ticker = exchange.ResolveTicker("AAPL");
+    NullExecutionSink sink;
+
+    int orders = 0;
+    for (auto _ : state)
+    {
+        int64_t id = exchange.HandleOrder("taker", OrderType::BID, 1, 98.5, ticker, sink);
+        exchange.CancelOrder(ticker, id);
+        if (flush_every > 0 && ++orders % flush_every == 0)
+        {
+            publisher.Flush();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_AddCancelPublishing)->Arg(0)->Arg(1)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,205 @@
+#include <benchmark/benchmark.h>
+#include "exchange/limit_order_book.hpp"
+#include "exchange/execution_sink.hpp"
+#include "exchange/matching_policy.hpp"
+#include "utils/order_type.hpp"
+
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::string kTicker = "AAPL";
+
+    std::vector<std::string> MakeUsers(int count)
+    {
+        std::vector<std::string> users;
+        for (int i = 0; i < count; ++i)
+        {
+            users.push_back("maker_" + std::to_string(i));
+        }
+        return users;
+    }
+
+    // Rests `depth` one-lot asks at a single price
+    void FillLevel(LimitOrderBook &book, const std::vector<std::string> &users, int depth, double price)
+    {
+        NullExecutionSink sink;
+        for (int i = 0; i < depth; ++i)
+        {
+            book.HandleOrder(users[i % users.size()], OrderType::ASK, 1, price, 0, kTicker, sink);
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+// Level sweep: one aggressive order walks a single deep price level
+// -------------------------------------------------------------------
+static void BM_LevelSweep(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    const std::vector<std::string> users = MakeUsers(64);
+    LimitOrderBook book(kTicker);
+    NullExecutionSink sink;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        FillLevel(book, users, depth, 100.0);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(book.HandleOrder("taker", OrderType::BID, depth, 100.0, 0, kTicker, sink));
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_LevelSweep)->Arg(64)->Arg(1024)->Arg(16384);
+
+// -------------------------------------------------------------------
+// Aggressive sweep: one order walks `levels` price levels of one order each
+// (exercises the level heap and the crossing test once per level)
+// -------------------------------------------------------------------
+static void BM_MultiLevelSweep(benchmark::State &state)
+{
+    const int levels = static_cast<int>(state.range(0));
+    const std::vector<std::string> users = MakeUsers(64);
+    LimitOrderBook book(kTicker);
+    NullExecutionSink sink;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < levels; ++i)
+        {
+            book.HandleOrder(users[i % users.size()], OrderType::ASK, 1, 100.0 + i, 0, kTicker, sink);
+        }
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(book.HandleOrder("taker", OrderType::BID, levels, 100.0 + levels, 0, kTicker, sink));
+    }
+    state.SetItemsProcessed(state.iterations() * levels);
+}
+BENCHMARK(BM_MultiLevelSweep)->Arg(64)->Arg(1024);
+
+// -------------------------------------------------------------------
+// Allocation policy vs level depth: the aggressor takes half of one level
+// (FIFO touches depth/2 orders, the pro-rata policies walk the whole level)
+// Args: policy (MatchingPolicy as int), depth
+// -------------------------------------------------------------------
+static void BM_PolicyPartialFill(benchmark::State &state)
+{
+    const MatchingPolicy policy = static_cast<MatchingPolicy>(state.range(0));
+    const int depth = static_cast<int>(state.range(1));
+    const std::vector<std::string> users = MakeUsers(64);
+    LimitOrderBook book(kTicker);
+    book.SetMatchingPolicy(policy);
+    NullExecutionSink sink;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        // One-lot orders would round every pro-rata share to zero; use 2 lots
+        for (int i = 0; i < depth; ++i)
+        {
+            book.HandleOrder(users[i % users.size()], OrderType::ASK, 2, 100.0, 0, kTicker, sink);
+        }
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(book.HandleOrder("taker", OrderType::BID, depth, 100.0, 0, kTicker, sink));
+
+        state.PauseTiming();
+        book.HandleOrder("taker", OrderType::BID, depth, 100.0, 0, kTicker, sink); // clear the level
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_PolicyPartialFill)
+    ->ArgsProduct({{static_cast<int>(MatchingPolicy::FIFO),
+                    static_cast<int>(MatchingPolicy::PRO_RATA),
+                    static_cast<int>(MatchingPolicy::TOP_ORDER_PRO_RATA)},
+                   {64, 1024, 16384}});
+
+// -------------------------------------------------------------------
+// Continuous vs batch matching on the same generated flow: random limit
+// orders around a fixed mid, two thirds of them marketable.
+// Arg: orders per batch (0 = continuous matching)
+// -------------------------------------------------------------------
+static void BM_FlowContinuousVsBatch(benchmark::State &state)
+{
+    const int batch_size = static_cast<int>(state.range(0));
+    const int kFlowLength = 8192;
+    const std::vector<std::string> users = MakeUsers(64);
+
+    struct FlowOrder
+    {
+        OrderType side;
+        int volume;
+        double price;
+    };
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> tick(-5, 10);
+    std::uniform_int_distribution<int> size(1, 10);
+    std::vector<FlowOrder> flow;
+    for (int i = 0; i < kFlowLength; ++i)
+    {
+        OrderType side = (i % 2 == 0) ? OrderType::BID : OrderType::ASK;
+        int offset = tick(rng); // > 0 => priced through the mid
+        double price = (side == OrderType::BID) ? 100.0 + offset : 100.0 - offset;
+        flow.push_back(FlowOrder{side, size(rng), price});
+    }
+
+    NullExecutionSink sink;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        LimitOrderBook book(kTicker);
+        if (batch_size > 0)
+        {
+            book.StartAuction();
+        }
+        state.ResumeTiming();
+
+        for (int i = 0; i < kFlowLength; ++i)
+        {
+            const FlowOrder &order = flow[i];
+            book.HandleOrder(users[i % users.size()], order.side, order.volume, order.price, 0, kTicker, sink);
+            if (batch_size > 0 && (i + 1) % batch_size == 0)
+            {
+                book.Uncross(sink);
+                book.StartAuction();
+            }
+        }
+        benchmark::DoNotOptimize(book.GetTradeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * kFlowLength);
+}
+BENCHMARK(BM_FlowContinuousVsBatch)->Arg(0)->Arg(16)->Arg(256)->Arg(4096);
+
+// -------------------------------------------------------------------
+// Add then cancel: exercises order storage without matching
+// -------------------------------------------------------------------
+static void BM_AddCancel(benchmark::State &state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    const std::vector<std::string> users = MakeUsers(64);
+    LimitOrderBook book(kTicker);
+    NullExecutionSink sink;
+    std::vector<int64_t> ids(depth);
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < depth; ++i)
+        {
+            ids[i] = book.HandleOrder(users[i % users.size()], OrderType::ASK, 1, 100.0 + (i % 8), 0, kTicker, sink);
+        }
+        for (int64_t id : ids)
+        {
+            book.CancelOrder(id, sink);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_AddCancel)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+#include "server/request_parser.hpp"
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    const std::string kOrder = R"({"action":"handle_order","user_id":"trader_042","order_type":1,)"
+                               R"("volume":25,"price":101.25,"ticker":"AAPL"})";
+}
+
+// -------------------------------------------------------------------
+// Order request to typed fields: schema parser vs DOM + field reads
+// -------------------------------------------------------------------
+static void BM_ParseOrderFast(benchmark::State &state)
+{
+    ParsedRequest request;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ParseRequest(kOrder.data(), kOrder.size(), request));
+        benchmark::DoNotOptimize(request.price);
+    }
+}
+BENCHMARK(BM_ParseOrderFast);
+
+static void BM_ParseOrderDom(benchmark::State &state)
+{
+    ParsedRequest request;
+    for (auto _ : state)
+    {
+        nlohmann::json document = nlohmann::json::parse(kOrder);
+        ReadRequest(document, request);
+        benchmark::DoNotOptimize(request.price);
+    }
+}
+BENCHMARK(BM_ParseOrderDom);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include "exchange/execution_sink.hpp"
+#include "tape/trade_tape_reader.hpp"
+#include "tape/trade_tape_writer.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int kTrades = 1 << 20;
+    constexpr int kTradesPerSecond = 1000;
+
+    struct TapeDirectory
+    {
+        std::string path;
+
+        TapeDirectory()
+        {
+            char name[] = "/tmp/bench_trade_tape_XXXXXX";
+            path = mkdtemp(name);
+        }
+        ~TapeDirectory() { std::filesystem::remove_all(path); }
+    };
+
+    void Record(TradeTapeWriter &writer, int64_t trade_id, time_t timestamp)
+    {
+        Trade trade(trade_id, 100, 10, timestamp, "momentum_fund_0042", "market_maker_0001");
+        writer.OnTrade(TickerHandle{0}, Fill{trade, 100.0 + trade_id % 7, OrderType::BID, 0, 0, 100.0});
+    }
+
+    // kTrades trades of AAPL, kTradesPerSecond per second
+    const std::string &GetTape()
+    {
+        static TapeDirectory directory;
+        static bool written = []()
+        {
+            TradeTapeWriter writer(directory.path, {"AAPL"});
+            for (int i = 0; i < kTrades; ++i)
+            {
+                Record(writer, i + 1, i / kTradesPerSecond);
+            }
+            return writer.Flush() == 1;
+        }();
+        benchmark::DoNotOptimize(written);
+        return directory.path;
+    }
+}
+
+// -------------------------------------------------------------------
+// Writer: buffer a round of trades and append it, as the engine does
+// once per round of requests
+// -------------------------------------------------------------------
+static void BM_TapeAppend(benchmark::State &state)
+{
+    TapeDirectory directory;
+    TradeTapeWriter writer(directory.path, {"AAPL"});
+    const int per_flush = static_cast<int>(state.range(0));
+    int64_t trade_id = 0;
+    for (auto _ : state)
+    {
+        for (int i = 0; i < per_flush; ++i)
+        {
+            ++trade_id;
+            Record(writer, trade_id, trade_id / kTradesPerSecond);
+        }
+        writer.Flush();
+    }
+    state.SetItemsProcessed(state.iterations() * per_flush);
+}
+BENCHMARK(BM_TapeAppend)->Arg(1)->Arg(64);
+
+// -------------------------------------------------------------------
+// Reader: VWAP over a time range found by binary search, scanning the
+// mapped price and volume columns
+// -------------------------------------------------------------------
+static void BM_TapeTimeRangeVwap(benchmark::State &state)
+{
+    TradeTapeReader reader(GetTape(), "AAPL");
+    const int64_t seconds = state.range(0);
+    const int64_t from = kTrades / kTradesPerSecond / 4;
+    size_t scanned = 0;
+    for (auto _ : state)
+    {
+        TapeRange range = reader.FindTimeRange(from, from + seconds);
+        const double *prices = reader.GetPrices();
+        const int32_t *volumes = reader.GetVolumes();
+        double notional = 0.0;
+        int64_t volume = 0;
+        for (size_t row = range.begin; row < range.end; ++row)
+        {
+            notional += prices[row] * volumes[row];
+            volume += volumes[row];
+        }
+        benchmark::DoNotOptimize(notional / volume);
+        scanned += range.GetSize();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(scanned));
+}
+BENCHMARK(BM_TapeTimeRangeVwap)->Arg(1)->Arg(100);
+
+static void BM_TapeTradeIdLookup(benchmark::State &state)
+{
+    TradeTapeReader reader(GetTape(), "AAPL");
+    int64_t trade_id = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(reader.FindTradeIdRange(trade_id, trade_id + 1));
+        trade_id = trade_id * 7919 % kTrades + 1;
+    }
+}
+BENCHMARK(BM_TapeTradeIdLookup);
+
+BENCHMARK_MAIN();
@@ -6,37 +6,168 @@
 #include "exchange/top_of_book.hpp"
 #include "exchange/order_result.hpp"
 #include "exchange/limit_order_book.hpp"
+#include "exchange/ticker_handle.hpp"
+#include "exchange/execution_sink.hpp"
+#include "exchange/market_data_listener.hpp"
+#include "exchange/matching_policy.hpp"
+#include "exchange/trading_phase.hpp"
+#include "portfolio/portfolio.hpp"
+#include "portfolio/position_store.hpp"
+#include "portfolio/leaderboard_entry.hpp"
+#include "risk/margin_engine.hpp"
+#include "risk/risk_engine.hpp"
+#include "risk/risk_limits.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <ctime>
+#include <deque>
 
 class Exchange
 {
 private:
-    std::unordered_map<std::string, LimitOrderBook> limit_order_books;
+    // Books indexed by TickerHandle::index
+    std::vector<LimitOrderBook> limit_order_books;
+    std::unordered_map<std::string, TickerHandle> ticker_handles;
     std::unordered_set<std::string> tickers;
-    std::unordered_map<std::string, std::vector<Trade>> trades_by_user;
-    std::unordered_set<std::string> users;
-    inline void ThrowIfTickerNotFound(std::string ticker);
+    // Position of a trade inside its book's history
+    struct TradeRef
+    {
+        TickerHandle ticker;
+        size_t index;
+    };
+    std::unordered_map<std::string, std::vector<TradeRef>> trades_by_user;
+    // Registered users, by dense user index
+    std::unordered_map<std::string, uint32_t> user_indices;
+    std::vector<std::string> user_ids;
+    // One portfolio per registered user, updated on every fill (deque: stable references)
+    std::deque<Portfolio> portfolios;
+    // Columnar mirror of all positions for exchange-wide mark-to-market
+    PositionStore position_store;
+    // Pre-trade limits and their per-user counters
+    RiskEngine risk_engine;
+    // Committed buying power per registered user
+    MarginEngine margin_engine;
+
+    // Frequent batch auction schedule per ticker (interval 0 = continuous)
+    struct BatchSchedule
+    {
+        std::chrono::nanoseconds interval{0};
+        std::chrono::steady_clock::time_point next_clear;
+    };
+    std::vector<BatchSchedule> batch_schedules;
+    // Public feeds of trades and book changes (not owned)
+    std::vector<MarketDataListener *> market_data_listeners;
+    inline void NotifyBookUpdate(TickerHandle ticker);
+    inline void ClearBatchIfDue(TickerHandle ticker, std::chrono::steady_clock::time_point now);
+    inline void ApplyFillToPortfolio(uint32_t index,
+                                     TickerHandle ticker,
+                                     int signed_volume,
+                                     double price);
+    // RiskEngine::kUnregistered if not registered
+    inline uint32_t FindUserIndex(const std::string &user_id);
+    // Throws if not registered
+    inline uint32_t GetUserIndex(const std::string &user_id);
+    inline LimitOrderBook &GetBook(TickerHandle ticker);
+    inline const LimitOrderBook &GetBook(TickerHandle ticker) const;
+
+    // Records fills/cancels for the exchange, then forwards them to the caller's sink
+    class ExecutionRecorder;
 
 public:
-    Exchange(const std::vector<std::string> &allowed_tickers);
+    Exchange(const std::vector<std::string> &allowed_tickers, const RiskLimits &risk_limits = RiskLimits());
     std::unordered_set<std::string> GetTickers();
-    int GetVolume(std::string ticker, double price, OrderType order_type);
-    TopOfBook GetTopOfBook(std::string ticker);
-    std::vector<Trade> GetPreviousTrades(std::string ticker, int num_previous_trades);
-    bool CancelOrder(std::string ticker, int order_id);
+
+    // Resolve once, then use the handle overloads below
+    TickerHandle ResolveTicker(const std::string &ticker);
+
+    int GetVolume(const std::string &ticker, double price, OrderType order_type);
+    // Owning thread only: reads the book's per-price volume map
+    int GetVolume(TickerHandle ticker, double price, OrderType order_type) const;
+    TopOfBook GetTopOfBook(const std::string &ticker);
+    // Any thread: reads the book's published snapshot
+    TopOfBook GetTopOfBook(TickerHandle ticker) const;
+    // Any thread: the published best bid/ask and the book version it was
+    // taken at, read together
+    BboSnapshot GetBbo(TickerHandle ticker) const;
+    std::vector<Trade> GetPreviousTrades(const std::string &ticker, int num_previous_trades);
+    std::vector<Trade> GetPreviousTrades(TickerHandle ticker, int num_previous_trades);
+    // Same trades as GetPreviousTrades, oldest first, visited in place
+    void ForEachPreviousTrade(TickerHandle ticker,
+                              int num_previous_trades,
+                              const std::function<void(const Trade &)> &visit);
+    bool CancelOrder(const std::string &ticker, int64_t order_id);
+    bool CancelOrder(TickerHandle ticker, int64_t order_id);
     OrderResult HandleOrder(
-        std::string user_id,
+        const std::string &user_id,
+        OrderType order_type,
+        int volume,
+        double price,
+        const std::string &ticker);
+    OrderResult HandleOrder(
+        const std::string &user_id,
+        OrderType order_type,
+        int volume,
+        double price,
+        TickerHandle ticker);
+    // Streams fills to `sink`; returns the resting order's ID or -1
+    int64_t HandleOrder(
+        const std::string &user_id,
         OrderType order_type,
         int volume,
         double price,
-        std::string ticker);
-    std::vector<Trade> GetTradesByUser(std::string user_id);
-    bool RegisterUser(std::string user_id);
+        TickerHandle ticker,
+        ExecutionSink &sink);
+    std::vector<Trade> GetTradesByUser(const std::string &user_id);
+    void ForEachTradeByUser(const std::string &user_id, const std::function<void(const Trade &)> &visit);
+    bool RegisterUser(const std::string &user_id);
+    const Portfolio &GetPortfolio(const std::string &user_id);
+
+    // Mark-to-market at each ticker's last trade price
+    double GetEquity(const std::string &user_id);
+    double GetUnrealizedPnL(const std::string &user_id);
+    std::vector<LeaderboardEntry> GetLeaderboard(size_t count);
+
+    // Per-ticker call auction: orders rest unmatched until Uncross
+    void StartAuction(const std::string &ticker);
+    TradingPhase GetTradingPhase(const std::string &ticker);
+    TradingPhase GetTradingPhase(TickerHandle ticker);
+    UncrossResult GetIndicativeUncross(const std::string &ticker);
+    UncrossResult GetIndicativeUncross(TickerHandle ticker);
+    UncrossResult Uncross(const std::string &ticker);
+    UncrossResult Uncross(TickerHandle ticker, ExecutionSink &sink);
+
+    // Frequent batch auction: orders collect for `interval` and clear in one
+    // uncross; fills are recorded (GetTradesByUser / portfolios) when the
+    // batch clears. A zero interval clears what is pending and resumes
+    // continuous trading.
+    void SetBatchInterval(const std::string &ticker, std::chrono::nanoseconds interval);
+    std::chrono::nanoseconds GetBatchInterval(const std::string &ticker);
+    // Clears every batch whose interval has elapsed; returns the number cleared
+    size_t ClearDueBatches();
+    size_t ClearDueBatches(std::chrono::steady_clock::time_point now);
+
+    // Per-ticker allocation within a price level (default FIFO)
+    void SetMatchingPolicy(const std::string &ticker, MatchingPolicy policy, int min_allocation = 1);
+    MatchingPolicy GetMatchingPolicy(const std::string &ticker);
+
+    void SetRiskLimits(const RiskLimits &risk_limits);
+    const RiskLimits &GetRiskLimits() const;
+    // Notional the user may still commit under the margin limits
+    double GetBuyingPower(const std::string &user_id);
+
+    // Keeps IDs unique across restarts, e.g. after the last trade on a tape
+    void ResumeIdsAfter(TickerHandle ticker, int64_t id);
+
+    // Publishes every trade and book change to `listener` as well
+    void AddMarketDataListener(MarketDataListener *listener);
+    // Lets conflating listeners publish; returns the books they published
+    size_t FlushMarketData();
 };
 
-#endif
\ No newline at end of file
+#endif
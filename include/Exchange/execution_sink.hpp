@@ -0,0 +1,85 @@
+#ifndef EXECUTION_SINK
+#define EXECUTION_SINK
+
+#include "exchange/trade.hpp"
+#include "utils/order_type.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Lightweight view of a single fill
+ *
+ * Only valid for the duration of ExecutionSink::OnFill; `trade` refers to the
+ * book's own trade history, so copy out anything that must outlive the call.
+ */
+struct Fill
+{
+    const Trade &trade;
+    double price;                 // exact execution price (resting level, or the uncross price)
+    OrderType aggressor_side;     // side of the incoming order
+    int64_t resting_order_id;     // order that was hit
+    int resting_remaining_volume; // 0 => resting order left the book
+    double resting_order_price;   // limit price of the resting order
+
+    // Auction uncross only: the aggressor side (BID) was a resting order too
+    int64_t aggressor_order_id = -1;
+    int aggressor_remaining_volume = 0;
+    double aggressor_order_price = 0.0;
+};
+
+/**
+ * @brief View of a resting order leaving the book without trading
+ *
+ * Only valid for the duration of ExecutionSink::OnCancel.
+ */
+struct Cancel
+{
+    int64_t order_id;
+    const std::string &user_id;
+    OrderType side;
+    double price;
+    int volume;      // remaining volume removed from the book
+    bool self_trade; // removed by self-trade prevention, not by request
+};
+
+/**
+ * @brief Receives execution reports from a LimitOrderBook
+ *
+ * OnFill is invoked once per fill, in match order, after the book has been
+ * updated for that fill. OnCancel is invoked when a resting order is
+ * cancelled (explicitly or by self-trade prevention). Implementations must
+ * not call back into the book.
+ */
+class ExecutionSink
+{
+public:
+    virtual ~ExecutionSink() = default;
+    virtual void OnFill(const Fill &fill) = 0;
+    virtual void OnCancel(const Cancel & /*cancel*/) {}
+};
+
+/**
+ * @brief Sink that ignores every report
+ */
+class NullExecutionSink : public ExecutionSink
+{
+public:
+    void OnFill(const Fill &fill) override;
+};
+
+/**
+ * @brief Sink that copies every fill into a vector of Trades
+ *
+ * Backs the OrderResult-returning HandleOrder overloads.
+ */
+class TradeCollector : public ExecutionSink
+{
+public:
+    std::vector<Trade> trades;
+
+    void OnFill(const Fill &fill) override;
+};
+
+#endif // EXECUTION_SINK
@@ -2,24 +2,106 @@
 #define LIMIT_ORDER_BOOK
 // project headers
 #include "exchange/order_node.hpp"
+#include "exchange/order_pool.hpp"
 #include "exchange/trade.hpp"
 #include "utils/order_type.hpp"
 #include "exchange/price_level_queue.hpp"
 #include "exchange/top_of_book.hpp"
 #include "exchange/order_result.hpp"
+#include "exchange/id_generator.hpp"
+#include "exchange/execution_sink.hpp"
+#include "exchange/matching_policy.hpp"
+#include "exchange/trading_phase.hpp"
+#include "ipc/seqlock.hpp"
 
 // std headers
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <variant>
 #include <ctime>
+#include <map>
 #include <unordered_map>
 #include <queue>
 #include <vector>
 
+/**
+ * @brief Compile-time description of one side of the book
+ *
+ * BookSide<S> gives the opposite side, the heap ordering of S's price levels
+ * (best level on top) and whether an aggressive S order at `price` crosses a
+ * resting opposite level, so the matching loop carries no OrderType branches.
+ */
+template <OrderType Side>
+struct BookSide;
+
+template <>
+struct BookSide<OrderType::BID>
+{
+    static constexpr OrderType kOpposite = OrderType::ASK;
+
+    // Max-heap on price: highest bid on top
+    struct Priority
+    {
+        bool operator()(const std::shared_ptr<PriceLevelQueue> &a, const std::shared_ptr<PriceLevelQueue> &b) const
+        {
+            return a->GetPrice() < b->GetPrice();
+        }
+    };
+
+    // Tolerance for floating-point comparison
+    static constexpr bool Crosses(double price, double resting_price)
+    {
+        return price >= resting_price - 1e-6;
+    }
+};
+
+template <>
+struct BookSide<OrderType::ASK>
+{
+    static constexpr OrderType kOpposite = OrderType::BID;
+
+    // Min-heap on price: lowest ask on top
+    struct Priority
+    {
+        bool operator()(const std::shared_ptr<PriceLevelQueue> &a, const std::shared_ptr<PriceLevelQueue> &b) const
+        {
+            return a->GetPrice() > b->GetPrice();
+        }
+    };
+
+    static constexpr bool Crosses(double price, double resting_price)
+    {
+        return resting_price >= price - 1e-6;
+    }
+};
+
+// Price levels of one side, best on top. PopTop moves the best level out
+// instead of copying it, so walking the top levels and pushing them back
+// costs no reference-count traffic.
+template <OrderType Side>
+class PriceLevelHeap : public std::priority_queue<std::shared_ptr<PriceLevelQueue>,
+                                                  std::vector<std::shared_ptr<PriceLevelQueue>>,
+                                                  typename BookSide<Side>::Priority>
+{
+public:
+    std::shared_ptr<PriceLevelQueue> PopTop()
+    {
+        std::pop_heap(this->c.begin(), this->c.end(), this->comp);
+        std::shared_ptr<PriceLevelQueue> top = std::move(this->c.back());
+        this->c.pop_back();
+        return top;
+    }
+};
+
 class LimitOrderBook
 {
 private:
     const std::string ticker;
+
+    // Order & trade IDs, owned by this book (no shared counter)
+    IdGenerator id_generator;
+
     // volume
     std::unordered_map<int, int> ask_volume_at_price;
     std::unordered_map<int, int> bid_volume_at_price;
@@ -29,62 +111,191 @@ private:
     std::unordered_map<double, std::shared_ptr<PriceLevelQueue>> bid_order_queues;
 
     // PQ's of PLQ's
-    std::priority_queue<
-        std::shared_ptr<PriceLevelQueue>,
-        std::vector<std::shared_ptr<PriceLevelQueue>>,
-        std::function<bool(const std::shared_ptr<PriceLevelQueue> &, const std::shared_ptr<PriceLevelQueue> &)>>
-        ask_order_pq;
+    PriceLevelHeap<OrderType::ASK> ask_order_pq;
+    PriceLevelHeap<OrderType::BID> bid_order_pq;
 
-    std::priority_queue<
-        std::shared_ptr<PriceLevelQueue>,
-        std::vector<std::shared_ptr<PriceLevelQueue>>,
-        std::function<bool(const std::shared_ptr<PriceLevelQueue> &, const std::shared_ptr<PriceLevelQueue> &)>>
-        bid_order_pq;
+    // Resting orders: hot/cold slots in the pool, located by order ID
+    OrderPool order_pool;
+    std::unordered_map<int64_t, uint32_t> order_slots;
 
-    // Orders
-    std::unordered_map<int, OrderNode> order_node_map;
+    // Owners of resting orders, by book-local index (OrderNode::owner)
+    std::unordered_map<std::string, uint32_t> owner_indices;
+    std::vector<std::string> owners;
 
     // Previous filled trades
     std::vector<Trade> filled_trades;
 
+    // Per-side members, resolved at compile time
+    template <OrderType Side>
+    PriceLevelHeap<Side> &LevelHeap();
+    template <OrderType Side>
+    std::unordered_map<double, std::shared_ptr<PriceLevelQueue>> &LevelQueues();
+    template <OrderType Side>
+    std::unordered_map<int, int> &VolumeAtPrice();
+
+    // Allocation across the orders of a level
+    MatchingPolicy matching_policy;
+    int min_allocation;
+
+    TradingPhase phase;
+    // Bumped by every change to orders, trades or phase
+    uint64_t update_sequence;
+    // Best bid/ask republished after every change; heap-allocated so its
+    // address survives the book being moved
+    std::unique_ptr<Seqlock<BboSnapshot>> bbo;
+
+    // Drops emptied levels off the top of both heaps and publishes the BBO
+    // (with the indicative uncross during an auction)
+    void PublishBbo();
+    // One pass over the crossing prices of the auction volume maps; leaves
+    // the heaps alone
+    UncrossResult ComputeIndicativeUncross();
+
+    // A price level taking part in an uncross, with its resting volume
+    // (`level` is null for an indication)
+    struct AuctionLevel
+    {
+        double price;
+        std::shared_ptr<PriceLevelQueue> level;
+        int64_t volume;
+    };
+    // Resting volume by price, kept only during an auction: ordered, so an
+    // indication reads the crossing prices without touching the heaps
+    std::map<double, int64_t> auction_bid_volume;
+    std::map<double, int64_t> auction_ask_volume;
+    void AddAuctionVolume(OrderType side, double price, int64_t volume);
+    // Scratch for uncrosses and indications, reused across calls
+    std::vector<AuctionLevel> auction_bids;
+    std::vector<AuctionLevel> auction_asks;
+    // Pops the crossing levels off both heaps (best first); Restore pushes
+    // back the ones that still hold orders
+    void CollectAuctionLevels(std::vector<AuctionLevel> &bids, std::vector<AuctionLevel> &asks);
+    void RestoreAuctionLevels(const std::vector<AuctionLevel> &bids, const std::vector<AuctionLevel> &asks);
+    UncrossResult FindEquilibrium(const std::vector<AuctionLevel> &bids,
+                                  const std::vector<AuctionLevel> &asks) const;
+
+    // Matching core for an aggressive `Side` order
+    template <OrderType Side, typename Allocation>
+    int64_t Match(const std::string &user_id,
+                  int volume,
+                  double price,
+                  time_t timestamp,
+                  ExecutionSink &sink);
+
+    // Fill one crossing level per allocation policy; return unfilled volume
+    template <OrderType Side>
+    int FillLevel(FifoAllocation, PriceLevelQueue &level, uint32_t owner,
+                  const std::string &user_id, int volume, ExecutionSink &sink);
+    template <OrderType Side>
+    int FillLevel(ProRataAllocation, PriceLevelQueue &level, uint32_t owner,
+                  const std::string &user_id, int volume, ExecutionSink &sink);
+    template <OrderType Side>
+    int FillLevel(TopOrderProRataAllocation, PriceLevelQueue &level, uint32_t owner,
+                  const std::string &user_id, int volume, ExecutionSink &sink);
+
+    template <OrderType Side>
+    int64_t WashLevel(PriceLevelQueue &level, uint32_t owner,
+                      const std::string &user_id, ExecutionSink &sink);
+    template <OrderType Side>
+    void AllocateProRata(PriceLevelQueue &level, OrderNode *first, const std::string &user_id,
+                         int volume, int64_t level_volume, ExecutionSink &sink);
+    template <OrderType Side>
+    void FillResting(OrderNode &resting, PriceLevelQueue &level,
+                     const std::string &user_id, int vol_filled, ExecutionSink &sink);
+    template <OrderType Side>
+    void WashResting(OrderNode &resting, PriceLevelQueue &level,
+                     const std::string &user_id, ExecutionSink &sink);
+
+    // Pops the best levels of one side off its heap and pushes them back
+    // before returning: owning thread only
+    template <OrderType Side>
+    size_t CollectDepth(DepthLevel *levels, size_t max_levels);
+    // Levels popped by CollectDepth, pushed back before it returns
+    std::vector<std::shared_ptr<PriceLevelQueue>> depth_scratch;
+
+    // Rests an order without matching and updates the level volume
+    template <OrderType Side>
+    int64_t RestOrder(uint32_t owner, int volume, double price, time_t timestamp);
+
     // Helper to add order to book
-    int AddOrderToBook(std::string user_id,
-                       OrderType order_type,
-                       int volume,
-                       double price,
-                       time_t timestamp,
-                       std::string ticker);
+    template <OrderType Side>
+    int64_t AddOrderToBook(uint32_t owner,
+                           int volume,
+                           double price,
+                           time_t timestamp);
 
-    // std::variant<void, Trade> HandleOrderMatching();
+    uint32_t InternOwner(const std::string &user_id);
+    void ReleaseOrder(int64_t order_id);
 
-    inline bool PricesMatch(double aggressive_price,
-                            double opposite_side_price,
-                            OrderType opposite_side);
+    // std::variant<void, Trade> HandleOrderMatching();
 
-    Trade GenerateTrade(OrderType opposite_side,
-                        std::string user_id,
-                        std::string opposite_user_id,
+    Trade GenerateTrade(const std::string &bid_user_id,
+                        const std::string &ask_user_id,
                         double price,
                         int volume);
 
 public:
-    LimitOrderBook(std::string ticker);
-    int GenerateId();
+    LimitOrderBook(const std::string &ticker, int shard = 0);
+
+    // Applies to orders handled from now on; min_allocation is the smallest
+    // non-zero pro-rata share (smaller shares go to the time-priority remainder)
+    void SetMatchingPolicy(MatchingPolicy policy, int min_allocation = 1);
+    MatchingPolicy GetMatchingPolicy() const;
+
+    // Call auction (opening / re-opening): orders rest without matching
+    // until Uncross executes them at one price and resumes continuous trading
+    void StartAuction();
+    TradingPhase GetTradingPhase() const;
+    // Price and volume an uncross would execute now, without trading; read
+    // from the published snapshot, so safe off the owning thread
+    UncrossResult GetIndicativeUncross() const;
+    UncrossResult Uncross(ExecutionSink &sink);
+    int64_t GenerateId();
 
     // Returns confirmation or vector of trades
     OrderResult HandleOrder(
-        std::string user_id,
+        const std::string &user_id,
+        OrderType order_type,
+        int volume,
+        double price,
+        time_t timestamp,
+        const std::string &ticker);
+
+    // Streams each fill to `sink`; returns the resting order's ID or -1
+    int64_t HandleOrder(
+        const std::string &user_id,
         OrderType order_type,
         int volume,
         double price,
         time_t timestamp,
-        std::string ticker);
+        const std::string &ticker,
+        ExecutionSink &sink);
 
     const std::string &GetTicker() const;
-    int GetVolume(double price, OrderType order_type);
-    bool CancelOrder(int order_id);
-    TopOfBook GetTopOfBook();
+    int GetVolume(double price, OrderType order_type) const;
+    bool CancelOrder(int64_t order_id);
+    // Reports the removed order to `sink`
+    bool CancelOrder(int64_t order_id, ExecutionSink &sink);
+    // Read from the published snapshot: safe from any thread, never
+    // touches the levels the matching thread is changing
+    TopOfBook GetTopOfBook() const;
+    BboSnapshot GetBbo() const;
+    // Writes up to `max_levels` best levels of `side`, best first; returns the count
+    size_t GetDepth(OrderType side, DepthLevel *levels, size_t max_levels);
     std::vector<Trade> GetPreviousTrades(int num_previous_trades);
+
+    // Trade history access by position (0 = oldest)
+    size_t GetTradeCount() const;
+    const Trade &GetTrade(size_t index) const;
+
+    size_t GetRestingOrderCount() const;
+
+    // Version of the book: equal sequences mean no order, trade or phase
+    // change in between, so anything derived from the book is still valid
+    uint64_t GetUpdateSequence() const;
+
+    // New order and trade IDs continue after `id` (see IdGenerator::AdvancePast)
+    void ResumeIdsAfter(int64_t id);
 };
 
 template <typename Comparator>
@@ -0,0 +1,31 @@
+#ifndef MARKET_DATA_LISTENER
+#define MARKET_DATA_LISTENER
+
+#include "exchange/execution_sink.hpp"
+#include "exchange/ticker_handle.hpp"
+
+#include <cstddef>
+
+class LimitOrderBook;
+
+/**
+ * @brief Receives public market data from an Exchange
+ *
+ * OnTrade is invoked once per fill, after the exchange has recorded it.
+ * OnBookUpdate is invoked after every order, cancel or uncross that may have
+ * changed a book, once the exchange is done with it; the listener may read
+ * the book (e.g. LimitOrderBook::GetDepth) but must not trade on it.
+ * Flush is invoked by whoever drives the exchange (Exchange::FlushMarketData)
+ * between rounds of requests; listeners that conflate publish there.
+ */
+class MarketDataListener
+{
+public:
+    virtual ~MarketDataListener() = default;
+    virtual void OnTrade(TickerHandle ticker, const Fill &fill) = 0;
+    virtual void OnBookUpdate(TickerHandle ticker, LimitOrderBook &book) = 0;
+    // Returns the number of books published
+    virtual size_t Flush() { return 0; }
+};
+
+#endif // MARKET_DATA_LISTENER
@@ -0,0 +1,37 @@
+#ifndef MATCHING_POLICY
+#define MATCHING_POLICY
+
+/**
+ * @brief How an aggressive order's volume is allocated across the resting
+ * orders of one price level
+ *
+ * FIFO                 strict time priority.
+ * PRO_RATA             in proportion to resting size; shares below the
+ *                      book's minimum allocation round to zero and the
+ *                      remainder goes out in time priority.
+ * TOP_ORDER_PRO_RATA   the first order in time priority fills first, the
+ *                      rest of the level is allocated PRO_RATA.
+ *
+ * Selected per book at runtime; each value maps to one of the allocation
+ * tags below, which LimitOrderBook::Match takes as a template parameter.
+ */
+enum class MatchingPolicy
+{
+    FIFO,
+    PRO_RATA,
+    TOP_ORDER_PRO_RATA
+};
+
+struct FifoAllocation
+{
+};
+
+struct ProRataAllocation
+{
+};
+
+struct TopOrderProRataAllocation
+{
+};
+
+#endif // MATCHING_POLICY
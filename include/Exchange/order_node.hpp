@@ -1,30 +1,41 @@
 #ifndef ORDER_NODE_H
 #define ORDER_NODE_H
+#include <cstdint>
 #include <ctime>
-#include <string>
 #include "utils/order_type.hpp"
 
-struct OrderNode
+/**
+ * @brief Hot part of a resting order
+ *
+ * Only what a level sweep touches (links, id, volume, owner), packed into a
+ * 32-byte aligned slot so two orders share a cache line. Everything else
+ * lives in the parallel OrderInfo record (see OrderPool).
+ */
+struct alignas(32) OrderNode
 {
-    int order_id;
-    std::string user_id;
-    int volume;
-    double price;
-    OrderType order_type;
-    time_t timestamp;
-    std::string ticker;
     OrderNode *prev;
     OrderNode *next;
+    int64_t order_id;
+    int volume;
+    uint32_t owner; // book-local owner index, see LimitOrderBook::InternOwner
 
-    OrderNode(int order_id,
-              std::string user_id,
-              int volume,
-              double price,
-              OrderType order_type,
-              time_t timestamp,
-              std::string ticker,
+    OrderNode(int64_t order_id = -1,
+              uint32_t owner = 0,
+              int volume = 0,
               OrderNode *prev = nullptr,
               OrderNode *next = nullptr);
 };
 
+static_assert(sizeof(OrderNode) == 32, "OrderNode must fit a 32-byte slot");
+
+/**
+ * @brief Cold part of a resting order, only read on cancel
+ */
+struct OrderInfo
+{
+    double price;
+    time_t timestamp;
+    OrderType order_type;
+};
+
 #endif
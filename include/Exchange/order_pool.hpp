@@ -0,0 +1,53 @@
+#ifndef ORDER_POOL_H
+#define ORDER_POOL_H
+#include "exchange/order_node.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Chunked slot pool holding every resting order of one book
+ *
+ * Hot OrderNodes and cold OrderInfos live in parallel arrays indexed by the
+ * same slot, allocated kChunkSize at a time. Chunks never move, so nodes can
+ * be linked into PriceLevelQueues by pointer; freed slots are reused LIFO
+ * (the most recently freed slot is the one most likely still in cache).
+ */
+class OrderPool
+{
+private:
+    std::vector<std::unique_ptr<OrderNode[]>> hot_chunks;
+    std::vector<std::unique_ptr<OrderInfo[]>> cold_chunks;
+    std::vector<uint32_t> free_slots;
+    uint32_t next_slot;
+
+public:
+    static constexpr uint32_t kChunkBits = 12;
+    static constexpr uint32_t kChunkSize = uint32_t{1} << kChunkBits;
+
+    OrderPool();
+    // Linked nodes point into the chunks: movable (chunks stay put), not copyable
+    OrderPool(const OrderPool &) = delete;
+    OrderPool &operator=(const OrderPool &) = delete;
+    OrderPool(OrderPool &&) = default;
+    OrderPool &operator=(OrderPool &&) = default;
+
+    // Stores an order and returns its slot
+    uint32_t Allocate(const OrderNode &hot, const OrderInfo &cold);
+    void Free(uint32_t slot);
+    size_t GetLiveCount() const;
+
+    OrderNode &Hot(uint32_t slot)
+    {
+        return hot_chunks[slot >> kChunkBits][slot & (kChunkSize - 1)];
+    }
+
+    const OrderInfo &Cold(uint32_t slot) const
+    {
+        return cold_chunks[slot >> kChunkBits][slot & (kChunkSize - 1)];
+    }
+};
+
+#endif
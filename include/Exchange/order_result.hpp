@@ -1,6 +1,7 @@
 #ifndef ORDER_RESULT
 #define ORDER_RESULT
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <variant>
@@ -8,19 +9,21 @@
 
 /**
  * @brief Struct to represent the results of an order
+ *
+ * Members are non-const so results (and their trades) can be moved.
  */
 struct OrderResult
 {
-    const bool trades_executed;
-    const std::vector<Trade> trades;
-    const bool order_added_to_book;
-    const int order_id;
+    bool trades_executed;
+    std::vector<Trade> trades;
+    bool order_added_to_book;
+    int64_t order_id;
 
     OrderResult(
         bool trades_executed,
         std::vector<Trade> trades,
         bool order_added_to_book,
-        int order_id);
+        int64_t order_id);
 };
 
 #endif // ORDER_RESULT
@@ -3,6 +3,8 @@
 #include "exchange/order_node.hpp"
 #include "utils/order_type.hpp"
 
+#include <cstdint>
+
 class PriceLevelQueue
 {
 private:
@@ -10,13 +12,23 @@ private:
     OrderNode front;
     OrderNode back;
     bool has_orders;
+    int64_t volume; // resting volume of the orders in the queue
 
 public:
     PriceLevelQueue(double price);
     double GetPrice() const;
-    void AddOrder(OrderNode &order);
+    // order_price: the order's limit price (OrderNode does not carry it)
+    void AddOrder(OrderNode &order, double order_price);
     bool HasOrders() const;
+    // Remaining volume of every order in the queue, kept exact per price
+    int64_t GetVolume() const;
+    // Call when a queued order's volume is reduced in place by a fill
+    void ReduceVolume(int filled);
     void RemoveOrder(OrderNode &order);
+    // Time-priority iteration: Begin() up to (excluding) End(); save `next`
+    // before removing the current node
+    OrderNode *Begin();
+    const OrderNode *End() const;
     // Additional methods for testing
     const OrderNode *GetFrontNext() const;
     const OrderNode *GetBackPrev() const;
@@ -0,0 +1,21 @@
+#ifndef TICKER_HANDLE
+#define TICKER_HANDLE
+
+#include <cstdint>
+
+/**
+ * @brief Resolved ticker: dense index of a LimitOrderBook inside an Exchange
+ *
+ * Obtained once via Exchange::ResolveTicker and then passed to the
+ * handle-based Exchange methods, which index straight into the book vector
+ * instead of hashing the ticker string on every call.
+ */
+struct TickerHandle
+{
+    uint32_t index;
+
+    bool operator==(const TickerHandle &other) const { return index == other.index; }
+    bool operator!=(const TickerHandle &other) const { return index != other.index; }
+};
+
+#endif // TICKER_HANDLE
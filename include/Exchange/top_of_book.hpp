@@ -1,6 +1,32 @@
 #ifndef TOP_OF_BOOK
 #define TOP_OF_BOOK
 
+#include "exchange/trading_phase.hpp"
+#include <cstdint>
+
+/**
+ * One aggregated price level of a book side, as reported by GetDepth
+ */
+struct DepthLevel
+{
+    double price;
+    int volume;
+};
+
+/**
+ * Best level of each side as a plain value, for publishing through a
+ * Seqlock; a side with volume 0 is empty. During an auction it also carries
+ * the indicative uncross, worked out by the owning thread at publish time.
+ */
+struct BboSnapshot
+{
+    DepthLevel bid;
+    DepthLevel ask;
+    uint64_t update_sequence; // the book's sequence when it was taken
+    TradingPhase phase;
+    UncrossResult indicative; // all zero outside an auction
+};
+
 struct TopOfBook
 {
     const bool book_has_top;
@@ -15,6 +41,8 @@ struct TopOfBook
         int ask_volume,
         int bid_price,
         int bid_volume);
+    // No top when both sides are empty; an empty side keeps price 0 and volume 0
+    explicit TopOfBook(const BboSnapshot &snapshot);
 };
 
-#endif
\ No newline at end of file
+#endif
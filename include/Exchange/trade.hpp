@@ -1,5 +1,6 @@
 #ifndef TRADE
 #define TRADE
+#include <cstdint>
 #include <ctime>
 #include <string>
 
@@ -8,7 +9,7 @@
  */
 struct Trade
 {
-    const int trade_id;
+    const int64_t trade_id;
     const int price;
     const int volume;
     const time_t timestamp;
@@ -26,7 +27,7 @@ struct Trade
      * @param ask_user_id ask user
      *
      */
-    Trade(int trade_id, int price, int volume, time_t timestamp,
+    Trade(int64_t trade_id, int price, int volume, time_t timestamp,
           const std::string &bid_user_id, const std::string &ask_user_id);
 };
 
@@ -0,0 +1,29 @@
+#ifndef TRADING_PHASE
+#define TRADING_PHASE
+
+/**
+ * @brief Trading phase of one LimitOrderBook
+ *
+ * CONTINUOUS   every order is matched on arrival.
+ * AUCTION      orders rest without matching, even when the book crosses;
+ *              Uncross() executes them at a single equilibrium price and
+ *              returns the book to CONTINUOUS. Cancels are not deferred:
+ *              CancelOrder removes the order immediately in either phase.
+ */
+enum class TradingPhase
+{
+    CONTINUOUS,
+    AUCTION
+};
+
+/**
+ * @brief Outcome (or indication) of an auction uncross
+ */
+struct UncrossResult
+{
+    double price;  // equilibrium price, 0.0 if the book does not cross
+    int volume;    // volume executed (or executable) at `price`
+    int imbalance; // buy volume - sell volume left unmatched at `price`
+};
+
+#endif // TRADING_PHASE
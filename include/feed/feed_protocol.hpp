@@ -0,0 +1,106 @@
+#ifndef FEED_PROTOCOL_HPP
+#define FEED_PROTOCOL_HPP
+
+#include "exchange/top_of_book.hpp"
+#include "utils/order_type.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Wire format of the sequenced market data feed.
+ *
+ * The incremental feed is UDP multicast. Every datagram is a FeedPacketHeader
+ * followed by `message_count` FeedMessages carrying consecutive sequence
+ * numbers, starting at `sequence` (the first message of a session is 1). A
+ * packet with no messages is a heartbeat announcing the next sequence number,
+ * so a receiver notices a lost tail even when the market is quiet.
+ *
+ * Book state is L2 over the best kFeedDepth levels per side: a LEVEL_UPDATE
+ * sets the aggregate volume at a price, and volume 0 deletes the level. The
+ * publisher emits deletes for levels that leave the top kFeedDepth, so a
+ * receiver's book never holds more than kFeedDepth levels per side.
+ *
+ * Recovery is over TCP: the snapshot service writes a FeedSnapshotHeader, one
+ * FeedSnapshotTicker per ticker and closes. The snapshot reflects every
+ * message up to and including its `sequence`. Same-host protocol: fields are
+ * in host byte order.
+ */
+
+constexpr uint32_t kFeedMagic = 0x58464544; // "XFED"
+constexpr size_t kFeedDepth = 10;
+constexpr size_t kFeedTickerSize = 16;
+constexpr size_t kFeedMaxMessagesPerPacket = 32;
+
+enum class FeedMessageType : uint8_t
+{
+    LEVEL_UPDATE,
+    EXECUTION
+};
+
+struct FeedPacketHeader
+{
+    uint32_t magic;
+    uint32_t session;   // changes when the publisher restarts
+    uint64_t sequence;  // of the first message, or the next one for a heartbeat
+    uint16_t message_count;
+    uint16_t reserved[3];
+};
+
+struct FeedMessage
+{
+    uint32_t ticker;   // TickerHandle::index
+    int32_t volume;    // LEVEL_UPDATE: new aggregate volume (0 => deleted); EXECUTION: traded
+    double price;
+    int64_t trade_id;  // EXECUTION only
+    int64_t timestamp; // EXECUTION only
+    FeedMessageType type;
+    OrderType side;    // LEVEL_UPDATE: book side; EXECUTION: aggressor side
+};
+
+struct FeedPacket
+{
+    FeedPacketHeader header;
+    FeedMessage messages[kFeedMaxMessagesPerPacket];
+};
+static_assert(sizeof(FeedPacket) <= 1472, "a full packet must fit one Ethernet frame");
+
+// L2 state of one ticker: best levels first
+struct FeedBook
+{
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+    DepthLevel bids[kFeedDepth];
+    DepthLevel asks[kFeedDepth];
+};
+
+struct FeedSnapshotHeader
+{
+    uint32_t magic;
+    uint32_t session;
+    uint64_t sequence; // last message reflected in the books
+    uint32_t num_tickers;
+    uint32_t reserved;
+};
+
+struct FeedSnapshotTicker
+{
+    char name[kFeedTickerSize];
+    FeedBook book;
+};
+
+/**
+ * Where the feed is published. The defaults keep everything on loopback:
+ * an administratively scoped group, sent and joined on 127.0.0.1, with the
+ * snapshot service listening on the same address.
+ */
+struct FeedOptions
+{
+    std::string group = "239.255.42.1";
+    uint16_t port = 30001;
+    std::string interface_address = "127.0.0.1";
+    uint16_t snapshot_port = 30002; // 0 picks a free port (see FeedSnapshotServer::GetPort)
+};
+
+#endif // FEED_PROTOCOL_HPP
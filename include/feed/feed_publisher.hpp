@@ -0,0 +1,79 @@
+#ifndef FEED_PUBLISHER_HPP
+#define FEED_PUBLISHER_HPP
+
+#include "exchange/market_data_listener.hpp"
+#include "feed/feed_protocol.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Publishes an Exchange's trades and L2 changes as a sequenced UDP
+ * multicast feed
+ *
+ * Attach with Exchange::AddMarketDataListener and drive from the thread that
+ * drives the exchange. Trades are sequenced as they happen; book updates
+ * only mark the ticker dirty, and Flush diffs each dirty ticker's top
+ * kFeedDepth levels against what was last published, emitting one
+ * LEVEL_UPDATE per changed level. Messages are batched into packets that go
+ * out when full or at the end of Flush; sends never block, and a datagram
+ * the kernel refuses is counted and left to the receivers' gap recovery.
+ *
+ * The published books double as the recovery snapshot: CopySnapshot may be
+ * called from any thread (see FeedSnapshotServer).
+ */
+class FeedPublisher : public MarketDataListener
+{
+private:
+    static constexpr std::chrono::seconds kHeartbeatInterval{1};
+
+    int socket_fd;
+    sockaddr_in group_address;
+    uint32_t session;
+    std::vector<std::string> tickers;
+    uint64_t next_sequence;
+    FeedPacket packet;
+    uint64_t dropped_packets;
+    std::chrono::steady_clock::time_point last_send;
+
+    std::vector<LimitOrderBook *> books;
+    std::vector<uint32_t> dirty_tickers;
+    std::vector<bool> is_dirty;
+    FeedBook scratch;
+
+    // Books as last published, and the last sequence they reflect
+    mutable std::mutex snapshot_mutex;
+    std::vector<FeedBook> published_books;
+    uint64_t published_sequence;
+
+    FeedMessage &AppendMessage(FeedMessageType type, uint32_t ticker);
+    void PublishLevelChanges(uint32_t ticker, OrderType side,
+                             const DepthLevel *before, uint32_t before_levels,
+                             const DepthLevel *after, uint32_t after_levels);
+    void SendPacket();
+
+public:
+    // `tickers` in Exchange order: ticker i is TickerHandle{i}
+    FeedPublisher(const FeedOptions &options, const std::vector<std::string> &tickers);
+    ~FeedPublisher();
+
+    FeedPublisher(const FeedPublisher &) = delete;
+    FeedPublisher &operator=(const FeedPublisher &) = delete;
+
+    void OnTrade(TickerHandle ticker, const Fill &fill) override;
+    void OnBookUpdate(TickerHandle ticker, LimitOrderBook &book) override;
+    // Publishes every ticker updated since the last flush; returns how many
+    size_t Flush() override;
+
+    void CopySnapshot(FeedSnapshotHeader &header, std::vector<FeedSnapshotTicker> &books) const;
+    uint32_t GetSession() const;
+    // Datagrams the kernel would not take
+    uint64_t GetDroppedPackets() const;
+};
+
+#endif // FEED_PUBLISHER_HPP
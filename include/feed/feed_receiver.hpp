@@ -0,0 +1,64 @@
+#ifndef FEED_RECEIVER_HPP
+#define FEED_RECEIVER_HPP
+
+#include "exchange/ticker_handle.hpp"
+#include "exchange/top_of_book.hpp"
+#include "feed/feed_protocol.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Subscriber side of the multicast feed: keeps every ticker's L2 book
+ *
+ * Joins the group, then loads a snapshot so it starts in sync. Each packet
+ * is checked against the next expected sequence number: duplicates and
+ * messages the snapshot already covers are skipped, and a gap (or a new
+ * publisher session) triggers another snapshot before the packet is applied.
+ * If the snapshot is older than the packet, the receiver stays out of sync
+ * and retries on the next packet. Single-threaded.
+ */
+class FeedReceiver
+{
+private:
+    FeedOptions options;
+    int socket_fd;
+    FeedPacket packet;
+
+    bool synced;
+    uint32_t session;
+    uint64_t next_sequence;
+    std::vector<std::string> tickers;
+    std::vector<FeedBook> books;
+    uint64_t gaps;
+    uint64_t recoveries;
+
+    bool Recover();
+    void ApplyLevelUpdate(const FeedMessage &message);
+
+public:
+    // Joins the feed and loads the first snapshot; throws if either fails
+    explicit FeedReceiver(const FeedOptions &options);
+    ~FeedReceiver();
+
+    FeedReceiver(const FeedReceiver &) = delete;
+    FeedReceiver &operator=(const FeedReceiver &) = delete;
+
+    // Waits up to `timeout_millis` for a packet and applies it; trades it
+    // carried are appended to `trades`. Returns false if nothing arrived.
+    bool Poll(int timeout_millis, std::vector<FeedMessage> *trades = nullptr);
+
+    // Throws std::out_of_range for unknown tickers
+    TickerHandle ResolveTicker(const std::string &ticker) const;
+    const FeedBook &GetBook(TickerHandle ticker) const;
+    TopOfBook GetTopOfBook(TickerHandle ticker) const;
+
+    bool IsSynced() const;
+    uint64_t GetNextSequence() const;
+    // Sequence gaps seen while in sync, and snapshots loaded (including the first)
+    uint64_t GetGapCount() const;
+    uint64_t GetRecoveryCount() const;
+};
+
+#endif // FEED_RECEIVER_HPP
@@ -0,0 +1,44 @@
+#ifndef FEED_SNAPSHOT_SERVER_HPP
+#define FEED_SNAPSHOT_SERVER_HPP
+
+#include "feed/feed_protocol.hpp"
+#include "feed/feed_publisher.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief TCP recovery service for the multicast feed
+ *
+ * Every connection is answered with the publisher's current snapshot
+ * (FeedSnapshotHeader, then one FeedSnapshotTicker per ticker) and closed;
+ * the client sends nothing. Runs on its own thread and only touches the
+ * publisher through FeedPublisher::CopySnapshot, so the engine thread is
+ * never held up by a slow client beyond one short lock.
+ */
+class FeedSnapshotServer
+{
+private:
+    FeedPublisher &publisher;
+    int listen_fd;
+    uint16_t port;
+    std::atomic<bool> stop;
+    std::thread thread;
+
+    void Serve();
+    void SendSnapshot(int client_fd);
+
+public:
+    // Listens on options.interface_address:options.snapshot_port
+    FeedSnapshotServer(FeedPublisher &publisher, const FeedOptions &options);
+    ~FeedSnapshotServer();
+
+    FeedSnapshotServer(const FeedSnapshotServer &) = delete;
+    FeedSnapshotServer &operator=(const FeedSnapshotServer &) = delete;
+
+    // Port actually bound (useful with snapshot_port 0)
+    uint16_t GetPort() const;
+};
+
+#endif // FEED_SNAPSHOT_SERVER_HPP
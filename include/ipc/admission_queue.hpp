@@ -0,0 +1,152 @@
+#ifndef ADMISSION_QUEUE_HPP
+#define ADMISSION_QUEUE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Priority lanes, served in this order
+enum class AdmissionClass : uint8_t
+{
+    CANCEL,
+    ORDER,
+    QUERY,
+    BULK_QUERY // trade history scans: get_previous_trades, get_trades_by_user
+};
+
+constexpr size_t kAdmissionClasses = 4;
+
+inline const char *AdmissionClassToString(AdmissionClass admission_class)
+{
+    switch (admission_class)
+    {
+    case AdmissionClass::CANCEL:
+        return "cancel";
+    case AdmissionClass::ORDER:
+        return "order";
+    case AdmissionClass::QUERY:
+        return "query";
+    case AdmissionClass::BULK_QUERY:
+        return "bulk_query";
+    }
+    return "unknown";
+}
+
+/**
+ * Queue depths (requests waiting, all lanes together) at which each class
+ * is shed instead of queued. Cancels are never shed: pulling quotes is what
+ * a participant most needs during a burst. The defaults are fractions of
+ * the 512 requests an engine round holds when every gateway channel has a
+ * full pipeline (EngineService::kMaxRoundDepth).
+ */
+struct AdmissionOptions
+{
+    size_t shed_bulk_queries_depth = 64;
+    size_t shed_queries_depth = 256;
+    size_t shed_orders_depth = 448;
+};
+
+/**
+ * @brief Classifies a burst of requests into priority lanes and sheds the
+ * least important ones once the backlog passes configurable depths
+ *
+ * Pop serves cancels before orders and orders before queries, each lane in
+ * arrival order. Lanes are vectors rewound when drained, so a queue that
+ * is emptied every round stops allocating once it has seen its largest
+ * burst. Single-threaded.
+ */
+template <typename T>
+class AdmissionQueue
+{
+private:
+    struct Lane
+    {
+        std::vector<T> items;
+        size_t next = 0;
+    };
+
+    AdmissionOptions options;
+    std::array<Lane, kAdmissionClasses> lanes;
+    size_t depth = 0;
+    size_t max_depth = 0;
+    std::array<uint64_t, kAdmissionClasses> admitted{};
+    std::array<uint64_t, kAdmissionClasses> shed{};
+
+    size_t ShedDepth(AdmissionClass admission_class) const
+    {
+        switch (admission_class)
+        {
+        case AdmissionClass::ORDER:
+            return options.shed_orders_depth;
+        case AdmissionClass::QUERY:
+            return options.shed_queries_depth;
+        case AdmissionClass::BULK_QUERY:
+            return options.shed_bulk_queries_depth;
+        default:
+            return SIZE_MAX;
+        }
+    }
+
+public:
+    explicit AdmissionQueue(const AdmissionOptions &options = AdmissionOptions()) : options(options) {}
+
+    // False when the request is shed; it is then counted and not queued
+    bool Push(AdmissionClass admission_class, T value)
+    {
+        size_t lane_index = static_cast<size_t>(admission_class);
+        if (depth >= ShedDepth(admission_class))
+        {
+            ++shed[lane_index];
+            return false;
+        }
+        lanes[lane_index].items.push_back(std::move(value));
+        ++admitted[lane_index];
+        if (++depth > max_depth)
+        {
+            max_depth = depth;
+        }
+        return true;
+    }
+
+    // Highest-priority request waiting; false when empty
+    bool Pop(T &value)
+    {
+        for (Lane &lane : lanes)
+        {
+            if (lane.next == lane.items.size())
+            {
+                continue;
+            }
+            value = std::move(lane.items[lane.next++]);
+            if (lane.next == lane.items.size())
+            {
+                lane.items.clear();
+                lane.next = 0;
+            }
+            --depth;
+            return true;
+        }
+        return false;
+    }
+
+    size_t GetDepth() const { return depth; }
+    size_t GetDepth(AdmissionClass admission_class) const
+    {
+        const Lane &lane = lanes[static_cast<size_t>(admission_class)];
+        return lane.items.size() - lane.next;
+    }
+    size_t GetMaxDepth() const { return max_depth; }
+    uint64_t GetAdmittedCount(AdmissionClass admission_class) const
+    {
+        return admitted[static_cast<size_t>(admission_class)];
+    }
+    uint64_t GetShedCount(AdmissionClass admission_class) const
+    {
+        return shed[static_cast<size_t>(admission_class)];
+    }
+    const AdmissionOptions &GetOptions() const { return options; }
+};
+
+#endif // ADMISSION_QUEUE_HPP
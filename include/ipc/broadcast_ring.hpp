@@ -0,0 +1,81 @@
+#ifndef BROADCAST_RING_HPP
+#define BROADCAST_RING_HPP
+
+#include "ipc/seqlock.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Single-writer ring that any number of readers follow independently
+ *
+ * Unlike SpscRing the writer never waits: each reader keeps its own cursor,
+ * and one that falls more than Capacity entries behind skips ahead to the
+ * oldest entry still held. Every slot is a Seqlock stamped with the entry's
+ * sequence number, so a reader racing the writer on a slot retries instead
+ * of returning a torn or newer entry.
+ */
+template <typename T, size_t Capacity>
+class BroadcastRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    struct Entry
+    {
+        uint64_t sequence;
+        T value;
+    };
+
+    alignas(64) std::atomic<uint64_t> published{0};
+    Seqlock<Entry> slots[Capacity];
+
+public:
+    // Writer side
+    void Publish(const T &value)
+    {
+        const uint64_t sequence = published.load(std::memory_order_relaxed);
+        slots[sequence & (Capacity - 1)].Store(Entry{sequence, value});
+        published.store(sequence + 1, std::memory_order_release);
+    }
+
+    // Sequence number the next Publish will use
+    uint64_t GetPublished() const
+    {
+        return published.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Reads the entry at `cursor` and advances it. If the entry was already
+     * overwritten, the cursor first jumps to the oldest entry held, so
+     * callers can count skipped entries from the jump.
+     *
+     * @return false if no entry at or after `cursor` has been published
+     */
+    bool Read(uint64_t &cursor, T &value) const
+    {
+        Entry entry;
+        while (true)
+        {
+            const uint64_t head = published.load(std::memory_order_acquire);
+            if (cursor >= head)
+            {
+                return false;
+            }
+            if (head - cursor > Capacity)
+            {
+                cursor = head - Capacity;
+            }
+            if (slots[cursor & (Capacity - 1)].TryLoad(entry) && entry.sequence == cursor)
+            {
+                value = entry.value;
+                ++cursor;
+                return true;
+            }
+            // The writer is reusing this slot: the next head shows how far
+        }
+    }
+};
+
+#endif // BROADCAST_RING_HPP
@@ -0,0 +1,99 @@
+#ifndef ENGINE_CLIENT_HPP
+#define ENGINE_CLIENT_HPP
+
+#include "exchange/execution_sink.hpp"
+#include "exchange/ticker_handle.hpp"
+#include "ipc/gateway_protocol.hpp"
+#include "utils/order_type.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Gateway side of one shared-memory channel to the matching engine
+ *
+ * Claims a free GatewayChannel on construction and releases it on
+ * destruction. The plain calls are synchronous: each request is pushed onto
+ * the channel and the caller spins (yielding after a short budget) until
+ * the engine's answer arrives. The Submit/Collect pairs pipeline instead:
+ * up to kMaxGatewayPipeline requests are sent before any answer is read, so
+ * a burst reaches the engine's admission queue as one backlog, and answers
+ * that arrive for another request in flight are held until collected. If
+ * the engine drops the channel because responses went unread, the waiting
+ * call throws, and so does collecting any request that was in flight on it;
+ * the next submission claims a fresh channel. One instance per thread; not
+ * thread-safe.
+ */
+class EngineClient
+{
+private:
+    GatewayRegion &region;
+    GatewayChannel *channel;
+    uint64_t next_request_id;
+    // Requests sent on this channel and not fully answered yet, and the
+    // answers read for them while collecting another
+    std::vector<uint64_t> in_flight;
+    std::vector<GatewayResponse> held;
+
+    void Claim();
+    // Id for a new request, counted in flight until its last response
+    uint64_t NextRequestId();
+    // Throws if the engine died or dropped the channel
+    void CheckEngine() const;
+    void Send(const GatewayRequest &request);
+    // Next response to `request_id`; responses to abandoned requests are
+    // skipped. Throws if the request is not in flight on this channel.
+    GatewayResponse Receive(uint64_t request_id);
+    [[noreturn]] void ThrowRejection(const GatewayResponse &response);
+
+public:
+    static constexpr int kSpinsBeforeYield = 1024;
+    static constexpr uint64_t kLivenessInterval = 1 << 16; // waits between engine checks
+
+    explicit EngineClient(GatewayRegion &region);
+    ~EngineClient();
+    EngineClient(const EngineClient &) = delete;
+    EngineClient &operator=(const EngineClient &) = delete;
+
+    // Resolved from the ticker table the engine published; no round trip
+    TickerHandle ResolveTicker(const std::string &ticker) const;
+    std::vector<std::string> GetTickers() const;
+    // The engine's admission counters, read from the region; no round trip
+    EngineLoad GetEngineLoad() const;
+
+    // Same contract as Exchange::HandleOrder: fills go to `sink`, throws
+    // RiskRejection when a risk check fails
+    int64_t HandleOrder(
+        const std::string &user_id,
+        OrderType order_type,
+        int volume,
+        double price,
+        TickerHandle ticker,
+        ExecutionSink &sink);
+    bool CancelOrder(TickerHandle ticker, int64_t order_id);
+    // Forwards a JSON request for the engine's RequestHandler; returns its JSON response
+    std::string Query(const std::string &request_json);
+    // Same, appending the response to `response`
+    void Query(std::string_view request_json, std::string &response);
+
+    // Pipelined forms of the calls above: Submit* sends the request and
+    // returns its id, the matching Collect* waits for its answer, in any
+    // order. Submit* throws once kMaxGatewayPipeline requests are in flight.
+    uint64_t SubmitOrder(
+        const std::string &user_id,
+        OrderType order_type,
+        int volume,
+        double price,
+        TickerHandle ticker);
+    uint64_t SubmitCancel(TickerHandle ticker, int64_t order_id);
+    uint64_t SubmitQuery(std::string_view request_json);
+    int64_t CollectOrder(uint64_t request_id, ExecutionSink &sink);
+    bool CollectCancel(uint64_t request_id);
+    void CollectQuery(uint64_t request_id, std::string &response);
+
+    size_t GetInFlightCount() const { return in_flight.size(); }
+};
+
+#endif // ENGINE_CLIENT_HPP
@@ -0,0 +1,110 @@
+#ifndef ENGINE_SERVICE_HPP
+#define ENGINE_SERVICE_HPP
+
+#include "exchange/exchange.hpp"
+#include "exchange/execution_sink.hpp"
+#include "ipc/admission_queue.hpp"
+#include "ipc/gateway_protocol.hpp"
+#include "server/request_handler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Engine side of the shared-memory gateway
+ *
+ * Drains the request ring of every claimed GatewayChannel into an
+ * AdmissionQueue, then runs the round against the Exchange on the calling
+ * thread, cancels first, and answers on each channel's response ring. The
+ * backlog a round sees is whatever the gateways pipelined (EngineClient's
+ * Submit calls) while the previous round ran.
+ * Requests the queue sheds under load are answered straight away with an
+ * overload error. Single-threaded by design: the engine thread is the only
+ * one touching the Exchange, and nothing on the order path enters the
+ * kernel. After answering a round of requests it flushes conflated market
+ * data (Exchange::FlushMarketData) and publishes its queue counters
+ * (GatewayRegion::load). Every poll first clears due batch auctions; when
+ * idle it now and then frees channels whose gateway process has died. A
+ * gateway that leaves its response ring full for kRespondTimeout has its
+ * channel dropped (GatewayChannel::dropped) and counted in the load.
+ */
+class EngineService
+{
+private:
+    // Streams the fills of one order back to its channel
+    class FillForwarder : public ExecutionSink
+    {
+    private:
+        EngineService &service;
+        uint32_t channel_index;
+        uint64_t request_id;
+
+    public:
+        FillForwarder(EngineService &service, uint32_t channel_index, uint64_t request_id)
+            : service(service), channel_index(channel_index), request_id(request_id) {}
+
+        void OnFill(const Fill &fill) override;
+    };
+
+    // A request waiting in the admission queue; QUERY chunks are staged
+    // once, reassembled and parsed
+    struct StagedRequest
+    {
+        uint32_t channel_index;
+        uint32_t channel_generation; // stale once the channel is reset
+        GatewayRequest request;
+        nlohmann::json query;
+    };
+
+    Exchange &exchange;
+    GatewayRegion &region;
+    RequestHandler request_handler;
+    AdmissionQueue<StagedRequest> admission;
+    // Per channel: QUERY text received so far, tickers it resolved, resets
+    std::vector<std::string> pending_queries;
+    std::vector<RequestHandler::TickerCache> ticker_caches;
+    std::vector<uint32_t> channel_generations;
+    std::string query_response; // reused for every QUERY_RESULT
+    uint64_t idle_polls;
+
+    void StageRequest(uint32_t channel_index, const GatewayRequest &request);
+    void Shed(const StagedRequest &staged);
+    void HandleRequest(const StagedRequest &staged);
+    void HandleNewOrder(uint32_t channel_index, const GatewayRequest &request);
+    void HandleQuery(uint32_t channel_index, uint64_t request_id, const nlohmann::json &query);
+    void PublishLoad(size_t depth);
+    // Waits for ring space; gives up the channel if its gateway died or stalled
+    void Respond(uint32_t channel_index, const GatewayResponse &response);
+    void RespondText(uint32_t channel_index, uint64_t request_id, GatewayResponseType type, std::string_view text);
+    void DropChannel(uint32_t channel_index);
+    void ResetChannel(uint32_t channel_index);
+    void ReapDeadChannels();
+
+public:
+    // Per poll, for fairness; a full pipeline is taken in one round
+    static constexpr size_t kMaxRequestsPerChannel = kMaxGatewayPipeline;
+    // Deepest backlog one round can hold
+    static constexpr size_t kMaxRoundDepth = kMaxGatewayChannels * kMaxRequestsPerChannel;
+    static constexpr uint64_t kReapInterval = 1 << 16;   // idle polls between liveness checks
+    static constexpr int kSpinsBeforeYield = 1024;       // on a full response ring
+    static constexpr std::chrono::milliseconds kRespondTimeout{10}; // then the channel is dropped
+
+    EngineService(Exchange &exchange,
+                  GatewayRegion &region,
+                  const AdmissionOptions &admission_options = AdmissionOptions());
+
+    // Handles whatever is queued on every channel; returns the number of requests
+    size_t PollOnce();
+    // Busy-polls until `stop` is set
+    void Run(const std::atomic<bool> &stop);
+
+    const ResponseCache &GetResponseCache() const { return request_handler.GetResponseCache(); }
+};
+
+#endif // ENGINE_SERVICE_HPP
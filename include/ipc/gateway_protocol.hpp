@@ -0,0 +1,151 @@
+#ifndef GATEWAY_PROTOCOL_HPP
+#define GATEWAY_PROTOCOL_HPP
+
+#include "ipc/admission_queue.hpp"
+#include "ipc/shared_memory.hpp"
+#include "ipc/spsc_ring.hpp"
+#include "utils/order_type.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Binary protocol between a network gateway process and the matching engine
+ * process, carried over SpscRings in one shared-memory region.
+ *
+ * Each gateway thread claims one GatewayChannel and is its only producer of
+ * requests and only consumer of responses; the engine is the other side of
+ * every channel. Orders and cancels travel as fixed binary messages; any
+ * other request is forwarded as JSON text (QUERY), split across as many
+ * messages as needed, and answered the same way. A gateway may have up to
+ * kMaxGatewayPipeline requests in flight on its channel; the engine answers
+ * each in full, but not necessarily in the order they were sent.
+ */
+
+constexpr uint64_t kGatewayMagic = 0x5845434847415445; // "XECHGATE"
+constexpr uint32_t kGatewayVersion = 3;
+constexpr uint32_t kMaxGatewayChannels = 8;
+constexpr size_t kMaxGatewayPipeline = 64; // requests in flight per channel
+constexpr uint32_t kMaxGatewayTickers = 64;
+constexpr size_t kGatewayTickerSize = 16;
+constexpr size_t kGatewayUserIdSize = 32;
+constexpr size_t kGatewayTextSize = 128;
+
+enum class GatewayRequestType : uint8_t
+{
+    NEW_ORDER,
+    CANCEL_ORDER,
+    QUERY
+};
+
+struct GatewayRequest
+{
+    uint64_t request_id;
+    GatewayRequestType type;
+    OrderType side;
+    bool last_chunk; // QUERY: false => text continues in the next request
+    uint16_t text_size;
+    uint32_t ticker;
+    int32_t volume;
+    double price;
+    int64_t order_id;
+    char user_id[kGatewayUserIdSize]; // NUL-terminated
+    char text[kGatewayTextSize];
+};
+
+enum class GatewayResponseType : uint8_t
+{
+    FILL,           // one per fill of a NEW_ORDER, before its ORDER_ACCEPTED
+    ORDER_ACCEPTED, // order_id > 0 => remainder rests on the book
+    CANCEL_RESULT,  // volume = 1 when the order was cancelled
+    REJECTED,       // reject_reason (a RiskCheck) or, when 0, an error in text
+    QUERY_RESULT    // JSON text, last_chunk on the final piece
+};
+
+struct GatewayResponse
+{
+    uint64_t request_id;
+    GatewayResponseType type;
+    OrderType aggressor_side;
+    bool last_chunk;
+    uint8_t reject_reason;
+    uint16_t text_size;
+    int32_t volume;
+    int32_t trade_price;
+    int32_t resting_remaining_volume;
+    double price;
+    double resting_order_price;
+    int64_t order_id; // order id, or the resting order id of a FILL
+    int64_t trade_id;
+    int64_t timestamp;
+    char bid_user_id[kGatewayUserIdSize];
+    char ask_user_id[kGatewayUserIdSize];
+    char text[kGatewayTextSize];
+};
+
+struct GatewayChannel
+{
+    std::atomic<int32_t> gateway_pid; // 0 => free to claim
+    std::atomic<uint32_t> dropped;    // set by the engine when the gateway stops reading
+    SpscRing<GatewayRequest, 1024> requests;
+    SpscRing<GatewayResponse, 2048> responses;
+};
+
+/**
+ * Engine admission counters, republished by the engine after every round
+ * of requests so gateways can report them (relaxed: each value is
+ * individually current, the set is not a snapshot)
+ */
+struct EngineLoadStats
+{
+    std::atomic<uint64_t> depth;     // requests queued in the last round
+    std::atomic<uint64_t> max_depth; // deepest round so far
+    std::atomic<uint64_t> admitted[kAdmissionClasses];
+    std::atomic<uint64_t> shed[kAdmissionClasses];
+    std::atomic<uint64_t> dropped_channels; // gateways that stopped reading responses
+};
+
+// Plain copy of EngineLoadStats, indexed by AdmissionClass
+struct EngineLoad
+{
+    uint64_t depth;
+    uint64_t max_depth;
+    uint64_t admitted[kAdmissionClasses];
+    uint64_t shed[kAdmissionClasses];
+    uint64_t dropped_channels;
+};
+
+/**
+ * Layout of the whole shared-memory region. The engine creates it,
+ * publishes the ticker table and then sets `ready`; gateways attach after.
+ */
+struct GatewayRegion
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_tickers;
+    std::atomic<uint32_t> ready;
+    std::atomic<int32_t> engine_pid;
+    std::atomic<uint32_t> sessions; // bumped per channel claim, prefixes request ids
+    char tickers[kMaxGatewayTickers][kGatewayTickerSize]; // index == TickerHandle::index
+    EngineLoadStats load;
+    GatewayChannel channels[kMaxGatewayChannels];
+};
+
+// Engine side: builds a zeroed region inside a mapping of sizeof(GatewayRegion)
+GatewayRegion &CreateGatewayRegion(SharedMemory &memory, const std::vector<std::string> &tickers);
+// Gateway side: validates the mapping and waits for the engine to publish it
+GatewayRegion &AttachGatewayRegion(SharedMemory &memory);
+
+EngineLoad ReadEngineLoad(const GatewayRegion &region);
+
+// True while the process that claimed a channel (or runs the engine) is alive
+bool IsProcessAlive(int32_t pid);
+
+// Copies `value` into a fixed NUL-terminated field; throws if it does not fit
+void CopyFixedString(char *field, size_t field_size, const std::string &value);
+
+#endif // GATEWAY_PROTOCOL_HPP
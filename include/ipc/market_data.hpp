@@ -0,0 +1,69 @@
+#ifndef MARKET_DATA_HPP
+#define MARKET_DATA_HPP
+
+#include "exchange/top_of_book.hpp"
+#include "ipc/broadcast_ring.hpp"
+#include "ipc/seqlock.hpp"
+#include "ipc/shared_memory.hpp"
+#include "utils/order_type.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Layout of the shared-memory market data region the matching engine
+ * publishes for co-located readers: one Seqlock'ed BookSnapshot per ticker
+ * plus a BroadcastRing of every trade. The engine is the only writer;
+ * readers map the region read-only (see MarketDataReader).
+ */
+
+constexpr uint64_t kMarketDataMagic = 0x584348474D444154; // "XCHGMDAT"
+constexpr uint32_t kMarketDataVersion = 1;
+constexpr uint32_t kMaxMarketDataTickers = 64;
+constexpr size_t kMarketDataTickerSize = 16;
+constexpr size_t kMarketDataDepth = 5;
+constexpr size_t kMarketDataTradeCapacity = 4096;
+
+struct BookSnapshot
+{
+    uint64_t update_id;   // book updates published for this ticker
+    uint32_t bid_levels;  // valid entries in `bids`, best first
+    uint32_t ask_levels;  // valid entries in `asks`, best first
+    DepthLevel bids[kMarketDataDepth];
+    DepthLevel asks[kMarketDataDepth];
+    uint64_t trade_count; // trades on this ticker so far
+    double last_trade_price;
+    int32_t last_trade_volume;
+    int64_t last_trade_timestamp;
+};
+
+struct MarketDataTrade
+{
+    uint32_t ticker; // TickerHandle::index
+    OrderType aggressor_side;
+    int32_t volume;
+    double price;
+    int64_t trade_id;
+    int64_t timestamp;
+};
+
+struct MarketDataRegion
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_tickers;
+    std::atomic<uint32_t> ready;
+    char tickers[kMaxMarketDataTickers][kMarketDataTickerSize]; // index == TickerHandle::index
+    Seqlock<BookSnapshot> books[kMaxMarketDataTickers];
+    BroadcastRing<MarketDataTrade, kMarketDataTradeCapacity> trades;
+};
+
+// Engine side: builds an empty region inside a mapping of sizeof(MarketDataRegion)
+MarketDataRegion &CreateMarketDataRegion(SharedMemory &memory, const std::vector<std::string> &tickers);
+// Reader side: validates the mapping and waits for the engine to publish it
+const MarketDataRegion &AttachMarketDataRegion(const SharedMemory &memory);
+
+#endif // MARKET_DATA_HPP
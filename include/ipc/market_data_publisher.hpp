@@ -0,0 +1,41 @@
+#ifndef MARKET_DATA_PUBLISHER_HPP
+#define MARKET_DATA_PUBLISHER_HPP
+
+#include "exchange/market_data_listener.hpp"
+#include "ipc/market_data.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Writes an Exchange's trades and book changes into a MarketDataRegion
+ *
+ * Attach with Exchange::AddMarketDataListener. Trades are appended to the
+ * trade ring as they happen. Book updates only mark the ticker dirty; Flush
+ * republishes each dirty ticker's snapshot once (depth from
+ * LimitOrderBook::GetDepth plus the last trade), so a burst of orders costs
+ * one depth walk per ticker rather than one per order. Must be driven by a
+ * single thread, as the region has a single writer.
+ */
+class MarketDataPublisher : public MarketDataListener
+{
+private:
+    MarketDataRegion &region;
+    // Writer-side copy of every snapshot, updated in place and then stored
+    std::vector<BookSnapshot> snapshots;
+    std::vector<LimitOrderBook *> books;
+    std::vector<uint32_t> dirty_tickers;
+    std::vector<bool> is_dirty;
+
+public:
+    explicit MarketDataPublisher(MarketDataRegion &region);
+
+    void OnTrade(TickerHandle ticker, const Fill &fill) override;
+    void OnBookUpdate(TickerHandle ticker, LimitOrderBook &book) override;
+
+    // Publishes every ticker updated since the last flush; returns how many
+    size_t Flush() override;
+};
+
+#endif // MARKET_DATA_PUBLISHER_HPP
@@ -0,0 +1,42 @@
+#ifndef MARKET_DATA_READER_HPP
+#define MARKET_DATA_READER_HPP
+
+#include "exchange/ticker_handle.hpp"
+#include "ipc/market_data.hpp"
+#include "ipc/shared_memory.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only view of the engine's market data for co-located strategies
+ *
+ * Maps the region read-only and reads it in place: GetBook is a seqlock copy
+ * and NextTrade a cursor into the trade ring, neither makes a syscall or
+ * can slow the engine down. Each reader follows the trade ring on its own
+ * cursor, starting at trades published after it attached. One instance per
+ * thread.
+ */
+class MarketDataReader
+{
+private:
+    SharedMemory memory;
+    const MarketDataRegion &region;
+    uint64_t trade_cursor;
+    uint64_t dropped_trades;
+
+public:
+    explicit MarketDataReader(const std::string &shm_name);
+
+    TickerHandle ResolveTicker(const std::string &ticker) const;
+    // Latest consistent snapshot; update_id 0 => nothing published yet
+    BookSnapshot GetBook(TickerHandle ticker) const;
+    // Best bid/ask from the snapshot, in the shape Exchange::GetTopOfBook returns
+    TopOfBook GetTopOfBook(TickerHandle ticker) const;
+    // False when caught up with the engine
+    bool NextTrade(MarketDataTrade &trade);
+    // Trades overwritten before this reader got to them
+    uint64_t GetDroppedTrades() const;
+};
+
+#endif // MARKET_DATA_READER_HPP
@@ -0,0 +1,87 @@
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Single-writer, many-reader sequence lock around a small POD value
+ *
+ * The writer bumps the sequence to odd, stores the value and bumps it back
+ * to even; a reader copies the value and retries if the sequence was odd or
+ * moved meanwhile. Readers never write, so they can work on a read-only
+ * mapping, and they never block the writer. The value is held as relaxed
+ * atomic words, which keeps concurrent copies free of data races. Like
+ * SpscRing it holds no pointers and can live in shared memory.
+ */
+template <typename T>
+class alignas(64) Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock values are copied word by word");
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> words[kWords]{};
+
+public:
+    // Writer side; never called concurrently with itself
+    void Store(const T &value)
+    {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    // False if a store was in progress; `value` is only written on success
+    bool TryLoad(T &value) const
+    {
+        const uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            return false;
+        }
+        uint64_t buffer[kWords];
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before)
+        {
+            return false;
+        }
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    // Spins until a consistent copy is read
+    T Load() const
+    {
+        T value;
+        while (!TryLoad(value))
+        {
+        }
+        return value;
+    }
+
+    // Number of completed stores
+    uint64_t GetVersion() const
+    {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+#endif // SEQLOCK_HPP
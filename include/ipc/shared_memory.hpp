@@ -0,0 +1,47 @@
+#ifndef SHARED_MEMORY_HPP
+#define SHARED_MEMORY_HPP
+
+#include <cstddef>
+#include <string>
+
+enum class ShmAccess
+{
+    READ_WRITE,
+    READ_ONLY // readers that must not be able to corrupt the writer's state
+};
+
+/**
+ * @brief RAII mapping of a POSIX shared-memory object (shm_open + mmap)
+ *
+ * The creating side sizes the object and unlinks its name on destruction;
+ * the opening side maps whatever size the creator chose, read/write or
+ * read-only. Movable, not copyable.
+ */
+class SharedMemory
+{
+private:
+    std::string name;
+    void *data;
+    size_t size;
+    bool owner;
+
+    void Release();
+
+public:
+    // Creates (or truncates) `name`, sized to `size` bytes and zero-filled
+    SharedMemory(const std::string &name, size_t size);
+    // Maps an existing object created by another process
+    explicit SharedMemory(const std::string &name, ShmAccess access = ShmAccess::READ_WRITE);
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory &) = delete;
+    SharedMemory &operator=(const SharedMemory &) = delete;
+    SharedMemory(SharedMemory &&other) noexcept;
+    SharedMemory &operator=(SharedMemory &&other) noexcept;
+
+    void *GetData() const;
+    size_t GetSize() const;
+    const std::string &GetName() const;
+};
+
+#endif // SHARED_MEMORY_HPP
@@ -0,0 +1,91 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Bounded single-producer / single-consumer ring of fixed-size slots
+ *
+ * Lock-free and address-free: the ring holds no pointers, so it can be
+ * placed in a shared-memory mapping and used from two processes (one
+ * pushes, the other pops). Head and tail sit on separate cache lines, and
+ * each side caches the other's index so the shared line is only re-read
+ * when the ring looks full (producer) or empty (consumer).
+ */
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Slots are copied byte-wise across processes");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring indices must be lock-free to live in shared memory");
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kCacheLine = 64;
+
+    // Written by the consumer
+    alignas(kCacheLine) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail = 0;
+    // Written by the producer
+    alignas(kCacheLine) std::atomic<uint64_t> tail{0};
+    uint64_t cached_head = 0;
+
+    alignas(kCacheLine) T slots[Capacity];
+
+public:
+    // Producer side: false when the ring is full
+    bool TryPush(const T &value)
+    {
+        const uint64_t current = tail.load(std::memory_order_relaxed);
+        if (current - cached_head == Capacity)
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if (current - cached_head == Capacity)
+            {
+                return false;
+            }
+        }
+        slots[current & kMask] = value;
+        tail.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: false when the ring is empty
+    bool TryPop(T &value)
+    {
+        const uint64_t current = head.load(std::memory_order_relaxed);
+        if (current == cached_tail)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (current == cached_tail)
+            {
+                return false;
+            }
+        }
+        value = slots[current & kMask];
+        head.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with either side
+    size_t Size() const
+    {
+        return static_cast<size_t>(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+    }
+
+    // Empties the ring; only safe while neither side is using it
+    void Reset()
+    {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        cached_head = 0;
+        cached_tail = 0;
+    }
+
+    static constexpr size_t GetCapacity() { return Capacity; }
+};
+
+#endif // SPSC_RING_HPP
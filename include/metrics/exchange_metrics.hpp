@@ -0,0 +1,63 @@
+#ifndef EXCHANGE_METRICS_HPP
+#define EXCHANGE_METRICS_HPP
+
+#include "exchange/market_data_listener.hpp"
+#include "exchange/top_of_book.hpp"
+#include "metrics/metrics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Book and trade metrics per ticker, fed as a market data listener
+ *
+ * Attach with Exchange::AddMarketDataListener on the thread that drives the
+ * exchange. Fills and resting orders are updated as they happen; book depth
+ * (levels and volume within the best kDepthLevels of each side) is
+ * conflated like the market data publishers and only measured on Flush,
+ * once per ticker that changed. Measuring walks the book's heaps, so
+ * without a thread that owns the exchange (the single-process Server)
+ * depth is left out: its series are not registered and Flush does nothing.
+ */
+class ExchangeMetrics : public MarketDataListener
+{
+public:
+    static constexpr size_t kDepthLevels = 10;
+
+private:
+    struct TickerMetrics
+    {
+        Counter *fills;
+        Counter *traded_volume;
+        Gauge *resting_orders;
+        // null unless depth is measured
+        Gauge *bid_levels;
+        Gauge *ask_levels;
+        Gauge *bid_volume;
+        Gauge *ask_volume;
+    };
+
+    std::vector<TickerMetrics> tickers; // by TickerHandle::index
+    bool measure_depth;
+    std::vector<LimitOrderBook *> books;
+    std::vector<uint32_t> dirty_tickers;
+    std::vector<bool> is_dirty;
+    DepthLevel depth[kDepthLevels];
+
+public:
+    // `tickers` in Exchange order; `measure_depth` only when Flush runs on
+    // the thread that owns the exchange
+    ExchangeMetrics(MetricsRegistry &registry,
+                    const std::vector<std::string> &tickers,
+                    bool measure_depth = true);
+
+    void OnTrade(TickerHandle ticker, const Fill &fill) override;
+    void OnBookUpdate(TickerHandle ticker, LimitOrderBook &book) override;
+    // Measures the depth of every ticker updated since the last flush;
+    // publishes no books, so always returns 0
+    size_t Flush() override;
+};
+
+#endif // EXCHANGE_METRICS_HPP
@@ -0,0 +1,149 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Lock-free metrics with a Prometheus text rendering.
+ *
+ * Counters and histograms are split into kMetricShards cache-line-sized
+ * shards; each thread updates the shard it was assigned on first use, so
+ * hot-path updates are uncontended relaxed atomics and only a scrape sums
+ * the shards. Gauges are a single atomic: they are set by the one thread
+ * that owns the quantity.
+ */
+
+constexpr size_t kMetricShards = 16;
+constexpr size_t kCacheLineSize = 64;
+
+// Shard of the calling thread, assigned round-robin on first use
+size_t GetMetricShard();
+
+// name="value" pairs, rendered in the given order
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter
+{
+private:
+    struct alignas(kCacheLineSize) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, kMetricShards> shards;
+
+public:
+    void Increment(uint64_t amount = 1)
+    {
+        shards[GetMetricShard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint64_t GetValue() const;
+};
+
+class Gauge
+{
+private:
+    std::atomic<int64_t> value{0};
+
+public:
+    void Set(int64_t new_value) { value.store(new_value, std::memory_order_relaxed); }
+    void Add(int64_t amount) { value.fetch_add(amount, std::memory_order_relaxed); }
+    int64_t GetValue() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Latency histogram with fixed buckets from 1 µs to 1 s, observed in
+ * nanoseconds and rendered in seconds
+ */
+class Histogram
+{
+public:
+    static constexpr size_t kBuckets = 19; // upper bounds; +Inf is implicit
+    static const std::array<uint64_t, kBuckets> kBucketBoundsNanos;
+
+    struct Snapshot
+    {
+        std::array<uint64_t, kBuckets + 1> counts{}; // not cumulative; last is +Inf
+        uint64_t sum_nanos = 0;
+        uint64_t count = 0;
+    };
+
+private:
+    struct alignas(kCacheLineSize) Shard
+    {
+        std::array<std::atomic<uint64_t>, kBuckets + 1> counts{};
+        std::atomic<uint64_t> sum_nanos{0};
+    };
+    std::array<Shard, kMetricShards> shards;
+
+public:
+    void Observe(uint64_t nanos);
+    Snapshot GetSnapshot() const;
+};
+
+/**
+ * @brief Owns every metric of a process and renders them for a scrape
+ *
+ * Metrics are created once, at setup, and callers keep the returned
+ * reference: registration takes a lock, updates never do. Asking again for
+ * the same name and labels returns the same metric. Callback metrics are
+ * read only when rendering, for values that already live elsewhere (e.g.
+ * counters in shared memory).
+ */
+class MetricsRegistry
+{
+public:
+    enum class Type
+    {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+private:
+    struct Series
+    {
+        std::string labels; // rendered: {name="value",...} or empty
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> callback;
+    };
+
+    struct Family
+    {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<Series> series;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Family>> families;
+
+    Series &GetSeries(const std::string &name, const std::string &help, Type type, const MetricLabels &labels);
+
+public:
+    Counter &GetCounter(const std::string &name, const std::string &help, const MetricLabels &labels = {});
+    Gauge &GetGauge(const std::string &name, const std::string &help, const MetricLabels &labels = {});
+    Histogram &GetHistogram(const std::string &name, const std::string &help, const MetricLabels &labels = {});
+    // `type` COUNTER or GAUGE; `read` is called from the scraping thread
+    void AddCallback(const std::string &name,
+                     const std::string &help,
+                     Type type,
+                     const MetricLabels &labels,
+                     std::function<double()> read);
+
+    // Prometheus text exposition format, version 0.0.4
+    std::string Render() const;
+};
+
+#endif // METRICS_HPP
@@ -0,0 +1,40 @@
+#ifndef METRICS_HTTP_SERVER_HPP
+#define METRICS_HTTP_SERVER_HPP
+
+#include "metrics/metrics.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief Minimal HTTP/1.0 endpoint serving GET /metrics for Prometheus
+ *
+ * One request per connection, answered from its own thread with
+ * MetricsRegistry::Render; anything else gets a 404. Scrapes only read the
+ * metrics, so they never hold up the threads updating them.
+ */
+class MetricsHttpServer
+{
+private:
+    MetricsRegistry &registry;
+    int listen_fd;
+    uint16_t port;
+    std::atomic<bool> stop;
+    std::thread thread;
+
+    void Serve();
+    void HandleConnection(int client_fd);
+
+public:
+    // Listens on all interfaces at `port` (0 picks a free one)
+    MetricsHttpServer(MetricsRegistry &registry, uint16_t port);
+    ~MetricsHttpServer();
+
+    MetricsHttpServer(const MetricsHttpServer &) = delete;
+    MetricsHttpServer &operator=(const MetricsHttpServer &) = delete;
+
+    uint16_t GetPort() const;
+};
+
+#endif // METRICS_HTTP_SERVER_HPP
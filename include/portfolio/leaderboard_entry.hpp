@@ -0,0 +1,17 @@
+#ifndef LEADERBOARD_ENTRY_HPP
+#define LEADERBOARD_ENTRY_HPP
+
+#include <string>
+
+/**
+ * @brief One row of the exchange-wide equity leaderboard
+ */
+struct LeaderboardEntry
+{
+    std::string user_id;
+    double equity;         // cash + market value of positions
+    double unrealized_pnl; // market value - cost basis
+    double realized_pnl;
+};
+
+#endif // LEADERBOARD_ENTRY_HPP
@@ -0,0 +1,77 @@
+#ifndef POSITION_STORE_HPP
+#define POSITION_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One user's mark-to-market equity, as returned by GetLeaderboard
+ */
+struct UserEquity
+{
+    uint32_t user;
+    double equity;         // cash + market value of all positions
+    double unrealized_pnl; // market value - cost basis
+};
+
+/**
+ * Structure-of-arrays position store for every user on the exchange.
+ *
+ * For each ticker, net_shares / avg_cost / market_value are contiguous arrays
+ * indexed by dense user id, so revaluing every holder of a ticker after a
+ * price change is a single SIMD pass (RevalueTicker) instead of a string-keyed
+ * map walk per portfolio. Per-user totals are maintained incrementally.
+ *
+ * Prices are marked lazily: UpdateMark only records the new price, and the
+ * revaluation runs on the next Revalue() (i.e. once per query, not per fill).
+ */
+class PositionStore
+{
+private:
+    size_t num_users;
+
+    // [ticker][user]
+    std::vector<std::vector<double>> net_shares;
+    std::vector<std::vector<double>> avg_cost;
+    std::vector<std::vector<double>> market_value; // net_shares * applied mark
+
+    // [ticker]
+    std::vector<double> applied_marks;
+    std::vector<double> pending_marks;
+    std::vector<uint8_t> mark_dirty;
+
+    // [user]
+    std::vector<double> cash;
+    std::vector<double> total_market_value;
+    std::vector<double> total_cost_basis; // sum of net_shares * avg_cost
+
+    void RevalueTicker(size_t ticker, double price);
+
+public:
+    explicit PositionStore(size_t num_tickers);
+
+    // Returns the new user's dense index
+    uint32_t AddUser(double initial_cash = 0.0);
+    size_t GetNumUsers() const;
+    size_t GetNumTickers() const;
+
+    // Mirror a user's position/cash after a fill (revalued at the applied mark)
+    void SetPosition(size_t ticker, uint32_t user, int shares, double cost);
+    void SetCash(uint32_t user, double balance);
+
+    // Record a new price for `ticker`; applied on the next Revalue()
+    void UpdateMark(size_t ticker, double price);
+    // Apply all pending marks
+    void Revalue();
+
+    double GetMark(size_t ticker) const;
+    double GetMarketValue(uint32_t user) const;
+    double GetUnrealizedPnL(uint32_t user) const;
+    double GetEquity(uint32_t user) const;
+
+    // Top `count` users by equity (after Revalue), highest first
+    std::vector<UserEquity> GetLeaderboard(size_t count) const;
+};
+
+#endif // POSITION_STORE_HPP
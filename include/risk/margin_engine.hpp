@@ -0,0 +1,93 @@
+#ifndef MARGIN_ENGINE_HPP
+#define MARGIN_ENGINE_HPP
+
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+#include "utils/order_type.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Incremental margin / buying-power engine.
+ *
+ * Each user's committed buying power is
+ *    sum(resting order price * charged shares) + sum(|net_shares| * avg_cost)
+ * and is adjusted on every add, fill and cancel, so a margin check on order
+ * entry is one comparison instead of a scan over positions and open orders.
+ * An order is only charged for the gross exposure it can add (see
+ * AddedShares), both when it is checked and while it rests, so orders that close a position are accepted even when no buying
+ * power is left and commit nothing. The charged shares are the tail of the
+ * order: fills take the uncharged shares first.
+ *
+ * Counters are indexed by dense user index (RiskEngine::kUnregistered users
+ * are not margined).
+ */
+class MarginEngine
+{
+private:
+    RiskLimits limits;
+    size_t num_tickers;
+
+    // [user]
+    std::vector<double> order_notional;    // resting orders
+    std::vector<double> position_exposure; // positions at cost
+    std::vector<double> realized_pnl;
+    // [user * num_tickers + ticker], this ticker's share of position_exposure
+    std::vector<double> ticker_exposure;
+
+    // Resting orders that commit buying power, by order ID; orders that
+    // only reduce a position have no entry
+    struct OrderMargin
+    {
+        int charged; // trailing shares that count against buying power
+        double price;
+    };
+    std::unordered_map<int64_t, OrderMargin> charged_orders;
+
+public:
+    MarginEngine(size_t num_tickers, const RiskLimits &limits = RiskLimits());
+
+    void SetLimits(const RiskLimits &new_limits);
+
+    // Returns the new user's dense index
+    uint32_t AddUser();
+
+    // How far a `volume` order on `side` can grow the user's absolute
+    // position, once their resting orders on that side have filled.
+    // `position` is the user's net shares in the order's ticker and
+    // `same_side_open` their resting volume on the order's side there
+    static int64_t AddedShares(OrderType side, int volume, int64_t position, int64_t same_side_open);
+
+    RiskCheck CheckOrder(uint32_t user,
+                         OrderType side,
+                         int volume,
+                         double price,
+                         int64_t position,
+                         int64_t same_side_open) const;
+
+    // A resting order entered the book; `position` and `same_side_open` as
+    // for CheckOrder, taken after its immediate fills and without itself
+    void OnOrderAdded(uint32_t user,
+                      int64_t order_id,
+                      OrderType side,
+                      int volume,
+                      double price,
+                      int64_t position,
+                      int64_t same_side_open);
+    // A resting order has `remaining_volume` left after a fill or cancel
+    // (0 => it left the book)
+    void OnOrderReduced(uint32_t user, int64_t order_id, int remaining_volume);
+    // `user`'s position in `ticker` changed after a fill
+    void OnPositionChanged(uint32_t user, size_t ticker, int net_shares, double avg_cost, double total_realized_pnl);
+
+    double GetCommitted(uint32_t user) const;
+    // Equity backing the user's margin: buying_power + realized_pnl
+    double GetEquity(uint32_t user) const;
+    // Remaining notional the user may commit
+    double GetBuyingPower(uint32_t user) const;
+};
+
+#endif // MARGIN_ENGINE_HPP
@@ -0,0 +1,35 @@
+#ifndef RISK_CHECK_HPP
+#define RISK_CHECK_HPP
+
+#include <stdexcept>
+
+/**
+ * Outcome of a pre-trade risk check
+ */
+enum class RiskCheck
+{
+    ACCEPTED,
+    MAX_ORDER_VOLUME,
+    MAX_ORDER_NOTIONAL,
+    MAX_POSITION,
+    MAX_OPEN_ORDERS,
+    PRICE_COLLAR,
+    INSUFFICIENT_BUYING_POWER
+};
+
+const char *RiskCheckToString(RiskCheck check);
+
+/**
+ * @brief Thrown by Exchange::HandleOrder when an order fails a risk check
+ */
+class RiskRejection : public std::runtime_error
+{
+private:
+    RiskCheck reason;
+
+public:
+    explicit RiskRejection(RiskCheck reason);
+    RiskCheck GetReason() const;
+};
+
+#endif // RISK_CHECK_HPP
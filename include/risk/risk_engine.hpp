@@ -0,0 +1,78 @@
+#ifndef RISK_ENGINE_HPP
+#define RISK_ENGINE_HPP
+
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+#include "utils/order_type.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Inline pre-trade risk layer.
+ *
+ * Every check in CheckOrder is a constant number of comparisons against
+ * counters that are kept up to date on add / fill / cancel, so the cost per
+ * order is independent of how many orders or positions a user has.
+ *
+ * Counters are indexed by dense user index and ticker index. Orders from
+ * users without an index (kUnregistered) only get the stateless checks
+ * (size, notional, price collar), so the Exchange gives every user an index
+ * before their first order while HasPerUserLimits().
+ */
+class RiskEngine
+{
+public:
+    static constexpr uint32_t kUnregistered = UINT32_MAX;
+
+private:
+    struct PositionRisk
+    {
+        int64_t position = 0;        // + long, - short
+        int64_t open_bid_volume = 0; // resting BID volume
+        int64_t open_ask_volume = 0; // resting ASK volume
+    };
+
+    RiskLimits limits;
+    size_t num_tickers;
+
+    // [user * num_tickers + ticker]
+    std::vector<PositionRisk> positions;
+    // [user]
+    std::vector<int> open_orders;
+    // [ticker], 0 => no trade yet
+    std::vector<double> last_trade_price;
+
+    inline PositionRisk &At(uint32_t user, size_t ticker);
+
+public:
+    RiskEngine(size_t num_tickers, const RiskLimits &limits = RiskLimits());
+
+    void SetLimits(const RiskLimits &new_limits);
+    const RiskLimits &GetLimits() const;
+    // True if any limit needs per-user counters (position, open orders, margin)
+    bool HasPerUserLimits() const;
+
+    // Returns the new user's dense index
+    uint32_t AddUser();
+
+    RiskCheck CheckOrder(uint32_t user, size_t ticker, OrderType side, int volume, double price) const;
+
+    // Counter maintenance
+    // A resting order entered the book
+    void OnOrderAdded(uint32_t user, size_t ticker, OrderType side, int volume);
+    // A resting order lost `volume` (fill or cancel); order_done => it left the book
+    void OnOrderReduced(uint32_t user, size_t ticker, OrderType side, int volume, bool order_done);
+    // `user` traded `volume` on `side` (aggressor or resting)
+    void OnExecution(uint32_t user, size_t ticker, OrderType side, int volume);
+    // Reference price for the price collar
+    void OnTrade(size_t ticker, double price);
+
+    int64_t GetPosition(uint32_t user, size_t ticker) const;
+    // Resting volume of `user` on `side` of `ticker`
+    int64_t GetOpenVolume(uint32_t user, size_t ticker, OrderType side) const;
+    int GetOpenOrders(uint32_t user) const;
+};
+
+#endif // RISK_ENGINE_HPP
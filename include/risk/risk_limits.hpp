@@ -0,0 +1,25 @@
+#ifndef RISK_LIMITS_HPP
+#define RISK_LIMITS_HPP
+
+#include <limits>
+
+/**
+ * Pre-trade limits applied to every order before it reaches the book.
+ * The defaults disable every check.
+ *
+ * Margin: a user's committed buying power (notional of the exposure their
+ * resting orders can add, plus position exposure at cost) may not exceed
+ * (buying_power + realized_pnl) * max_leverage.
+ */
+struct RiskLimits
+{
+    int max_order_volume = std::numeric_limits<int>::max();              // shares per order
+    double max_order_notional = std::numeric_limits<double>::infinity(); // price * volume per order
+    int max_position = std::numeric_limits<int>::max();                  // |position + open orders| per ticker
+    int max_open_orders = std::numeric_limits<int>::max();               // resting orders per user
+    double price_collar = std::numeric_limits<double>::infinity();       // max |price - last| / last
+    double buying_power = std::numeric_limits<double>::infinity();       // starting equity per user
+    double max_leverage = 1.0;                                           // committed / equity
+};
+
+#endif // RISK_LIMITS_HPP
@@ -0,0 +1,21 @@
+#ifndef CLIENT_SESSION_HPP
+#define CLIENT_SESSION_HPP
+
+#include "server/rate_limiter.hpp"
+#include "server/request_handler.hpp"
+
+#include <string>
+
+/**
+ * @brief State the server keeps for one client connection, whichever I/O
+ * backend serves it
+ */
+struct ClientSession
+{
+    RequestHandler::TickerCache ticker_cache;
+    ClientBudget budget;
+    // Every response is serialized here; its capacity is kept between requests
+    std::string response;
+};
+
+#endif // CLIENT_SESSION_HPP
@@ -0,0 +1,100 @@
+#ifndef IO_URING_HPP
+#define IO_URING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <vector>
+
+/**
+ * @brief Minimal io_uring ring driven through the raw syscalls
+ *
+ * Owns one submission/completion queue pair plus, optionally, a ring of
+ * provided buffers (IORING_REGISTER_PBUF_RING) that multishot receives pick
+ * from. Submissions are only queued by the Prepare* calls; SubmitAndWait
+ * hands the whole batch to the kernel and waits for completions in a single
+ * io_uring_enter. Single-threaded: the ring is set up with
+ * IORING_SETUP_SINGLE_ISSUER where the kernel supports it, so it must be
+ * created on the thread that will submit to it.
+ */
+class IoUring
+{
+private:
+    int ring_fd;
+    unsigned entries;
+
+    // Shared with the kernel
+    void *ring_memory;
+    size_t ring_memory_size;
+    io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned sq_mask;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    io_uring_cqe *cqes;
+    unsigned sqe_tail; // next SQE to hand out; published to *sq_tail on submit
+
+    // Provided buffer ring (group kBufferGroup)
+    io_uring_buf_ring *buffer_ring;
+    size_t buffer_ring_size;
+    uint16_t buffer_count;
+    uint32_t buffer_size;
+    std::vector<char> buffers;
+
+    __kernel_timespec timeout;
+
+    io_uring_sqe *GetSqe();
+    void Release();
+
+public:
+    static constexpr uint16_t kBufferGroup = 0;
+
+    // `entries` is rounded up to a power of two by the kernel
+    explicit IoUring(unsigned entries);
+    ~IoUring();
+
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    // Registers `count` (power of two) buffers of `size` bytes for multishot receives
+    void RegisterBuffers(uint16_t count, uint32_t size);
+    const char *GetBuffer(uint16_t buffer_id) const;
+    // Hands a buffer from a completed receive back to the kernel
+    void RecycleBuffer(uint16_t buffer_id);
+
+    // Each completion is reported with IORING_CQE_F_MORE until the kernel stops the operation
+    void PrepareMultishotAccept(int listen_fd, uint64_t user_data);
+    void PrepareMultishotRecv(int fd, uint64_t user_data);
+    // `data` must stay valid until the completion
+    void PrepareSend(int fd, const void *data, size_t size, uint64_t user_data);
+    void PrepareTimeout(int64_t nanoseconds, uint64_t user_data);
+
+    // Submits everything prepared and waits for at least `wait_count`
+    // completions; returns the number submitted or -errno
+    int SubmitAndWait(unsigned wait_count);
+
+    // Calls `handler(const io_uring_cqe &)` for each completion ready; returns how many
+    template <typename Handler>
+    unsigned ForEachCompletion(Handler &&handler);
+};
+
+template <typename Handler>
+unsigned IoUring::ForEachCompletion(Handler &&handler)
+{
+    unsigned head = *cq_head;
+    const unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    unsigned seen = 0;
+    for (; head != tail; ++head, ++seen)
+    {
+        handler(cqes[head & cq_mask]);
+    }
+    // Frees the slots for the kernel only after the handlers read them
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    return seen;
+}
+
+#endif // IO_URING_HPP
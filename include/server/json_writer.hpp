@@ -0,0 +1,93 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief An object key serialized ahead of time: `"name":`
+ *
+ * Declare keys as constexpr constants so writing one is a single append.
+ * Names are written as-is and must not need escaping.
+ */
+class JsonKey
+{
+public:
+    static constexpr size_t kMaxSize = 32; // including quotes and colon
+
+private:
+    char text[kMaxSize]{};
+    size_t size = 0;
+
+public:
+    template <size_t N>
+    explicit constexpr JsonKey(const char (&name)[N])
+    {
+        static_assert(N + 2 <= kMaxSize, "JSON key too long");
+        text[size++] = '"';
+        for (size_t i = 0; i + 1 < N; ++i)
+        {
+            text[size++] = name[i];
+        }
+        text[size++] = '"';
+        text[size++] = ':';
+    }
+
+    std::string_view GetText() const { return std::string_view(text, size); }
+};
+
+/**
+ * @brief Streams JSON into a caller-owned buffer
+ *
+ * Appends to `out` without building a DOM: numbers go through
+ * std::to_chars and keys are precomputed, so a buffer reused across
+ * responses stops allocating once it has grown to the largest one.
+ * Commas are inserted automatically. Output matches nlohmann::json::dump()
+ * for the same values, except that object members keep the order they
+ * were written in.
+ */
+class JsonWriter
+{
+private:
+    static constexpr size_t kMaxDepth = 16;
+
+    std::string &out;
+    // Per open container: whether it already holds a value
+    std::array<bool, kMaxDepth> has_values{};
+    size_t depth = 0;
+    bool after_key = false;
+
+    void BeforeValue();
+    void Open(char bracket);
+    void Close(char bracket);
+    void AppendEscaped(std::string_view text);
+
+public:
+    // Appends after whatever `out` already holds
+    explicit JsonWriter(std::string &out) : out(out) {}
+
+    JsonWriter &BeginObject() { Open('{'); return *this; }
+    JsonWriter &EndObject() { Close('}'); return *this; }
+    JsonWriter &BeginArray() { Open('['); return *this; }
+    JsonWriter &EndArray() { Close(']'); return *this; }
+
+    JsonWriter &Key(const JsonKey &key);
+    // Escaped; for keys only known at run time
+    JsonWriter &Key(std::string_view name);
+
+    JsonWriter &String(std::string_view value);
+    JsonWriter &Int(int64_t value);
+    JsonWriter &Uint(uint64_t value);
+    // Shortest round-trip form; integral values keep a ".0", NaN and
+    // infinities are written as null
+    JsonWriter &Double(double value);
+    JsonWriter &Bool(bool value);
+    JsonWriter &Null();
+    // A complete value serialized elsewhere, copied verbatim
+    JsonWriter &Raw(std::string_view json);
+};
+
+#endif // JSON_WRITER_HPP
@@ -0,0 +1,133 @@
+#ifndef RATE_LIMITER_HPP
+#define RATE_LIMITER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+enum class RequestAction : uint8_t; // server/request_parser.hpp
+
+/**
+ * Sustained rate and burst of a token bucket; a non-positive
+ * `per_second` disables the limit
+ */
+struct RateLimit
+{
+    double per_second;
+    double burst;
+};
+
+/**
+ * @brief Token bucket state, refilled lazily on each request
+ *
+ * Holds no configuration: the RateLimit is passed on every call, so the
+ * same options can be shared by every connection and user.
+ */
+class TokenBucket
+{
+private:
+    double tokens = 0;
+    std::chrono::steady_clock::time_point last_refill{};
+    bool started = false;
+
+public:
+    // Starts full; false (and nothing taken) when fewer than one token is left
+    bool TryConsume(const RateLimit &limit, std::chrono::steady_clock::time_point now);
+    // True when the bucket has refilled to its burst, i.e. is as good as new
+    bool IsFull(const RateLimit &limit, std::chrono::steady_clock::time_point now) const;
+};
+
+// What a request costs: orders and queries have separate budgets, cancels
+// are never throttled so a throttled client can still pull its quotes
+enum class RequestClass
+{
+    ORDER,
+    CANCEL,
+    QUERY
+};
+
+/**
+ * Budgets applied to every client. Per-connection buckets stop one socket
+ * from flooding; per-user buckets stop one user_id spreading a flood over
+ * many sockets.
+ */
+struct RateLimitOptions
+{
+    RateLimit connection_orders{500, 100};
+    RateLimit connection_queries{2000, 400};
+    RateLimit user_orders{1000, 200};
+    RateLimit user_queries{4000, 800};
+    // User ids tracked at once; past this, idle users are evicted and new
+    // ids share one bucket until room frees up
+    size_t max_tracked_users = 1 << 16;
+    // Responses a connection may have queued but not yet sent; a client that
+    // stops reading past this is disconnected
+    size_t max_send_queue_bytes = 1 << 20;
+};
+
+// Buckets of one connection or one user
+struct ClientBudget
+{
+    TokenBucket orders;
+    TokenBucket queries;
+};
+
+/**
+ * @brief Admits or throttles requests against per-connection and per-user
+ * token buckets
+ *
+ * Connection buckets live with the connection and need no locking; user
+ * buckets are shared by every worker and are sharded by user id so that
+ * workers rarely contend. Each admission is one hash lookup plus a
+ * constant amount of arithmetic.
+ *
+ * User ids come from clients, so the user table is capped
+ * (RateLimitOptions::max_tracked_users). A full shard forgets users whose
+ * buckets have refilled, at most once per kEvictionInterval; ids that still
+ * find no room draw on the shard's shared overflow bucket.
+ */
+class RateLimiter
+{
+private:
+    static constexpr size_t kUserShards = 16;
+
+    struct UserShard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, ClientBudget> users;
+        ClientBudget overflow; // shared by ids that found the shard full
+        std::chrono::steady_clock::time_point last_eviction{};
+    };
+
+    RateLimitOptions options;
+    size_t max_users_per_shard;
+    std::array<UserShard, kUserShards> user_shards;
+
+    ClientBudget &FindUser(UserShard &shard, const std::string &user_id, std::chrono::steady_clock::time_point now);
+    void EvictIdleUsers(UserShard &shard, std::chrono::steady_clock::time_point now);
+
+public:
+    static constexpr std::chrono::seconds kEvictionInterval{1};
+
+    explicit RateLimiter(const RateLimitOptions &options);
+
+    static RequestClass Classify(RequestAction action);
+    static RequestClass Classify(const std::string &action);
+
+    // False when the request must be rejected; `user_id` may be null for
+    // requests that carry none
+    bool Admit(ClientBudget &connection,
+               const std::string *user_id,
+               RequestClass request_class,
+               std::chrono::steady_clock::time_point now);
+
+    const RateLimitOptions &GetOptions() const;
+    // User ids currently holding their own buckets
+    size_t GetTrackedUserCount();
+};
+
+#endif // RATE_LIMITER_HPP
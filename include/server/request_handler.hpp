@@ -0,0 +1,67 @@
+#ifndef REQUEST_HANDLER_HPP
+#define REQUEST_HANDLER_HPP
+
+#include "exchange/exchange.hpp"
+#include "exchange/execution_sink.hpp"
+#include "exchange/ticker_handle.hpp"
+#include "server/json_writer.hpp"
+#include "server/request_parser.hpp"
+#include "server/response_cache.hpp"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+// Writes a trade as a response object: {bid_user_id, ask_user_id, price, volume, timestamp}
+void WriteTrade(JsonWriter &writer, const Trade &trade);
+
+/**
+ * @brief Writes each fill straight into an open "trades" array
+ */
+class JsonTradeWriter : public ExecutionSink
+{
+private:
+    JsonWriter &writer;
+    size_t fill_count;
+
+public:
+    explicit JsonTradeWriter(JsonWriter &writer) : writer(writer), fill_count(0) {}
+
+    void OnFill(const Fill &fill) override;
+    size_t GetFillCount() const { return fill_count; }
+};
+
+/**
+ * @brief Executes one parsed request against an Exchange
+ *
+ * Shared by the single-process Server and the matching engine process,
+ * which answers the requests a gateway forwards over shared memory.
+ */
+class RequestHandler
+{
+public:
+    // Tickers resolved on one connection (or one gateway channel)
+    using TickerCache = std::unordered_map<std::string, TickerHandle>;
+
+private:
+    Exchange &exchange;
+    // get_tickers, get_top_of_book and get_auction_state, per book version
+    ResponseCache response_cache;
+
+    // Ticker handle from "ticker_handle", or "ticker" via the cache
+    TickerHandle ResolveTicker(const ParsedRequest &request, TickerCache &ticker_cache);
+
+public:
+    explicit RequestHandler(Exchange &exchange);
+
+    // Replace `response` with the serialized response and never throw for
+    // a bad request: errors are reported in the response. False when the
+    // request failed, or a cancel or registration had nothing to act on.
+    bool Handle(const ParsedRequest &request, TickerCache &ticker_cache, std::string &response);
+    bool Handle(const nlohmann::json &request, TickerCache &ticker_cache, std::string &response);
+
+    const ResponseCache &GetResponseCache() const { return response_cache; }
+};
+
+#endif // REQUEST_HANDLER_HPP
@@ -0,0 +1,97 @@
+#ifndef REQUEST_PARSER_HPP
+#define REQUEST_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <nlohmann/json.hpp>
+
+// Every action a client may send; UNKNOWN for anything else
+enum class RequestAction : uint8_t
+{
+    UNKNOWN,
+    HANDLE_ORDER,
+    CANCEL_ORDER,
+    GET_TOP_OF_BOOK,
+    GET_VOLUME,
+    GET_PREVIOUS_TRADES,
+    GET_TRADES_BY_USER,
+    GET_TICKERS,
+    RESOLVE_TICKER,
+    REGISTER_USER,
+    GET_PORTFOLIO,
+    GET_POSITIONS,
+    GET_LEADERBOARD,
+    GET_AUCTION_STATE,
+    GET_ENGINE_LOAD // answered by a gateway, not the exchange
+};
+
+constexpr size_t kRequestActions = 15;
+
+// The action's wire name; "unknown" for UNKNOWN
+const char *RequestActionToString(RequestAction action);
+// Perfect hash over the wire names: one table probe and one comparison
+RequestAction LookupRequestAction(std::string_view name);
+
+/**
+ * @brief A client request reduced to the fields the exchange reads
+ *
+ * Strings are views into the parsed text (or DOM), which must outlive the
+ * request. `fields` says which fields were present with a usable type.
+ */
+struct ParsedRequest
+{
+    // Prefixed: ORDER_TYPE and TICKER_HANDLE are include guards elsewhere
+    enum Field : uint32_t
+    {
+        FIELD_USER_ID = 1 << 0,
+        FIELD_TICKER = 1 << 1,
+        FIELD_TICKER_HANDLE = 1 << 2,
+        FIELD_ORDER_TYPE = 1 << 3,
+        FIELD_VOLUME = 1 << 4,
+        FIELD_PRICE = 1 << 5,
+        FIELD_ORDER_ID = 1 << 6,
+        FIELD_NUM_PREVIOUS_TRADES = 1 << 7,
+        FIELD_COUNT = 1 << 8
+    };
+
+    RequestAction action = RequestAction::UNKNOWN;
+    std::string_view action_name;
+    uint32_t fields = 0;
+    std::string_view user_id;
+    std::string_view ticker;
+    uint32_t ticker_handle = 0;
+    int order_type = 0;
+    int volume = 0;
+    double price = 0;
+    int64_t order_id = 0;
+    int num_previous_trades = 0;
+    int64_t count = 0;
+
+    bool Has(uint32_t mask) const { return (fields & mask) == mask; }
+    // Throws std::invalid_argument unless every field in `mask` is present
+    void Require(uint32_t mask) const;
+};
+
+/**
+ * Schema-specific parser for the flat request objects clients send: reads
+ * the known fields straight into `request` in one pass, without building a
+ * DOM or allocating. Unknown keys with scalar values are skipped.
+ *
+ * @return false, leaving the request to ReadRequest, for any other shape:
+ * no string "action", nested values, escaped strings in known fields,
+ * known fields of an unexpected type, or text that is not valid JSON
+ */
+bool ParseRequest(const char *data, size_t size, ParsedRequest &request);
+
+/**
+ * Fallback for requests ParseRequest declines: reads the same fields from
+ * a parsed DOM, converting numbers as nlohmann does. Fields of another
+ * type are left out.
+ *
+ * @throws std::invalid_argument if the request is not an object with a
+ * string "action"
+ */
+void ReadRequest(const nlohmann::json &document, ParsedRequest &request);
+
+#endif // REQUEST_PARSER_HPP
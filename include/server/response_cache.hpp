@@ -0,0 +1,52 @@
+#ifndef RESPONSE_CACHE_HPP
+#define RESPONSE_CACHE_HPP
+
+#include "metrics/metrics.hpp"
+#include "server/request_parser.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Serialized responses to read-only queries, keyed by (action,
+ * ticker) and tagged with the book's update sequence they were built from
+ *
+ * A response stored for one sequence is served until the book moves on,
+ * so repeated polls of an unchanged book cost a copy. One entry per key:
+ * a newer sequence overwrites the older response in place, reusing its
+ * storage. Safe to share between threads.
+ */
+class ResponseCache
+{
+private:
+    struct Entry
+    {
+        bool valid = false;
+        uint64_t sequence = 0;
+        std::string response;
+    };
+
+    mutable std::mutex mutex;
+    // [action][ticker index], grown on first store
+    std::array<std::vector<Entry>, kRequestActions> entries;
+    mutable std::atomic<uint64_t> hits{0};
+    mutable std::atomic<uint64_t> misses{0};
+
+public:
+    // Replaces `response` with the response stored for exactly `sequence`;
+    // false (and `response` untouched) on a miss
+    bool Lookup(RequestAction action, uint32_t ticker_index, uint64_t sequence, std::string &response) const;
+    void Store(RequestAction action, uint32_t ticker_index, uint64_t sequence, std::string_view response);
+
+    uint64_t GetHitCount() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t GetMissCount() const { return misses.load(std::memory_order_relaxed); }
+    // Hit and miss counters, read on each scrape; the cache must outlive `registry`'s scrapes
+    void RegisterMetrics(MetricsRegistry &registry) const;
+};
+
+#endif // RESPONSE_CACHE_HPP
@@ -3,11 +3,27 @@
 
 // Project headers
 #include "exchange/exchange.hpp"
+#include "metrics/exchange_metrics.hpp"
+#include "metrics/metrics.hpp"
+#include "metrics/metrics_http_server.hpp"
+#include "server/client_session.hpp"
+#include "server/rate_limiter.hpp"
+#include "server/request_handler.hpp"
+#include "server/request_parser.hpp"
+#include "server/thread_topology.hpp"
+#include "server/uring_connection_loop.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <array>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <vector>
 #include <mutex>
 #include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <unistd.h>
@@ -16,21 +32,149 @@
 
 #define PORT 8080
 #define MAX_PENDING_CONNECTIONS 100
+#define METRICS_PORT 9100
+
+class EngineClient;
+class SharedMemory;
+struct GatewayRegion;
+
+/**
+ * Split deployment: this process only terminates client connections and
+ * forwards requests to a matching engine process (see EngineService) over
+ * the shared-memory region `engine_shm_name`
+ */
+struct GatewayOptions
+{
+    std::string engine_shm_name;
+};
+
+/**
+ * How client connections are served: THREADS hands each accepted connection
+ * to a worker that blocks in recv/send; IO_URING runs one UringConnectionLoop
+ * per worker, each multiplexing its connections over io_uring
+ */
+enum class IoBackend
+{
+    THREADS,
+    IO_URING
+};
 
 class Server
 {
 private:
-    Exchange exchange;
+    // Single-process mode: the server owns the exchange
+    std::unique_ptr<Exchange> exchange;
+    std::unique_ptr<RequestHandler> request_handler;
+    // Gateway mode: the engine's region, one channel claimed per worker
+    std::unique_ptr<SharedMemory> engine_memory;
+    GatewayRegion *engine_region;
+    std::string tickers_response; // gateway mode: the ticker table never changes
+
+    RateLimiter rate_limiter;
+
+    // Prometheus metrics, served on METRICS_PORT once started. Every series
+    // is registered at construction; requests only touch the pointers.
+    MetricsRegistry metrics;
+    std::unique_ptr<ExchangeMetrics> exchange_metrics; // single-process mode
+    std::unique_ptr<MetricsHttpServer> metrics_server;
+    std::array<Counter *, kRequestActions> requests_by_action;
+    std::unordered_map<std::string, Counter *> orders_by_ticker;
+    std::vector<Counter *> orders_by_handle;
+    Counter *cancels_done;
+    Counter *cancels_not_found;
+    std::vector<Counter *> risk_rejects; // by RiskCheck
+    Counter *throttled_requests;
+    Counter *failed_requests;
+    Histogram *request_duration;
+    Gauge *connections;
+    std::mutex uring_loops_mutex;
+    std::vector<const UringConnectionLoop *> uring_loops;
+
+    ThreadTopology topology;
+    std::vector<int> inherited_cpus; // where roles without CPUs of their own run
+
     std::queue<int> client_queue;
     std::mutex queue_mutex;
+    std::condition_variable queue_ready; // BLOCKING workers wait on it
     std::vector<std::thread> workers;
 
-    void worker_thread();                  // Handles client connections
-    void handle_client(int client_socket); // Processes each client request
+    void register_metrics(const std::vector<std::string> &tickers);
+    void start_metrics(IoBackend backend);
+    void count_order(const ParsedRequest &request);
+    int worker_count() const;
+    void pin_worker(int worker_index) const;
+    int open_listener(bool reuse_port);
+    void worker_thread(int worker_index);                         // Handles client connections
+    void handle_client(int client_socket, EngineClient *engine); // Processes each client request
+    void uring_worker_thread(int worker_index);                   // Serves its own listener via io_uring
+
+    // A request of an io_uring round in gateway mode, kept from its
+    // submission to the engine until its answer is collected
+    struct EngineRoundSlot
+    {
+        ParsedRequest request;
+        nlohmann::json document; // `request` may view into it
+        std::chrono::steady_clock::time_point started;
+        uint64_t engine_request_id; // 0 => already answered
+    };
+
+    // Parses one request (a DOM only for shapes ParseRequest declines) and
+    // charges it to the client's rate limits; false when it is throttled,
+    // with the response written
+    bool admit_request(const char *data,
+                       size_t size,
+                       ClientSession &session,
+                       ParsedRequest &request,
+                       nlohmann::json &document,
+                       std::string &response);
+    // Called from a catch block: writes the exception being handled as the
+    // response and counts it; rethrows anything that is not a std::exception
+    void write_failure(std::string &response);
+
+    // Parses one request, runs it unless the client is over its rate limits
+    // and serializes the response into the session's buffer; the view is
+    // valid until the next request on the session
+    std::string_view process_request(const char *data,
+                                     size_t size,
+                                     ClientSession &session,
+                                     EngineClient *engine);
+    // Gateway mode on io_uring: every engine request of the round is
+    // submitted before any answer is read (up to kMaxGatewayPipeline at a
+    // time), so a burst reaches the engine's admission queue together
+    void process_round(UringConnectionLoop::RoundRequest *requests,
+                       size_t count,
+                       EngineClient &engine,
+                       std::vector<EngineRoundSlot> &slots);
+
+    // Gateway mode: orders and cancels go over as binary messages, anything
+    // else is forwarded as the client's JSON text for the engine's
+    // RequestHandler. Writes the response to `response`; false when a cancel
+    // found nothing to cancel.
+    bool forward_to_engine(const ParsedRequest &request,
+                           const char *data,
+                           size_t size,
+                           EngineClient &engine,
+                           std::string &response);
+    // The two halves of forward_to_engine: returns the engine request id,
+    // or 0 when the gateway answered on its own
+    uint64_t submit_to_engine(const ParsedRequest &request,
+                              const char *data,
+                              size_t size,
+                              EngineClient &engine,
+                              std::string &response);
+    bool collect_from_engine(const ParsedRequest &request,
+                             uint64_t engine_request_id,
+                             EngineClient &engine,
+                             std::string &response);
 
 public:
-    Server(const std::vector<std::string> &allowed_tickers);
-    void start(); // Starts the server
+    Server(const std::vector<std::string> &allowed_tickers,
+           const RateLimitOptions &rate_limits = RateLimitOptions{});
+    explicit Server(const GatewayOptions &options,
+                    const RateLimitOptions &rate_limits = RateLimitOptions{});
+    ~Server();
+    // Starts the server; runs until the process exits
+    void start(IoBackend backend = IoBackend::THREADS, const ThreadTopology &topology = ThreadTopology{});
 };
 
 #endif
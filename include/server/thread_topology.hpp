@@ -0,0 +1,57 @@
+#ifndef THREAD_TOPOLOGY_HPP
+#define THREAD_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * How an idle thread waits for work: BLOCKING sleeps in the kernel (condition
+ * variable, io_uring_enter, short back-off sleeps); BUSY_POLL never gives up
+ * its CPU, trading a core per thread for wake-up latency. Busy polling is
+ * only worth it on CPUs nothing else is scheduled on.
+ */
+enum class WaitStrategy
+{
+    BLOCKING,
+    BUSY_POLL
+};
+
+/**
+ * @brief Which CPUs each role of thread runs on
+ *
+ * An empty set leaves that role on the CPUs the process was started with.
+ * Background threads (metrics endpoint, feed snapshot server) inherit the
+ * affinity of the thread that starts them, so they are started while it is
+ * pinned to `housekeeping_cpus`.
+ *
+ * There is no explicit NUMA policy: Linux places a page on the node of the
+ * CPU that first touches it, so the engine thread is pinned before the
+ * books are allocated and their memory ends up local to it.
+ */
+struct ThreadTopology
+{
+    std::vector<int> acceptor_cpus;     // blocking backend's accept loop
+    std::vector<int> io_cpus;           // connection workers, one CPU each, round-robin
+    std::vector<int> engine_cpus;       // matching engine thread (engine process)
+    std::vector<int> housekeeping_cpus; // background threads
+    int io_threads = 0;                 // 0: one per io CPU, or cores - 2 without any
+    WaitStrategy wait_strategy = WaitStrategy::BLOCKING;
+};
+
+// "0,2-5" => {0, 2, 3, 4, 5}; throws std::invalid_argument when malformed
+std::vector<int> ParseCpuList(const std::string &list);
+
+/**
+ * Removes the topology flags from `args` and returns the topology they
+ * describe:
+ *   --acceptor-cpus LIST  --io-cpus LIST  --engine-cpus LIST
+ *   --housekeeping-cpus LIST  --io-threads N  --busy-poll
+ */
+ThreadTopology ParseThreadTopology(std::vector<std::string> &args);
+
+// CPUs the calling thread may run on
+std::vector<int> GetThreadAffinity();
+// Restricts the calling thread to `cpus`; does nothing when empty
+void PinCurrentThread(const std::vector<int> &cpus);
+
+#endif // THREAD_TOPOLOGY_HPP
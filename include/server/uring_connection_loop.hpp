@@ -0,0 +1,176 @@
+#ifndef URING_CONNECTION_LOOP_HPP
+#define URING_CONNECTION_LOOP_HPP
+
+#include "server/client_session.hpp"
+#include "server/io_uring.hpp"
+#include "server/thread_topology.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Serves every connection of one listening socket from one thread
+ * through io_uring
+ *
+ * A single multishot accept produces the connections and a multishot
+ * receive per connection delivers requests into provided buffers, so no
+ * accept/recv has to be re-submitted per message. Each received chunk is one
+ * request (the same framing as the blocking path); its response is queued
+ * and sent with IORING_OP_SEND, responses produced while a send is in flight
+ * going out together in the next one. All sends queued while handling a
+ * round of completions are submitted by the same io_uring_enter that waits
+ * for the next round. A client that stops reading while its queued
+ * responses exceed the send queue bound is disconnected rather than
+ * buffered without limit. With WaitStrategy::BUSY_POLL the loop submits
+ * without waiting and polls the completion queue instead of sleeping in
+ * io_uring_enter. A per-round handler is given every request received in
+ * one round of completions together instead, so it can send the whole
+ * burst downstream before waiting for any answer. Construct it on the
+ * thread that calls Run.
+ */
+class UringConnectionLoop
+{
+public:
+    // Returns the response to one request received on a connection; it is
+    // copied into the send queue before the next request is handled, so it
+    // must view storage that outlives the call, such as ClientSession::response
+    using RequestCallback =
+        std::function<std::string_view(const char *data, size_t size, ClientSession &session)>;
+
+    // One request of a round; the handler writes its response in place.
+    // Several may come from the same connection and share its session.
+    struct RoundRequest
+    {
+        const char *data;
+        size_t size;
+        ClientSession *session;
+        std::string response; // capacity reused across rounds
+    };
+    using RoundCallback = std::function<void(RoundRequest *requests, size_t count)>;
+
+    static constexpr unsigned kQueueDepth = 4096;
+    static constexpr uint16_t kBufferCount = 4096;
+    static constexpr uint32_t kBufferSize = 2048; // largest request, as on the blocking path
+    static constexpr int64_t kStopCheckNanos = 100000000;
+    static constexpr size_t kDefaultMaxSendQueueBytes = 1 << 20;
+
+    // `listen_fd` must already be listening; it is not closed by the loop.
+    // `on_request` is either a RoundCallback or a per-request handler, which
+    // must return std::string_view itself: a handler returning std::string
+    // would convert to a view of a destroyed temporary
+    template <typename Handler>
+    UringConnectionLoop(int listen_fd,
+                        Handler on_request,
+                        size_t max_send_queue_bytes = kDefaultMaxSendQueueBytes,
+                        WaitStrategy wait_strategy = WaitStrategy::BLOCKING)
+        : UringConnectionLoop(listen_fd, MakeCallbacks(std::move(on_request)), max_send_queue_bytes, wait_strategy)
+    {
+    }
+    ~UringConnectionLoop();
+
+    UringConnectionLoop(const UringConnectionLoop &) = delete;
+    UringConnectionLoop &operator=(const UringConnectionLoop &) = delete;
+
+    // Serves until `stop` is set (checked every kStopCheckNanos), then closes every connection
+    void Run(const std::atomic<bool> &stop);
+    size_t GetConnectionCount() const;
+    // Connections dropped for letting their send queue overflow
+    size_t GetSlowConsumerCount() const;
+
+private:
+    // Exactly one is set
+    struct Callbacks
+    {
+        RequestCallback on_request;
+        RoundCallback on_round;
+    };
+
+    template <typename Handler>
+    static Callbacks MakeCallbacks(Handler handler)
+    {
+        if constexpr (std::is_invocable_v<Handler &, RoundRequest *, size_t>)
+        {
+            return Callbacks{nullptr, RoundCallback(std::move(handler))};
+        }
+        else
+        {
+            static_assert(std::is_same_v<std::invoke_result_t<Handler &, const char *, size_t, ClientSession &>,
+                                         std::string_view>,
+                          "The request handler must return a std::string_view into storage that outlives the "
+                          "call (e.g. ClientSession::response), not a std::string");
+            return Callbacks{RequestCallback(std::move(handler)), nullptr};
+        }
+    }
+
+    UringConnectionLoop(int listen_fd,
+                        Callbacks callbacks,
+                        size_t max_send_queue_bytes,
+                        WaitStrategy wait_strategy);
+
+    enum class Operation : uint8_t
+    {
+        ACCEPT,
+        RECV,
+        SEND,
+        TIMEOUT
+    };
+
+    struct Connection
+    {
+        bool open = false;
+        bool receiving = false; // multishot receive armed
+        bool sending = false;   // `in_flight` submitted
+        ClientSession session;
+        std::string in_flight;
+        size_t sent = 0;
+        std::string pending; // responses queued behind `in_flight`
+        size_t staged = 0;   // requests waiting for the end of the round
+    };
+
+    // A request held for the round handler, with the buffer it arrived in
+    struct StagedReceive
+    {
+        int fd;
+        uint16_t buffer_id;
+        size_t size;
+    };
+
+    IoUring ring;
+    int listen_fd;
+    RequestCallback on_request;
+    RoundCallback on_round;
+    std::vector<StagedReceive> staged;
+    std::vector<RoundRequest> round;
+    size_t max_send_queue_bytes;
+    WaitStrategy wait_strategy;
+    // Indexed by file descriptor; heap-allocated so sends in flight keep
+    // pointing at valid buffers when the table grows
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::atomic<size_t> connection_count; // readable from any thread
+    std::atomic<size_t> slow_consumer_count;
+
+    static uint64_t Encode(Operation operation, int fd);
+    void HandleCompletion(const io_uring_cqe &cqe, const std::atomic<bool> &stop);
+    void OnAccept(const io_uring_cqe &cqe);
+    void OnReceive(int fd, const io_uring_cqe &cqe);
+    void OnSend(int fd, int result);
+    // Runs the round handler over the requests staged by this round's completions
+    void HandleRound();
+    // Queues a response; disconnects the client if it is not reading them
+    void QueueResponse(int fd, std::string_view response);
+    void SendPending(int fd);
+    // Stops serving the connection; the fd closes once its operations end
+    void Disconnect(int fd);
+    // Closes once the socket is dead and no operation still refers to it
+    void CloseIfIdle(int fd);
+};
+
+#endif // URING_CONNECTION_LOOP_HPP
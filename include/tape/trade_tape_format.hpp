@@ -0,0 +1,94 @@
+#ifndef TRADE_TAPE_FORMAT_HPP
+#define TRADE_TAPE_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * On-disk layout of the trade tape.
+ *
+ * Every ticker has its own directory, `<tape>/<ticker>/`, holding one file
+ * per column. Each column file is a bare array of fixed-width values in host
+ * byte order, one per trade, in execution order; row i of every column
+ * belongs to the same trade. User IDs are dictionary-encoded: the user
+ * columns hold indexes into `users.txt`, one name per line in the order
+ * they first traded. Names are escaped so each stays on its line: a
+ * newline is written as `\n` and a backslash as `\\`.
+ *
+ * Files are only ever appended to, and a user's name is written before any
+ * row that refers to it. A reader takes the shortest column as the row
+ * count, so a trade whose columns are only partly written is not visible
+ * yet. Within a tape, trade IDs increase strictly and timestamps never
+ * decrease, which is what lets readers binary-search either column.
+ */
+
+constexpr size_t kTapeColumnCount = 6;
+
+enum class TapeColumn : uint8_t
+{
+    TRADE_ID,  // int64_t
+    PRICE,     // double, the exact execution price
+    VOLUME,    // int32_t
+    TIMESTAMP, // int64_t, seconds since the epoch
+    BID_USER,  // uint32_t index into users.txt
+    ASK_USER   // uint32_t index into users.txt
+};
+
+constexpr const char *kTapeColumnFiles[kTapeColumnCount] = {
+    "trade_id.i64", "price.f64", "volume.i32", "timestamp.i64", "bid_user.u32", "ask_user.u32"};
+constexpr size_t kTapeColumnWidths[kTapeColumnCount] = {
+    sizeof(int64_t), sizeof(double), sizeof(int32_t), sizeof(int64_t), sizeof(uint32_t), sizeof(uint32_t)};
+constexpr const char *kTapeUsersFile = "users.txt";
+
+inline std::string GetTapeTickerDirectory(const std::string &tape_directory, const std::string &ticker)
+{
+    return tape_directory + "/" + ticker;
+}
+
+inline std::string GetTapeColumnPath(const std::string &ticker_directory, TapeColumn column)
+{
+    return ticker_directory + "/" + kTapeColumnFiles[static_cast<size_t>(column)];
+}
+
+// Appends `name` to `line` escaped for users.txt, without the newline
+inline void AppendTapeUserName(std::string &line, const std::string &name)
+{
+    for (char c : name)
+    {
+        if (c == '\\')
+        {
+            line += "\\\\";
+        }
+        else if (c == '\n')
+        {
+            line += "\\n";
+        }
+        else
+        {
+            line += c;
+        }
+    }
+}
+
+// Inverse of AppendTapeUserName for one line of users.txt
+inline std::string ParseTapeUserName(std::string_view line)
+{
+    std::string name;
+    name.reserve(line.size());
+    for (size_t i = 0; i < line.size(); ++i)
+    {
+        if (line[i] == '\\' && i + 1 < line.size())
+        {
+            name += line[++i] == 'n' ? '\n' : line[i];
+        }
+        else
+        {
+            name += line[i];
+        }
+    }
+    return name;
+}
+
+#endif // TRADE_TAPE_FORMAT_HPP
@@ -0,0 +1,95 @@
+#ifndef TRADE_TAPE_READER_HPP
+#define TRADE_TAPE_READER_HPP
+
+#include "tape/trade_tape_format.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Rows [begin, end) of a tape
+struct TapeRange
+{
+    size_t begin;
+    size_t end;
+
+    size_t GetSize() const { return end - begin; }
+};
+
+// One row of the tape; users are indexes for TradeTapeReader::GetUserName
+struct TapeTrade
+{
+    int64_t trade_id;
+    double price;
+    int32_t volume;
+    int64_t timestamp;
+    uint32_t bid_user;
+    uint32_t ask_user;
+};
+
+/**
+ * @brief Read-only, memory-mapped view of one ticker's trade tape
+ *
+ * Maps every column file, so scans read straight from the page cache with
+ * no parsing or copying, and never touch the exchange that writes them.
+ * Columns are exposed as plain arrays for vectorizable scans; FindTimeRange
+ * and FindTradeIdRange binary-search the sorted columns. The view covers
+ * the trades on disk when it was opened or last refreshed. Movable, not
+ * copyable.
+ */
+class TradeTapeReader
+{
+private:
+    struct MappedColumn
+    {
+        const void *data = nullptr;
+        size_t size = 0;
+    };
+
+    std::string directory;
+    std::array<MappedColumn, kTapeColumnCount> columns;
+    std::vector<std::string> user_names;
+    size_t row_count;
+
+    void Unmap();
+
+    template <typename T>
+    const T *GetColumn(TapeColumn column) const
+    {
+        return static_cast<const T *>(columns[static_cast<size_t>(column)].data);
+    }
+
+public:
+    // Opens `<tape_directory>/<ticker>/`
+    TradeTapeReader(const std::string &tape_directory, const std::string &ticker);
+    ~TradeTapeReader();
+
+    TradeTapeReader(const TradeTapeReader &) = delete;
+    TradeTapeReader &operator=(const TradeTapeReader &) = delete;
+    TradeTapeReader(TradeTapeReader &&other) noexcept;
+    TradeTapeReader &operator=(TradeTapeReader &&other) noexcept;
+
+    // Remaps to pick up trades appended since; returns the new trade count
+    size_t Refresh();
+
+    size_t GetTradeCount() const;
+    TapeTrade GetTrade(size_t row) const;
+    const std::string &GetUserName(uint32_t user) const;
+
+    // Rows with timestamp in [from, to)
+    TapeRange FindTimeRange(int64_t from, int64_t to) const;
+    // Rows with trade ID in [first_id, end_id)
+    TapeRange FindTradeIdRange(int64_t first_id, int64_t end_id) const;
+
+    // GetTradeCount() values each
+    const int64_t *GetTradeIds() const { return GetColumn<int64_t>(TapeColumn::TRADE_ID); }
+    const double *GetPrices() const { return GetColumn<double>(TapeColumn::PRICE); }
+    const int32_t *GetVolumes() const { return GetColumn<int32_t>(TapeColumn::VOLUME); }
+    const int64_t *GetTimestamps() const { return GetColumn<int64_t>(TapeColumn::TIMESTAMP); }
+    const uint32_t *GetBidUsers() const { return GetColumn<uint32_t>(TapeColumn::BID_USER); }
+    const uint32_t *GetAskUsers() const { return GetColumn<uint32_t>(TapeColumn::ASK_USER); }
+};
+
+#endif // TRADE_TAPE_READER_HPP
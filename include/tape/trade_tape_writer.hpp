@@ -0,0 +1,71 @@
+#ifndef TRADE_TAPE_WRITER_HPP
+#define TRADE_TAPE_WRITER_HPP
+
+#include "exchange/market_data_listener.hpp"
+#include "tape/trade_tape_format.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Appends every trade of an Exchange to the on-disk trade tape
+ *
+ * Registered as a MarketDataListener on the engine thread. OnTrade only
+ * buffers the row in memory; Flush appends each ticker's buffered rows
+ * with one write per column, so the engine pays a few syscalls per round
+ * of requests rather than per trade. Opening an existing tape continues
+ * it, after dropping a tail left half-written by a crash. Not copyable.
+ */
+class TradeTapeWriter : public MarketDataListener
+{
+private:
+    struct TickerTape
+    {
+        std::string directory;
+        std::array<int, kTapeColumnCount> column_fds;
+        int users_fd;
+        std::unordered_map<std::string, uint32_t> user_indexes;
+        size_t row_count;
+        int64_t last_trade_id;
+        int64_t last_timestamp;
+
+        // Buffered since the last Flush
+        std::string new_users;
+        std::vector<int64_t> trade_ids;
+        std::vector<double> prices;
+        std::vector<int32_t> volumes;
+        std::vector<int64_t> timestamps;
+        std::vector<uint32_t> bid_users;
+        std::vector<uint32_t> ask_users;
+    };
+    std::vector<TickerTape> tapes;
+
+    static void Open(TickerTape &tape);
+    static uint32_t InternUser(TickerTape &tape, const std::string &user_id);
+    static void Append(TickerTape &tape);
+    void Close();
+
+public:
+    // Creates `<directory>/<ticker>/` for each ticker as needed
+    TradeTapeWriter(const std::string &directory, const std::vector<std::string> &tickers);
+    ~TradeTapeWriter() override;
+
+    TradeTapeWriter(const TradeTapeWriter &) = delete;
+    TradeTapeWriter &operator=(const TradeTapeWriter &) = delete;
+
+    void OnTrade(TickerHandle ticker, const Fill &fill) override;
+    void OnBookUpdate(TickerHandle /*ticker*/, LimitOrderBook & /*book*/) override {}
+    // Returns the number of tickers whose trades were appended
+    size_t Flush() override;
+
+    // Including buffered trades
+    size_t GetTradeCount(TickerHandle ticker) const;
+    // 0 for an empty tape; feed to Exchange::ResumeIdsAfter on startup
+    int64_t GetLastTradeId(TickerHandle ticker) const;
+};
+
+#endif // TRADE_TAPE_WRITER_HPP
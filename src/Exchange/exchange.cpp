@@ -5,29 +5,151 @@
 #include "exchange/order_result.hpp"
 #include "exchange/limit_order_book.hpp"
 #include "exchange/exchange.hpp"
+#include "exchange/ticker_handle.hpp"
+#include "exchange/execution_sink.hpp"
+#include "exchange/matching_policy.hpp"
+#include "exchange/trading_phase.hpp"
+#include "portfolio/portfolio.hpp"
+#include "portfolio/position_store.hpp"
+#include "portfolio/leaderboard_entry.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/margin_engine.hpp"
+#include "risk/risk_engine.hpp"
+#include "risk/risk_limits.hpp"
 
 // std headers
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <chrono>
+#include <functional>
 #include <ctime>
+#include <stdexcept>
+#include <utility>
 
-Exchange::Exchange(const std::vector<std::string> &allowed_tickers)
+class Exchange::ExecutionRecorder : public ExecutionSink
 {
+private:
+    Exchange &exchange;
+    TickerHandle ticker;
+    ExecutionSink &downstream;
+
+public:
+    int filled_volume = 0;
+
+    ExecutionRecorder(Exchange &exchange, TickerHandle ticker, ExecutionSink &downstream)
+        : exchange(exchange), ticker(ticker), downstream(downstream) {}
+
+    void OnFill(const Fill &fill) override
+    {
+        // The fill is always the newest trade in its book
+        const LimitOrderBook &book = exchange.limit_order_books[ticker.index];
+        TradeRef ref{ticker, book.GetTradeCount() - 1};
+        exchange.trades_by_user[fill.trade.bid_user_id].push_back(ref);
+        exchange.trades_by_user[fill.trade.ask_user_id].push_back(ref);
+
+        const int volume = fill.trade.volume;
+        uint32_t bid_user = exchange.FindUserIndex(fill.trade.bid_user_id);
+        uint32_t ask_user = exchange.FindUserIndex(fill.trade.ask_user_id);
+
+        exchange.ApplyFillToPortfolio(bid_user, ticker, volume, fill.price);
+        exchange.ApplyFillToPortfolio(ask_user, ticker, -volume, fill.price);
+        exchange.position_store.UpdateMark(ticker.index, fill.price);
+
+        // Risk counters: both positions move, the resting order shrinks
+        RiskEngine &risk = exchange.risk_engine;
+        risk.OnExecution(bid_user, ticker.index, OrderType::BID, volume);
+        risk.OnExecution(ask_user, ticker.index, OrderType::ASK, volume);
+        uint32_t resting_user = (fill.aggressor_side == OrderType::BID) ? ask_user : bid_user;
+        OrderType resting_side = (fill.aggressor_side == OrderType::BID) ? OrderType::ASK : OrderType::BID;
+        risk.OnOrderReduced(resting_user, ticker.index, resting_side, volume, fill.resting_remaining_volume == 0);
+        risk.OnTrade(ticker.index, fill.price);
+
+        // Margin: the resting order's charged notional becomes position exposure
+        if (resting_user != RiskEngine::kUnregistered)
+        {
+            exchange.margin_engine.OnOrderReduced(resting_user, fill.resting_order_id, fill.resting_remaining_volume);
+        }
+
+        // Auction uncross: the aggressor side was resting as well
+        if (fill.aggressor_order_id > 0)
+        {
+            uint32_t aggressor_user = (fill.aggressor_side == OrderType::BID) ? bid_user : ask_user;
+            risk.OnOrderReduced(aggressor_user, ticker.index, fill.aggressor_side, volume, fill.aggressor_remaining_volume == 0);
+            if (aggressor_user != RiskEngine::kUnregistered)
+            {
+                exchange.margin_engine.OnOrderReduced(aggressor_user, fill.aggressor_order_id, fill.aggressor_remaining_volume);
+            }
+        }
+
+        filled_volume += volume;
+        for (MarketDataListener *listener : exchange.market_data_listeners)
+        {
+            listener->OnTrade(ticker, fill);
+        }
+        downstream.OnFill(fill);
+    }
+
+    void OnCancel(const Cancel &cancel) override
+    {
+        uint32_t user = exchange.FindUserIndex(cancel.user_id);
+        exchange.risk_engine.OnOrderReduced(user, ticker.index, cancel.side, cancel.volume, true);
+        if (user != RiskEngine::kUnregistered)
+        {
+            exchange.margin_engine.OnOrderReduced(user, cancel.order_id, 0);
+        }
+        downstream.OnCancel(cancel);
+    }
+};
+
+Exchange::Exchange(const std::vector<std::string> &allowed_tickers, const RiskLimits &risk_limits)
+    : position_store(allowed_tickers.size()),
+      risk_engine(allowed_tickers.size(), risk_limits),
+      margin_engine(allowed_tickers.size(), risk_limits),
+      batch_schedules(allowed_tickers.size())
+{
+    // Books never move after construction (resting OrderNodes are linked by pointer)
+    limit_order_books.reserve(allowed_tickers.size());
+
+    // Each book is its own ID shard
     for (const auto &tk : allowed_tickers)
     {
-        tickers.insert(tk);
-        limit_order_books.emplace(tk, LimitOrderBook(tk));
+        if (tickers.insert(tk).second)
+        {
+            TickerHandle handle{static_cast<uint32_t>(limit_order_books.size())};
+            limit_order_books.emplace_back(tk, static_cast<int>(handle.index));
+            ticker_handles.emplace(tk, handle);
+        }
+    }
+}
+
+inline LimitOrderBook &Exchange::GetBook(TickerHandle ticker)
+{
+    if (ticker.index >= limit_order_books.size())
+    {
+        throw std::runtime_error("Ticker not found");
     }
+    return limit_order_books[ticker.index];
 }
 
-inline void Exchange::ThrowIfTickerNotFound(std::string ticker)
+inline const LimitOrderBook &Exchange::GetBook(TickerHandle ticker) const
 {
-    if (tickers.find(ticker) == tickers.end())
+    if (ticker.index >= limit_order_books.size())
     {
         throw std::runtime_error("Ticker not found");
     }
+    return limit_order_books[ticker.index];
+}
+
+inline void Exchange::NotifyBookUpdate(TickerHandle ticker)
+{
+    for (MarketDataListener *listener : market_data_listeners)
+    {
+        listener->OnBookUpdate(ticker, limit_order_books[ticker.index]);
+    }
 }
 
 std::unordered_set<std::string> Exchange::GetTickers()
@@ -35,78 +157,536 @@ std::unordered_set<std::string> Exchange::GetTickers()
     return tickers;
 }
 
-int Exchange::GetVolume(std::string ticker, double price, OrderType order_type)
+/**
+ * Resolves a ticker symbol to a handle for the handle-based overloads.
+ *
+ * @param ticker The ticker symbol (e.g., "AAPL").
+ * @return The ticker's handle, stable for the lifetime of the Exchange.
+ * @throws std::runtime_error if the ticker is not listed.
+ */
+TickerHandle Exchange::ResolveTicker(const std::string &ticker)
+{
+    auto it = ticker_handles.find(ticker);
+    if (it == ticker_handles.end())
+    {
+        throw std::runtime_error("Ticker not found");
+    }
+    return it->second;
+}
+
+int Exchange::GetVolume(const std::string &ticker, double price, OrderType order_type)
+{
+    return GetVolume(ResolveTicker(ticker), price, order_type);
+}
+
+int Exchange::GetVolume(TickerHandle ticker, double price, OrderType order_type) const
+{
+    return GetBook(ticker).GetVolume(price, order_type);
+}
+
+TopOfBook Exchange::GetTopOfBook(const std::string &ticker)
+{
+    return GetTopOfBook(ResolveTicker(ticker));
+}
+
+TopOfBook Exchange::GetTopOfBook(TickerHandle ticker) const
 {
-    ThrowIfTickerNotFound(ticker);
-    return limit_order_books.at(ticker).GetVolume(price, order_type);
+    return GetBook(ticker).GetTopOfBook();
 }
 
-TopOfBook Exchange::GetTopOfBook(std::string ticker)
+BboSnapshot Exchange::GetBbo(TickerHandle ticker) const
 {
-    ThrowIfTickerNotFound(ticker);
-    return limit_order_books.at(ticker).GetTopOfBook();
+    return GetBook(ticker).GetBbo();
+}
+
+std::vector<Trade> Exchange::GetPreviousTrades(const std::string &ticker, int num_previous_trades)
+{
+    return GetPreviousTrades(ResolveTicker(ticker), num_previous_trades);
+}
+
+std::vector<Trade> Exchange::GetPreviousTrades(TickerHandle ticker, int num_previous_trades)
+{
+    return GetBook(ticker).GetPreviousTrades(num_previous_trades);
+}
+
+void Exchange::ForEachPreviousTrade(TickerHandle ticker,
+                                    int num_previous_trades,
+                                    const std::function<void(const Trade &)> &visit)
+{
+    LimitOrderBook &book = GetBook(ticker);
+    size_t count = book.GetTradeCount();
+    size_t start = num_previous_trades <= 0 ? count
+                                            : count - std::min(count, static_cast<size_t>(num_previous_trades));
+    for (size_t i = start; i < count; ++i)
+    {
+        visit(book.GetTrade(i));
+    }
 }
 
-std::vector<Trade> Exchange::GetPreviousTrades(std::string ticker, int num_previous_trades)
+bool Exchange::CancelOrder(const std::string &ticker, int64_t order_id)
 {
-    ThrowIfTickerNotFound(ticker);
-    return limit_order_books.at(ticker).GetPreviousTrades(num_previous_trades);
+    return CancelOrder(ResolveTicker(ticker), order_id);
 }
 
-bool Exchange::CancelOrder(std::string ticker, int order_id)
+bool Exchange::CancelOrder(TickerHandle ticker, int64_t order_id)
 {
-    ThrowIfTickerNotFound(ticker);
-    return limit_order_books.at(ticker).CancelOrder(order_id);
+    NullExecutionSink sink;
+    ExecutionRecorder recorder(*this, ticker, sink);
+    bool cancelled = GetBook(ticker).CancelOrder(order_id, recorder);
+    NotifyBookUpdate(ticker);
+    return cancelled;
 }
 
 OrderResult Exchange::HandleOrder(
-    std::string user_id,
+    const std::string &user_id,
     OrderType order_type,
     int volume,
     double price,
-    std::string ticker)
+    const std::string &ticker)
 {
     // Make sure ticker is valid
-    ThrowIfTickerNotFound(ticker);
+    return HandleOrder(user_id, order_type, volume, price, ResolveTicker(ticker));
+}
 
-    OrderResult new_order = limit_order_books.at(ticker).HandleOrder(
+OrderResult Exchange::HandleOrder(
+    const std::string &user_id,
+    OrderType order_type,
+    int volume,
+    double price,
+    TickerHandle ticker)
+{
+    TradeCollector collector;
+    int64_t order_id = HandleOrder(user_id, order_type, volume, price, ticker, collector);
+    bool trades_executed = !collector.trades.empty();
+    return OrderResult(trades_executed, std::move(collector.trades), order_id > 0, order_id);
+}
+
+/**
+ * Routes an order through the pre-trade risk checks to its book, recording
+ * every fill under both users and forwarding it to `sink` without
+ * materializing a vector of trades.
+ *
+ * While any per-user limit (position, open orders, buying power) is set, a
+ * user who never called RegisterUser is registered by their first order.
+ *
+ * @param sink Receives one Fill per match, after the exchange has recorded it.
+ * @return The ID of the remainder added to the book, or -1 if fully filled.
+ * @throws RiskRejection if the order breaches a risk limit or, for
+ *         registered users, exceeds their remaining buying power.
+ */
+int64_t Exchange::HandleOrder(
+    const std::string &user_id,
+    OrderType order_type,
+    int volume,
+    double price,
+    TickerHandle ticker,
+    ExecutionSink &sink)
+{
+    LimitOrderBook &book = GetBook(ticker);
+    if (batch_schedules[ticker.index].interval.count() != 0)
+    {
+        // A batch that is due clears before this order opens the next one
+        ClearBatchIfDue(ticker, std::chrono::steady_clock::now());
+    }
+
+    uint32_t user = FindUserIndex(user_id);
+    if (user == RiskEngine::kUnregistered && risk_engine.HasPerUserLimits())
+    {
+        // Per-user limits live in the user's counters: skipping RegisterUser must not skip them
+        RegisterUser(user_id);
+        user = FindUserIndex(user_id);
+    }
+    RiskCheck check = risk_engine.CheckOrder(user, ticker.index, order_type, volume, price);
+    if (check == RiskCheck::ACCEPTED && user != RiskEngine::kUnregistered)
+    {
+        check = margin_engine.CheckOrder(user,
+                                         order_type,
+                                         volume,
+                                         price,
+                                         risk_engine.GetPosition(user, ticker.index),
+                                         risk_engine.GetOpenVolume(user, ticker.index, order_type));
+    }
+    if (check != RiskCheck::ACCEPTED)
+    {
+        throw RiskRejection(check);
+    }
+
+    ExecutionRecorder recorder(*this, ticker, sink);
+    int64_t order_id = book.HandleOrder(
         user_id,
         order_type,
         volume,
         price,
         time(0), // Current epoch time
-        ticker);
+        book.GetTicker(),
+        recorder);
 
-    // If trades occurred, record them under this user
-    if (new_order.trades_executed)
+    if (order_id > 0)
     {
-        for (const auto &tr : new_order.trades)
+        int resting_volume = volume - recorder.filled_volume;
+        if (user != RiskEngine::kUnregistered)
         {
-            trades_by_user[tr.bid_user_id].push_back(tr);
-            trades_by_user[tr.ask_user_id].push_back(tr);
+            // Charged like the check: position after the fills, open volume without this order
+            margin_engine.OnOrderAdded(user,
+                                       order_id,
+                                       order_type,
+                                       resting_volume,
+                                       price,
+                                       risk_engine.GetPosition(user, ticker.index),
+                                       risk_engine.GetOpenVolume(user, ticker.index, order_type));
         }
+        risk_engine.OnOrderAdded(user, ticker.index, order_type, resting_volume);
     }
+    NotifyBookUpdate(ticker);
+    return order_id;
+}
 
-    return new_order;
+std::vector<Trade> Exchange::GetTradesByUser(const std::string &user_id)
+{
+    auto it = trades_by_user.find(user_id);
+    if (it == trades_by_user.end())
+    {
+        return {};
+    }
+
+    std::vector<Trade> trades;
+    trades.reserve(it->second.size());
+    for (const TradeRef &ref : it->second)
+    {
+        trades.push_back(limit_order_books[ref.ticker.index].GetTrade(ref.index));
+    }
+    return trades;
 }
 
-std::vector<Trade> Exchange::GetTradesByUser(std::string user_id)
+void Exchange::ForEachTradeByUser(const std::string &user_id, const std::function<void(const Trade &)> &visit)
 {
     auto it = trades_by_user.find(user_id);
-    if (it != trades_by_user.end())
+    if (it == trades_by_user.end())
+    {
+        return;
+    }
+    for (const TradeRef &ref : it->second)
     {
-        return it->second;
+        visit(limit_order_books[ref.ticker.index].GetTrade(ref.index));
     }
-    return {};
 }
 
-bool Exchange::RegisterUser(std::string user_id)
+bool Exchange::RegisterUser(const std::string &user_id)
 {
-    auto it = users.find(user_id);
-    if (it != users.end())
+    auto it = user_indices.find(user_id);
+    if (it != user_indices.end())
     {
         return false; // Username/id already registered
     }
-    users.emplace(user_id); // register user
+    // register user
+    uint32_t index = position_store.AddUser();
+    risk_engine.AddUser();
+    margin_engine.AddUser();
+    user_indices.emplace(user_id, index);
+    user_ids.push_back(user_id);
+    portfolios.emplace_back();
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * Applies one side of a fill to a registered user's portfolio and mirrors
+ * the resulting position into the position store.
+ * Fills for unregistered users are only kept in the trade history.
+ *
+ * @param index Dense user index, or RiskEngine::kUnregistered.
+ * @param signed_volume > 0 for the buyer, < 0 for the seller.
+ */
+inline void Exchange::ApplyFillToPortfolio(uint32_t index,
+                                           TickerHandle ticker,
+                                           int signed_volume,
+                                           double price)
+{
+    if (index == RiskEngine::kUnregistered)
+    {
+        return;
+    }
+
+    Portfolio &portfolio = portfolios[index];
+    const std::string &symbol = limit_order_books[ticker.index].GetTicker();
+    portfolio.Trade(symbol, signed_volume, price);
+
+    const TickerPosition &position = portfolio.positions[symbol];
+    position_store.SetPosition(ticker.index, index, position.net_shares, position.avg_cost);
+    position_store.SetCash(index, portfolio.cash_balance);
+    margin_engine.OnPositionChanged(index, ticker.index, position.net_shares, position.avg_cost, portfolio.realized_pnl);
+}
+
+inline uint32_t Exchange::FindUserIndex(const std::string &user_id)
+{
+    auto it = user_indices.find(user_id);
+    return (it == user_indices.end()) ? RiskEngine::kUnregistered : it->second;
+}
+
+inline uint32_t Exchange::GetUserIndex(const std::string &user_id)
+{
+    auto it = user_indices.find(user_id);
+    if (it == user_indices.end())
+    {
+        throw std::runtime_error("User not found");
+    }
+    return it->second;
+}
+
+/**
+ * Current portfolio of a registered user, maintained incrementally from fills.
+ *
+ * @throws std::runtime_error if the user is not registered.
+ */
+const Portfolio &Exchange::GetPortfolio(const std::string &user_id)
+{
+    return portfolios[GetUserIndex(user_id)];
+}
+
+/**
+ * Cash plus market value of all positions, marked at each ticker's last
+ * trade price.
+ *
+ * @throws std::runtime_error if the user is not registered.
+ */
+double Exchange::GetEquity(const std::string &user_id)
+{
+    uint32_t index = GetUserIndex(user_id);
+    position_store.Revalue();
+    return position_store.GetEquity(index);
+}
+
+double Exchange::GetUnrealizedPnL(const std::string &user_id)
+{
+    uint32_t index = GetUserIndex(user_id);
+    position_store.Revalue();
+    return position_store.GetUnrealizedPnL(index);
+}
+
+/**
+ * Marks every registered user to market and ranks them by equity.
+ *
+ * @param count Maximum number of entries to return.
+ * @return Up to `count` entries, highest equity first.
+ */
+std::vector<LeaderboardEntry> Exchange::GetLeaderboard(size_t count)
+{
+    position_store.Revalue();
+
+    std::vector<LeaderboardEntry> leaderboard;
+    for (const UserEquity &entry : position_store.GetLeaderboard(count))
+    {
+        leaderboard.push_back(LeaderboardEntry{user_ids[entry.user],
+                                               entry.equity,
+                                               entry.unrealized_pnl,
+                                               portfolios[entry.user].realized_pnl});
+    }
+    return leaderboard;
+}
+
+/**
+ * Puts a ticker into its call auction phase (opening or re-opening): orders
+ * are accepted and rest without matching until Uncross.
+ *
+ * @throws std::runtime_error if the ticker is not listed.
+ */
+void Exchange::StartAuction(const std::string &ticker)
+{
+    GetBook(ResolveTicker(ticker)).StartAuction();
+}
+
+TradingPhase Exchange::GetTradingPhase(const std::string &ticker)
+{
+    return GetTradingPhase(ResolveTicker(ticker));
+}
+
+TradingPhase Exchange::GetTradingPhase(TickerHandle ticker)
+{
+    return GetBook(ticker).GetTradingPhase();
+}
+
+UncrossResult Exchange::GetIndicativeUncross(const std::string &ticker)
+{
+    return GetIndicativeUncross(ResolveTicker(ticker));
+}
+
+UncrossResult Exchange::GetIndicativeUncross(TickerHandle ticker)
+{
+    return GetBook(ticker).GetIndicativeUncross();
+}
+
+UncrossResult Exchange::Uncross(const std::string &ticker)
+{
+    NullExecutionSink sink;
+    return Uncross(ResolveTicker(ticker), sink);
+}
+
+/**
+ * Executes a ticker's auction at its equilibrium price, recording every fill
+ * like continuous trading does, and resumes continuous trading.
+ *
+ * @param sink Receives each uncross fill after the exchange has recorded it.
+ * @return The uncross price, executed volume and remaining imbalance.
+ */
+UncrossResult Exchange::Uncross(TickerHandle ticker, ExecutionSink &sink)
+{
+    LimitOrderBook &book = GetBook(ticker);
+    ExecutionRecorder recorder(*this, ticker, sink);
+    UncrossResult result = book.Uncross(recorder);
+    NotifyBookUpdate(ticker);
+    return result;
+}
+
+/**
+ * Switches a ticker between continuous trading and frequent batch auctions.
+ *
+ * @param interval Batch length; zero uncrosses the pending batch and
+ *                 resumes continuous trading.
+ * @throws std::runtime_error if the ticker is not listed or interval < 0.
+ */
+void Exchange::SetBatchInterval(const std::string &ticker, std::chrono::nanoseconds interval)
+{
+    if (interval.count() < 0)
+    {
+        throw std::runtime_error("Batch interval must not be negative");
+    }
+    TickerHandle handle = ResolveTicker(ticker);
+    BatchSchedule &schedule = batch_schedules[handle.index];
+    LimitOrderBook &book = GetBook(handle);
+
+    if (interval.count() == 0)
+    {
+        if (book.GetTradingPhase() == TradingPhase::AUCTION)
+        {
+            NullExecutionSink sink;
+            Uncross(handle, sink);
+        }
+        schedule = BatchSchedule{};
+        return;
+    }
+    schedule.interval = interval;
+    schedule.next_clear = std::chrono::steady_clock::now() + interval;
+    book.StartAuction();
+}
+
+std::chrono::nanoseconds Exchange::GetBatchInterval(const std::string &ticker)
+{
+    return batch_schedules[ResolveTicker(ticker).index].interval;
+}
+
+/**
+ * Uncrosses a batch ticker whose interval has elapsed and opens the next
+ * batch. Fills are recorded under both users like continuous fills.
+ */
+inline void Exchange::ClearBatchIfDue(TickerHandle ticker, std::chrono::steady_clock::time_point now)
+{
+    BatchSchedule &schedule = batch_schedules[ticker.index];
+    if (now < schedule.next_clear)
+    {
+        return;
+    }
+
+    NullExecutionSink sink;
+    Uncross(ticker, sink);
+    limit_order_books[ticker.index].StartAuction();
+
+    // Next boundary on the interval grid, skipping batches nobody traded in
+    const auto missed = (now - schedule.next_clear) / schedule.interval;
+    schedule.next_clear += schedule.interval * (missed + 1);
+}
+
+size_t Exchange::ClearDueBatches()
+{
+    return ClearDueBatches(std::chrono::steady_clock::now());
+}
+
+/**
+ * Clears every batch-auction ticker whose interval has elapsed at `now`.
+ * Meant to be called periodically by the one thread that owns the
+ * exchange (EngineService does once per poll), so batches clear even when
+ * no new order arrives. Readers must not call it.
+ *
+ * @return The number of batches cleared.
+ */
+size_t Exchange::ClearDueBatches(std::chrono::steady_clock::time_point now)
+{
+    size_t cleared = 0;
+    for (uint32_t index = 0; index < batch_schedules.size(); ++index)
+    {
+        const BatchSchedule &schedule = batch_schedules[index];
+        if (schedule.interval.count() != 0 && now >= schedule.next_clear)
+        {
+            ClearBatchIfDue(TickerHandle{index}, now);
+            ++cleared;
+        }
+    }
+    return cleared;
+}
+
+/**
+ * Selects the allocation policy of one ticker's book. Resting orders keep
+ * their time priority; the policy applies from the next aggressive order.
+ *
+ * @param min_allocation Smallest non-zero pro-rata share.
+ * @throws std::runtime_error if the ticker is not listed or min_allocation < 1.
+ */
+void Exchange::SetMatchingPolicy(const std::string &ticker, MatchingPolicy policy, int min_allocation)
+{
+    GetBook(ResolveTicker(ticker)).SetMatchingPolicy(policy, min_allocation);
+}
+
+MatchingPolicy Exchange::GetMatchingPolicy(const std::string &ticker)
+{
+    return GetBook(ResolveTicker(ticker)).GetMatchingPolicy();
+}
+
+void Exchange::SetRiskLimits(const RiskLimits &risk_limits)
+{
+    risk_engine.SetLimits(risk_limits);
+    margin_engine.SetLimits(risk_limits);
+}
+
+const RiskLimits &Exchange::GetRiskLimits() const
+{
+    return risk_engine.GetLimits();
+}
+
+/**
+ * Remaining buying power: (buying_power + realized P&L) * max_leverage minus
+ * resting order notional and position exposure at cost.
+ *
+ * @throws std::runtime_error if the user is not registered.
+ */
+double Exchange::GetBuyingPower(const std::string &user_id)
+{
+    return margin_engine.GetBuyingPower(GetUserIndex(user_id));
+}
+
+/**
+ * Makes the ticker's book issue order and trade IDs greater than `id`.
+ * Call before trading starts.
+ */
+void Exchange::ResumeIdsAfter(TickerHandle ticker, int64_t id)
+{
+    GetBook(ticker).ResumeIdsAfter(id);
+}
+
+void Exchange::AddMarketDataListener(MarketDataListener *listener)
+{
+    market_data_listeners.push_back(listener);
+}
+
+/**
+ * Called by the thread driving the exchange once per round of requests, so
+ * conflating listeners publish one update per changed book.
+ *
+ * @return books published across all listeners
+ */
+size_t Exchange::FlushMarketData()
+{
+    size_t published = 0;
+    for (MarketDataListener *listener : market_data_listeners)
+    {
+        published += listener->Flush();
+    }
+    return published;
+}
@@ -0,0 +1,11 @@
+#include "exchange/execution_sink.hpp"
+#include "exchange/trade.hpp"
+
+void TradeCollector::OnFill(const Fill &fill)
+{
+    trades.push_back(fill.trade);
+}
+
+void NullExecutionSink::OnFill(const Fill &)
+{
+}
@@ -0,0 +1,68 @@
+#include "exchange/id_generator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+IdGenerator::IdGenerator(int shard)
+    : shard_prefix(ShardPrefix(shard)),
+      sequence(0)
+{
+}
+
+/**
+ * The shard's bits in place, checked before shifting so a negative shard
+ * is never shifted.
+ *
+ * @throws std::out_of_range if the shard does not fit in kShardBits.
+ */
+int64_t IdGenerator::ShardPrefix(int shard)
+{
+    if (shard < 0 || shard > kMaxShard)
+    {
+        throw std::out_of_range("Shard " + std::to_string(shard) + " does not fit in the ID layout");
+    }
+    return static_cast<int64_t>(shard) << kSequenceBits;
+}
+
+/**
+ * Generates the next ID for this shard.
+ *
+ * Single writer: the owning book is the only caller, so a plain counter is
+ * enough and no cache line is shared between books.
+ *
+ * @return A positive 64-bit ID unique across all shards.
+ * @throws std::overflow_error if the 48-bit sequence is exhausted.
+ */
+int64_t IdGenerator::Next()
+{
+    if (sequence == kMaxSequence)
+    {
+        throw std::overflow_error("ID sequence exhausted for shard " + std::to_string(GetShard()));
+    }
+    return shard_prefix | ++sequence;
+}
+
+/**
+ * Moves the sequence forward so Next() returns IDs greater than `id`.
+ * IDs of other shards, and IDs the sequence is already past, are ignored.
+ */
+void IdGenerator::AdvancePast(int64_t id)
+{
+    if (id <= 0 || ShardOf(id) != GetShard())
+    {
+        return;
+    }
+    sequence = std::max(sequence, id & kMaxSequence);
+}
+
+int IdGenerator::GetShard() const
+{
+    return static_cast<int>(shard_prefix >> kSequenceBits);
+}
+
+int IdGenerator::ShardOf(int64_t id)
+{
+    return static_cast<int>((id >> kSequenceBits) & kMaxShard);
+}
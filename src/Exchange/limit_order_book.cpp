@@ -1,39 +1,427 @@
 // project headers
 #include "exchange/limit_order_book.hpp"
 #include "exchange/order_node.hpp"
+#include "exchange/order_pool.hpp"
 #include "exchange/trade.hpp"
 #include "utils/order_type.hpp"
 #include "exchange/price_level_queue.hpp"
 #include "exchange/top_of_book.hpp"
 #include "exchange/order_result.hpp"
+#include "exchange/execution_sink.hpp"
+#include "exchange/matching_policy.hpp"
+#include "exchange/trading_phase.hpp"
 
 // std headers
+#include <cstdint>
 #include <string>
 #include <variant>
 #include <ctime>
 #include <unordered_map>
 #include <queue>
 #include <vector>
+#include <utility>
 #include <stdexcept>
 #include <random>
-#include <iostream> //For debugging
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 /**
  * Constructs a new LimitOrderBook for a given ticker symbol.
  *
  * @param ticker The ticker symbol for the order book (e.g., "AAPL").
+ * @param shard Shard encoded into every order/trade ID issued by this book.
  */
-LimitOrderBook::LimitOrderBook(std::string ticker)
+LimitOrderBook::LimitOrderBook(const std::string &ticker, int shard)
     : ticker(ticker),
-      ask_order_pq([](const std::shared_ptr<PriceLevelQueue> &a, const std::shared_ptr<PriceLevelQueue> &b)
-                   {
-                       return a->GetPrice() > b->GetPrice(); // Min-heap for ask orders
-                   }),
-      bid_order_pq([](const std::shared_ptr<PriceLevelQueue> &a, const std::shared_ptr<PriceLevelQueue> &b)
-                   {
-                       return a->GetPrice() < b->GetPrice(); // Max-heap for bid orders
-                   })
+      id_generator(shard),
+      matching_policy(MatchingPolicy::FIFO),
+      min_allocation(1),
+      phase(TradingPhase::CONTINUOUS),
+      update_sequence(0),
+      bbo(std::make_unique<Seqlock<BboSnapshot>>())
 {
+    PublishBbo();
+}
+
+/**
+ * Selects how aggressive volume is allocated within a price level.
+ *
+ * @param policy FIFO, PRO_RATA or TOP_ORDER_PRO_RATA.
+ * @param min_allocation Smallest non-zero pro-rata share, >= 1.
+ * @throws std::runtime_error if min_allocation < 1.
+ */
+void LimitOrderBook::SetMatchingPolicy(MatchingPolicy policy, int min_allocation)
+{
+    if (min_allocation < 1)
+    {
+        throw std::runtime_error("Minimum allocation must be at least one");
+    }
+    matching_policy = policy;
+    this->min_allocation = min_allocation;
+}
+
+MatchingPolicy LimitOrderBook::GetMatchingPolicy() const
+{
+    return matching_policy;
+}
+
+/**
+ * Enters the call auction phase: from now on orders rest without matching,
+ * even if they cross, until Uncross(). The resting volume is copied into
+ * the ordered auction maps once, here; orders and cancels keep them current.
+ */
+void LimitOrderBook::StartAuction()
+{
+    ++update_sequence;
+    phase = TradingPhase::AUCTION;
+    auction_bid_volume.clear();
+    auction_ask_volume.clear();
+    for (const auto &[price, level] : bid_order_queues)
+    {
+        AddAuctionVolume(OrderType::BID, price, level->GetVolume());
+    }
+    for (const auto &[price, level] : ask_order_queues)
+    {
+        AddAuctionVolume(OrderType::ASK, price, level->GetVolume());
+    }
+    PublishBbo();
+}
+
+void LimitOrderBook::AddAuctionVolume(OrderType side, double price, int64_t volume)
+{
+    std::map<double, int64_t> &volumes = (side == OrderType::BID) ? auction_bid_volume : auction_ask_volume;
+    auto it = volumes.try_emplace(price, 0).first;
+    it->second += volume;
+    if (it->second <= 0)
+    {
+        volumes.erase(it);
+    }
+}
+
+TradingPhase LimitOrderBook::GetTradingPhase() const
+{
+    return phase;
+}
+
+/**
+ * Collects the price levels that can take part in an uncross: bids at or
+ * above the lowest ask and asks at or below the highest bid, best first,
+ * each with its total resting volume.
+ *
+ * The levels are popped off the heaps, so only crossing levels are touched
+ * (O(k log L) for k crossing of L levels); call RestoreAuctionLevels after.
+ */
+void LimitOrderBook::CollectAuctionLevels(std::vector<AuctionLevel> &bids, std::vector<AuctionLevel> &asks)
+{
+    CleanupPriorityQueue(ask_order_pq);
+    CleanupPriorityQueue(bid_order_pq);
+    if (ask_order_pq.empty() || bid_order_pq.empty())
+    {
+        return;
+    }
+    const double best_bid = bid_order_pq.top()->GetPrice();
+    const double best_ask = ask_order_pq.top()->GetPrice();
+
+    while (!bid_order_pq.empty() && bid_order_pq.top()->GetPrice() >= best_ask)
+    {
+        std::shared_ptr<PriceLevelQueue> level = bid_order_pq.top();
+        bid_order_pq.pop();
+        if (level->HasOrders())
+        {
+            bids.push_back(AuctionLevel{level->GetPrice(), level, level->GetVolume()});
+        }
+    }
+    while (!ask_order_pq.empty() && ask_order_pq.top()->GetPrice() <= best_bid)
+    {
+        std::shared_ptr<PriceLevelQueue> level = ask_order_pq.top();
+        ask_order_pq.pop();
+        if (level->HasOrders())
+        {
+            asks.push_back(AuctionLevel{level->GetPrice(), level, level->GetVolume()});
+        }
+    }
+}
+
+void LimitOrderBook::RestoreAuctionLevels(const std::vector<AuctionLevel> &bids, const std::vector<AuctionLevel> &asks)
+{
+    for (const AuctionLevel &level : bids)
+    {
+        if (level.level->HasOrders())
+        {
+            bid_order_pq.push(level.level);
+        }
+    }
+    for (const AuctionLevel &level : asks)
+    {
+        if (level.level->HasOrders())
+        {
+            ask_order_pq.push(level.level);
+        }
+    }
+}
+
+/**
+ * Finds the uncross price in one ascending pass over the crossing levels.
+ *
+ * At each candidate price p, demand is the bid volume priced >= p and supply
+ * the ask volume priced <= p. The price maximizing min(demand, supply) wins;
+ * ties go to the smallest imbalance, then to market pressure (highest price
+ * if buyers are left over), then to the price closest to the last trade.
+ */
+UncrossResult LimitOrderBook::FindEquilibrium(const std::vector<AuctionLevel> &bids,
+                                              const std::vector<AuctionLevel> &asks) const
+{
+    UncrossResult best{0.0, 0, 0};
+    if (bids.empty() || asks.empty())
+    {
+        return best;
+    }
+
+    int64_t total_demand = 0;
+    for (const AuctionLevel &level : bids)
+    {
+        total_demand += level.volume;
+    }
+
+    const bool has_reference = !filled_trades.empty();
+    const double reference = has_reference ? filled_trades.back().price : 0.0;
+
+    int64_t supply = 0;     // asks priced <= p
+    int64_t bids_below = 0; // bids priced < p
+    size_t a = 0;
+    size_t b = bids.size(); // bids are best first; walk them from the back (ascending)
+    while (a < asks.size() || b > 0)
+    {
+        double p = (a < asks.size()) ? asks[a].price : bids[b - 1].price;
+        if (b > 0)
+        {
+            p = std::min(p, bids[b - 1].price);
+        }
+
+        while (a < asks.size() && asks[a].price <= p)
+        {
+            supply += asks[a++].volume;
+        }
+        const int64_t demand = total_demand - bids_below;
+
+        const int volume = static_cast<int>(std::min(demand, supply));
+        const int imbalance = static_cast<int>(demand - supply);
+        bool better = volume > best.volume;
+        if (volume == best.volume && volume > 0)
+        {
+            if (std::abs(imbalance) != std::abs(best.imbalance))
+            {
+                better = std::abs(imbalance) < std::abs(best.imbalance);
+            }
+            else if (imbalance > 0)
+            {
+                better = true; // buyers left over: the higher price
+            }
+            else if (imbalance == 0 && has_reference)
+            {
+                better = std::abs(p - reference) < std::abs(best.price - reference);
+            }
+        }
+        if (better)
+        {
+            best = UncrossResult{p, volume, imbalance};
+        }
+
+        while (b > 0 && bids[b - 1].price <= p)
+        {
+            bids_below += bids[--b].volume;
+        }
+    }
+    return best;
+}
+
+/**
+ * Price and volume an uncross would execute now, from the auction volume
+ * maps: O(k) for k crossing prices, no heap pops and, once the scratch
+ * vectors have grown, no allocation. Runs on the owning thread, from
+ * PublishBbo.
+ */
+UncrossResult LimitOrderBook::ComputeIndicativeUncross()
+{
+    auction_bids.clear();
+    auction_asks.clear();
+    if (auction_bid_volume.empty() || auction_ask_volume.empty())
+    {
+        return UncrossResult{0.0, 0, 0};
+    }
+    const double best_bid = auction_bid_volume.rbegin()->first;
+    const double best_ask = auction_ask_volume.begin()->first;
+    for (auto it = auction_bid_volume.rbegin(); it != auction_bid_volume.rend() && it->first >= best_ask; ++it)
+    {
+        auction_bids.push_back(AuctionLevel{it->first, nullptr, it->second});
+    }
+    for (auto it = auction_ask_volume.begin(); it != auction_ask_volume.end() && it->first <= best_bid; ++it)
+    {
+        auction_asks.push_back(AuctionLevel{it->first, nullptr, it->second});
+    }
+    return FindEquilibrium(auction_bids, auction_asks);
+}
+
+/**
+ * Ends the auction: executes every crossing order at the single equilibrium
+ * price, bids and asks each in price-time priority, then returns the book to
+ * continuous trading.
+ *
+ * Each Fill reports the ask as the resting order and the bid through the
+ * aggressor_* fields, since both were resting. If the two orders at the
+ * front belong to the same user, the ask is cancelled (self-trade).
+ *
+ * @param sink Receives every fill (and self-trade cancel) of the uncross.
+ * @return The uncross price, the executed volume and the imbalance left.
+ */
+UncrossResult LimitOrderBook::Uncross(ExecutionSink &sink)
+{
+    std::vector<AuctionLevel> &bids = auction_bids;
+    std::vector<AuctionLevel> &asks = auction_asks;
+    bids.clear();
+    asks.clear();
+    CollectAuctionLevels(bids, asks);
+    UncrossResult result = FindEquilibrium(bids, asks);
+    ++update_sequence;
+    phase = TradingPhase::CONTINUOUS;
+    auction_bid_volume.clear();
+    auction_ask_volume.clear();
+    if (result.volume == 0)
+    {
+        RestoreAuctionLevels(bids, asks);
+        bids.clear();
+        asks.clear();
+        PublishBbo();
+        return result;
+    }
+
+    const double uncross_price = result.price;
+    int executed = 0;
+    size_t b = 0;
+    size_t a = 0;
+    while (b < bids.size() && a < asks.size() &&
+           bids[b].price >= uncross_price && asks[a].price <= uncross_price)
+    {
+        PriceLevelQueue &bid_level = *bids[b].level;
+        PriceLevelQueue &ask_level = *asks[a].level;
+        if (!bid_level.HasOrders())
+        {
+            ++b;
+            continue;
+        }
+        if (!ask_level.HasOrders())
+        {
+            ++a;
+            continue;
+        }
+
+        OrderNode &bid = bid_level.Peek();
+        OrderNode &ask = ask_level.Peek();
+        if (bid.owner == ask.owner)
+        {
+            WashResting<OrderType::BID>(ask, ask_level, owners[bid.owner], sink);
+            continue;
+        }
+
+        const int vol_filled = std::min(bid.volume, ask.volume);
+        bid.volume -= vol_filled;
+        ask.volume -= vol_filled;
+        executed += vol_filled;
+        filled_trades.push_back(GenerateTrade(owners[bid.owner], owners[ask.owner], uncross_price, vol_filled));
+
+        const int64_t bid_id = bid.order_id;
+        const int bid_remaining = bid.volume;
+        const int64_t ask_id = ask.order_id;
+        const int ask_remaining = ask.volume;
+        bid_volume_at_price[bid_level.GetPrice()] -= vol_filled;
+        ask_volume_at_price[ask_level.GetPrice()] -= vol_filled;
+        bid_level.ReduceVolume(vol_filled);
+        ask_level.ReduceVolume(vol_filled);
+        if (bid_remaining == 0)
+        {
+            bid_level.Pop();
+            ReleaseOrder(bid_id);
+        }
+        if (ask_remaining == 0)
+        {
+            ask_level.Pop();
+            ReleaseOrder(ask_id);
+        }
+
+        Fill fill{filled_trades.back(),
+                  uncross_price,
+                  OrderType::BID,
+                  ask_id,
+                  ask_remaining,
+                  ask_level.GetPrice()};
+        fill.aggressor_order_id = bid_id;
+        fill.aggressor_remaining_volume = bid_remaining;
+        fill.aggressor_order_price = bid_level.GetPrice();
+        sink.OnFill(fill);
+    }
+
+    // Emptied levels leave the price maps, the rest go back on the heaps
+    RestoreAuctionLevels(bids, asks);
+    for (const AuctionLevel &level : bids)
+    {
+        if (!level.level->HasOrders())
+        {
+            bid_order_queues.erase(level.price);
+        }
+    }
+    for (const AuctionLevel &level : asks)
+    {
+        if (!level.level->HasOrders())
+        {
+            ask_order_queues.erase(level.price);
+        }
+    }
+    bids.clear(); // the scratch must not keep emptied levels alive
+    asks.clear();
+
+    result.volume = executed;
+    PublishBbo();
+    return result;
+}
+
+template <OrderType Side>
+PriceLevelHeap<Side> &LimitOrderBook::LevelHeap()
+{
+    if constexpr (Side == OrderType::BID)
+    {
+        return bid_order_pq;
+    }
+    else
+    {
+        return ask_order_pq;
+    }
+}
+
+template <OrderType Side>
+std::unordered_map<double, std::shared_ptr<PriceLevelQueue>> &LimitOrderBook::LevelQueues()
+{
+    if constexpr (Side == OrderType::BID)
+    {
+        return bid_order_queues;
+    }
+    else
+    {
+        return ask_order_queues;
+    }
+}
+
+template <OrderType Side>
+std::unordered_map<int, int> &LimitOrderBook::VolumeAtPrice()
+{
+    if constexpr (Side == OrderType::BID)
+    {
+        return bid_volume_at_price;
+    }
+    else
+    {
+        return ask_volume_at_price;
+    }
 }
 
 /**
@@ -50,12 +438,41 @@ LimitOrderBook::LimitOrderBook(std::string ticker)
  */
 
 OrderResult LimitOrderBook::HandleOrder(
-    std::string user_id,
+    const std::string &user_id,
     OrderType order_type,
     int volume,
     double price,
     time_t timestamp,
-    std::string ticker)
+    const std::string &ticker)
+{
+    TradeCollector collector;
+    int64_t new_order_id = HandleOrder(user_id, order_type, volume, price, timestamp, ticker, collector);
+    bool trades_executed = !collector.trades.empty();
+    return OrderResult(trades_executed, std::move(collector.trades), new_order_id > 0, new_order_id);
+}
+
+/**
+ * Handles an incoming order, reporting each fill to an ExecutionSink instead
+ * of building a vector of trades.
+ *
+ * @param user_id The ID of the user submitting the order.
+ * @param order_type The type of order (OrderType::ASK or OrderType::BID).
+ * @param volume The number of shares in the order.
+ * @param price The price at which the order is placed.
+ * @param timestamp The timestamp of the order submission.
+ * @param ticker The ticker symbol for the order.
+ * @param sink Receives one Fill per match, in match order.
+ * @return The ID of the remainder added to the book, or -1 if fully filled.
+ */
+
+int64_t LimitOrderBook::HandleOrder(
+    const std::string &user_id,
+    OrderType order_type,
+    int volume,
+    double price,
+    time_t timestamp,
+    const std::string &ticker,
+    ExecutionSink &sink)
 {
     if (ticker != GetTicker())
     {
@@ -74,13 +491,68 @@ OrderResult LimitOrderBook::HandleOrder(
     CleanupPriorityQueue(ask_order_pq);
     CleanupPriorityQueue(bid_order_pq);
 
-    const OrderType opposite_side = (order_type == OrderType::ASK) ? OrderType::BID : OrderType::ASK;
-    auto &opposite_pq = (opposite_side == OrderType::ASK) ? ask_order_pq : bid_order_pq;
-    auto &opposite_volume_map = (opposite_side == OrderType::BID) ? bid_volume_at_price : ask_volume_at_price;
+    // A valid order always rests or trades
+    ++update_sequence;
+    const bool is_bid = (order_type == OrderType::BID);
+    if (phase == TradingPhase::AUCTION)
+    {
+        // Accumulate without matching until Uncross
+        const uint32_t owner = InternOwner(user_id);
+        const int64_t order_id = is_bid ? RestOrder<OrderType::BID>(owner, volume, price, timestamp)
+                                        : RestOrder<OrderType::ASK>(owner, volume, price, timestamp);
+        AddAuctionVolume(order_type, price, volume);
+        PublishBbo();
+        return order_id;
+    }
+
+    // One branch per order; everything below is specialized on side and policy
+    int64_t order_id;
+    switch (matching_policy)
+    {
+    case MatchingPolicy::PRO_RATA:
+        order_id = is_bid ? Match<OrderType::BID, ProRataAllocation>(user_id, volume, price, timestamp, sink)
+                          : Match<OrderType::ASK, ProRataAllocation>(user_id, volume, price, timestamp, sink);
+        break;
+    case MatchingPolicy::TOP_ORDER_PRO_RATA:
+        order_id = is_bid ? Match<OrderType::BID, TopOrderProRataAllocation>(user_id, volume, price, timestamp, sink)
+                          : Match<OrderType::ASK, TopOrderProRataAllocation>(user_id, volume, price, timestamp, sink);
+        break;
+    case MatchingPolicy::FIFO:
+    default:
+        order_id = is_bid ? Match<OrderType::BID, FifoAllocation>(user_id, volume, price, timestamp, sink)
+                          : Match<OrderType::ASK, FifoAllocation>(user_id, volume, price, timestamp, sink);
+        break;
+    }
+    PublishBbo();
+    return order_id;
+}
+
+/**
+ * Matches an aggressive `Side` order against the opposite side level by
+ * level, allocating each level's fills per `Allocation`, then rests any
+ * remainder.
+ *
+ * Side selection (heap, level map, volume map, crossing test, bid/ask user
+ * of each trade) is resolved at compile time, so the loop has no OrderType
+ * branches.
+ *
+ * @return The ID of the remainder added to the book, or -1 if fully filled.
+ */
+
+template <OrderType Side, typename Allocation>
+int64_t LimitOrderBook::Match(const std::string &user_id,
+                              int volume,
+                              double price,
+                              time_t timestamp,
+                              ExecutionSink &sink)
+{
+    constexpr OrderType opposite_side = BookSide<Side>::kOpposite;
 
-    std::vector<Trade> trades;
+    const uint32_t owner = InternOwner(user_id);
+    auto &opposite_pq = LevelHeap<opposite_side>();
+    auto &opposite_price_level_queues = LevelQueues<opposite_side>();
 
-    // Process matching orders
+    // Process matching levels
     while (!opposite_pq.empty() && volume > 0)
     {
         auto best_opposite_queue = opposite_pq.top();
@@ -93,108 +565,291 @@ OrderResult LimitOrderBook::HandleOrder(
         PriceLevelQueue &opposite_best_price_queue = *best_opposite_queue;
         double best_opposite_price = opposite_best_price_queue.GetPrice();
 
-        if (!PricesMatch(price, best_opposite_price, opposite_side))
+        if (!BookSide<Side>::Crosses(price, best_opposite_price))
         {
             break; // Stop if prices no longer match
         }
 
-        OrderNode &current_opposite_order = opposite_best_price_queue.Peek();
+        volume = FillLevel<Side>(Allocation{}, opposite_best_price_queue, owner, user_id, volume, sink);
+
+        if (!opposite_best_price_queue.HasOrders())
+        {
+            // Empty levels leave the price map so a new order at this price starts a fresh level
+            opposite_pq.pop();
+            opposite_price_level_queues.erase(best_opposite_price);
+        }
+    }
+
+    if (volume > 0)
+    {
+        // Add remaining order to the book
+        return RestOrder<Side>(owner, volume, price, timestamp);
+    }
+    return -1;
+}
+
+template <OrderType Side>
+int64_t LimitOrderBook::RestOrder(uint32_t owner, int volume, double price, time_t timestamp)
+{
+    int64_t order_id = AddOrderToBook<Side>(owner, volume, price, timestamp);
+    VolumeAtPrice<Side>()[price] += volume;
+    return order_id;
+}
+
+/**
+ * Strict time priority: fills the level front to back.
+ *
+ * @return The aggressive order's unfilled volume.
+ */
+
+template <OrderType Side>
+int LimitOrderBook::FillLevel(FifoAllocation,
+                              PriceLevelQueue &level,
+                              uint32_t owner,
+                              const std::string &user_id,
+                              int volume,
+                              ExecutionSink &sink)
+{
+    while (volume > 0 && level.HasOrders())
+    {
+        OrderNode &resting = level.Peek();
 
         // Handle wash trades by cancelling opposite order
-        if (current_opposite_order.user_id == user_id)
+        if (resting.owner == owner)
         {
-            opposite_best_price_queue.RemoveOrder(current_opposite_order);
+            WashResting<Side>(resting, level, user_id, sink);
             continue;
         }
 
-        int vol_filled = std::min(volume, current_opposite_order.volume);
-
-        // Adjust volumes
-        current_opposite_order.volume -= vol_filled;
+        int vol_filled = std::min(volume, resting.volume);
         volume -= vol_filled;
+        FillResting<Side>(resting, level, user_id, vol_filled, sink);
+    }
+    return volume;
+}
 
-        // Log trade
-        Trade trade = GenerateTrade(opposite_side, user_id, current_opposite_order.user_id, best_opposite_price, vol_filled);
-        trades.push_back(trade);
-        filled_trades.push_back(trade);
+/**
+ * Pro-rata: each resting order gets floor(volume * size / level size),
+ * shares below min_allocation round to zero, and the rounding remainder
+ * goes out in time priority. Three passes over the level, no allocation.
+ *
+ * @return The aggressive order's unfilled volume.
+ */
+
+template <OrderType Side>
+int LimitOrderBook::FillLevel(ProRataAllocation,
+                              PriceLevelQueue &level,
+                              uint32_t owner,
+                              const std::string &user_id,
+                              int volume,
+                              ExecutionSink &sink)
+{
+    int64_t level_volume = WashLevel<Side>(level, owner, user_id, sink);
+    if (volume >= level_volume)
+    {
+        // Takes the whole level, allocation order is irrelevant
+        return FillLevel<Side>(FifoAllocation{}, level, owner, user_id, volume, sink);
+    }
+    AllocateProRata<Side>(level, level.Begin(), user_id, volume, level_volume, sink);
+    return 0;
+}
+
+/**
+ * Top order, then pro-rata: the first order in time priority fills up to its
+ * size, and what is left is allocated pro-rata over the rest of the level.
+ *
+ * @return The aggressive order's unfilled volume.
+ */
+
+template <OrderType Side>
+int LimitOrderBook::FillLevel(TopOrderProRataAllocation,
+                              PriceLevelQueue &level,
+                              uint32_t owner,
+                              const std::string &user_id,
+                              int volume,
+                              ExecutionSink &sink)
+{
+    int64_t level_volume = WashLevel<Side>(level, owner, user_id, sink);
+    if (volume >= level_volume)
+    {
+        return FillLevel<Side>(FifoAllocation{}, level, owner, user_id, volume, sink);
+    }
+
+    OrderNode &top = level.Peek();
+    const int top_fill = std::min(volume, top.volume);
+    OrderNode *rest = top.next; // top may be unlinked by the fill
+    level_volume -= top_fill;
+    volume -= top_fill;
+    FillResting<Side>(top, level, user_id, top_fill, sink);
+
+    if (volume > 0)
+    {
+        AllocateProRata<Side>(level, rest, user_id, volume, level_volume, sink);
+    }
+    return 0;
+}
+
+/**
+ * Cancels every order of `owner` resting in `level` (self-trade prevention
+ * for the allocation policies that touch the whole level).
+ *
+ * @return The volume left resting in the level.
+ */
 
-        // Remove fully matched orders
-        if (current_opposite_order.volume == 0)
+template <OrderType Side>
+int64_t LimitOrderBook::WashLevel(PriceLevelQueue &level,
+                                  uint32_t owner,
+                                  const std::string &user_id,
+                                  ExecutionSink &sink)
+{
+    int64_t level_volume = 0;
+    const OrderNode *end = level.End();
+    for (OrderNode *node = level.Begin(); node != end;)
+    {
+        OrderNode *next = node->next;
+        if (node->owner == owner)
+        {
+            WashResting<Side>(*node, level, user_id, sink);
+        }
+        else
         {
-            opposite_best_price_queue.Pop();
-            order_node_map.erase(current_opposite_order.order_id);
+            level_volume += node->volume;
         }
+        node = next;
+    }
+    return level_volume;
+}
 
-        opposite_volume_map[best_opposite_price] -= vol_filled;
+/**
+ * Allocates `volume` (< level_volume) pro-rata over the orders from `first`
+ * to the end of the level. One fill per order.
+ *
+ * @param level_volume Total resting volume from `first` onwards.
+ */
 
-        if (!opposite_best_price_queue.HasOrders())
+template <OrderType Side>
+void LimitOrderBook::AllocateProRata(PriceLevelQueue &level,
+                                     OrderNode *first,
+                                     const std::string &user_id,
+                                     int volume,
+                                     int64_t level_volume,
+                                     ExecutionSink &sink)
+{
+    const OrderNode *end = level.End();
+    auto share_of = [&](const OrderNode &node)
+    {
+        int share = static_cast<int>(static_cast<int64_t>(volume) * node.volume / level_volume);
+        return (share < min_allocation) ? 0 : share;
+    };
+
+    // Pass 1: what the proportional shares leave over
+    int remainder = volume;
+    for (const OrderNode *node = first; node != end; node = node->next)
+    {
+        remainder -= share_of(*node);
+    }
+
+    // Pass 2: share plus remainder in time priority, filled at once
+    for (OrderNode *node = first; node != end;)
+    {
+        OrderNode *next = node->next;
+        int share = share_of(*node);
+        int extra = std::min(remainder, node->volume - share);
+        remainder -= extra;
+        if (share + extra > 0)
         {
-            opposite_pq.pop();
+            FillResting<Side>(*node, level, user_id, share + extra, sink);
         }
+        node = next;
     }
+}
 
-    int new_order_id = -1;
-    if (volume > 0)
+/**
+ * Fills `vol_filled` of a resting order: logs the trade, updates the level's
+ * volume, unlinks and releases the order if it is done, and reports the fill.
+ */
+
+template <OrderType Side>
+void LimitOrderBook::FillResting(OrderNode &resting,
+                                 PriceLevelQueue &level,
+                                 const std::string &user_id,
+                                 int vol_filled,
+                                 ExecutionSink &sink)
+{
+    const double level_price = level.GetPrice();
+    resting.volume -= vol_filled;
+    level.ReduceVolume(vol_filled);
+
+    // Log trade
+    const std::string &resting_user_id = owners[resting.owner];
+    if constexpr (Side == OrderType::BID)
     {
-        // Add remaining order to the book
-        new_order_id = AddOrderToBook(user_id, order_type, volume, price, timestamp, ticker);
-        auto &same_side_volume = (order_type == OrderType::BID) ? bid_volume_at_price : ask_volume_at_price;
-        same_side_volume[price] += volume;
+        filled_trades.push_back(GenerateTrade(user_id, resting_user_id, level_price, vol_filled));
+    }
+    else
+    {
+        filled_trades.push_back(GenerateTrade(resting_user_id, user_id, level_price, vol_filled));
+    }
+
+    const int64_t resting_order_id = resting.order_id;
+    const int resting_remaining_volume = resting.volume;
+
+    // Remove fully matched orders
+    if (resting.volume == 0)
+    {
+        level.RemoveOrder(resting);
+        ReleaseOrder(resting_order_id);
     }
 
-    return OrderResult(!trades.empty(), trades, new_order_id > 0, new_order_id);
+    VolumeAtPrice<BookSide<Side>::kOpposite>()[level_price] -= vol_filled;
+
+    sink.OnFill(Fill{filled_trades.back(),
+                     level_price,
+                     Side,
+                     resting_order_id,
+                     resting_remaining_volume,
+                     level_price});
 }
 
 /**
- * Helper to determine if a trade will be executed
- *
- * @param aggressive_price the price of the order just submitted.
- * @param opposite_side_price the best price on the other side of the book.
- * @param opposite_side whether the other side of the book is BID or ASK.
- * @return True if the prices match within a tolerance, otherwise false.
- *
- * Inline
+ * Cancels a resting order of the aggressor's own user (wash trade) and
+ * reports it as a self-trade cancel.
  */
-inline bool LimitOrderBook::PricesMatch(double aggressive_price, double opposite_side_price, OrderType opposite_side)
-{
-    const double epsilon = 1e-6; // Tolerance for floating-point comparison
 
-    double bid_price = (opposite_side == OrderType::BID)
-                           ? opposite_side_price
-                           : aggressive_price;
-    double ask_price = (opposite_side == OrderType::BID)
-                           ? aggressive_price
-                           : opposite_side_price;
+template <OrderType Side>
+void LimitOrderBook::WashResting(OrderNode &resting,
+                                 PriceLevelQueue &level,
+                                 const std::string &user_id,
+                                 ExecutionSink &sink)
+{
+    const double level_price = level.GetPrice();
+    const int64_t washed_order_id = resting.order_id;
+    const int washed_volume = resting.volume;
 
-    return bid_price >= ask_price - epsilon;
+    VolumeAtPrice<BookSide<Side>::kOpposite>()[level_price] -= washed_volume;
+    level.RemoveOrder(resting);
+    sink.OnCancel(Cancel{washed_order_id,
+                         user_id,
+                         BookSide<Side>::kOpposite,
+                         level_price,
+                         washed_volume,
+                         true});
+    ReleaseOrder(washed_order_id);
 }
 
 /**
  * Generates a Trade object representing a successful match between two orders.
  *
- * @param opposite_side The type of the opposite side (OrderType::ASK or OrderType::BID).
- * @param user_id The ID of the user submitting the aggressive order.
- * @param opposite_user_id The ID of the user with the resting order.
+ * @param bid_user_id The ID of the buyer.
+ * @param ask_user_id The ID of the seller.
  * @param price The price at which the trade was executed.
  * @param volume The number of shares traded.
  * @return A Trade object containing details of the executed trade.
  */
 
-Trade LimitOrderBook::GenerateTrade(OrderType opposite_side, std::string user_id, std::string opposite_user_id, double price, int volume)
+Trade LimitOrderBook::GenerateTrade(const std::string &bid_user_id, const std::string &ask_user_id, double price, int volume)
 {
     time_t now = time(0);
-    std::string bid_user_id;
-    std::string ask_user_id;
-    if (opposite_side == OrderType::ASK)
-    {
-        ask_user_id = opposite_user_id;
-        bid_user_id = user_id;
-    }
-    else
-    {
-        bid_user_id = opposite_user_id;
-        ask_user_id = user_id;
-    }
     return Trade(
         GenerateId(),
         price,
@@ -207,60 +862,76 @@ Trade LimitOrderBook::GenerateTrade(OrderType opposite_side, std::string user_id
 /**
  * Generates a unique ID for orders or trades.
  *
- * @return A unique integer ID.
+ * IDs come from this book's own IdGenerator, so they are unique across the
+ * exchange (shard bits) without touching a shared atomic.
+ *
+ * @return A unique 64-bit ID.
+ */
+
+int64_t LimitOrderBook::GenerateId()
+{
+    return id_generator.Next();
+}
+
+/**
+ * Maps a user ID to the compact owner index stored in OrderNode, so the
+ * self-trade check during a sweep is an integer compare.
+ *
+ * @param user_id The ID of the user submitting an order.
+ * @return The user's owner index in this book, assigned on first use.
  */
 
-int LimitOrderBook::GenerateId()
+uint32_t LimitOrderBook::InternOwner(const std::string &user_id)
 {
-    static std::atomic<int> id_counter(0);
-    return ++id_counter;
+    auto [it, inserted] = owner_indices.emplace(user_id, static_cast<uint32_t>(owners.size()));
+    if (inserted)
+    {
+        owners.push_back(user_id);
+    }
+    return it->second;
+}
+
+/**
+ * Returns a filled or cancelled order's slot to the pool. The order must
+ * already be unlinked from its PriceLevelQueue.
+ */
+
+void LimitOrderBook::ReleaseOrder(int64_t order_id)
+{
+    auto it = order_slots.find(order_id);
+    order_pool.Free(it->second);
+    order_slots.erase(it);
 }
 
 /**
  * Adds a new order to the order book and creates a new PriceLevelQueue if
  * one does not already exist for the specified price.
  *
- * @param user_id The ID of the user submitting the order.
- * @param order_type The type of order (OrderType::ASK or OrderType::BID).
+ * @tparam Side The side the order rests on.
+ * @param owner The submitting user's owner index (see InternOwner).
  * @param volume The number of shares in the order.
  * @param price The price at which the order is placed.
  * @param timestamp The timestamp of the order submission.
- * @param ticker The ticker symbol for the order.
  * @return The unique ID of the newly added order.
  */
 
-int LimitOrderBook::AddOrderToBook(std::string user_id,
-                                   OrderType order_type,
-                                   int volume,
-                                   double price,
-                                   time_t timestamp,
-                                   std::string ticker)
+template <OrderType Side>
+int64_t LimitOrderBook::AddOrderToBook(uint32_t owner,
+                                       int volume,
+                                       double price,
+                                       time_t timestamp)
 {
-    int order_id = GenerateId();
+    int64_t order_id = GenerateId();
 
-    // Create a local OrderNode, but only use it to initialize the map.
-    // The map will contain the *official* (long-lived) copy.
-    OrderNode tmp_order(
-        order_id,
-        user_id,
-        volume,
-        price,
-        order_type,
-        timestamp,
-        ticker,
-        nullptr,
-        nullptr);
-
-    // Emplace it into the map (by value), then get a reference to
-    // the newly stored node inside the map
-    auto [map_it, inserted] = order_node_map.emplace(order_id, tmp_order);
-    OrderNode &stored_node = map_it->second;
+    // Hot fields go in the node the queue links, cold fields in the parallel record
+    uint32_t slot = order_pool.Allocate(OrderNode(order_id, owner, volume),
+                                        OrderInfo{price, timestamp, Side});
+    order_slots.emplace(order_id, slot);
+    OrderNode &stored_node = order_pool.Hot(slot);
 
     // NOW pass that reference to PriceLevelQueue
-    auto &side_price_level_queues =
-        (order_type == OrderType::ASK) ? ask_order_queues : bid_order_queues;
-    auto &side_pq =
-        (order_type == OrderType::ASK) ? ask_order_pq : bid_order_pq;
+    auto &side_price_level_queues = LevelQueues<Side>();
+    auto &side_pq = LevelHeap<Side>();
 
     // If no PriceLevelQueue exists, create a new one
     auto it = side_price_level_queues.find(price);
@@ -271,8 +942,8 @@ int LimitOrderBook::AddOrderToBook(std::string user_id,
         side_pq.push(new_price_level_queue);
     }
 
-    // Add the *map's* node, not the temporary
-    side_price_level_queues[price]->AddOrder(stored_node);
+    // Add the pooled node, not a temporary
+    side_price_level_queues[price]->AddOrder(stored_node, price);
 
     return order_id;
 }
@@ -290,7 +961,7 @@ const std::string &LimitOrderBook::GetTicker() const
  * @return The total volume available at the specified price level.
  */
 
-int LimitOrderBook::GetVolume(double price, OrderType order_type)
+int LimitOrderBook::GetVolume(double price, OrderType order_type) const
 {
     const auto &volume_map = (order_type == OrderType::ASK) ? ask_volume_at_price : bid_volume_at_price;
     auto it = volume_map.find(price);
@@ -304,135 +975,196 @@ int LimitOrderBook::GetVolume(double price, OrderType order_type)
 /**
  * Cancels an order in the order book by its unique ID.
  *
- * ToDo: Clean up allocated memory for ordernode
- *
  * @param order_id The unique ID of the order to cancel.
  * @return True if the order was successfully canceled, otherwise false.
  * @throws std::out_of_range if the order ID is not found.
  * @throws std::runtime_error if the associated PriceLevelQueue is invalid.
  */
 
-bool LimitOrderBook::CancelOrder(int order_id)
+bool LimitOrderBook::CancelOrder(int64_t order_id)
+{
+    NullExecutionSink sink;
+    return CancelOrder(order_id, sink);
+}
+
+/**
+ * Cancels an order and reports it to `sink` (OnCancel) before it is erased.
+ *
+ * @param order_id The unique ID of the order to cancel.
+ * @param sink Receives the cancelled order's owner, side, price and volume.
+ * @return True if the order was successfully canceled.
+ * @throws std::out_of_range if the order ID is not found.
+ */
+
+bool LimitOrderBook::CancelOrder(int64_t order_id, ExecutionSink &sink)
 {
     // Check if the order exists
-    auto order_it = order_node_map.find(order_id); // Rename to `order_it` to avoid redeclaration conflicts
-    if (order_it == order_node_map.end())
+    auto order_it = order_slots.find(order_id); // Rename to `order_it` to avoid redeclaration conflicts
+    if (order_it == order_slots.end())
     {
         throw std::out_of_range("Order: " + std::to_string(order_id) + " not found");
     }
+    ++update_sequence;
 
-    // Reference the order to cancel
-    OrderNode &order_to_cancel = order_it->second;
+    // Reference the order to cancel: links/volume from the hot node, side/price from the cold record
+    const uint32_t slot = order_it->second;
+    OrderNode &order_to_cancel = order_pool.Hot(slot);
+    const OrderInfo &order_info = order_pool.Cold(slot);
 
     // Reference the appropriate price level queue
-    auto &given_side_price_level_queues = (order_to_cancel.order_type == OrderType::ASK)
+    auto &given_side_price_level_queues = (order_info.order_type == OrderType::ASK)
                                               ? ask_order_queues
                                               : bid_order_queues;
 
-    auto queue_it = given_side_price_level_queues.find(order_to_cancel.price); // Rename to `queue_it`
+    auto queue_it = given_side_price_level_queues.find(order_info.price); // Rename to `queue_it`
     if (queue_it == given_side_price_level_queues.end() || !queue_it->second)
     {
-        throw std::runtime_error("PriceLevelQueue not found or null for price: " + std::to_string(order_to_cancel.price));
+        throw std::runtime_error("PriceLevelQueue not found or null for price: " + std::to_string(order_info.price));
     }
 
     PriceLevelQueue &price_level = *(queue_it->second);
 
     // Decrease volume
-    std::unordered_map<int, int> &same_side_volume = (order_to_cancel.order_type == OrderType::BID)
+    std::unordered_map<int, int> &same_side_volume = (order_info.order_type == OrderType::BID)
                                                          ? bid_volume_at_price
                                                          : ask_volume_at_price;
-    same_side_volume[order_to_cancel.price] -= order_to_cancel.volume;
+    same_side_volume[order_info.price] -= order_to_cancel.volume;
+    if (phase == TradingPhase::AUCTION)
+    {
+        AddAuctionVolume(order_info.order_type, order_info.price, -static_cast<int64_t>(order_to_cancel.volume));
+    }
 
     // Remove the order from the price level queue
     price_level.RemoveOrder(order_to_cancel);
 
-    // Erase the order from the map
-    order_node_map.erase(order_it); // Use the correctly scoped `order_it`
+    // Drop the emptied level from the price map; the heap discards it lazily.
+    // Otherwise a later order at this price would join a level the heap already popped.
+    if (!price_level.HasOrders())
+    {
+        given_side_price_level_queues.erase(queue_it);
+    }
+
+    sink.OnCancel(Cancel{order_id,
+                         owners[order_to_cancel.owner],
+                         order_info.order_type,
+                         order_info.price,
+                         order_to_cancel.volume,
+                         false});
 
+    // Return the slot to the pool
+    order_pool.Free(slot);
+    order_slots.erase(order_it); // Use the correctly scoped `order_it`
+
+    PublishBbo();
     return true;
 }
 
 /**
- * Retrieves top of LOB
+ * Retrieves top of LOB from the last published snapshot.
+ *
+ * Wait-free for the writer and O(1) for readers, so any thread may call it
+ * while the matching thread keeps trading.
  *
  * @return A TopOfBook object containing the best bid, best ask, and their volumes.
  */
 
-TopOfBook LimitOrderBook::GetTopOfBook()
+TopOfBook LimitOrderBook::GetTopOfBook() const
+{
+    return TopOfBook(bbo->Load());
+}
+
+/**
+ * The published best bid and ask together with the update sequence they
+ * were taken at; see GetTopOfBook().
+ */
+BboSnapshot LimitOrderBook::GetBbo() const
+{
+    return bbo->Load();
+}
+
+/**
+ * The indicative uncross published with the last BBO; all zero outside an
+ * auction. Safe to call from any thread.
+ */
+UncrossResult LimitOrderBook::GetIndicativeUncross() const
+{
+    return bbo->Load().indicative;
+}
+
+/**
+ * Drops emptied levels off the top of both heaps and publishes the best
+ * level of each side, plus the indicative uncross while in an auction.
+ * Called on the owning thread after every change to the resting orders or
+ * the phase, so the snapshot never lags the book.
+ */
+void LimitOrderBook::PublishBbo()
 {
+    CleanupPriorityQueue(ask_order_pq);
+    CleanupPriorityQueue(bid_order_pq);
 
-    double best_ask_price = 0.0;
-    int best_ask_volume = 0;
-    bool has_ask = false;
+    BboSnapshot snapshot{DepthLevel{0.0, 0}, DepthLevel{0.0, 0}, update_sequence, phase, UncrossResult{0.0, 0, 0}};
+    if (phase == TradingPhase::AUCTION)
+    {
+        snapshot.indicative = ComputeIndicativeUncross();
+    }
+    if (!bid_order_pq.empty())
+    {
+        const PriceLevelQueue &level = *bid_order_pq.top();
+        snapshot.bid = DepthLevel{level.GetPrice(), static_cast<int>(level.GetVolume())};
+    }
+    if (!ask_order_pq.empty())
+    {
+        const PriceLevelQueue &level = *ask_order_pq.top();
+        snapshot.ask = DepthLevel{level.GetPrice(), static_cast<int>(level.GetVolume())};
+    }
+    bbo->Store(snapshot);
+}
 
-    while (!ask_order_pq.empty())
+/**
+ * Aggregated depth of one side: the best `max_levels` price levels with the
+ * volume resting at each, best price first.
+ *
+ * @param levels Output array with room for `max_levels` entries.
+ * @return Number of levels written (fewer if the side is shallower).
+ */
+size_t LimitOrderBook::GetDepth(OrderType side, DepthLevel *levels, size_t max_levels)
+{
+    if (side == OrderType::BID)
     {
-        auto ask_top = ask_order_pq.top();
-        // If top pointer is invalid or empty, pop and continue
-        if (!ask_top || !ask_top->HasOrders())
-        {
-            ask_order_pq.pop();
-            continue;
-        }
-        double price = ask_top->GetPrice();
-        int vol = ask_volume_at_price[price];
-        if (vol > 0)
-        {
-            best_ask_price = price;
-            best_ask_volume = vol;
-            has_ask = true;
-        }
-        // If volume is zero, also pop. Otherwise we found our best ask
-        if (vol == 0)
-        {
-            ask_order_pq.pop();
-            continue;
-        }
-        break;
+        return CollectDepth<OrderType::BID>(levels, max_levels);
     }
+    return CollectDepth<OrderType::ASK>(levels, max_levels);
+}
 
-    double best_bid_price = 0.0;
-    int best_bid_volume = 0;
-    bool has_bid = false;
+/**
+ * Pops the best non-empty levels off the side's heap and pushes them back,
+ * touching O(k log L) entries instead of sorting every level of the side.
+ * Emptied levels met on the way are dropped for good.
+ */
+template <OrderType Side>
+size_t LimitOrderBook::CollectDepth(DepthLevel *levels, size_t max_levels)
+{
+    PriceLevelHeap<Side> &heap = LevelHeap<Side>();
 
-    while (!bid_order_pq.empty())
+    depth_scratch.clear();
+    while (depth_scratch.size() < max_levels && !heap.empty())
     {
-        auto bid_top = bid_order_pq.top();
-        if (!bid_top || !bid_top->HasOrders())
+        std::shared_ptr<PriceLevelQueue> level = heap.PopTop();
+        if (level->HasOrders())
         {
-            bid_order_pq.pop();
-            continue;
-        }
-        double price = bid_top->GetPrice();
-        int vol = bid_volume_at_price[price];
-        if (vol > 0)
-        {
-            best_bid_price = price;
-            best_bid_volume = vol;
-            has_bid = true;
-        }
-        if (vol == 0)
-        {
-            bid_order_pq.pop();
-            continue;
+            depth_scratch.push_back(std::move(level));
         }
-        break;
     }
 
-    // If neither ask nor bid exists, no top
-    if (!has_ask && !has_bid)
+    const size_t count = depth_scratch.size();
+    for (size_t i = 0; i < count; ++i)
     {
-        return TopOfBook(false, 0.0, 0, 0.0, 0);
+        const PriceLevelQueue &level = *depth_scratch[i];
+        levels[i] = DepthLevel{level.GetPrice(), static_cast<int>(level.GetVolume())};
+        heap.push(std::move(depth_scratch[i]));
     }
-
-    // Otherwise, we have at least one side
-    //    If no ask, we keep ask_price=0, ask_volume=0
-    //    If no bid, we keep bid_price=0, bid_volume=0
-    std::cout << "INSIDE LOB" << "\n";
-    std::cout << "BID: " << best_bid_price << " " << best_bid_volume << "\n";
-    std::cout << "ASK: " << best_ask_price << " " << best_ask_volume << "\n";
-
-    return TopOfBook(true, best_ask_price, best_ask_volume, best_bid_price, best_bid_volume);
+    depth_scratch.clear();
+    return count;
 }
 
 std::vector<Trade> LimitOrderBook::GetPreviousTrades(int num_previous_trades)
@@ -446,3 +1178,28 @@ std::vector<Trade> LimitOrderBook::GetPreviousTrades(int num_previous_trades)
     int start_idx = std::max(0, static_cast<int>(filled_trades.size()) - num_previous_trades);
     return std::vector<Trade>(filled_trades.begin() + start_idx, filled_trades.end());
 }
+
+size_t LimitOrderBook::GetTradeCount() const
+{
+    return filled_trades.size();
+}
+
+const Trade &LimitOrderBook::GetTrade(size_t index) const
+{
+    return filled_trades.at(index);
+}
+
+uint64_t LimitOrderBook::GetUpdateSequence() const
+{
+    return update_sequence;
+}
+
+void LimitOrderBook::ResumeIdsAfter(int64_t id)
+{
+    id_generator.AdvancePast(id);
+}
+
+size_t LimitOrderBook::GetRestingOrderCount() const
+{
+    return order_pool.GetLiveCount();
+}
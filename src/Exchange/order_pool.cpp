@@ -0,0 +1,50 @@
+#include "exchange/order_pool.hpp"
+#include "exchange/order_node.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+OrderPool::OrderPool()
+    : next_slot(0)
+{
+}
+
+/**
+ * Copies an order's hot and cold parts into a free slot, growing the pool by
+ * one chunk when every slot is in use.
+ *
+ * @return The slot, valid until Free(slot).
+ */
+uint32_t OrderPool::Allocate(const OrderNode &hot, const OrderInfo &cold)
+{
+    uint32_t slot;
+    if (!free_slots.empty())
+    {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+    else
+    {
+        if (next_slot == hot_chunks.size() * kChunkSize)
+        {
+            hot_chunks.emplace_back(new OrderNode[kChunkSize]);
+            cold_chunks.emplace_back(new OrderInfo[kChunkSize]);
+        }
+        slot = next_slot++;
+    }
+
+    Hot(slot) = hot;
+    cold_chunks[slot >> kChunkBits][slot & (kChunkSize - 1)] = cold;
+    return slot;
+}
+
+void OrderPool::Free(uint32_t slot)
+{
+    free_slots.push_back(slot);
+}
+
+size_t OrderPool::GetLiveCount() const
+{
+    return next_slot - free_slots.size();
+}
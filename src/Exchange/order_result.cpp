@@ -1,13 +1,14 @@
 #include "exchange/order_result.hpp"
 #include "exchange/trade.hpp"
+#include <utility>
 #include <variant>
 
 OrderResult::OrderResult(
     bool trades_executed,
     std::vector<Trade> trades,
     bool order_added_to_book,
-    int order_id)
+    int64_t order_id)
     : trades_executed(trades_executed),
-      trades(trades),
+      trades(std::move(trades)),
       order_added_to_book(order_added_to_book),
       order_id(order_id) {}
@@ -5,9 +5,10 @@
 
 PriceLevelQueue::PriceLevelQueue(double price)
     : price(price),
-      front(-1, "dummy_front", 0, 0.0, OrderType::ASK, time(nullptr), "dummy", nullptr, nullptr), // Initialize dummy front
-      back(-1, "dummy_back", 0, 0.0, OrderType::ASK, time(nullptr), "dummy", nullptr, nullptr),   // Initialize dummy back
-      has_orders(false)
+      front(-1), // Initialize dummy front
+      back(-1),  // Initialize dummy back
+      has_orders(false),
+      volume(0)
 {
     front.next = &back;
     back.prev = &front;
@@ -18,14 +19,15 @@ double PriceLevelQueue::GetPrice() const
     return price;
 }
 
-void PriceLevelQueue::AddOrder(OrderNode &order)
+void PriceLevelQueue::AddOrder(OrderNode &order, double order_price)
 {
-    if (order.price != price)
+    if (order_price != price)
     {
         throw std::runtime_error("Order price does not match PriceLevelQueue price.");
     }
 
     has_orders = true;
+    volume += order.volume;
 
     order.prev = back.prev;
     order.next = &back;
@@ -42,10 +44,18 @@ bool PriceLevelQueue::HasOrders() const
     return has_orders;
 }
 
-void PriceLevelQueue::RemoveOrder(OrderNode &order)
+int64_t PriceLevelQueue::GetVolume() const
+{
+    return volume;
+}
+
+void PriceLevelQueue::ReduceVolume(int filled)
 {
-    std::cout << "[PLQ] Trying to cancel order: " << order.order_id << std::endl;
+    volume -= filled;
+}
 
+void PriceLevelQueue::RemoveOrder(OrderNode &order)
+{
     // Check if the order is actually part of this PriceLevelQueue
     if (order.prev == nullptr && order.next == nullptr)
     {
@@ -68,17 +78,25 @@ void PriceLevelQueue::RemoveOrder(OrderNode &order)
     // Clean up dangling references
     order.prev = nullptr;
     order.next = nullptr;
-
-    std::cout << "[PLQ] Order " << order.order_id << " removed successfully." << std::endl;
+    volume -= order.volume;
 
     // Check if PLQ is empty
     if (front.next == &back)
     {
         has_orders = false;
-        std::cout << "[PLQ] PriceLevelQueue is now empty." << std::endl;
     }
 }
 
+OrderNode *PriceLevelQueue::Begin()
+{
+    return front.next;
+}
+
+const OrderNode *PriceLevelQueue::End() const
+{
+    return &back;
+}
+
 const OrderNode *PriceLevelQueue::GetFrontNext() const
 {
     return front.next;
@@ -120,6 +138,7 @@ OrderNode &PriceLevelQueue::Pop()
     // Clean up dangling references in the removed node
     node_to_remove->next = nullptr;
     node_to_remove->prev = nullptr;
+    volume -= node_to_remove->volume;
 
     // Check if the queue is now empty
     if (front.next == &back)
@@ -11,3 +11,10 @@ TopOfBook::TopOfBook(
       ask_volume(ask_volume),
       bid_price(bid_price),
       bid_volume(bid_volume) {}
+
+TopOfBook::TopOfBook(const BboSnapshot &snapshot)
+    : TopOfBook(snapshot.bid.volume != 0 || snapshot.ask.volume != 0,
+                static_cast<int>(snapshot.ask.price),
+                snapshot.ask.volume,
+                static_cast<int>(snapshot.bid.price),
+                snapshot.bid.volume) {}
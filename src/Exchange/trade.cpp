@@ -2,7 +2,7 @@
 #include <string>
 #include <ctime>
 
-Trade::Trade(int trade_id,
+Trade::Trade(int64_t trade_id,
              int price,
              int volume,
              time_t timestamp,
@@ -0,0 +1,250 @@
+#include "feed/feed_publisher.hpp"
+#include "exchange/limit_order_book.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    std::runtime_error FeedError(const std::string &what)
+    {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    // Volume at `price` among `levels`, 0 if absent
+    int FindVolume(const DepthLevel *levels, uint32_t num_levels, double price)
+    {
+        for (uint32_t i = 0; i < num_levels; ++i)
+        {
+            if (levels[i].price == price)
+            {
+                return levels[i].volume;
+            }
+        }
+        return 0;
+    }
+}
+
+/**
+ * Opens the multicast sender. Loopback delivery is enabled and the TTL is 1,
+ * so with the default options nothing leaves the host.
+ *
+ * @param options group, port and interface to publish on
+ * @param tickers tickers in Exchange order
+ * @throws std::runtime_error if the socket cannot be set up
+ */
+FeedPublisher::FeedPublisher(const FeedOptions &options, const std::vector<std::string> &tickers)
+    : socket_fd(-1),
+      group_address{},
+      session(static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count())),
+      tickers(tickers),
+      next_sequence(1),
+      packet{},
+      dropped_packets(0),
+      last_send(std::chrono::steady_clock::now()),
+      books(tickers.size(), nullptr),
+      is_dirty(tickers.size(), false),
+      scratch{},
+      published_books(tickers.size(), FeedBook{}),
+      published_sequence(0)
+{
+    for (const std::string &ticker : tickers)
+    {
+        if (ticker.size() >= kFeedTickerSize)
+        {
+            throw std::runtime_error("Ticker too long for the feed: " + ticker);
+        }
+    }
+
+    group_address.sin_family = AF_INET;
+    group_address.sin_port = htons(options.port);
+    in_addr interface_address{};
+    if (inet_pton(AF_INET, options.group.c_str(), &group_address.sin_addr) != 1 ||
+        inet_pton(AF_INET, options.interface_address.c_str(), &interface_address) != 1)
+    {
+        throw std::runtime_error("Invalid feed address " + options.group + " / " + options.interface_address);
+    }
+
+    socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_fd < 0)
+    {
+        throw FeedError("Feed socket failed");
+    }
+    unsigned char loop = 1;
+    unsigned char ttl = 1;
+    if (setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_IF, &interface_address, sizeof(interface_address)) < 0 ||
+        setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0 ||
+        setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0)
+    {
+        std::runtime_error error = FeedError("Feed multicast setup failed");
+        close(socket_fd);
+        throw error;
+    }
+    packet.header.magic = kFeedMagic;
+    packet.header.session = session;
+}
+
+FeedPublisher::~FeedPublisher()
+{
+    close(socket_fd);
+}
+
+void FeedPublisher::OnTrade(TickerHandle ticker, const Fill &fill)
+{
+    FeedMessage &message = AppendMessage(FeedMessageType::EXECUTION, ticker.index);
+    message.side = fill.aggressor_side;
+    message.volume = fill.trade.volume;
+    message.price = fill.price;
+    message.trade_id = fill.trade.trade_id;
+    message.timestamp = static_cast<int64_t>(fill.trade.timestamp);
+}
+
+void FeedPublisher::OnBookUpdate(TickerHandle ticker, LimitOrderBook &book)
+{
+    books[ticker.index] = &book;
+    if (!is_dirty[ticker.index])
+    {
+        is_dirty[ticker.index] = true;
+        dirty_tickers.push_back(ticker.index);
+    }
+}
+
+/**
+ * Sends the L2 changes of every dirty ticker plus any buffered trades; with
+ * nothing to send, a heartbeat goes out once per kHeartbeatInterval.
+ *
+ * @return number of tickers whose levels were diffed
+ */
+size_t FeedPublisher::Flush()
+{
+    size_t published = dirty_tickers.size();
+    // Trades alone move the snapshot sequence too
+    if (published > 0 || published_sequence != next_sequence - 1)
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        for (uint32_t index : dirty_tickers)
+        {
+            FeedBook &before = published_books[index];
+            LimitOrderBook &book = *books[index];
+            scratch.bid_levels = static_cast<uint32_t>(book.GetDepth(OrderType::BID, scratch.bids, kFeedDepth));
+            scratch.ask_levels = static_cast<uint32_t>(book.GetDepth(OrderType::ASK, scratch.asks, kFeedDepth));
+            PublishLevelChanges(index, OrderType::BID, before.bids, before.bid_levels, scratch.bids, scratch.bid_levels);
+            PublishLevelChanges(index, OrderType::ASK, before.asks, before.ask_levels, scratch.asks, scratch.ask_levels);
+            before = scratch;
+            is_dirty[index] = false;
+        }
+        dirty_tickers.clear();
+        published_sequence = next_sequence - 1;
+    }
+
+    if (packet.header.message_count > 0)
+    {
+        SendPacket();
+    }
+    else if (std::chrono::steady_clock::now() - last_send >= kHeartbeatInterval)
+    {
+        packet.header.sequence = next_sequence;
+        SendPacket();
+    }
+    return published;
+}
+
+// Deletes for levels that left the top of book, then every new or changed level
+void FeedPublisher::PublishLevelChanges(uint32_t ticker, OrderType side,
+                                        const DepthLevel *before, uint32_t before_levels,
+                                        const DepthLevel *after, uint32_t after_levels)
+{
+    for (uint32_t i = 0; i < before_levels; ++i)
+    {
+        if (FindVolume(after, after_levels, before[i].price) == 0)
+        {
+            FeedMessage &message = AppendMessage(FeedMessageType::LEVEL_UPDATE, ticker);
+            message.side = side;
+            message.price = before[i].price;
+            message.volume = 0;
+        }
+    }
+    for (uint32_t i = 0; i < after_levels; ++i)
+    {
+        if (FindVolume(before, before_levels, after[i].price) != after[i].volume)
+        {
+            FeedMessage &message = AppendMessage(FeedMessageType::LEVEL_UPDATE, ticker);
+            message.side = side;
+            message.price = after[i].price;
+            message.volume = after[i].volume;
+        }
+    }
+}
+
+// Sequences the next message, sending the current packet first if it is full
+FeedMessage &FeedPublisher::AppendMessage(FeedMessageType type, uint32_t ticker)
+{
+    if (packet.header.message_count == kFeedMaxMessagesPerPacket)
+    {
+        SendPacket();
+    }
+    if (packet.header.message_count == 0)
+    {
+        packet.header.sequence = next_sequence;
+    }
+    FeedMessage &message = packet.messages[packet.header.message_count++];
+    message = FeedMessage{};
+    message.type = type;
+    message.ticker = ticker;
+    ++next_sequence;
+    return message;
+}
+
+void FeedPublisher::SendPacket()
+{
+    size_t size = sizeof(FeedPacketHeader) + packet.header.message_count * sizeof(FeedMessage);
+    ssize_t sent = sendto(socket_fd, &packet, size, MSG_DONTWAIT,
+                          reinterpret_cast<const sockaddr *>(&group_address), sizeof(group_address));
+    if (sent != static_cast<ssize_t>(size))
+    {
+        ++dropped_packets;
+    }
+    packet.header.message_count = 0;
+    last_send = std::chrono::steady_clock::now();
+}
+
+/**
+ * Copies the books as of the last Flush. Safe to call from any thread.
+ *
+ * @param header receives the session, and the sequence the books reflect
+ * @param books receives one entry per ticker, in TickerHandle order
+ */
+void FeedPublisher::CopySnapshot(FeedSnapshotHeader &header, std::vector<FeedSnapshotTicker> &books) const
+{
+    books.resize(tickers.size());
+    for (size_t i = 0; i < tickers.size(); ++i)
+    {
+        std::memset(books[i].name, 0, kFeedTickerSize);
+        tickers[i].copy(books[i].name, kFeedTickerSize - 1);
+    }
+
+    header = FeedSnapshotHeader{};
+    header.magic = kFeedMagic;
+    header.session = session;
+    header.num_tickers = static_cast<uint32_t>(tickers.size());
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    header.sequence = published_sequence;
+    for (size_t i = 0; i < tickers.size(); ++i)
+    {
+        books[i].book = published_books[i];
+    }
+}
+
+uint32_t FeedPublisher::GetSession() const
+{
+    return session;
+}
+
+uint64_t FeedPublisher::GetDroppedPackets() const
+{
+    return dropped_packets;
+}
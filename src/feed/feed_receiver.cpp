@@ -0,0 +1,302 @@
+#include "feed/feed_receiver.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    std::runtime_error FeedError(const std::string &what)
+    {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    bool ReadAll(int fd, void *data, size_t size)
+    {
+        char *bytes = static_cast<char *>(data);
+        while (size > 0)
+        {
+            ssize_t received = recv(fd, bytes, size, 0);
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (received <= 0)
+            {
+                return false;
+            }
+            bytes += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    // Bids rank by higher price, asks by lower
+    bool IsBetter(OrderType side, double price, double other)
+    {
+        return side == OrderType::BID ? price > other : price < other;
+    }
+}
+
+/**
+ * @param options group, port and snapshot service of the feed
+ * @throws std::runtime_error if the group cannot be joined or the first
+ * snapshot cannot be loaded
+ */
+FeedReceiver::FeedReceiver(const FeedOptions &options)
+    : options(options),
+      socket_fd(-1),
+      packet{},
+      synced(false),
+      session(0),
+      next_sequence(0),
+      gaps(0),
+      recoveries(0)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.port);
+    ip_mreq membership{};
+    if (inet_pton(AF_INET, options.group.c_str(), &address.sin_addr) != 1 ||
+        inet_pton(AF_INET, options.group.c_str(), &membership.imr_multiaddr) != 1 ||
+        inet_pton(AF_INET, options.interface_address.c_str(), &membership.imr_interface) != 1)
+    {
+        throw std::runtime_error("Invalid feed address " + options.group + " / " + options.interface_address);
+    }
+
+    // Several receivers on one host share the port
+    socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int reuse = 1;
+    if (socket_fd < 0 ||
+        setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+        bind(socket_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        setsockopt(socket_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0)
+    {
+        std::runtime_error error = FeedError("Joining feed " + options.group + " failed");
+        if (socket_fd >= 0)
+        {
+            close(socket_fd);
+        }
+        throw error;
+    }
+    // Joined first, so nothing published after the snapshot is missed
+    if (!Recover())
+    {
+        close(socket_fd);
+        throw std::runtime_error("Feed snapshot service unavailable on port " + std::to_string(options.snapshot_port));
+    }
+    synced = true;
+}
+
+FeedReceiver::~FeedReceiver()
+{
+    close(socket_fd);
+}
+
+/**
+ * Receives and applies at most one packet.
+ *
+ * @param timeout_millis how long to wait for a packet (0 = don't wait)
+ * @param trades optional output for the trades in the packet
+ * @return false if no valid packet arrived in time
+ */
+bool FeedReceiver::Poll(int timeout_millis, std::vector<FeedMessage> *trades)
+{
+    pollfd receiver{socket_fd, POLLIN, 0};
+    if (poll(&receiver, 1, timeout_millis) <= 0)
+    {
+        return false;
+    }
+    ssize_t size = recv(socket_fd, &packet, sizeof(packet), 0);
+    if (size < static_cast<ssize_t>(sizeof(FeedPacketHeader)) ||
+        packet.header.magic != kFeedMagic ||
+        packet.header.message_count > kFeedMaxMessagesPerPacket ||
+        static_cast<size_t>(size) != sizeof(FeedPacketHeader) + packet.header.message_count * sizeof(FeedMessage))
+    {
+        return false;
+    }
+
+    const FeedPacketHeader header = packet.header;
+    if (synced && (header.session != session || header.sequence > next_sequence))
+    {
+        ++gaps;
+        synced = false;
+    }
+    if (!synced)
+    {
+        // A snapshot older than this packet would leave a hole: retry later
+        synced = Recover() && header.session == session && header.sequence <= next_sequence;
+        if (!synced)
+        {
+            return true;
+        }
+    }
+
+    for (uint16_t i = 0; i < header.message_count; ++i)
+    {
+        if (header.sequence + i < next_sequence)
+        {
+            continue; // duplicate, or already in the snapshot
+        }
+        const FeedMessage &message = packet.messages[i];
+        if (message.ticker < books.size())
+        {
+            if (message.type == FeedMessageType::LEVEL_UPDATE)
+            {
+                ApplyLevelUpdate(message);
+            }
+            else if (trades != nullptr)
+            {
+                trades->push_back(message);
+            }
+        }
+        next_sequence = header.sequence + i + 1;
+    }
+    return true;
+}
+
+/**
+ * Replaces every book with the snapshot service's copy and resumes after
+ * the sequence it reflects.
+ *
+ * @return false if the snapshot could not be loaded; state is unchanged
+ */
+bool FeedReceiver::Recover()
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.snapshot_port);
+    inet_pton(AF_INET, options.interface_address.c_str(), &address.sin_addr);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+    FeedSnapshotHeader header;
+    std::vector<FeedSnapshotTicker> snapshot;
+    bool loaded = ReadAll(fd, &header, sizeof(header)) && header.magic == kFeedMagic;
+    if (loaded)
+    {
+        snapshot.resize(header.num_tickers);
+        loaded = ReadAll(fd, snapshot.data(), snapshot.size() * sizeof(FeedSnapshotTicker));
+    }
+    close(fd);
+    if (!loaded)
+    {
+        return false;
+    }
+
+    session = header.session;
+    next_sequence = header.sequence + 1;
+    tickers.resize(snapshot.size());
+    books.resize(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        tickers[i] = std::string(snapshot[i].name, strnlen(snapshot[i].name, kFeedTickerSize));
+        books[i] = snapshot[i].book;
+    }
+    ++recoveries;
+    return true;
+}
+
+// Keeps the side sorted best first; volume 0 removes the level
+void FeedReceiver::ApplyLevelUpdate(const FeedMessage &message)
+{
+    FeedBook &book = books[message.ticker];
+    bool is_bid = message.side == OrderType::BID;
+    DepthLevel *levels = is_bid ? book.bids : book.asks;
+    uint32_t &num_levels = is_bid ? book.bid_levels : book.ask_levels;
+
+    uint32_t position = 0;
+    while (position < num_levels && IsBetter(message.side, levels[position].price, message.price))
+    {
+        ++position;
+    }
+    bool exists = position < num_levels && levels[position].price == message.price;
+    if (message.volume == 0)
+    {
+        if (exists)
+        {
+            std::memmove(levels + position, levels + position + 1, (num_levels - position - 1) * sizeof(DepthLevel));
+            --num_levels;
+        }
+        return;
+    }
+    if (exists)
+    {
+        levels[position].volume = message.volume;
+        return;
+    }
+    if (position == kFeedDepth)
+    {
+        return; // worse than every level kept
+    }
+    // The publisher deletes a level before another takes its place, so a
+    // full side only happens if messages were lost; the worst level goes
+    uint32_t kept = num_levels < kFeedDepth ? num_levels : kFeedDepth - 1;
+    std::memmove(levels + position + 1, levels + position, (kept - position) * sizeof(DepthLevel));
+    levels[position] = DepthLevel{message.price, message.volume};
+    num_levels = kept + 1;
+}
+
+TickerHandle FeedReceiver::ResolveTicker(const std::string &ticker) const
+{
+    for (uint32_t i = 0; i < tickers.size(); ++i)
+    {
+        if (tickers[i] == ticker)
+        {
+            return TickerHandle{i};
+        }
+    }
+    throw std::out_of_range("Ticker not found: " + ticker);
+}
+
+const FeedBook &FeedReceiver::GetBook(TickerHandle ticker) const
+{
+    if (ticker.index >= books.size())
+    {
+        throw std::runtime_error("Ticker not found");
+    }
+    return books[ticker.index];
+}
+
+TopOfBook FeedReceiver::GetTopOfBook(TickerHandle ticker) const
+{
+    const FeedBook &book = GetBook(ticker);
+    bool has_bid = book.bid_levels > 0;
+    bool has_ask = book.ask_levels > 0;
+    return TopOfBook(has_bid || has_ask,
+                     has_ask ? book.asks[0].price : 0,
+                     has_ask ? book.asks[0].volume : 0,
+                     has_bid ? book.bids[0].price : 0,
+                     has_bid ? book.bids[0].volume : 0);
+}
+
+bool FeedReceiver::IsSynced() const
+{
+    return synced;
+}
+
+uint64_t FeedReceiver::GetNextSequence() const
+{
+    return next_sequence;
+}
+
+uint64_t FeedReceiver::GetGapCount() const
+{
+    return gaps;
+}
+
+uint64_t FeedReceiver::GetRecoveryCount() const
+{
+    return recoveries;
+}
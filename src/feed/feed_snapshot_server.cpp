@@ -0,0 +1,114 @@
+#include "feed/feed_snapshot_server.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    constexpr int kStopCheckMillis = 100;
+
+    bool WriteAll(int fd, const void *data, size_t size)
+    {
+        const char *bytes = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+}
+
+/**
+ * Binds the listening socket and starts serving.
+ *
+ * @throws std::runtime_error if the address cannot be bound
+ */
+FeedSnapshotServer::FeedSnapshotServer(FeedPublisher &publisher, const FeedOptions &options)
+    : publisher(publisher), listen_fd(-1), port(0), stop(false)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.snapshot_port);
+    if (inet_pton(AF_INET, options.interface_address.c_str(), &address.sin_addr) != 1)
+    {
+        throw std::runtime_error("Invalid snapshot address " + options.interface_address);
+    }
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    socklen_t length = sizeof(address);
+    if (listen_fd < 0 ||
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+        bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0 ||
+        getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+    {
+        std::runtime_error error("Snapshot service failed on port " + std::to_string(options.snapshot_port) +
+                                 ": " + std::strerror(errno));
+        if (listen_fd >= 0)
+        {
+            close(listen_fd);
+        }
+        throw error;
+    }
+    port = ntohs(address.sin_port);
+    thread = std::thread(&FeedSnapshotServer::Serve, this);
+}
+
+FeedSnapshotServer::~FeedSnapshotServer()
+{
+    stop.store(true);
+    thread.join();
+    close(listen_fd);
+}
+
+void FeedSnapshotServer::Serve()
+{
+    pollfd listener{listen_fd, POLLIN, 0};
+    while (!stop.load())
+    {
+        if (poll(&listener, 1, kStopCheckMillis) <= 0)
+        {
+            continue;
+        }
+        int client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd >= 0)
+        {
+            SendSnapshot(client_fd);
+            close(client_fd);
+        }
+    }
+}
+
+void FeedSnapshotServer::SendSnapshot(int client_fd)
+{
+    FeedSnapshotHeader header;
+    std::vector<FeedSnapshotTicker> books;
+    publisher.CopySnapshot(header, books);
+    if (WriteAll(client_fd, &header, sizeof(header)))
+    {
+        WriteAll(client_fd, books.data(), books.size() * sizeof(FeedSnapshotTicker));
+    }
+}
+
+uint16_t FeedSnapshotServer::GetPort() const
+{
+    return port;
+}
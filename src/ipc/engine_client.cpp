@@ -0,0 +1,361 @@
+#include "ipc/engine_client.hpp"
+#include "exchange/trade.hpp"
+#include "risk/risk_check.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    std::string FixedString(const char *field, size_t field_size)
+    {
+        return std::string(field, strnlen(field, field_size));
+    }
+
+    GatewayRequest MakeRequest(uint64_t request_id, GatewayRequestType type)
+    {
+        GatewayRequest request{};
+        request.request_id = request_id;
+        request.type = type;
+        request.last_chunk = true;
+        return request;
+    }
+
+    // The last response a request gets
+    bool IsFinal(const GatewayResponse &response)
+    {
+        return response.type != GatewayResponseType::FILL && response.last_chunk;
+    }
+}
+
+/**
+ * Claims the first free channel of the region for this thread.
+ *
+ * @param region region attached with AttachGatewayRegion
+ */
+EngineClient::EngineClient(GatewayRegion &region)
+    : region(region), channel(nullptr), next_request_id(0)
+{
+    Claim();
+}
+
+EngineClient::~EngineClient()
+{
+    channel->gateway_pid.store(0, std::memory_order_release);
+}
+
+/**
+ * Takes the first channel that is free and not still waiting for the
+ * engine to reset it after a drop.
+ *
+ * @throws std::runtime_error if every channel is taken
+ */
+void EngineClient::Claim()
+{
+    const int32_t pid = static_cast<int32_t>(getpid());
+    channel = nullptr;
+    for (uint32_t i = 0; i < kMaxGatewayChannels && channel == nullptr; ++i)
+    {
+        if (region.channels[i].dropped.load(std::memory_order_acquire) != 0)
+        {
+            continue;
+        }
+        int32_t expected = 0;
+        if (region.channels[i].gateway_pid.compare_exchange_strong(expected, pid, std::memory_order_acq_rel))
+        {
+            channel = &region.channels[i];
+        }
+    }
+    if (channel == nullptr)
+    {
+        throw std::runtime_error("No free gateway channel");
+    }
+    // Ids never repeat across claims, so a new client skips any answers
+    // still queued for the channel's previous owner
+    uint64_t session = region.sessions.fetch_add(1, std::memory_order_relaxed) + 1;
+    next_request_id = session << 32;
+    // Nothing sent on the old channel will be answered
+    in_flight.clear();
+    held.clear();
+}
+
+/**
+ * Id for a new request. A channel the engine dropped is handed back for it
+ * to reset and a fresh one claimed first, so the gateway recovers on its
+ * next request.
+ *
+ * @throws std::runtime_error if kMaxGatewayPipeline requests are in flight
+ */
+uint64_t EngineClient::NextRequestId()
+{
+    if (channel->dropped.load(std::memory_order_acquire) != 0)
+    {
+        channel->gateway_pid.store(0, std::memory_order_release);
+        Claim();
+    }
+    if (in_flight.size() >= kMaxGatewayPipeline)
+    {
+        throw std::runtime_error("Too many gateway requests in flight");
+    }
+    in_flight.push_back(++next_request_id);
+    return next_request_id;
+}
+
+/**
+ * @throws std::runtime_error if the engine died or dropped this channel
+ */
+void EngineClient::CheckEngine() const
+{
+    if (!IsProcessAlive(region.engine_pid.load(std::memory_order_acquire)))
+    {
+        throw std::runtime_error("Matching engine is not running");
+    }
+    if (channel->dropped.load(std::memory_order_acquire) != 0)
+    {
+        throw std::runtime_error("Matching engine dropped the channel");
+    }
+}
+
+TickerHandle EngineClient::ResolveTicker(const std::string &ticker) const
+{
+    for (uint32_t i = 0; i < region.num_tickers; ++i)
+    {
+        if (ticker == FixedString(region.tickers[i], kGatewayTickerSize))
+        {
+            return TickerHandle{i};
+        }
+    }
+    throw std::out_of_range("Ticker not found: " + ticker);
+}
+
+std::vector<std::string> EngineClient::GetTickers() const
+{
+    std::vector<std::string> tickers;
+    for (uint32_t i = 0; i < region.num_tickers; ++i)
+    {
+        tickers.push_back(FixedString(region.tickers[i], kGatewayTickerSize));
+    }
+    return tickers;
+}
+
+EngineLoad EngineClient::GetEngineLoad() const
+{
+    return ReadEngineLoad(region);
+}
+
+int64_t EngineClient::HandleOrder(
+    const std::string &user_id,
+    OrderType order_type,
+    int volume,
+    double price,
+    TickerHandle ticker,
+    ExecutionSink &sink)
+{
+    return CollectOrder(SubmitOrder(user_id, order_type, volume, price, ticker), sink);
+}
+
+bool EngineClient::CancelOrder(TickerHandle ticker, int64_t order_id)
+{
+    return CollectCancel(SubmitCancel(ticker, order_id));
+}
+
+std::string EngineClient::Query(const std::string &request_json)
+{
+    std::string response;
+    Query(request_json, response);
+    return response;
+}
+
+void EngineClient::Query(std::string_view request_json, std::string &response)
+{
+    CollectQuery(SubmitQuery(request_json), response);
+}
+
+uint64_t EngineClient::SubmitOrder(
+    const std::string &user_id,
+    OrderType order_type,
+    int volume,
+    double price,
+    TickerHandle ticker)
+{
+    GatewayRequest request = MakeRequest(0, GatewayRequestType::NEW_ORDER);
+    request.side = order_type;
+    request.ticker = ticker.index;
+    request.volume = volume;
+    request.price = price;
+    // Checked before an id is taken, so a bad user id leaves nothing in flight
+    CopyFixedString(request.user_id, kGatewayUserIdSize, user_id);
+    request.request_id = NextRequestId();
+    Send(request);
+    return request.request_id;
+}
+
+uint64_t EngineClient::SubmitCancel(TickerHandle ticker, int64_t order_id)
+{
+    GatewayRequest request = MakeRequest(NextRequestId(), GatewayRequestType::CANCEL_ORDER);
+    request.ticker = ticker.index;
+    request.order_id = order_id;
+    Send(request);
+    return request.request_id;
+}
+
+uint64_t EngineClient::SubmitQuery(std::string_view request_json)
+{
+    const uint64_t request_id = NextRequestId();
+    size_t offset = 0;
+    do
+    {
+        GatewayRequest request = MakeRequest(request_id, GatewayRequestType::QUERY);
+        size_t chunk = std::min(kGatewayTextSize, request_json.size() - offset);
+        request_json.copy(request.text, chunk, offset);
+        request.text_size = static_cast<uint16_t>(chunk);
+        offset += chunk;
+        request.last_chunk = offset == request_json.size();
+        Send(request);
+    } while (offset < request_json.size());
+    return request_id;
+}
+
+/**
+ * Replays the engine's FILL responses to a submitted order into `sink`.
+ *
+ * @return order id if the remainder rests on the book, otherwise -1
+ */
+int64_t EngineClient::CollectOrder(uint64_t request_id, ExecutionSink &sink)
+{
+    while (true)
+    {
+        GatewayResponse response = Receive(request_id);
+        switch (response.type)
+        {
+        case GatewayResponseType::FILL:
+        {
+            Trade trade(response.trade_id, response.trade_price, response.volume, static_cast<time_t>(response.timestamp),
+                        FixedString(response.bid_user_id, kGatewayUserIdSize),
+                        FixedString(response.ask_user_id, kGatewayUserIdSize));
+            sink.OnFill(Fill{trade, response.price, response.aggressor_side, response.order_id,
+                             response.resting_remaining_volume, response.resting_order_price});
+            break;
+        }
+        case GatewayResponseType::ORDER_ACCEPTED:
+            return response.order_id;
+        case GatewayResponseType::REJECTED:
+            ThrowRejection(response);
+        default:
+            throw std::runtime_error("Unexpected gateway response to an order");
+        }
+    }
+}
+
+bool EngineClient::CollectCancel(uint64_t request_id)
+{
+    GatewayResponse response = Receive(request_id);
+    if (response.type == GatewayResponseType::REJECTED)
+    {
+        ThrowRejection(response);
+    }
+    return response.volume == 1;
+}
+
+void EngineClient::CollectQuery(uint64_t request_id, std::string &response)
+{
+    while (true)
+    {
+        GatewayResponse gateway_response = Receive(request_id);
+        response.append(gateway_response.text, std::min<size_t>(gateway_response.text_size, kGatewayTextSize));
+        if (gateway_response.last_chunk)
+        {
+            return;
+        }
+    }
+}
+
+void EngineClient::Send(const GatewayRequest &request)
+{
+    uint64_t attempts = 0;
+    while (!channel->requests.TryPush(request))
+    {
+        if (++attempts > kSpinsBeforeYield)
+        {
+            std::this_thread::yield();
+        }
+        if (attempts % kLivenessInterval == 0)
+        {
+            CheckEngine();
+        }
+    }
+}
+
+GatewayResponse EngineClient::Receive(uint64_t request_id)
+{
+    auto waiting = std::find(in_flight.begin(), in_flight.end(), request_id);
+    if (waiting == in_flight.end())
+    {
+        throw std::runtime_error("Gateway request is not in flight");
+    }
+    auto settle = [this, waiting](const GatewayResponse &response)
+    {
+        if (IsFinal(response))
+        {
+            in_flight.erase(waiting);
+        }
+        return response;
+    };
+
+    // Read earlier while collecting another request
+    for (auto it = held.begin(); it != held.end(); ++it)
+    {
+        if (it->request_id == request_id)
+        {
+            GatewayResponse response = *it;
+            held.erase(it);
+            return settle(response);
+        }
+    }
+
+    GatewayResponse response;
+    uint64_t attempts = 0;
+    while (true)
+    {
+        if (channel->responses.TryPop(response))
+        {
+            if (response.request_id == request_id)
+            {
+                return settle(response);
+            }
+            if (std::find(in_flight.begin(), in_flight.end(), response.request_id) != in_flight.end())
+            {
+                held.push_back(response);
+            }
+            continue;
+        }
+        if (++attempts > kSpinsBeforeYield)
+        {
+            std::this_thread::yield();
+        }
+        if (attempts % kLivenessInterval == 0)
+        {
+            CheckEngine();
+        }
+    }
+}
+
+// Reads the rest of a multi-chunk error first, so nothing of the request stays in flight
+void EngineClient::ThrowRejection(const GatewayResponse &response)
+{
+    if (response.reject_reason != 0)
+    {
+        throw RiskRejection(static_cast<RiskCheck>(response.reject_reason));
+    }
+    std::string message(response.text, std::min<size_t>(response.text_size, kGatewayTextSize));
+    for (bool last_chunk = response.last_chunk; !last_chunk;)
+    {
+        GatewayResponse next = Receive(response.request_id);
+        message.append(next.text, std::min<size_t>(next.text_size, kGatewayTextSize));
+        last_chunk = next.last_chunk;
+    }
+    throw std::runtime_error(message);
+}
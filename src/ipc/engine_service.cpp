@@ -0,0 +1,385 @@
+#include "ipc/engine_service.hpp"
+#include "risk/risk_check.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    static_assert(AdmissionOptions{}.shed_orders_depth < EngineService::kMaxRoundDepth,
+                  "Default shed depths must be reachable by one round");
+
+    GatewayResponse MakeResponse(uint64_t request_id, GatewayResponseType type)
+    {
+        GatewayResponse response{};
+        response.request_id = request_id;
+        response.type = type;
+        response.last_chunk = true;
+        return response;
+    }
+
+    std::string FixedString(const char *field, size_t field_size)
+    {
+        return std::string(field, strnlen(field, field_size));
+    }
+
+    AdmissionClass ClassifyQuery(const nlohmann::json &query)
+    {
+        auto action = query.find("action");
+        if (action == query.end() || !action->is_string())
+        {
+            return AdmissionClass::QUERY;
+        }
+        const std::string &name = action->get_ref<const std::string &>();
+        if (name == "cancel_order")
+        {
+            return AdmissionClass::CANCEL;
+        }
+        if (name == "handle_order")
+        {
+            return AdmissionClass::ORDER;
+        }
+        if (name == "get_previous_trades" || name == "get_trades_by_user")
+        {
+            return AdmissionClass::BULK_QUERY;
+        }
+        return AdmissionClass::QUERY;
+    }
+}
+
+void EngineService::FillForwarder::OnFill(const Fill &fill)
+{
+    GatewayResponse response = MakeResponse(request_id, GatewayResponseType::FILL);
+    response.aggressor_side = fill.aggressor_side;
+    response.volume = fill.trade.volume;
+    response.trade_price = fill.trade.price;
+    response.resting_remaining_volume = fill.resting_remaining_volume;
+    response.price = fill.price;
+    response.resting_order_price = fill.resting_order_price;
+    response.order_id = fill.resting_order_id;
+    response.trade_id = fill.trade.trade_id;
+    response.timestamp = static_cast<int64_t>(fill.trade.timestamp);
+    // User ids were checked against the field size when they entered
+    fill.trade.bid_user_id.copy(response.bid_user_id, kGatewayUserIdSize - 1);
+    fill.trade.ask_user_id.copy(response.ask_user_id, kGatewayUserIdSize - 1);
+    service.Respond(channel_index, response);
+}
+
+/**
+ * @param exchange book state served to every gateway; only this service's
+ * thread may touch it while Run/PollOnce is in use
+ * @param region region created with CreateGatewayRegion for the same tickers
+ * @param admission_options backlog at which each class of request is shed
+ */
+EngineService::EngineService(Exchange &exchange, GatewayRegion &region, const AdmissionOptions &admission_options)
+    : exchange(exchange),
+      region(region),
+      request_handler(exchange),
+      admission(admission_options),
+      pending_queries(kMaxGatewayChannels),
+      ticker_caches(kMaxGatewayChannels),
+      channel_generations(kMaxGatewayChannels, 0),
+      idle_polls(0)
+{
+}
+
+/**
+ * Drains up to kMaxRequestsPerChannel requests from each claimed channel
+ * into the admission queue, then handles them in priority order.
+ *
+ * @return number of requests received; 0 => idle work was done instead
+ */
+size_t EngineService::PollOnce()
+{
+    // The batch-auction timer: due batches clear here, on the only thread
+    // that touches the Exchange, before the round's orders join the next one
+    exchange.ClearDueBatches();
+
+    size_t handled = 0;
+    GatewayRequest request;
+    for (uint32_t i = 0; i < kMaxGatewayChannels; ++i)
+    {
+        GatewayChannel &channel = region.channels[i];
+        if (channel.gateway_pid.load(std::memory_order_acquire) == 0 ||
+            channel.dropped.load(std::memory_order_acquire) != 0)
+        {
+            continue;
+        }
+        for (size_t n = 0; n < kMaxRequestsPerChannel && channel.requests.TryPop(request); ++n)
+        {
+            StageRequest(i, request);
+            ++handled;
+        }
+    }
+
+    if (handled > 0)
+    {
+        size_t depth = admission.GetDepth();
+        StagedRequest staged;
+        while (admission.Pop(staged))
+        {
+            // Requests from a gateway that died (and was reset) mid-round go nowhere
+            if (staged.channel_generation == channel_generations[staged.channel_index])
+            {
+                HandleRequest(staged);
+            }
+        }
+        PublishLoad(depth);
+    }
+    else
+    {
+        if (++idle_polls % kReapInterval == 0)
+        {
+            ReapDeadChannels();
+        }
+    }
+    // After the responses: readers see one snapshot per ticker per round
+    exchange.FlushMarketData();
+    return handled;
+}
+
+void EngineService::Run(const std::atomic<bool> &stop)
+{
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        PollOnce();
+    }
+}
+
+/**
+ * Queues one request under its class, answering it at once if shed. QUERY
+ * chunks are only queued when the last one arrives.
+ */
+void EngineService::StageRequest(uint32_t channel_index, const GatewayRequest &request)
+{
+    StagedRequest staged{channel_index, channel_generations[channel_index], request, nullptr};
+    AdmissionClass admission_class = request.type == GatewayRequestType::NEW_ORDER ? AdmissionClass::ORDER
+                                                                                    : AdmissionClass::CANCEL;
+    if (request.type == GatewayRequestType::QUERY)
+    {
+        std::string &pending = pending_queries[channel_index];
+        pending.append(request.text, std::min<size_t>(request.text_size, kGatewayTextSize));
+        if (!request.last_chunk)
+        {
+            return;
+        }
+        // Unparseable text stays null and is reported when handled
+        staged.query = nlohmann::json::parse(pending, nullptr, false);
+        pending.clear();
+        admission_class = staged.query.is_discarded() ? AdmissionClass::QUERY : ClassifyQuery(staged.query);
+    }
+
+    if (!admission.Push(admission_class, staged))
+    {
+        Shed(staged);
+    }
+}
+
+void EngineService::Shed(const StagedRequest &staged)
+{
+    if (staged.request.type == GatewayRequestType::QUERY)
+    {
+        nlohmann::json response = {{"error", "Engine overloaded"}, {"shed", true}};
+        RespondText(staged.channel_index, staged.request.request_id, GatewayResponseType::QUERY_RESULT,
+                    response.dump());
+        return;
+    }
+    RespondText(staged.channel_index, staged.request.request_id, GatewayResponseType::REJECTED, "Engine overloaded");
+}
+
+void EngineService::HandleRequest(const StagedRequest &staged)
+{
+    uint32_t channel_index = staged.channel_index;
+    const GatewayRequest &request = staged.request;
+    if (request.type == GatewayRequestType::QUERY)
+    {
+        HandleQuery(channel_index, request.request_id, staged.query);
+        return;
+    }
+    if (request.ticker >= region.num_tickers)
+    {
+        RespondText(channel_index, request.request_id, GatewayResponseType::REJECTED, "Unknown ticker handle");
+        return;
+    }
+
+    if (request.type == GatewayRequestType::NEW_ORDER)
+    {
+        HandleNewOrder(channel_index, request);
+        return;
+    }
+    try
+    {
+        bool cancelled = exchange.CancelOrder(TickerHandle{request.ticker}, request.order_id);
+        GatewayResponse response = MakeResponse(request.request_id, GatewayResponseType::CANCEL_RESULT);
+        response.order_id = request.order_id;
+        response.volume = cancelled ? 1 : 0;
+        Respond(channel_index, response);
+    }
+    catch (const std::exception &e)
+    {
+        RespondText(channel_index, request.request_id, GatewayResponseType::REJECTED, e.what());
+    }
+}
+
+/**
+ * Runs a NEW_ORDER: FILL responses are streamed while the order matches,
+ * then ORDER_ACCEPTED (or REJECTED) ends the request.
+ */
+void EngineService::HandleNewOrder(uint32_t channel_index, const GatewayRequest &request)
+{
+    FillForwarder forwarder(*this, channel_index, request.request_id);
+    try
+    {
+        int64_t order_id = exchange.HandleOrder(FixedString(request.user_id, kGatewayUserIdSize),
+                                                request.side, request.volume, request.price,
+                                                TickerHandle{request.ticker}, forwarder);
+        GatewayResponse response = MakeResponse(request.request_id, GatewayResponseType::ORDER_ACCEPTED);
+        response.order_id = order_id;
+        Respond(channel_index, response);
+    }
+    catch (const RiskRejection &e)
+    {
+        GatewayResponse response = MakeResponse(request.request_id, GatewayResponseType::REJECTED);
+        response.reject_reason = static_cast<uint8_t>(e.GetReason());
+        Respond(channel_index, response);
+    }
+    catch (const std::exception &e)
+    {
+        RespondText(channel_index, request.request_id, GatewayResponseType::REJECTED, e.what());
+    }
+}
+
+/**
+ * Runs a reassembled QUERY through the same RequestHandler the
+ * single-process server uses.
+ */
+void EngineService::HandleQuery(uint32_t channel_index, uint64_t request_id, const nlohmann::json &query)
+{
+    if (query.is_discarded())
+    {
+        RespondText(channel_index, request_id, GatewayResponseType::QUERY_RESULT,
+                    "{\"error\":\"Exception caught during processing\"}");
+        return;
+    }
+    request_handler.Handle(query, ticker_caches[channel_index], query_response);
+    RespondText(channel_index, request_id, GatewayResponseType::QUERY_RESULT, query_response);
+}
+
+void EngineService::PublishLoad(size_t depth)
+{
+    EngineLoadStats &load = region.load;
+    load.depth.store(depth, std::memory_order_relaxed);
+    load.max_depth.store(admission.GetMaxDepth(), std::memory_order_relaxed);
+    for (size_t i = 0; i < kAdmissionClasses; ++i)
+    {
+        AdmissionClass admission_class = static_cast<AdmissionClass>(i);
+        load.admitted[i].store(admission.GetAdmittedCount(admission_class), std::memory_order_relaxed);
+        load.shed[i].store(admission.GetShedCount(admission_class), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Pushes one response, waiting at most kRespondTimeout for ring space.
+ *
+ * A full ring normally drains within microseconds. A gateway that stops
+ * reading loses its channel instead, as the gateway disconnects a slow
+ * TCP client, so one stalled reader cannot hold up every other channel.
+ */
+void EngineService::Respond(uint32_t channel_index, const GatewayResponse &response)
+{
+    GatewayChannel &channel = region.channels[channel_index];
+    if (channel.gateway_pid.load(std::memory_order_acquire) == 0 ||
+        channel.dropped.load(std::memory_order_relaxed) != 0)
+    {
+        return; // released or dropped mid-request
+    }
+    if (channel.responses.TryPush(response))
+    {
+        return;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + kRespondTimeout;
+    int attempts = 0;
+    while (!channel.responses.TryPush(response))
+    {
+        if (++attempts > kSpinsBeforeYield)
+        {
+            std::this_thread::yield();
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            int32_t pid = channel.gateway_pid.load(std::memory_order_acquire);
+            if (pid == 0 || !IsProcessAlive(pid))
+            {
+                ResetChannel(channel_index);
+            }
+            else
+            {
+                DropChannel(channel_index);
+            }
+            return;
+        }
+    }
+}
+
+void EngineService::RespondText(uint32_t channel_index, uint64_t request_id, GatewayResponseType type, std::string_view text)
+{
+    size_t offset = 0;
+    do
+    {
+        GatewayResponse response = MakeResponse(request_id, type);
+        size_t chunk = std::min(kGatewayTextSize, text.size() - offset);
+        text.copy(response.text, chunk, offset);
+        response.text_size = static_cast<uint16_t>(chunk);
+        offset += chunk;
+        response.last_chunk = offset == text.size();
+        Respond(channel_index, response);
+    } while (offset < text.size());
+}
+
+/**
+ * Stops serving a live gateway's channel; its requests are ignored from
+ * now on. The rings are left alone, since the gateway may still be using
+ * them, until the gateway lets go and ReapDeadChannels resets them.
+ */
+void EngineService::DropChannel(uint32_t channel_index)
+{
+    GatewayChannel &channel = region.channels[channel_index];
+    pending_queries[channel_index].clear();
+    ticker_caches[channel_index].clear();
+    ++channel_generations[channel_index];
+    channel.dropped.store(1, std::memory_order_release);
+    region.load.dropped_channels.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineService::ResetChannel(uint32_t channel_index)
+{
+    GatewayChannel &channel = region.channels[channel_index];
+    channel.requests.Reset();
+    channel.responses.Reset();
+    pending_queries[channel_index].clear();
+    ticker_caches[channel_index].clear();
+    ++channel_generations[channel_index];
+    channel.dropped.store(0, std::memory_order_relaxed);
+    // Release last: a new gateway may claim the channel right after
+    channel.gateway_pid.store(0, std::memory_order_release);
+}
+
+void EngineService::ReapDeadChannels()
+{
+    for (uint32_t i = 0; i < kMaxGatewayChannels; ++i)
+    {
+        GatewayChannel &channel = region.channels[i];
+        int32_t pid = channel.gateway_pid.load(std::memory_order_acquire);
+        // A dropped channel stays unclaimable until the gateway releases it here
+        bool released = pid == 0 && channel.dropped.load(std::memory_order_acquire) != 0;
+        if (released || (pid != 0 && !IsProcessAlive(pid)))
+        {
+            ResetChannel(i);
+        }
+    }
+}
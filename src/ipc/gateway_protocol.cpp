@@ -0,0 +1,100 @@
+#include "ipc/gateway_protocol.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <new>
+#include <signal.h>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * Builds the gateway region inside a freshly created mapping and publishes
+ * the ticker table. Ticker i is served under TickerHandle{i}, matching the
+ * Exchange built from the same list.
+ *
+ * @param memory mapping of at least sizeof(GatewayRegion) bytes
+ * @param tickers tickers in Exchange order
+ */
+GatewayRegion &CreateGatewayRegion(SharedMemory &memory, const std::vector<std::string> &tickers)
+{
+    if (memory.GetSize() < sizeof(GatewayRegion))
+    {
+        throw std::runtime_error("Shared memory too small for the gateway region");
+    }
+    if (tickers.size() > kMaxGatewayTickers)
+    {
+        throw std::runtime_error("Too many tickers for the gateway region");
+    }
+
+    GatewayRegion *region = new (memory.GetData()) GatewayRegion();
+    region->magic = kGatewayMagic;
+    region->version = kGatewayVersion;
+    region->num_tickers = static_cast<uint32_t>(tickers.size());
+    for (size_t i = 0; i < tickers.size(); ++i)
+    {
+        CopyFixedString(region->tickers[i], kGatewayTickerSize, tickers[i]);
+    }
+    region->engine_pid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+    region->ready.store(1, std::memory_order_release);
+    return *region;
+}
+
+/**
+ * Validates a mapping created by the engine and waits (up to 5 s) for it
+ * to be published.
+ *
+ * @param memory mapping opened by name
+ */
+GatewayRegion &AttachGatewayRegion(SharedMemory &memory)
+{
+    if (memory.GetSize() < sizeof(GatewayRegion))
+    {
+        throw std::runtime_error("Shared memory too small for the gateway region");
+    }
+    GatewayRegion *region = static_cast<GatewayRegion *>(memory.GetData());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (region->ready.load(std::memory_order_acquire) == 0)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            throw std::runtime_error("Matching engine did not publish the gateway region");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (region->magic != kGatewayMagic || region->version != kGatewayVersion)
+    {
+        throw std::runtime_error("Gateway region has an unknown layout");
+    }
+    return *region;
+}
+
+bool IsProcessAlive(int32_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+void CopyFixedString(char *field, size_t field_size, const std::string &value)
+{
+    if (value.size() >= field_size)
+    {
+        throw std::runtime_error("Value too long for gateway field: " + value);
+    }
+    value.copy(field, value.size());
+    field[value.size()] = '\0';
+}
+
+EngineLoad ReadEngineLoad(const GatewayRegion &region)
+{
+    EngineLoad load{};
+    load.depth = region.load.depth.load(std::memory_order_relaxed);
+    load.max_depth = region.load.max_depth.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kAdmissionClasses; ++i)
+    {
+        load.admitted[i] = region.load.admitted[i].load(std::memory_order_relaxed);
+        load.shed[i] = region.load.shed[i].load(std::memory_order_relaxed);
+    }
+    load.dropped_channels = region.load.dropped_channels.load(std::memory_order_relaxed);
+    return load;
+}
@@ -0,0 +1,67 @@
+#include "ipc/market_data.hpp"
+#include "ipc/gateway_protocol.hpp"
+
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * Builds the market data region inside a freshly created mapping and
+ * publishes the ticker table. Every book starts empty (update_id 0).
+ *
+ * @param memory mapping of at least sizeof(MarketDataRegion) bytes
+ * @param tickers tickers in Exchange order
+ */
+MarketDataRegion &CreateMarketDataRegion(SharedMemory &memory, const std::vector<std::string> &tickers)
+{
+    if (memory.GetSize() < sizeof(MarketDataRegion))
+    {
+        throw std::runtime_error("Shared memory too small for the market data region");
+    }
+    if (tickers.size() > kMaxMarketDataTickers)
+    {
+        throw std::runtime_error("Too many tickers for the market data region");
+    }
+
+    MarketDataRegion *region = new (memory.GetData()) MarketDataRegion();
+    region->magic = kMarketDataMagic;
+    region->version = kMarketDataVersion;
+    region->num_tickers = static_cast<uint32_t>(tickers.size());
+    for (size_t i = 0; i < tickers.size(); ++i)
+    {
+        CopyFixedString(region->tickers[i], kMarketDataTickerSize, tickers[i]);
+    }
+    region->ready.store(1, std::memory_order_release);
+    return *region;
+}
+
+/**
+ * Validates a mapping created by the engine and waits (up to 5 s) for it
+ * to be published.
+ *
+ * @param memory mapping opened by name, typically read-only
+ */
+const MarketDataRegion &AttachMarketDataRegion(const SharedMemory &memory)
+{
+    if (memory.GetSize() < sizeof(MarketDataRegion))
+    {
+        throw std::runtime_error("Shared memory too small for the market data region");
+    }
+    const MarketDataRegion *region = static_cast<const MarketDataRegion *>(memory.GetData());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (region->ready.load(std::memory_order_acquire) == 0)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            throw std::runtime_error("Matching engine did not publish the market data region");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (region->magic != kMarketDataMagic || region->version != kMarketDataVersion)
+    {
+        throw std::runtime_error("Market data region has an unknown layout");
+    }
+    return *region;
+}
@@ -0,0 +1,56 @@
+#include "ipc/market_data_publisher.hpp"
+#include "exchange/limit_order_book.hpp"
+
+MarketDataPublisher::MarketDataPublisher(MarketDataRegion &region)
+    : region(region),
+      snapshots(region.num_tickers, BookSnapshot{}),
+      books(region.num_tickers, nullptr),
+      is_dirty(region.num_tickers, false)
+{
+}
+
+void MarketDataPublisher::OnTrade(TickerHandle ticker, const Fill &fill)
+{
+    MarketDataTrade trade{};
+    trade.ticker = ticker.index;
+    trade.aggressor_side = fill.aggressor_side;
+    trade.volume = fill.trade.volume;
+    trade.price = fill.price;
+    trade.trade_id = fill.trade.trade_id;
+    trade.timestamp = static_cast<int64_t>(fill.trade.timestamp);
+    region.trades.Publish(trade);
+
+    // Reaches readers with the snapshot of the book update that follows
+    BookSnapshot &snapshot = snapshots[ticker.index];
+    ++snapshot.trade_count;
+    snapshot.last_trade_price = fill.price;
+    snapshot.last_trade_volume = fill.trade.volume;
+    snapshot.last_trade_timestamp = trade.timestamp;
+}
+
+void MarketDataPublisher::OnBookUpdate(TickerHandle ticker, LimitOrderBook &book)
+{
+    books[ticker.index] = &book;
+    if (!is_dirty[ticker.index])
+    {
+        is_dirty[ticker.index] = true;
+        dirty_tickers.push_back(ticker.index);
+    }
+}
+
+size_t MarketDataPublisher::Flush()
+{
+    for (uint32_t index : dirty_tickers)
+    {
+        BookSnapshot &snapshot = snapshots[index];
+        LimitOrderBook &book = *books[index];
+        ++snapshot.update_id;
+        snapshot.bid_levels = static_cast<uint32_t>(book.GetDepth(OrderType::BID, snapshot.bids, kMarketDataDepth));
+        snapshot.ask_levels = static_cast<uint32_t>(book.GetDepth(OrderType::ASK, snapshot.asks, kMarketDataDepth));
+        region.books[index].Store(snapshot);
+        is_dirty[index] = false;
+    }
+    size_t published = dirty_tickers.size();
+    dirty_tickers.clear();
+    return published;
+}
@@ -0,0 +1,66 @@
+#include "ipc/market_data_reader.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @param shm_name region the engine publishes market data to
+ * @throws std::runtime_error if the region does not exist or is not published
+ */
+MarketDataReader::MarketDataReader(const std::string &shm_name)
+    : memory(shm_name, ShmAccess::READ_ONLY),
+      region(AttachMarketDataRegion(memory)),
+      trade_cursor(region.trades.GetPublished()),
+      dropped_trades(0)
+{
+}
+
+TickerHandle MarketDataReader::ResolveTicker(const std::string &ticker) const
+{
+    for (uint32_t i = 0; i < region.num_tickers; ++i)
+    {
+        if (ticker == std::string(region.tickers[i], strnlen(region.tickers[i], kMarketDataTickerSize)))
+        {
+            return TickerHandle{i};
+        }
+    }
+    throw std::out_of_range("Ticker not found: " + ticker);
+}
+
+BookSnapshot MarketDataReader::GetBook(TickerHandle ticker) const
+{
+    if (ticker.index >= region.num_tickers)
+    {
+        throw std::runtime_error("Ticker not found");
+    }
+    return region.books[ticker.index].Load();
+}
+
+TopOfBook MarketDataReader::GetTopOfBook(TickerHandle ticker) const
+{
+    BookSnapshot book = GetBook(ticker);
+    bool has_bid = book.bid_levels > 0;
+    bool has_ask = book.ask_levels > 0;
+    return TopOfBook(has_bid || has_ask,
+                     has_ask ? book.asks[0].price : 0,
+                     has_ask ? book.asks[0].volume : 0,
+                     has_bid ? book.bids[0].price : 0,
+                     has_bid ? book.bids[0].volume : 0);
+}
+
+bool MarketDataReader::NextTrade(MarketDataTrade &trade)
+{
+    const uint64_t expected = trade_cursor;
+    if (!region.trades.Read(trade_cursor, trade))
+    {
+        return false;
+    }
+    // Read() skipped ahead if the engine lapped this reader
+    dropped_trades += trade_cursor - 1 - expected;
+    return true;
+}
+
+uint64_t MarketDataReader::GetDroppedTrades() const
+{
+    return dropped_trades;
+}
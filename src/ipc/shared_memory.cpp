@@ -0,0 +1,139 @@
+#include "ipc/shared_memory.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+    std::runtime_error ShmError(const std::string &what, const std::string &name)
+    {
+        return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+    }
+}
+
+/**
+ * Creates the shared-memory object `name` and maps it.
+ *
+ * A stale object left behind by a crashed creator is truncated and reused.
+ * ftruncate zero-fills, so structures placed in the mapping start zeroed.
+ *
+ * @param name POSIX shm name ("/exchange_gateway")
+ * @param size bytes to allocate
+ */
+SharedMemory::SharedMemory(const std::string &name, size_t size)
+    : name(name), data(nullptr), size(size), owner(true)
+{
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        throw ShmError("shm_open failed for", name);
+    }
+    // Drop any previous contents before sizing
+    if (ftruncate(fd, 0) < 0 || ftruncate(fd, static_cast<off_t>(size)) < 0)
+    {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw ShmError("ftruncate failed for", name);
+    }
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        data = nullptr;
+        shm_unlink(name.c_str());
+        throw ShmError("mmap failed for", name);
+    }
+}
+
+/**
+ * Maps an existing shared-memory object at its current size.
+ *
+ * @param name POSIX shm name used by the creator
+ * @param access READ_ONLY maps with PROT_READ only
+ */
+SharedMemory::SharedMemory(const std::string &name, ShmAccess access)
+    : name(name), data(nullptr), size(0), owner(false)
+{
+    const bool read_only = access == ShmAccess::READ_ONLY;
+    int fd = shm_open(name.c_str(), read_only ? O_RDONLY : O_RDWR, 0);
+    if (fd < 0)
+    {
+        throw ShmError("shm_open failed for", name);
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0)
+    {
+        close(fd);
+        throw ShmError("fstat failed for", name);
+    }
+    size = static_cast<size_t>(info.st_size);
+    data = mmap(nullptr, size, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        data = nullptr;
+        throw ShmError("mmap failed for", name);
+    }
+}
+
+SharedMemory::~SharedMemory()
+{
+    Release();
+}
+
+SharedMemory::SharedMemory(SharedMemory &&other) noexcept
+    : name(std::move(other.name)), data(other.data), size(other.size), owner(other.owner)
+{
+    other.data = nullptr;
+    other.owner = false;
+}
+
+SharedMemory &SharedMemory::operator=(SharedMemory &&other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        name = std::move(other.name);
+        data = other.data;
+        size = other.size;
+        owner = other.owner;
+        other.data = nullptr;
+        other.owner = false;
+    }
+    return *this;
+}
+
+void SharedMemory::Release()
+{
+    if (data != nullptr)
+    {
+        munmap(data, size);
+        data = nullptr;
+    }
+    if (owner)
+    {
+        shm_unlink(name.c_str());
+        owner = false;
+    }
+}
+
+void *SharedMemory::GetData() const
+{
+    return data;
+}
+
+size_t SharedMemory::GetSize() const
+{
+    return size;
+}
+
+const std::string &SharedMemory::GetName() const
+{
+    return name;
+}
@@ -0,0 +1,86 @@
+#include "metrics/exchange_metrics.hpp"
+#include "exchange/limit_order_book.hpp"
+
+/**
+ * Registers every per-ticker series up front, so updates never touch the
+ * registry.
+ */
+ExchangeMetrics::ExchangeMetrics(MetricsRegistry &registry,
+                                 const std::vector<std::string> &tickers,
+                                 bool measure_depth)
+    : measure_depth(measure_depth),
+      books(tickers.size(), nullptr),
+      is_dirty(tickers.size(), false)
+{
+    for (const std::string &ticker : tickers)
+    {
+        MetricLabels labels{{"ticker", ticker}};
+        TickerMetrics metrics{
+            &registry.GetCounter("exchange_fills_total", "Fills executed", labels),
+            &registry.GetCounter("exchange_traded_volume_total", "Shares traded", labels),
+            &registry.GetGauge("exchange_resting_orders", "Orders resting on the book", labels),
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr};
+        if (measure_depth)
+        {
+            MetricLabels bids{{"ticker", ticker}, {"side", "bid"}};
+            MetricLabels asks{{"ticker", ticker}, {"side", "ask"}};
+            const std::string levels_help = "Price levels within the best " + std::to_string(kDepthLevels);
+            const std::string volume_help = "Resting volume within the best " + std::to_string(kDepthLevels) + " levels";
+            metrics.bid_levels = &registry.GetGauge("exchange_book_levels", levels_help, bids);
+            metrics.ask_levels = &registry.GetGauge("exchange_book_levels", levels_help, asks);
+            metrics.bid_volume = &registry.GetGauge("exchange_book_depth_volume", volume_help, bids);
+            metrics.ask_volume = &registry.GetGauge("exchange_book_depth_volume", volume_help, asks);
+        }
+        this->tickers.push_back(metrics);
+    }
+}
+
+void ExchangeMetrics::OnTrade(TickerHandle ticker, const Fill &fill)
+{
+    TickerMetrics &metrics = tickers[ticker.index];
+    metrics.fills->Increment();
+    metrics.traded_volume->Increment(static_cast<uint64_t>(fill.trade.volume));
+}
+
+void ExchangeMetrics::OnBookUpdate(TickerHandle ticker, LimitOrderBook &book)
+{
+    tickers[ticker.index].resting_orders->Set(static_cast<int64_t>(book.GetRestingOrderCount()));
+    if (!measure_depth)
+    {
+        return;
+    }
+    books[ticker.index] = &book;
+    if (!is_dirty[ticker.index])
+    {
+        is_dirty[ticker.index] = true;
+        dirty_tickers.push_back(ticker.index);
+    }
+}
+
+size_t ExchangeMetrics::Flush()
+{
+    auto measure = [this](LimitOrderBook &book, OrderType side, Gauge &levels, Gauge &volume)
+    {
+        size_t count = book.GetDepth(side, depth, kDepthLevels);
+        int64_t total = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += depth[i].volume;
+        }
+        levels.Set(static_cast<int64_t>(count));
+        volume.Set(total);
+    };
+
+    for (uint32_t index : dirty_tickers)
+    {
+        TickerMetrics &metrics = tickers[index];
+        measure(*books[index], OrderType::BID, *metrics.bid_levels, *metrics.bid_volume);
+        measure(*books[index], OrderType::ASK, *metrics.ask_levels, *metrics.ask_volume);
+        is_dirty[index] = false;
+    }
+    dirty_tickers.clear();
+    return 0;
+}
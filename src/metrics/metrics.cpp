@@ -0,0 +1,267 @@
+#include "metrics/metrics.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    std::atomic<size_t> next_shard{0};
+
+    std::string RenderLabels(const MetricLabels &labels)
+    {
+        if (labels.empty())
+        {
+            return "";
+        }
+        std::string rendered = "{";
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            if (i > 0)
+            {
+                rendered += ',';
+            }
+            rendered += labels[i].first + "=\"";
+            for (char c : labels[i].second)
+            {
+                if (c == '\\' || c == '"')
+                {
+                    rendered += '\\';
+                    rendered += c;
+                }
+                else if (c == '\n')
+                {
+                    rendered += "\\n";
+                }
+                else
+                {
+                    rendered += c;
+                }
+            }
+            rendered += '"';
+        }
+        return rendered + "}";
+    }
+
+    // Adds `le` to an already rendered label set
+    std::string WithBound(const std::string &labels, const std::string &bound)
+    {
+        std::string le = "le=\"" + bound + "\"";
+        if (labels.empty())
+        {
+            return "{" + le + "}";
+        }
+        return labels.substr(0, labels.size() - 1) + "," + le + "}";
+    }
+
+    const char *TypeName(MetricsRegistry::Type type)
+    {
+        switch (type)
+        {
+        case MetricsRegistry::Type::COUNTER:
+            return "counter";
+        case MetricsRegistry::Type::GAUGE:
+            return "gauge";
+        case MetricsRegistry::Type::HISTOGRAM:
+            return "histogram";
+        }
+        return "untyped";
+    }
+
+    std::string FormatDouble(double value)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        return buffer;
+    }
+
+    std::string FormatSeconds(uint64_t nanos)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(nanos) / 1e9);
+        return buffer;
+    }
+}
+
+size_t GetMetricShard()
+{
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+uint64_t Counter::GetValue() const
+{
+    uint64_t total = 0;
+    for (const Shard &shard : shards)
+    {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const std::array<uint64_t, Histogram::kBuckets> Histogram::kBucketBoundsNanos = {
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000, 5000000, 10000000, 25000000, 50000000, 100000000, 250000000, 500000000,
+    1000000000};
+
+void Histogram::Observe(uint64_t nanos)
+{
+    size_t bucket = 0;
+    while (bucket < kBuckets && nanos > kBucketBoundsNanos[bucket])
+    {
+        ++bucket;
+    }
+    Shard &shard = shards[GetMetricShard()];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum_nanos.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::GetSnapshot() const
+{
+    Snapshot snapshot;
+    for (const Shard &shard : shards)
+    {
+        for (size_t i = 0; i <= kBuckets; ++i)
+        {
+            uint64_t count = shard.counts[i].load(std::memory_order_relaxed);
+            snapshot.counts[i] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum_nanos += shard.sum_nanos.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+/**
+ * Finds or creates a series.
+ *
+ * @throws std::invalid_argument if `name` is already registered with another type
+ */
+MetricsRegistry::Series &MetricsRegistry::GetSeries(const std::string &name,
+                                                    const std::string &help,
+                                                    Type type,
+                                                    const MetricLabels &labels)
+{
+    Family *family = nullptr;
+    for (std::unique_ptr<Family> &candidate : families)
+    {
+        if (candidate->name == name)
+        {
+            family = candidate.get();
+            break;
+        }
+    }
+    if (family == nullptr)
+    {
+        families.push_back(std::make_unique<Family>(Family{name, help, type, {}}));
+        family = families.back().get();
+    }
+    if (family->type != type)
+    {
+        throw std::invalid_argument("Metric " + name + " registered with another type");
+    }
+
+    std::string rendered = RenderLabels(labels);
+    for (Series &series : family->series)
+    {
+        if (series.labels == rendered)
+        {
+            return series;
+        }
+    }
+    family->series.push_back(Series{rendered, nullptr, nullptr, nullptr, nullptr});
+    return family->series.back();
+}
+
+Counter &MetricsRegistry::GetCounter(const std::string &name, const std::string &help, const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Series &series = GetSeries(name, help, Type::COUNTER, labels);
+    if (series.counter == nullptr)
+    {
+        series.counter = std::make_unique<Counter>();
+    }
+    return *series.counter;
+}
+
+Gauge &MetricsRegistry::GetGauge(const std::string &name, const std::string &help, const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Series &series = GetSeries(name, help, Type::GAUGE, labels);
+    if (series.gauge == nullptr)
+    {
+        series.gauge = std::make_unique<Gauge>();
+    }
+    return *series.gauge;
+}
+
+Histogram &MetricsRegistry::GetHistogram(const std::string &name, const std::string &help, const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Series &series = GetSeries(name, help, Type::HISTOGRAM, labels);
+    if (series.histogram == nullptr)
+    {
+        series.histogram = std::make_unique<Histogram>();
+    }
+    return *series.histogram;
+}
+
+void MetricsRegistry::AddCallback(const std::string &name,
+                                  const std::string &help,
+                                  Type type,
+                                  const MetricLabels &labels,
+                                  std::function<double()> read)
+{
+    if (type == Type::HISTOGRAM)
+    {
+        throw std::invalid_argument("Callback metrics are counters or gauges");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    GetSeries(name, help, type, labels).callback = std::move(read);
+}
+
+std::string MetricsRegistry::Render() const
+{
+    std::ostringstream out;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::unique_ptr<Family> &family : families)
+    {
+        out << "# HELP " << family->name << ' ' << family->help << '\n';
+        out << "# TYPE " << family->name << ' ' << TypeName(family->type) << '\n';
+        for (const Series &series : family->series)
+        {
+            if (series.histogram != nullptr)
+            {
+                Histogram::Snapshot snapshot = series.histogram->GetSnapshot();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < Histogram::kBuckets; ++i)
+                {
+                    cumulative += snapshot.counts[i];
+                    out << family->name << "_bucket"
+                        << WithBound(series.labels, FormatSeconds(Histogram::kBucketBoundsNanos[i]))
+                        << ' ' << cumulative << '\n';
+                }
+                out << family->name << "_bucket" << WithBound(series.labels, "+Inf") << ' ' << snapshot.count << '\n';
+                out << family->name << "_sum" << series.labels << ' ' << FormatSeconds(snapshot.sum_nanos) << '\n';
+                out << family->name << "_count" << series.labels << ' ' << snapshot.count << '\n';
+                continue;
+            }
+
+            out << family->name << series.labels << ' ';
+            if (series.callback)
+            {
+                out << FormatDouble(series.callback());
+            }
+            else if (series.counter != nullptr)
+            {
+                out << series.counter->GetValue();
+            }
+            else if (series.gauge != nullptr)
+            {
+                out << series.gauge->GetValue();
+            }
+            out << '\n';
+        }
+    }
+    return out.str();
+}
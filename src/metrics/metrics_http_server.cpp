@@ -0,0 +1,138 @@
+#include "metrics/metrics_http_server.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr int kStopCheckMillis = 100;
+    constexpr size_t kMaxRequestBytes = 4096;
+    // A scraper that connects and goes quiet is dropped after this long
+    constexpr timeval kReceiveTimeout{1, 0};
+
+    bool WriteAll(int fd, const std::string &data)
+    {
+        size_t offset = 0;
+        while (offset < data.size())
+        {
+            ssize_t written = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                return false;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    std::string MakeResponse(const char *status, const std::string &body)
+    {
+        return std::string("HTTP/1.0 ") + status +
+               "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8"
+               "\r\nContent-Length: " + std::to_string(body.size()) +
+               "\r\nConnection: close\r\n\r\n" + body;
+    }
+}
+
+/**
+ * Binds the listening socket and starts serving.
+ *
+ * @throws std::runtime_error if the port cannot be bound
+ */
+MetricsHttpServer::MetricsHttpServer(MetricsRegistry &registry, uint16_t port)
+    : registry(registry), listen_fd(-1), port(0), stop(false)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    socklen_t length = sizeof(address);
+    if (listen_fd < 0 ||
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+        bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0 ||
+        getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+    {
+        std::runtime_error error("Metrics endpoint failed on port " + std::to_string(port) + ": " +
+                                 std::strerror(errno));
+        if (listen_fd >= 0)
+        {
+            close(listen_fd);
+        }
+        throw error;
+    }
+    this->port = ntohs(address.sin_port);
+    thread = std::thread(&MetricsHttpServer::Serve, this);
+}
+
+MetricsHttpServer::~MetricsHttpServer()
+{
+    stop.store(true);
+    thread.join();
+    close(listen_fd);
+}
+
+void MetricsHttpServer::Serve()
+{
+    pollfd listener{listen_fd, POLLIN, 0};
+    while (!stop.load())
+    {
+        if (poll(&listener, 1, kStopCheckMillis) <= 0)
+        {
+            continue;
+        }
+        int client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd >= 0)
+        {
+            HandleConnection(client_fd);
+            close(client_fd);
+        }
+    }
+}
+
+void MetricsHttpServer::HandleConnection(int client_fd)
+{
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &kReceiveTimeout, sizeof(kReceiveTimeout));
+
+    // Only the request line matters; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestBytes)
+    {
+        ssize_t received = recv(client_fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    bool is_scrape = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0;
+    if (is_scrape)
+    {
+        WriteAll(client_fd, MakeResponse("200 OK", registry.Render()));
+    }
+    else
+    {
+        WriteAll(client_fd, MakeResponse("404 Not Found", "Not found: try GET /metrics\n"));
+    }
+}
+
+uint16_t MetricsHttpServer::GetPort() const
+{
+    return port;
+}
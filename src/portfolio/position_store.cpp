@@ -0,0 +1,194 @@
+#include "portfolio/position_store.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // ---------------------------------------------------------------------
+    // RevalueKernel
+    //   new_mv[i]  = shares[i] * price
+    //   total[i]  += new_mv[i] - market_value[i]
+    //   market_value[i] = new_mv[i]
+    //
+    // AVX2 (4 doubles), SSE2 (2 doubles) or NEON (2 doubles), scalar tail.
+    // ---------------------------------------------------------------------
+    void RevalueKernel(const double *__restrict shares,
+                       double *__restrict market_value,
+                       double *__restrict total,
+                       size_t n,
+                       double price)
+    {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d px = _mm256_set1_pd(price);
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d new_mv = _mm256_mul_pd(_mm256_loadu_pd(shares + i), px);
+            __m256d delta = _mm256_sub_pd(new_mv, _mm256_loadu_pd(market_value + i));
+            _mm256_storeu_pd(total + i, _mm256_add_pd(_mm256_loadu_pd(total + i), delta));
+            _mm256_storeu_pd(market_value + i, new_mv);
+        }
+#elif defined(__SSE2__)
+        const __m128d px = _mm_set1_pd(price);
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d new_mv = _mm_mul_pd(_mm_loadu_pd(shares + i), px);
+            __m128d delta = _mm_sub_pd(new_mv, _mm_loadu_pd(market_value + i));
+            _mm_storeu_pd(total + i, _mm_add_pd(_mm_loadu_pd(total + i), delta));
+            _mm_storeu_pd(market_value + i, new_mv);
+        }
+#elif defined(__ARM_NEON)
+        const float64x2_t px = vdupq_n_f64(price);
+        for (; i + 2 <= n; i += 2)
+        {
+            float64x2_t new_mv = vmulq_f64(vld1q_f64(shares + i), px);
+            float64x2_t delta = vsubq_f64(new_mv, vld1q_f64(market_value + i));
+            vst1q_f64(total + i, vaddq_f64(vld1q_f64(total + i), delta));
+            vst1q_f64(market_value + i, new_mv);
+        }
+#endif
+        for (; i < n; i++)
+        {
+            double new_mv = shares[i] * price;
+            total[i] += new_mv - market_value[i];
+            market_value[i] = new_mv;
+        }
+    }
+}
+
+PositionStore::PositionStore(size_t num_tickers)
+    : num_users(0),
+      net_shares(num_tickers),
+      avg_cost(num_tickers),
+      market_value(num_tickers),
+      applied_marks(num_tickers, 0.0),
+      pending_marks(num_tickers, 0.0),
+      mark_dirty(num_tickers, 0)
+{
+}
+
+uint32_t PositionStore::AddUser(double initial_cash)
+{
+    for (size_t t = 0; t < net_shares.size(); t++)
+    {
+        net_shares[t].push_back(0.0);
+        avg_cost[t].push_back(0.0);
+        market_value[t].push_back(0.0);
+    }
+    cash.push_back(initial_cash);
+    total_market_value.push_back(0.0);
+    total_cost_basis.push_back(0.0);
+    return static_cast<uint32_t>(num_users++);
+}
+
+size_t PositionStore::GetNumUsers() const
+{
+    return num_users;
+}
+
+size_t PositionStore::GetNumTickers() const
+{
+    return net_shares.size();
+}
+
+// ---------------------------------------------------------------------
+// SetPosition(...) - overwrite one (ticker, user) entry and keep the
+// per-user totals in sync at the currently applied mark.
+// ---------------------------------------------------------------------
+void PositionStore::SetPosition(size_t ticker, uint32_t user, int shares, double cost)
+{
+    double &sh = net_shares.at(ticker).at(user);
+    double &avg = avg_cost[ticker][user];
+    double &mv = market_value[ticker][user];
+
+    double new_mv = shares * applied_marks[ticker];
+    total_market_value[user] += new_mv - mv;
+    total_cost_basis[user] += shares * cost - sh * avg;
+
+    sh = shares;
+    avg = cost;
+    mv = new_mv;
+}
+
+void PositionStore::SetCash(uint32_t user, double balance)
+{
+    cash.at(user) = balance;
+}
+
+void PositionStore::UpdateMark(size_t ticker, double price)
+{
+    pending_marks[ticker] = price;
+    mark_dirty[ticker] = 1;
+}
+
+void PositionStore::Revalue()
+{
+    for (size_t t = 0; t < mark_dirty.size(); t++)
+    {
+        if (mark_dirty[t])
+        {
+            RevalueTicker(t, pending_marks[t]);
+            mark_dirty[t] = 0;
+        }
+    }
+}
+
+void PositionStore::RevalueTicker(size_t ticker, double price)
+{
+    if (price == applied_marks[ticker])
+    {
+        return;
+    }
+    RevalueKernel(net_shares[ticker].data(),
+                  market_value[ticker].data(),
+                  total_market_value.data(),
+                  num_users,
+                  price);
+    applied_marks[ticker] = price;
+}
+
+double PositionStore::GetMark(size_t ticker) const
+{
+    return applied_marks.at(ticker);
+}
+
+double PositionStore::GetMarketValue(uint32_t user) const
+{
+    return total_market_value.at(user);
+}
+
+double PositionStore::GetUnrealizedPnL(uint32_t user) const
+{
+    return total_market_value.at(user) - total_cost_basis[user];
+}
+
+double PositionStore::GetEquity(uint32_t user) const
+{
+    return cash.at(user) + total_market_value[user];
+}
+
+std::vector<UserEquity> PositionStore::GetLeaderboard(size_t count) const
+{
+    std::vector<UserEquity> entries(num_users);
+    for (uint32_t u = 0; u < num_users; u++)
+    {
+        entries[u] = UserEquity{u, cash[u] + total_market_value[u], total_market_value[u] - total_cost_basis[u]};
+    }
+
+    count = std::min(count, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+                      [](const UserEquity &a, const UserEquity &b)
+                      { return a.equity > b.equity; });
+    entries.resize(count);
+    return entries;
+}
@@ -0,0 +1,140 @@
+#include "risk/margin_engine.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+
+MarginEngine::MarginEngine(size_t num_tickers, const RiskLimits &limits)
+    : limits(limits),
+      num_tickers(num_tickers)
+{
+}
+
+void MarginEngine::SetLimits(const RiskLimits &new_limits)
+{
+    limits = new_limits;
+}
+
+uint32_t MarginEngine::AddUser()
+{
+    order_notional.push_back(0.0);
+    position_exposure.push_back(0.0);
+    realized_pnl.push_back(0.0);
+    ticker_exposure.resize(ticker_exposure.size() + num_tickers, 0.0);
+    return static_cast<uint32_t>(order_notional.size() - 1);
+}
+
+/**
+ * The gross exposure an order adds: the position is first moved by the
+ * user's resting orders on the same side (they may all fill first), and
+ * only growth of the absolute position counts, so a flip is charged once
+ * the new side outgrows the old one.
+ */
+int64_t MarginEngine::AddedShares(OrderType side, int volume, int64_t position, int64_t same_side_open)
+{
+    const int64_t direction = (side == OrderType::BID) ? 1 : -1;
+    const int64_t committed_position = position + direction * same_side_open;
+    return std::max<int64_t>(0, std::abs(committed_position + direction * volume) - std::abs(committed_position));
+}
+
+/**
+ * Checks that a new order fits in the user's remaining buying power.
+ * O(1): committed notional is maintained incrementally.
+ *
+ * The order is charged only for AddedShares; an order that only reduces
+ * the position is always accepted.
+ *
+ * @return RiskCheck::ACCEPTED or RiskCheck::INSUFFICIENT_BUYING_POWER.
+ */
+RiskCheck MarginEngine::CheckOrder(uint32_t user,
+                                   OrderType side,
+                                   int volume,
+                                   double price,
+                                   int64_t position,
+                                   int64_t same_side_open) const
+{
+    const int64_t added_shares = AddedShares(side, volume, position, same_side_open);
+    if (added_shares == 0)
+    {
+        return RiskCheck::ACCEPTED;
+    }
+
+    double committed = order_notional[user] + position_exposure[user];
+    double limit = (limits.buying_power + realized_pnl[user]) * limits.max_leverage;
+    if (committed + price * static_cast<double>(added_shares) > limit)
+    {
+        return RiskCheck::INSUFFICIENT_BUYING_POWER;
+    }
+    return RiskCheck::ACCEPTED;
+}
+
+/**
+ * Commits the resting order's AddedShares at its price: the amount the check
+ * charged, less whatever filled on entry. Orders that add nothing are not
+ * tracked.
+ */
+void MarginEngine::OnOrderAdded(uint32_t user,
+                                int64_t order_id,
+                                OrderType side,
+                                int volume,
+                                double price,
+                                int64_t position,
+                                int64_t same_side_open)
+{
+    const int charged = static_cast<int>(AddedShares(side, volume, position, same_side_open));
+    if (charged == 0)
+    {
+        return;
+    }
+    charged_orders.emplace(order_id, OrderMargin{charged, price});
+    order_notional[user] += price * charged;
+}
+
+/**
+ * Releases the charged shares the order no longer has: fills take its
+ * uncharged (position-reducing) shares first, a cancel releases the rest.
+ */
+void MarginEngine::OnOrderReduced(uint32_t user, int64_t order_id, int remaining_volume)
+{
+    auto it = charged_orders.find(order_id);
+    if (it == charged_orders.end())
+    {
+        return;
+    }
+    OrderMargin &order = it->second;
+    const int charged = std::min(order.charged, remaining_volume);
+    order_notional[user] -= order.price * (order.charged - charged);
+    order.charged = charged;
+    if (charged == 0)
+    {
+        charged_orders.erase(it);
+    }
+}
+
+void MarginEngine::OnPositionChanged(uint32_t user, size_t ticker, int net_shares, double avg_cost, double total_realized_pnl)
+{
+    double &exposure = ticker_exposure[static_cast<size_t>(user) * num_tickers + ticker];
+    double new_exposure = std::abs(static_cast<double>(net_shares)) * avg_cost;
+    position_exposure[user] += new_exposure - exposure;
+    exposure = new_exposure;
+    realized_pnl[user] = total_realized_pnl;
+}
+
+double MarginEngine::GetCommitted(uint32_t user) const
+{
+    return order_notional.at(user) + position_exposure.at(user);
+}
+
+double MarginEngine::GetEquity(uint32_t user) const
+{
+    return limits.buying_power + realized_pnl.at(user);
+}
+
+double MarginEngine::GetBuyingPower(uint32_t user) const
+{
+    return GetEquity(user) * limits.max_leverage - GetCommitted(user);
+}
@@ -0,0 +1,37 @@
+#include "risk/risk_check.hpp"
+
+#include <stdexcept>
+#include <string>
+
+const char *RiskCheckToString(RiskCheck check)
+{
+    switch (check)
+    {
+    case RiskCheck::ACCEPTED:
+        return "accepted";
+    case RiskCheck::MAX_ORDER_VOLUME:
+        return "max_order_volume";
+    case RiskCheck::MAX_ORDER_NOTIONAL:
+        return "max_order_notional";
+    case RiskCheck::MAX_POSITION:
+        return "max_position";
+    case RiskCheck::MAX_OPEN_ORDERS:
+        return "max_open_orders";
+    case RiskCheck::PRICE_COLLAR:
+        return "price_collar";
+    case RiskCheck::INSUFFICIENT_BUYING_POWER:
+        return "insufficient_buying_power";
+    }
+    return "unknown";
+}
+
+RiskRejection::RiskRejection(RiskCheck reason)
+    : std::runtime_error(std::string("Order rejected by risk check: ") + RiskCheckToString(reason)),
+      reason(reason)
+{
+}
+
+RiskCheck RiskRejection::GetReason() const
+{
+    return reason;
+}
@@ -0,0 +1,150 @@
+#include "risk/risk_engine.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+#include "utils/order_type.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+RiskEngine::RiskEngine(size_t num_tickers, const RiskLimits &limits)
+    : limits(limits),
+      num_tickers(num_tickers),
+      last_trade_price(num_tickers, 0.0)
+{
+}
+
+void RiskEngine::SetLimits(const RiskLimits &new_limits)
+{
+    limits = new_limits;
+}
+
+const RiskLimits &RiskEngine::GetLimits() const
+{
+    return limits;
+}
+
+bool RiskEngine::HasPerUserLimits() const
+{
+    const RiskLimits defaults;
+    return limits.max_position != defaults.max_position || limits.max_open_orders != defaults.max_open_orders ||
+           limits.buying_power != defaults.buying_power;
+}
+
+uint32_t RiskEngine::AddUser()
+{
+    positions.resize(positions.size() + num_tickers);
+    open_orders.push_back(0);
+    return static_cast<uint32_t>(open_orders.size() - 1);
+}
+
+inline RiskEngine::PositionRisk &RiskEngine::At(uint32_t user, size_t ticker)
+{
+    return positions[static_cast<size_t>(user) * num_tickers + ticker];
+}
+
+/**
+ * Runs every pre-trade check for a new order. O(1): a few comparisons
+ * against precomputed counters, no allocation, no lookups by string.
+ *
+ * @param user Dense user index, or kUnregistered for stateless checks only.
+ * @param ticker Ticker index.
+ * @param side BID or ASK.
+ * @param volume Order volume.
+ * @param price Limit price.
+ * @return RiskCheck::ACCEPTED or the first limit the order breaches.
+ */
+RiskCheck RiskEngine::CheckOrder(uint32_t user, size_t ticker, OrderType side, int volume, double price) const
+{
+    if (volume > limits.max_order_volume)
+    {
+        return RiskCheck::MAX_ORDER_VOLUME;
+    }
+    if (price * volume > limits.max_order_notional)
+    {
+        return RiskCheck::MAX_ORDER_NOTIONAL;
+    }
+
+    double reference = last_trade_price[ticker];
+    if (reference > 0 && std::abs(price - reference) > limits.price_collar * reference)
+    {
+        return RiskCheck::PRICE_COLLAR;
+    }
+
+    if (user == kUnregistered)
+    {
+        return RiskCheck::ACCEPTED;
+    }
+
+    if (open_orders[user] >= limits.max_open_orders)
+    {
+        return RiskCheck::MAX_OPEN_ORDERS;
+    }
+
+    // Worst case if this order and every resting order on the same side fill
+    const PositionRisk &risk = positions[static_cast<size_t>(user) * num_tickers + ticker];
+    int64_t worst_case = (side == OrderType::BID)
+                             ? risk.position + risk.open_bid_volume + volume
+                             : risk.open_ask_volume + volume - risk.position;
+    if (worst_case > limits.max_position)
+    {
+        return RiskCheck::MAX_POSITION;
+    }
+
+    return RiskCheck::ACCEPTED;
+}
+
+void RiskEngine::OnOrderAdded(uint32_t user, size_t ticker, OrderType side, int volume)
+{
+    if (user == kUnregistered)
+    {
+        return;
+    }
+    PositionRisk &risk = At(user, ticker);
+    (side == OrderType::BID ? risk.open_bid_volume : risk.open_ask_volume) += volume;
+    open_orders[user]++;
+}
+
+void RiskEngine::OnOrderReduced(uint32_t user, size_t ticker, OrderType side, int volume, bool order_done)
+{
+    if (user == kUnregistered)
+    {
+        return;
+    }
+    PositionRisk &risk = At(user, ticker);
+    (side == OrderType::BID ? risk.open_bid_volume : risk.open_ask_volume) -= volume;
+    if (order_done)
+    {
+        open_orders[user]--;
+    }
+}
+
+void RiskEngine::OnExecution(uint32_t user, size_t ticker, OrderType side, int volume)
+{
+    if (user == kUnregistered)
+    {
+        return;
+    }
+    At(user, ticker).position += (side == OrderType::BID) ? volume : -volume;
+}
+
+void RiskEngine::OnTrade(size_t ticker, double price)
+{
+    last_trade_price[ticker] = price;
+}
+
+int64_t RiskEngine::GetPosition(uint32_t user, size_t ticker) const
+{
+    return positions.at(static_cast<size_t>(user) * num_tickers + ticker).position;
+}
+
+int64_t RiskEngine::GetOpenVolume(uint32_t user, size_t ticker, OrderType side) const
+{
+    const PositionRisk &risk = positions.at(static_cast<size_t>(user) * num_tickers + ticker);
+    return side == OrderType::BID ? risk.open_bid_volume : risk.open_ask_volume;
+}
+
+int RiskEngine::GetOpenOrders(uint32_t user) const
+{
+    return open_orders.at(user);
+}
@@ -0,0 +1,252 @@
+#include "server/io_uring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    std::runtime_error UringError(const std::string &what)
+    {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    int Setup(unsigned entries, io_uring_params &params)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    }
+}
+
+/**
+ * Creates the ring and maps its queues.
+ *
+ * @param entries submission queue size
+ * @throws std::runtime_error if io_uring is unavailable (old kernel, or
+ * disabled by seccomp / kernel.io_uring_disabled)
+ */
+IoUring::IoUring(unsigned entries)
+    : ring_fd(-1),
+      entries(0),
+      ring_memory(MAP_FAILED),
+      ring_memory_size(0),
+      sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+      sqes_size(0),
+      sqe_tail(0),
+      buffer_ring(static_cast<io_uring_buf_ring *>(MAP_FAILED)),
+      buffer_ring_size(0),
+      buffer_count(0),
+      buffer_size(0),
+      timeout{}
+{
+    // Completions are only ever reaped by the submitting thread, so the
+    // kernel may defer its task work until we ask for events
+    io_uring_params params{};
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    ring_fd = Setup(entries, params);
+    if (ring_fd < 0 && errno == EINVAL)
+    {
+        params = io_uring_params{};
+        ring_fd = Setup(entries, params);
+    }
+    if (ring_fd < 0)
+    {
+        throw UringError("io_uring_setup failed");
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        close(ring_fd);
+        throw std::runtime_error("io_uring: kernel too old (no IORING_FEAT_SINGLE_MMAP)");
+    }
+    this->entries = params.sq_entries;
+
+    ring_memory_size = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                                params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_memory = mmap(nullptr, ring_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd, IORING_OFF_SQ_RING);
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                            ring_fd, IORING_OFF_SQES));
+    if (ring_memory == MAP_FAILED || sqes == MAP_FAILED)
+    {
+        std::runtime_error error = UringError("io_uring mmap failed");
+        Release();
+        throw error;
+    }
+
+    char *ring = static_cast<char *>(ring_memory);
+    sq_head = reinterpret_cast<unsigned *>(ring + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned *>(ring + params.sq_off.tail);
+    sq_mask = *reinterpret_cast<unsigned *>(ring + params.sq_off.ring_mask);
+    cq_head = reinterpret_cast<unsigned *>(ring + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned *>(ring + params.cq_off.tail);
+    cq_mask = *reinterpret_cast<unsigned *>(ring + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+    // Slot i always holds SQE i: submission order is the SQE order
+    unsigned *sq_array = reinterpret_cast<unsigned *>(ring + params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; ++i)
+    {
+        sq_array[i] = i;
+    }
+    sqe_tail = *sq_tail;
+}
+
+IoUring::~IoUring()
+{
+    Release();
+}
+
+void IoUring::Release()
+{
+    if (buffer_ring != MAP_FAILED)
+    {
+        munmap(buffer_ring, buffer_ring_size);
+    }
+    if (sqes != MAP_FAILED)
+    {
+        munmap(sqes, sqes_size);
+    }
+    if (ring_memory != MAP_FAILED)
+    {
+        munmap(ring_memory, ring_memory_size);
+    }
+    close(ring_fd);
+}
+
+/**
+ * Allocates the buffers and registers them as group kBufferGroup.
+ *
+ * @param count number of buffers, a power of two (at most 32768)
+ * @param size bytes per buffer: the most a single receive completion carries
+ * @throws std::runtime_error if the kernel lacks provided buffer rings
+ */
+void IoUring::RegisterBuffers(uint16_t count, uint32_t size)
+{
+    if (count == 0 || (count & (count - 1)) != 0 || buffer_count != 0)
+    {
+        throw std::runtime_error("io_uring: buffer count must be a power of two, registered once");
+    }
+    buffer_ring_size = count * sizeof(io_uring_buf);
+    void *memory = mmap(nullptr, buffer_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        throw UringError("io_uring buffer ring mmap failed");
+    }
+    buffer_ring = static_cast<io_uring_buf_ring *>(memory);
+
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<uint64_t>(buffer_ring);
+    registration.ring_entries = count;
+    registration.bgid = kBufferGroup;
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0)
+    {
+        throw UringError("io_uring buffer ring registration failed");
+    }
+
+    buffer_count = count;
+    buffer_size = size;
+    buffers.resize(static_cast<size_t>(count) * size);
+    for (uint16_t id = 0; id < count; ++id)
+    {
+        RecycleBuffer(id);
+    }
+}
+
+const char *IoUring::GetBuffer(uint16_t buffer_id) const
+{
+    return buffers.data() + static_cast<size_t>(buffer_id) * buffer_size;
+}
+
+void IoUring::RecycleBuffer(uint16_t buffer_id)
+{
+    // Not buffer_ring->bufs: compiled as C++ the header's flexible array
+    // member lands 8 bytes into the ring, while the kernel expects entry 0
+    // at its start (with the tail overlaid on entry 0's resv field)
+    io_uring_buf *slots = reinterpret_cast<io_uring_buf *>(buffer_ring);
+    uint16_t tail = buffer_ring->tail;
+    io_uring_buf &buffer = slots[tail & (buffer_count - 1)];
+    buffer.addr = reinterpret_cast<uint64_t>(GetBuffer(buffer_id));
+    buffer.len = buffer_size;
+    buffer.bid = buffer_id;
+    __atomic_store_n(&buffer_ring->tail, static_cast<uint16_t>(tail + 1), __ATOMIC_RELEASE);
+}
+
+// Next free SQE, zeroed; a full queue is submitted first to make room
+io_uring_sqe *IoUring::GetSqe()
+{
+    if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) == entries)
+    {
+        SubmitAndWait(0);
+        if (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) == entries)
+        {
+            throw std::runtime_error("io_uring submission queue full");
+        }
+    }
+    io_uring_sqe *sqe = &sqes[sqe_tail & sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sqe_tail;
+    return sqe;
+}
+
+void IoUring::PrepareMultishotAccept(int listen_fd, uint64_t user_data)
+{
+    io_uring_sqe *sqe = GetSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = user_data;
+}
+
+void IoUring::PrepareMultishotRecv(int fd, uint64_t user_data)
+{
+    io_uring_sqe *sqe = GetSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = user_data;
+}
+
+void IoUring::PrepareSend(int fd, const void *data, size_t size, uint64_t user_data)
+{
+    io_uring_sqe *sqe = GetSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+// One timeout at a time: the timespec lives in the ring object
+void IoUring::PrepareTimeout(int64_t nanoseconds, uint64_t user_data)
+{
+    timeout.tv_sec = nanoseconds / 1000000000;
+    timeout.tv_nsec = nanoseconds % 1000000000;
+    io_uring_sqe *sqe = GetSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = reinterpret_cast<uint64_t>(&timeout);
+    sqe->len = 1;
+    sqe->user_data = user_data;
+}
+
+int IoUring::SubmitAndWait(unsigned wait_count)
+{
+    __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+    int submitted;
+    do
+    {
+        // Recomputed after EINTR: the kernel may have consumed the batch already
+        unsigned to_submit = sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        submitted = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, wait_count,
+                                             IORING_ENTER_GETEVENTS, nullptr, 0));
+    } while (submitted < 0 && errno == EINTR);
+    return submitted < 0 ? -errno : submitted;
+}
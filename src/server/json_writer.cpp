@@ -0,0 +1,204 @@
+#include "server/json_writer.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    constexpr char kHexDigits[] = "0123456789abcdef";
+
+    bool NeedsEscape(char c)
+    {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+}
+
+void JsonWriter::BeforeValue()
+{
+    if (after_key)
+    {
+        after_key = false;
+        return;
+    }
+    if (depth > 0)
+    {
+        if (has_values[depth - 1])
+        {
+            out += ',';
+        }
+        has_values[depth - 1] = true;
+    }
+}
+
+/**
+ * @throws std::length_error past kMaxDepth nested containers
+ */
+void JsonWriter::Open(char bracket)
+{
+    if (depth == kMaxDepth)
+    {
+        throw std::length_error("JSON nested too deeply");
+    }
+    BeforeValue();
+    out += bracket;
+    has_values[depth++] = false;
+}
+
+void JsonWriter::Close(char bracket)
+{
+    --depth;
+    out += bracket;
+}
+
+JsonWriter &JsonWriter::Key(const JsonKey &key)
+{
+    if (has_values[depth - 1])
+    {
+        out += ',';
+    }
+    has_values[depth - 1] = true;
+    out += key.GetText();
+    after_key = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::Key(std::string_view name)
+{
+    if (has_values[depth - 1])
+    {
+        out += ',';
+    }
+    has_values[depth - 1] = true;
+    AppendEscaped(name);
+    out += ':';
+    after_key = true;
+    return *this;
+}
+
+/**
+ * Quotes `text`, escaping as nlohmann::json does: the short escapes where
+ * JSON has one, \u00XX for other control characters, UTF-8 passed through.
+ */
+void JsonWriter::AppendEscaped(std::string_view text)
+{
+    out += '"';
+    size_t run_start = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if (!NeedsEscape(c))
+        {
+            continue;
+        }
+        out.append(text.data() + run_start, i - run_start);
+        run_start = i + 1;
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+        {
+            unsigned char code = static_cast<unsigned char>(c);
+            char escaped[] = {'\\', 'u', '0', '0', kHexDigits[code >> 4], kHexDigits[code & 0xf]};
+            out.append(escaped, sizeof(escaped));
+            break;
+        }
+        }
+    }
+    out.append(text.data() + run_start, text.size() - run_start);
+    out += '"';
+}
+
+JsonWriter &JsonWriter::String(std::string_view value)
+{
+    BeforeValue();
+    AppendEscaped(value);
+    return *this;
+}
+
+JsonWriter &JsonWriter::Int(int64_t value)
+{
+    BeforeValue();
+    char buffer[24];
+    char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, static_cast<size_t>(end - buffer));
+    return *this;
+}
+
+JsonWriter &JsonWriter::Uint(uint64_t value)
+{
+    BeforeValue();
+    char buffer[24];
+    char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, static_cast<size_t>(end - buffer));
+    return *this;
+}
+
+JsonWriter &JsonWriter::Double(double value)
+{
+    BeforeValue();
+    if (!std::isfinite(value))
+    {
+        out += "null";
+        return *this;
+    }
+    char buffer[32];
+    char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, static_cast<size_t>(end - buffer));
+    // Keep it a float for readers that type numbers by their text
+    bool is_integral = true;
+    for (const char *c = buffer; c != end; ++c)
+    {
+        if (*c == '.' || *c == 'e')
+        {
+            is_integral = false;
+            break;
+        }
+    }
+    if (is_integral)
+    {
+        out += ".0";
+    }
+    return *this;
+}
+
+JsonWriter &JsonWriter::Bool(bool value)
+{
+    BeforeValue();
+    out += value ? "true" : "false";
+    return *this;
+}
+
+JsonWriter &JsonWriter::Null()
+{
+    BeforeValue();
+    out += "null";
+    return *this;
+}
+
+JsonWriter &JsonWriter::Raw(std::string_view json)
+{
+    BeforeValue();
+    out += json;
+    return *this;
+}
@@ -1,9 +1,192 @@
 #include "server/server.hpp"
+#include "exchange/exchange.hpp"
+#include "feed/feed_protocol.hpp"
+#include "feed/feed_publisher.hpp"
+#include "feed/feed_snapshot_server.hpp"
+#include "ipc/engine_service.hpp"
+#include "ipc/gateway_protocol.hpp"
+#include "ipc/market_data.hpp"
+#include "ipc/market_data_publisher.hpp"
+#include "ipc/shared_memory.hpp"
+#include "metrics/exchange_metrics.hpp"
+#include "metrics/metrics.hpp"
+#include "metrics/metrics_http_server.hpp"
+#include "tape/trade_tape_writer.hpp"
 
-int main()
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    const char *kDefaultEngineShm = "/exchange_gateway";
+    const char *kDefaultMarketDataShm = "/exchange_market_data";
+    // Next to the gateway's METRICS_PORT, so both run on one host
+    constexpr uint16_t kEngineMetricsPort = METRICS_PORT + 1;
+
+    std::atomic<bool> stop_engine{false};
+
+    void RequestEngineStop(int)
+    {
+        stop_engine.store(true);
+    }
+
+    // BLOCKING engine: after this many idle polls in a row, sleep between polls
+    constexpr uint64_t kIdlePollsBeforeSleep = 10000;
+    constexpr std::chrono::microseconds kIdleSleep{50};
+
+    void RunEngineLoop(EngineService &service, WaitStrategy wait_strategy)
+    {
+        if (wait_strategy == WaitStrategy::BUSY_POLL)
+        {
+            service.Run(stop_engine);
+            return;
+        }
+        uint64_t idle_polls = 0;
+        while (!stop_engine.load(std::memory_order_relaxed))
+        {
+            if (service.PollOnce() > 0)
+            {
+                idle_polls = 0;
+            }
+            else if (++idle_polls > kIdlePollsBeforeSleep)
+            {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+        }
+    }
+
+    // Matching engine process: serves gateways over shared memory and
+    // publishes market data (shared memory for co-located readers, UDP
+    // multicast with TCP snapshots for everyone else) until SIGINT/SIGTERM.
+    // Book metrics are scraped here; request and queue metrics at the gateway.
+    // With a tape directory every trade is also appended to the trade tape,
+    // and IDs continue after the last trade already on it.
+    int RunEngine(const std::vector<std::string> &tickers,
+                  const std::string &shm_name,
+                  const std::string &market_data_shm_name,
+                  const std::string &tape_directory,
+                  const ThreadTopology &topology)
+    {
+        std::vector<int> inherited_cpus = GetThreadAffinity();
+        auto run_on = [&inherited_cpus](const std::vector<int> &cpus)
+        { PinCurrentThread(cpus.empty() ? inherited_cpus : cpus); };
+
+        MetricsRegistry metrics;
+
+        // Everything the engine thread touches is allocated after it is
+        // pinned, so first touch places it on the engine's NUMA node
+        run_on(topology.engine_cpus);
+        SharedMemory memory(shm_name, sizeof(GatewayRegion));
+        SharedMemory market_data_memory(market_data_shm_name, sizeof(MarketDataRegion));
+        Exchange exchange(tickers);
+        MarketDataPublisher publisher(CreateMarketDataRegion(market_data_memory, tickers));
+        exchange.AddMarketDataListener(&publisher);
+        FeedOptions feed_options;
+        FeedPublisher feed_publisher(feed_options, tickers);
+        exchange.AddMarketDataListener(&feed_publisher);
+        ExchangeMetrics exchange_metrics(metrics, tickers);
+        exchange.AddMarketDataListener(&exchange_metrics);
+        std::unique_ptr<TradeTapeWriter> trade_tape;
+        if (!tape_directory.empty())
+        {
+            trade_tape = std::make_unique<TradeTapeWriter>(tape_directory, tickers);
+            for (uint32_t index = 0; index < tickers.size(); ++index)
+            {
+                exchange.ResumeIdsAfter(TickerHandle{index}, trade_tape->GetLastTradeId(TickerHandle{index}));
+            }
+            exchange.AddMarketDataListener(trade_tape.get());
+        }
+        EngineService service(exchange, CreateGatewayRegion(memory, tickers));
+        service.GetResponseCache().RegisterMetrics(metrics);
+
+        // Background threads inherit the housekeeping CPUs; they stop before
+        // the objects their scrapes and snapshots read
+        run_on(topology.housekeeping_cpus);
+        MetricsHttpServer metrics_server(metrics, kEngineMetricsPort);
+        FeedSnapshotServer snapshot_server(feed_publisher, feed_options);
+        run_on(topology.engine_cpus);
+
+        std::signal(SIGINT, RequestEngineStop);
+        std::signal(SIGTERM, RequestEngineStop);
+        std::cout << "Matching engine serving gateways on " << shm_name
+                  << ", market data on " << market_data_shm_name
+                  << " and " << feed_options.group << ":" << feed_options.port
+                  << " (snapshots on port " << snapshot_server.GetPort() << ")"
+                  << ", metrics on port " << metrics_server.GetPort() << std::endl;
+        RunEngineLoop(service, topology.wait_strategy);
+        return 0; // the SharedMemory owners unlink both regions
+    }
+}
+
+/**
+ * Usage:
+ *   server_main                     single process (default)
+ *   server_main --engine [shm] [market_data_shm] [--tape-dir dir]
+ *                                   matching engine process, optionally
+ *                                   recording trades to a trade tape
+ *   server_main --gateway [shm]     network gateway for a running engine
+ *
+ * Serving modes also accept --io-uring to serve connections through
+ * io_uring instead of blocking worker threads. Thread placement and the
+ * wait strategy come from the flags of ParseThreadTopology (--io-cpus,
+ * --engine-cpus, --busy-poll, ...).
+ */
+int main(int argc, char **argv)
 {
     std::vector<std::string> tickers = {"AAPL", "GOOG", "TSLA", "MSFT", "QQQ", "TQQQ"};
+
+    std::vector<std::string> args(argv + 1, argv + argc);
+    IoBackend backend = IoBackend::THREADS;
+    auto io_uring_flag = std::find(args.begin(), args.end(), "--io-uring");
+    if (io_uring_flag != args.end())
+    {
+        backend = IoBackend::IO_URING;
+        args.erase(io_uring_flag);
+    }
+    std::string tape_directory;
+    auto tape_flag = std::find(args.begin(), args.end(), "--tape-dir");
+    if (tape_flag != args.end())
+    {
+        if (tape_flag + 1 == args.end())
+        {
+            std::cerr << "--tape-dir needs a directory" << std::endl;
+            return 1;
+        }
+        tape_directory = *(tape_flag + 1);
+        args.erase(tape_flag, tape_flag + 2);
+    }
+    ThreadTopology topology;
+    try
+    {
+        topology = ParseThreadTopology(args);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::string mode = args.size() > 0 ? args[0] : "";
+    std::string shm_name = args.size() > 1 ? args[1] : kDefaultEngineShm;
+    if (mode == "--engine")
+    {
+        return RunEngine(tickers, shm_name, args.size() > 2 ? args[2] : kDefaultMarketDataShm, tape_directory,
+                         topology);
+    }
+    if (mode == "--gateway")
+    {
+        Server server(GatewayOptions{shm_name});
+        server.start(backend, topology);
+        return 0;
+    }
+
     Server server(tickers);
-    server.start();
+    server.start(backend, topology);
     return 0;
 }
@@ -0,0 +1,176 @@
+#include "server/rate_limiter.hpp"
+#include "server/request_parser.hpp"
+
+#include <algorithm>
+#include <functional>
+
+/**
+ * Refills for the time elapsed since the last call, then takes one token.
+ *
+ * @param limit sustained rate and burst (bucket capacity)
+ * @param now current time; the bucket starts full on its first call
+ * @return true if the request may proceed
+ */
+bool TokenBucket::TryConsume(const RateLimit &limit, std::chrono::steady_clock::time_point now)
+{
+    if (limit.per_second <= 0)
+    {
+        return true;
+    }
+    if (!started)
+    {
+        tokens = limit.burst;
+        started = true;
+    }
+    else
+    {
+        double elapsed = std::chrono::duration<double>(now - last_refill).count();
+        tokens = std::min(limit.burst, tokens + elapsed * limit.per_second);
+    }
+    last_refill = now;
+
+    if (tokens < 1)
+    {
+        return false;
+    }
+    tokens -= 1;
+    return true;
+}
+
+bool TokenBucket::IsFull(const RateLimit &limit, std::chrono::steady_clock::time_point now) const
+{
+    if (!started || limit.per_second <= 0)
+    {
+        return true;
+    }
+    double elapsed = std::chrono::duration<double>(now - last_refill).count();
+    return tokens + elapsed * limit.per_second >= limit.burst;
+}
+
+RateLimiter::RateLimiter(const RateLimitOptions &options)
+    : options(options),
+      max_users_per_shard(std::max<size_t>(1, options.max_tracked_users / kUserShards))
+{
+}
+
+RequestClass RateLimiter::Classify(RequestAction action)
+{
+    switch (action)
+    {
+    case RequestAction::HANDLE_ORDER:
+        return RequestClass::ORDER;
+    case RequestAction::CANCEL_ORDER:
+        return RequestClass::CANCEL;
+    default:
+        return RequestClass::QUERY;
+    }
+}
+
+RequestClass RateLimiter::Classify(const std::string &action)
+{
+    return Classify(LookupRequestAction(action));
+}
+
+/**
+ * Charges the connection's bucket, then the user's. A request rejected by
+ * the connection bucket does not draw on the user's budget.
+ *
+ * @param connection buckets of the connection the request arrived on
+ * @param user_id the request's user, or null
+ * @param request_class which budget the request draws on
+ * @param now current time
+ * @return true if the request may proceed, false if it must be throttled
+ */
+bool RateLimiter::Admit(ClientBudget &connection,
+                        const std::string *user_id,
+                        RequestClass request_class,
+                        std::chrono::steady_clock::time_point now)
+{
+    if (request_class == RequestClass::CANCEL)
+    {
+        return true;
+    }
+    bool is_order = request_class == RequestClass::ORDER;
+
+    TokenBucket &connection_bucket = is_order ? connection.orders : connection.queries;
+    if (!connection_bucket.TryConsume(is_order ? options.connection_orders : options.connection_queries, now))
+    {
+        return false;
+    }
+    if (user_id == nullptr)
+    {
+        return true;
+    }
+
+    UserShard &shard = user_shards[std::hash<std::string>{}(*user_id) % kUserShards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ClientBudget &user = FindUser(shard, *user_id, now);
+    return is_order ? user.orders.TryConsume(options.user_orders, now)
+                    : user.queries.TryConsume(options.user_queries, now);
+}
+
+/**
+ * The buckets of `user_id`, created if the shard has room. Otherwise the
+ * shard's overflow bucket, so unknown ids cannot grow the table or dodge
+ * the user limit by never repeating. Called with the shard locked.
+ */
+ClientBudget &RateLimiter::FindUser(UserShard &shard,
+                                    const std::string &user_id,
+                                    std::chrono::steady_clock::time_point now)
+{
+    auto it = shard.users.find(user_id);
+    if (it != shard.users.end())
+    {
+        return it->second;
+    }
+    if (shard.users.size() >= max_users_per_shard)
+    {
+        EvictIdleUsers(shard, now);
+        if (shard.users.size() >= max_users_per_shard)
+        {
+            return shard.overflow;
+        }
+    }
+    return shard.users[user_id];
+}
+
+/**
+ * Forgets users whose buckets have refilled: a new bucket would start in
+ * the same state, so no budget is lost. Rate limited to one sweep per
+ * kEvictionInterval so a shard full of active users costs O(1) per new id.
+ */
+void RateLimiter::EvictIdleUsers(UserShard &shard, std::chrono::steady_clock::time_point now)
+{
+    if (now - shard.last_eviction < kEvictionInterval)
+    {
+        return;
+    }
+    shard.last_eviction = now;
+    for (auto it = shard.users.begin(); it != shard.users.end();)
+    {
+        if (it->second.orders.IsFull(options.user_orders, now) && it->second.queries.IsFull(options.user_queries, now))
+        {
+            it = shard.users.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+size_t RateLimiter::GetTrackedUserCount()
+{
+    size_t count = 0;
+    for (UserShard &shard : user_shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.users.size();
+    }
+    return count;
+}
+
+const RateLimitOptions &RateLimiter::GetOptions() const
+{
+    return options;
+}
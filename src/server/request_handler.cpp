@@ -0,0 +1,366 @@
+#include "server/request_handler.hpp"
+#include "exchange/exchange.hpp"
+#include "exchange/execution_sink.hpp"
+#include "portfolio/portfolio.hpp"
+#include "risk/risk_check.hpp"
+#include <iostream>
+
+namespace
+{
+    constexpr JsonKey kError("error");
+    constexpr JsonKey kRejectReason("reject_reason");
+    constexpr JsonKey kTickers("tickers");
+    constexpr JsonKey kTickerHandle("ticker_handle");
+    constexpr JsonKey kHasTop("has_top");
+    constexpr JsonKey kBidPrice("bid_price");
+    constexpr JsonKey kAskPrice("ask_price");
+    constexpr JsonKey kBidVolume("bid_volume");
+    constexpr JsonKey kAskVolume("ask_volume");
+    constexpr JsonKey kPhase("phase");
+    constexpr JsonKey kIndicativePrice("indicative_price");
+    constexpr JsonKey kIndicativeVolume("indicative_volume");
+    constexpr JsonKey kImbalance("imbalance");
+    constexpr JsonKey kVolume("volume");
+    constexpr JsonKey kTrades("trades");
+    constexpr JsonKey kSuccess("success");
+    constexpr JsonKey kOrderAddedToBook("order_added_to_book");
+    constexpr JsonKey kOrderId("order_id");
+    constexpr JsonKey kTradesExecuted("trades_executed");
+    constexpr JsonKey kCashBalance("cash_balance");
+    constexpr JsonKey kRealizedPnl("realized_pnl");
+    constexpr JsonKey kUnrealizedPnl("unrealized_pnl");
+    constexpr JsonKey kEquity("equity");
+    constexpr JsonKey kBuyingPower("buying_power");
+    constexpr JsonKey kPositions("positions");
+    constexpr JsonKey kNetShares("net_shares");
+    constexpr JsonKey kAvgCost("avg_cost");
+    constexpr JsonKey kLeaderboard("leaderboard");
+    constexpr JsonKey kUserId("user_id");
+    constexpr JsonKey kBidUserId("bid_user_id");
+    constexpr JsonKey kAskUserId("ask_user_id");
+    constexpr JsonKey kPrice("price");
+    constexpr JsonKey kTimestamp("timestamp");
+
+    // {ticker: {net_shares, avg_cost}} for every open position
+    void WritePositions(JsonWriter &writer, const Portfolio &portfolio)
+    {
+        writer.BeginObject();
+        for (const auto &[ticker, position] : portfolio.positions)
+        {
+            if (position.net_shares != 0)
+            {
+                writer.Key(ticker).BeginObject();
+                writer.Key(kNetShares).Int(position.net_shares);
+                writer.Key(kAvgCost).Double(position.avg_cost);
+                writer.EndObject();
+            }
+        }
+        writer.EndObject();
+    }
+
+    // Responses that only change when the book does
+    bool IsCacheable(RequestAction action)
+    {
+        return action == RequestAction::GET_TICKERS || action == RequestAction::GET_TOP_OF_BOOK ||
+               action == RequestAction::GET_AUCTION_STATE;
+    }
+
+    // Drops whatever was written so far and reports the failure instead
+    void WriteError(std::string &response, const char *message)
+    {
+        response.clear();
+        JsonWriter(response).BeginObject().Key(kError).String(message).EndObject();
+    }
+}
+
+void WriteTrade(JsonWriter &writer, const Trade &trade)
+{
+    writer.BeginObject();
+    writer.Key(kBidUserId).String(trade.bid_user_id);
+    writer.Key(kAskUserId).String(trade.ask_user_id);
+    writer.Key(kPrice).Int(trade.price);
+    writer.Key(kVolume).Int(trade.volume);
+    writer.Key(kTimestamp).Int(trade.timestamp);
+    writer.EndObject();
+}
+
+void JsonTradeWriter::OnFill(const Fill &fill)
+{
+    WriteTrade(writer, fill.trade);
+    ++fill_count;
+}
+
+RequestHandler::RequestHandler(Exchange &exchange) : exchange(exchange) {}
+
+TickerHandle RequestHandler::ResolveTicker(const ParsedRequest &request, TickerCache &ticker_cache)
+{
+    // Clients that called resolve_ticker up front send the handle directly
+    if (request.Has(ParsedRequest::FIELD_TICKER_HANDLE))
+    {
+        return TickerHandle{request.ticker_handle};
+    }
+
+    request.Require(ParsedRequest::FIELD_TICKER);
+    std::string ticker(request.ticker);
+    auto it = ticker_cache.find(ticker);
+    if (it != ticker_cache.end())
+    {
+        return it->second;
+    }
+    TickerHandle handle = exchange.ResolveTicker(ticker);
+    ticker_cache.emplace(std::move(ticker), handle);
+    return handle;
+}
+
+/**
+ * Reads the request's fields and dispatches it like a parsed request.
+ *
+ * @param request client request DOM
+ * @param ticker_cache tickers already resolved for this client
+ * @param response replaced with the serialized response
+ * @return false when the request failed or had nothing to act on
+ */
+bool RequestHandler::Handle(const nlohmann::json &request, TickerCache &ticker_cache, std::string &response)
+{
+    ParsedRequest parsed;
+    try
+    {
+        ReadRequest(request, parsed);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error processing request: " << e.what() << std::endl;
+        WriteError(response, "Exception caught during processing");
+        return false;
+    }
+    return Handle(parsed, ticker_cache, response);
+}
+
+/**
+ * Dispatches a request on its action and streams the JSON response into
+ * `response`, whose capacity is reused.
+ *
+ * @param request parsed client request
+ * @param ticker_cache tickers already resolved for this client
+ * @param response replaced with the serialized response, with "error" set
+ * when the request failed
+ * @return false when the request failed, or a cancel or registration had
+ * nothing to act on
+ */
+bool RequestHandler::Handle(const ParsedRequest &request, TickerCache &ticker_cache, std::string &response)
+{
+    response.clear();
+    JsonWriter writer(response);
+    bool succeeded = true;
+
+    try
+    {
+        // Polls of an unchanged book are answered with the bytes built for
+        // the first one. The ticker set is fixed: get_tickers is version 0.
+        // Book reads are keyed on the version of one published snapshot and
+        // serialized from that same snapshot, never from the live book.
+        bool cacheable = IsCacheable(request.action);
+        TickerHandle cache_ticker{0};
+        BboSnapshot bbo{};
+        if (cacheable)
+        {
+            if (request.action != RequestAction::GET_TICKERS)
+            {
+                cache_ticker = ResolveTicker(request, ticker_cache);
+                bbo = exchange.GetBbo(cache_ticker);
+            }
+            if (response_cache.Lookup(request.action, cache_ticker.index, bbo.update_sequence, response))
+            {
+                return true;
+            }
+        }
+
+        writer.BeginObject();
+        switch (request.action)
+        {
+        case RequestAction::GET_TICKERS:
+        {
+            writer.Key(kTickers).BeginArray();
+            for (const std::string &ticker : exchange.GetTickers())
+            {
+                writer.String(ticker);
+            }
+            writer.EndArray();
+            break;
+        }
+        case RequestAction::RESOLVE_TICKER:
+        {
+            writer.Key(kTickerHandle).Uint(ResolveTicker(request, ticker_cache).index);
+            break;
+        }
+        case RequestAction::GET_TOP_OF_BOOK:
+        {
+            TopOfBook top(bbo);
+
+            writer.Key(kHasTop).Bool(top.book_has_top);
+            writer.Key(kBidPrice).Int(top.bid_price);
+            writer.Key(kAskPrice).Int(top.ask_price);
+            writer.Key(kBidVolume).Int(top.bid_volume);
+            writer.Key(kAskVolume).Int(top.ask_volume);
+            break;
+        }
+        case RequestAction::GET_AUCTION_STATE:
+        {
+            bool in_auction = bbo.phase == TradingPhase::AUCTION;
+            writer.Key(kPhase).String(in_auction ? "auction" : "continuous");
+            if (in_auction)
+            {
+                writer.Key(kIndicativePrice).Double(bbo.indicative.price);
+                writer.Key(kIndicativeVolume).Int(bbo.indicative.volume);
+                writer.Key(kImbalance).Int(bbo.indicative.imbalance);
+            }
+            break;
+        }
+        case RequestAction::GET_VOLUME:
+        {
+            TickerHandle ticker = ResolveTicker(request, ticker_cache);
+            request.Require(ParsedRequest::FIELD_PRICE | ParsedRequest::FIELD_ORDER_TYPE);
+            OrderType order_type;
+            if (request.order_type == 1)
+            {
+                order_type = OrderType::ASK;
+            }
+            else
+            {
+                order_type = OrderType::BID;
+            }
+            int volume = exchange.GetVolume(ticker, request.price, order_type);
+            writer.Key(kVolume).Int(volume);
+            break;
+        }
+        case RequestAction::GET_PREVIOUS_TRADES:
+        {
+            TickerHandle ticker = ResolveTicker(request, ticker_cache);
+            request.Require(ParsedRequest::FIELD_NUM_PREVIOUS_TRADES);
+
+            // Serialized from the book's history in place, nothing copied out
+            writer.Key(kTrades).BeginArray();
+            exchange.ForEachPreviousTrade(ticker, request.num_previous_trades,
+                                          [&writer](const Trade &trade)
+                                          { WriteTrade(writer, trade); });
+            writer.EndArray();
+            break;
+        }
+        case RequestAction::CANCEL_ORDER:
+        {
+            TickerHandle ticker = ResolveTicker(request, ticker_cache);
+            request.Require(ParsedRequest::FIELD_ORDER_ID);
+            succeeded = exchange.CancelOrder(ticker, request.order_id);
+            writer.Key(kSuccess).Bool(succeeded);
+            break;
+        }
+        case RequestAction::HANDLE_ORDER:
+        {
+            request.Require(ParsedRequest::FIELD_USER_ID | ParsedRequest::FIELD_ORDER_TYPE | ParsedRequest::FIELD_VOLUME |
+                            ParsedRequest::FIELD_PRICE);
+            std::string user_id(request.user_id);
+            OrderType order_type = static_cast<OrderType>(request.order_type);
+            TickerHandle ticker = ResolveTicker(request, ticker_cache);
+
+            // Fills are serialized as they happen, no intermediate OrderResult
+            writer.Key(kTrades).BeginArray();
+            JsonTradeWriter trade_writer(writer);
+            int64_t order_id = exchange.HandleOrder(user_id, order_type, request.volume, request.price, ticker,
+                                                    trade_writer);
+            writer.EndArray();
+
+            writer.Key(kOrderAddedToBook).Bool(order_id > 0);
+            writer.Key(kOrderId).Int(order_id);
+            writer.Key(kTradesExecuted).Bool(trade_writer.GetFillCount() > 0);
+            break;
+        }
+        case RequestAction::GET_TRADES_BY_USER:
+        {
+            request.Require(ParsedRequest::FIELD_USER_ID);
+
+            writer.Key(kTrades).BeginArray();
+            exchange.ForEachTradeByUser(std::string(request.user_id),
+                                        [&writer](const Trade &trade)
+                                        { WriteTrade(writer, trade); });
+            writer.EndArray();
+            break;
+        }
+        case RequestAction::GET_PORTFOLIO:
+        {
+            request.Require(ParsedRequest::FIELD_USER_ID);
+            std::string user_id(request.user_id);
+            const Portfolio &portfolio = exchange.GetPortfolio(user_id);
+
+            writer.Key(kCashBalance).Double(portfolio.cash_balance);
+            writer.Key(kRealizedPnl).Double(portfolio.realized_pnl);
+            writer.Key(kUnrealizedPnl).Double(exchange.GetUnrealizedPnL(user_id));
+            writer.Key(kEquity).Double(exchange.GetEquity(user_id));
+            writer.Key(kBuyingPower).Double(exchange.GetBuyingPower(user_id)); // null when unlimited
+            writer.Key(kPositions);
+            WritePositions(writer, portfolio);
+            break;
+        }
+        case RequestAction::GET_POSITIONS:
+        {
+            request.Require(ParsedRequest::FIELD_USER_ID);
+            writer.Key(kPositions);
+            WritePositions(writer, exchange.GetPortfolio(std::string(request.user_id)));
+            break;
+        }
+        case RequestAction::GET_LEADERBOARD:
+        {
+            size_t count = request.Has(ParsedRequest::FIELD_COUNT) ? static_cast<size_t>(request.count) : 10;
+            writer.Key(kLeaderboard).BeginArray();
+            for (const auto &entry : exchange.GetLeaderboard(count))
+            {
+                writer.BeginObject();
+                writer.Key(kUserId).String(entry.user_id);
+                writer.Key(kEquity).Double(entry.equity);
+                writer.Key(kUnrealizedPnl).Double(entry.unrealized_pnl);
+                writer.Key(kRealizedPnl).Double(entry.realized_pnl);
+                writer.EndObject();
+            }
+            writer.EndArray();
+            break;
+        }
+        case RequestAction::REGISTER_USER:
+        {
+            request.Require(ParsedRequest::FIELD_USER_ID);
+            succeeded = exchange.RegisterUser(std::string(request.user_id));
+            writer.Key(kSuccess).Bool(succeeded);
+            break;
+        }
+        default:
+        {
+            writer.Key(kError).String("Unknown action");
+            succeeded = false;
+            break;
+        }
+        }
+        writer.EndObject();
+        if (cacheable)
+        {
+            response_cache.Store(request.action, cache_ticker.index, bbo.update_sequence, response);
+        }
+    }
+    catch (const RiskRejection &e)
+    {
+        response.clear();
+        JsonWriter(response)
+            .BeginObject()
+            .Key(kError)
+            .String("Order rejected by risk check")
+            .Key(kRejectReason)
+            .String(RiskCheckToString(e.GetReason()))
+            .EndObject();
+        return false;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error processing request: " << e.what() << std::endl;
+        WriteError(response, "Exception caught during processing");
+        return false;
+    }
+
+    return succeeded;
+}
@@ -0,0 +1,415 @@
+#include "server/request_parser.hpp"
+
+#include <array>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+namespace
+{
+    constexpr std::array<const char *, kRequestActions> kActionNames = {
+        "unknown", "handle_order", "cancel_order", "get_top_of_book", "get_volume",
+        "get_previous_trades", "get_trades_by_user", "get_tickers", "resolve_ticker",
+        "register_user", "get_portfolio", "get_positions", "get_leaderboard",
+        "get_auction_state", "get_engine_load"};
+
+    // Every action name is at least this long, so the hash may read [4] and [6]
+    constexpr size_t kMinActionLength = 10;
+    constexpr size_t kActionTableSize = 32;
+
+    constexpr size_t Length(const char *name)
+    {
+        size_t length = 0;
+        while (name[length] != '\0')
+        {
+            ++length;
+        }
+        return length;
+    }
+
+    // Found by search: collision-free over kActionNames
+    constexpr size_t HashAction(const char *name, size_t length)
+    {
+        return (length * 3 + static_cast<unsigned char>(name[4]) + static_cast<unsigned char>(name[6])) %
+               kActionTableSize;
+    }
+
+    constexpr std::array<RequestAction, kActionTableSize> BuildActionTable()
+    {
+        std::array<RequestAction, kActionTableSize> table{};
+        for (size_t i = 1; i < kRequestActions; ++i)
+        {
+            size_t slot = HashAction(kActionNames[i], Length(kActionNames[i]));
+            if (table[slot] != RequestAction::UNKNOWN)
+            {
+                throw "HashAction collides: pick new constants";
+            }
+            table[slot] = static_cast<RequestAction>(i);
+        }
+        return table;
+    }
+
+    constexpr std::array<RequestAction, kActionTableSize> kActionTable = BuildActionTable();
+
+    /**
+     * @brief Single-pass cursor over the request text
+     */
+    class Scanner
+    {
+    private:
+        const char *position;
+        const char *end;
+
+    public:
+        Scanner(const char *data, size_t size) : position(data), end(data + size) {}
+
+        void SkipWhitespace()
+        {
+            while (position < end && (*position == ' ' || *position == '\t' || *position == '\n' || *position == '\r'))
+            {
+                ++position;
+            }
+        }
+
+        bool AtEnd() const { return position == end; }
+
+        bool Consume(char expected)
+        {
+            SkipWhitespace();
+            if (position < end && *position == expected)
+            {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+
+        char Peek()
+        {
+            SkipWhitespace();
+            return position < end ? *position : '\0';
+        }
+
+        // A string without escapes, as a view of the text
+        bool ReadPlainString(std::string_view &value)
+        {
+            if (!Consume('"'))
+            {
+                return false;
+            }
+            const char *start = position;
+            while (position < end && *position != '"')
+            {
+                if (*position == '\\' || static_cast<unsigned char>(*position) < 0x20)
+                {
+                    return false;
+                }
+                ++position;
+            }
+            if (position == end)
+            {
+                return false;
+            }
+            value = std::string_view(start, static_cast<size_t>(position - start));
+            ++position;
+            return true;
+        }
+
+        bool SkipString()
+        {
+            if (!Consume('"'))
+            {
+                return false;
+            }
+            while (position < end && *position != '"')
+            {
+                if (static_cast<unsigned char>(*position) < 0x20)
+                {
+                    return false;
+                }
+                // Escapes are not decoded, only stepped over
+                position += *position == '\\' ? 2 : 1;
+            }
+            if (position >= end)
+            {
+                return false;
+            }
+            ++position;
+            return true;
+        }
+
+        // A number in JSON grammar, as a view of the text
+        bool ReadNumber(std::string_view &value, bool &is_integer)
+        {
+            SkipWhitespace();
+            const char *start = position;
+            if (position < end && *position == '-')
+            {
+                ++position;
+            }
+            if (position == end || *position < '0' || *position > '9')
+            {
+                return false;
+            }
+            // No leading zeros
+            if (*position == '0')
+            {
+                ++position;
+            }
+            else
+            {
+                SkipDigits();
+            }
+            is_integer = true;
+            if (position < end && *position == '.')
+            {
+                ++position;
+                if (!SkipDigits())
+                {
+                    return false;
+                }
+                is_integer = false;
+            }
+            if (position < end && (*position == 'e' || *position == 'E'))
+            {
+                ++position;
+                if (position < end && (*position == '+' || *position == '-'))
+                {
+                    ++position;
+                }
+                if (!SkipDigits())
+                {
+                    return false;
+                }
+                is_integer = false;
+            }
+            value = std::string_view(start, static_cast<size_t>(position - start));
+            return true;
+        }
+
+        bool SkipLiteral()
+        {
+            for (std::string_view literal : {std::string_view("true"), std::string_view("false"), std::string_view("null")})
+            {
+                if (static_cast<size_t>(end - position) >= literal.size() &&
+                    std::string_view(position, literal.size()) == literal)
+                {
+                    position += literal.size();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        // False if there was not at least one digit
+        bool SkipDigits()
+        {
+            const char *start = position;
+            while (position < end && *position >= '0' && *position <= '9')
+            {
+                ++position;
+            }
+            return position > start;
+        }
+    };
+
+    template <typename T>
+    bool ReadInteger(Scanner &scanner, T &value)
+    {
+        std::string_view text;
+        bool is_integer = false;
+        if (!scanner.ReadNumber(text, is_integer) || !is_integer)
+        {
+            return false;
+        }
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool ReadDouble(Scanner &scanner, double &value)
+    {
+        std::string_view text;
+        bool is_integer = false;
+        if (!scanner.ReadNumber(text, is_integer))
+        {
+            return false;
+        }
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool SkipValue(Scanner &scanner)
+    {
+        char next = scanner.Peek();
+        if (next == '"')
+        {
+            return scanner.SkipString();
+        }
+        if (next == '-' || (next >= '0' && next <= '9'))
+        {
+            std::string_view text;
+            bool is_integer = false;
+            return scanner.ReadNumber(text, is_integer);
+        }
+        return scanner.SkipLiteral(); // objects and arrays are left to nlohmann
+    }
+
+    // Reads the value of `key` into `request`; unknown keys are skipped
+    bool ReadField(Scanner &scanner, std::string_view key, ParsedRequest &request)
+    {
+        using Field = ParsedRequest::Field;
+        uint32_t field = 0;
+        bool ok = false;
+        if (key == "action")
+        {
+            ok = scanner.ReadPlainString(request.action_name);
+            request.action = LookupRequestAction(request.action_name);
+            return ok;
+        }
+        if (key == "user_id")
+        {
+            field = Field::FIELD_USER_ID;
+            ok = scanner.ReadPlainString(request.user_id);
+        }
+        else if (key == "ticker")
+        {
+            field = Field::FIELD_TICKER;
+            ok = scanner.ReadPlainString(request.ticker);
+        }
+        else if (key == "ticker_handle")
+        {
+            field = Field::FIELD_TICKER_HANDLE;
+            ok = ReadInteger(scanner, request.ticker_handle);
+        }
+        else if (key == "order_type")
+        {
+            field = Field::FIELD_ORDER_TYPE;
+            ok = ReadInteger(scanner, request.order_type);
+        }
+        else if (key == "volume")
+        {
+            field = Field::FIELD_VOLUME;
+            ok = ReadInteger(scanner, request.volume);
+        }
+        else if (key == "price")
+        {
+            field = Field::FIELD_PRICE;
+            ok = ReadDouble(scanner, request.price);
+        }
+        else if (key == "order_id")
+        {
+            field = Field::FIELD_ORDER_ID;
+            ok = ReadInteger(scanner, request.order_id);
+        }
+        else if (key == "num_previous_trades")
+        {
+            field = Field::FIELD_NUM_PREVIOUS_TRADES;
+            ok = ReadInteger(scanner, request.num_previous_trades);
+        }
+        else if (key == "count")
+        {
+            field = Field::FIELD_COUNT;
+            ok = ReadInteger(scanner, request.count);
+        }
+        else
+        {
+            return SkipValue(scanner);
+        }
+        request.fields |= field;
+        return ok;
+    }
+}
+
+const char *RequestActionToString(RequestAction action)
+{
+    size_t index = static_cast<size_t>(action);
+    return index < kRequestActions ? kActionNames[index] : kActionNames[0];
+}
+
+RequestAction LookupRequestAction(std::string_view name)
+{
+    if (name.size() < kMinActionLength)
+    {
+        return RequestAction::UNKNOWN;
+    }
+    RequestAction action = kActionTable[HashAction(name.data(), name.size())];
+    return name == kActionNames[static_cast<size_t>(action)] ? action : RequestAction::UNKNOWN;
+}
+
+void ParsedRequest::Require(uint32_t mask) const
+{
+    if (!Has(mask))
+    {
+        throw std::invalid_argument("Request is missing a field or has one of the wrong type");
+    }
+}
+
+bool ParseRequest(const char *data, size_t size, ParsedRequest &request)
+{
+    request = ParsedRequest();
+    Scanner scanner(data, size);
+    if (!scanner.Consume('{'))
+    {
+        return false;
+    }
+    if (!scanner.Consume('}'))
+    {
+        do
+        {
+            std::string_view key;
+            if (!scanner.ReadPlainString(key) || !scanner.Consume(':') || !ReadField(scanner, key, request))
+            {
+                return false;
+            }
+        } while (scanner.Consume(','));
+        if (!scanner.Consume('}'))
+        {
+            return false;
+        }
+    }
+    scanner.SkipWhitespace();
+    return scanner.AtEnd() && request.action_name.data() != nullptr;
+}
+
+void ReadRequest(const nlohmann::json &document, ParsedRequest &request)
+{
+    using Field = ParsedRequest::Field;
+    request = ParsedRequest();
+    auto action = document.is_object() ? document.find("action") : document.end();
+    if (action == document.end() || !action->is_string())
+    {
+        throw std::invalid_argument("Request has no action");
+    }
+    request.action_name = action->get_ref<const std::string &>();
+    request.action = LookupRequestAction(request.action_name);
+
+    auto read_string = [&document, &request](const char *key, Field field, std::string_view &value)
+    {
+        auto it = document.find(key);
+        if (it != document.end() && it->is_string())
+        {
+            value = it->get_ref<const std::string &>();
+            request.fields |= field;
+        }
+    };
+    auto read_number = [&document, &request](const char *key, Field field, auto &value)
+    {
+        auto it = document.find(key);
+        if (it != document.end() && it->is_number())
+        {
+            value = it->get<std::remove_reference_t<decltype(value)>>();
+            request.fields |= field;
+        }
+    };
+    read_string("user_id", Field::FIELD_USER_ID, request.user_id);
+    read_string("ticker", Field::FIELD_TICKER, request.ticker);
+    read_number("ticker_handle", Field::FIELD_TICKER_HANDLE, request.ticker_handle);
+    read_number("order_type", Field::FIELD_ORDER_TYPE, request.order_type);
+    read_number("volume", Field::FIELD_VOLUME, request.volume);
+    read_number("price", Field::FIELD_PRICE, request.price);
+    read_number("order_id", Field::FIELD_ORDER_ID, request.order_id);
+    read_number("num_previous_trades", Field::FIELD_NUM_PREVIOUS_TRADES, request.num_previous_trades);
+    read_number("count", Field::FIELD_COUNT, request.count);
+}
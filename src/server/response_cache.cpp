@@ -0,0 +1,46 @@
+#include "server/response_cache.hpp"
+
+bool ResponseCache::Lookup(RequestAction action,
+                           uint32_t ticker_index,
+                           uint64_t sequence,
+                           std::string &response) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::vector<Entry> &by_ticker = entries[static_cast<size_t>(action)];
+    if (ticker_index < by_ticker.size())
+    {
+        const Entry &entry = by_ticker[ticker_index];
+        if (entry.valid && entry.sequence == sequence)
+        {
+            response.assign(entry.response);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void ResponseCache::Store(RequestAction action, uint32_t ticker_index, uint64_t sequence, std::string_view response)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Entry> &by_ticker = entries[static_cast<size_t>(action)];
+    if (ticker_index >= by_ticker.size())
+    {
+        by_ticker.resize(static_cast<size_t>(ticker_index) + 1);
+    }
+    Entry &entry = by_ticker[ticker_index];
+    entry.valid = true;
+    entry.sequence = sequence;
+    entry.response.assign(response);
+}
+
+void ResponseCache::RegisterMetrics(MetricsRegistry &registry) const
+{
+    registry.AddCallback("exchange_response_cache_hits_total", "Read-only queries answered from the response cache",
+                         MetricsRegistry::Type::COUNTER, {},
+                         [this]() { return static_cast<double>(GetHitCount()); });
+    registry.AddCallback("exchange_response_cache_misses_total", "Cacheable queries that had to be built",
+                         MetricsRegistry::Type::COUNTER, {},
+                         [this]() { return static_cast<double>(GetMissCount()); });
+}
@@ -1,19 +1,257 @@
 #include "server/server.hpp"
 #include "exchange/exchange.hpp"
+#include "ipc/engine_client.hpp"
+#include "ipc/gateway_protocol.hpp"
+#include "ipc/shared_memory.hpp"
+#include "risk/risk_check.hpp"
+#include "server/json_writer.hpp"
+#include "server/request_handler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <cstring>
 
-Server::Server(const std::vector<std::string> &allowed_tickers)
-    : exchange(allowed_tickers) {}
+namespace
+{
+    // Blocking backend: a send stuck this long means the client stopped reading
+    constexpr timeval kSendTimeout{1, 0};
+    // BUSY_POLL: how long a blocking recv polls the device queue before sleeping
+    constexpr int kBusyPollMicros = 50;
+
+    // Last risk check in RiskCheck order
+    constexpr RiskCheck kLastRiskCheck = RiskCheck::INSUFFICIENT_BUYING_POWER;
+
+    constexpr JsonKey kError("error");
+    constexpr JsonKey kThrottled("throttled");
+    constexpr JsonKey kRejectReason("reject_reason");
+    constexpr JsonKey kTickers("tickers");
+    constexpr JsonKey kTickerHandle("ticker_handle");
+    constexpr JsonKey kQueueDepth("queue_depth");
+    constexpr JsonKey kMaxQueueDepth("max_queue_depth");
+    constexpr JsonKey kAdmitted("admitted");
+    constexpr JsonKey kShed("shed");
+    constexpr JsonKey kDroppedChannels("dropped_channels");
+    constexpr JsonKey kTrades("trades");
+    constexpr JsonKey kOrderAddedToBook("order_added_to_book");
+    constexpr JsonKey kOrderId("order_id");
+    constexpr JsonKey kTradesExecuted("trades_executed");
+    constexpr JsonKey kSuccess("success");
+}
+
+Server::Server(const std::vector<std::string> &allowed_tickers, const RateLimitOptions &rate_limits)
+    : exchange(std::make_unique<Exchange>(allowed_tickers)),
+      request_handler(std::make_unique<RequestHandler>(*exchange)),
+      engine_region(nullptr),
+      rate_limiter(rate_limits)
+{
+    register_metrics(allowed_tickers);
+    request_handler->GetResponseCache().RegisterMetrics(metrics);
+    // Every worker drives the exchange and none owns it: no depth walks
+    exchange_metrics = std::make_unique<ExchangeMetrics>(metrics, allowed_tickers, false);
+    exchange->AddMarketDataListener(exchange_metrics.get());
+}
+
+/**
+ * Gateway mode: attaches to the region of an already running engine.
+ *
+ * @throws std::runtime_error if the region is missing or never published
+ */
+Server::Server(const GatewayOptions &options, const RateLimitOptions &rate_limits)
+    : engine_memory(std::make_unique<SharedMemory>(options.engine_shm_name)),
+      engine_region(&AttachGatewayRegion(*engine_memory)),
+      rate_limiter(rate_limits)
+{
+    std::vector<std::string> tickers;
+    for (uint32_t i = 0; i < engine_region->num_tickers; ++i)
+    {
+        tickers.emplace_back(engine_region->tickers[i], strnlen(engine_region->tickers[i], kGatewayTickerSize));
+    }
+    register_metrics(tickers);
+
+    JsonWriter writer(tickers_response);
+    writer.BeginObject().Key(kTickers).BeginArray();
+    for (const std::string &ticker : tickers)
+    {
+        writer.String(ticker);
+    }
+    writer.EndArray().EndObject();
+
+    // The engine's admission queue, read from the region on each scrape
+    const GatewayRegion &region = *engine_region;
+    metrics.AddCallback("engine_queue_depth", "Requests the engine queued in its last round",
+                        MetricsRegistry::Type::GAUGE, {},
+                        [&region]() { return static_cast<double>(ReadEngineLoad(region).depth); });
+    metrics.AddCallback("engine_queue_max_depth", "Largest round the engine has queued",
+                        MetricsRegistry::Type::GAUGE, {},
+                        [&region]() { return static_cast<double>(ReadEngineLoad(region).max_depth); });
+    metrics.AddCallback("engine_dropped_channels_total", "Gateway channels dropped for leaving responses unread",
+                        MetricsRegistry::Type::COUNTER, {},
+                        [&region]() { return static_cast<double>(ReadEngineLoad(region).dropped_channels); });
+    for (size_t i = 0; i < kAdmissionClasses; ++i)
+    {
+        MetricLabels labels{{"class", AdmissionClassToString(static_cast<AdmissionClass>(i))}};
+        metrics.AddCallback("engine_admitted_total", "Requests the engine queued, by class",
+                            MetricsRegistry::Type::COUNTER, labels,
+                            [&region, i]() { return static_cast<double>(ReadEngineLoad(region).admitted[i]); });
+        metrics.AddCallback("engine_shed_total", "Requests the engine shed under load, by class",
+                            MetricsRegistry::Type::COUNTER, labels,
+                            [&region, i]() { return static_cast<double>(ReadEngineLoad(region).shed[i]); });
+    }
+}
+
+Server::~Server() = default;
+
+/**
+ * Registers the request metrics of both modes.
+ *
+ * @param tickers listed tickers in handle order
+ */
+void Server::register_metrics(const std::vector<std::string> &tickers)
+{
+    for (size_t i = 0; i < kRequestActions; ++i)
+    {
+        RequestAction action = static_cast<RequestAction>(i);
+        const char *name = action == RequestAction::UNKNOWN ? "other" : RequestActionToString(action);
+        requests_by_action[i] = &metrics.GetCounter("exchange_requests_total", "Requests received, by action",
+                                                    {{"action", name}});
+    }
+    for (const std::string &ticker : tickers)
+    {
+        Counter &orders = metrics.GetCounter("exchange_orders_total", "Orders submitted, by ticker",
+                                             {{"ticker", ticker}});
+        orders_by_ticker[ticker] = &orders;
+        orders_by_handle.push_back(&orders);
+    }
+    cancels_done = &metrics.GetCounter("exchange_cancels_total", "Cancel requests, by result",
+                                       {{"result", "cancelled"}});
+    cancels_not_found = &metrics.GetCounter("exchange_cancels_total", "Cancel requests, by result",
+                                            {{"result", "not_found"}});
+
+    const std::string rejects_help = "Requests refused: risk checks, rate limits and errors";
+    risk_rejects.assign(static_cast<size_t>(kLastRiskCheck) + 1, nullptr);
+    for (size_t i = static_cast<size_t>(RiskCheck::ACCEPTED) + 1; i < risk_rejects.size(); ++i)
+    {
+        risk_rejects[i] = &metrics.GetCounter("exchange_rejects_total", rejects_help,
+                                              {{"reason", RiskCheckToString(static_cast<RiskCheck>(i))}});
+    }
+    throttled_requests = &metrics.GetCounter("exchange_rejects_total", rejects_help, {{"reason", "throttled"}});
+    failed_requests = &metrics.GetCounter("exchange_rejects_total", rejects_help, {{"reason", "error"}});
+    request_duration = &metrics.GetHistogram("exchange_request_duration_seconds",
+                                             "Time from a request's arrival to its serialized response");
+    connections = nullptr;
+}
+
+/**
+ * Serves the registry on METRICS_PORT. Connections are a gauge kept by the
+ * blocking workers, or read from the io_uring loops on each scrape.
+ */
+void Server::start_metrics(IoBackend backend)
+{
+    const std::string help = "Open client connections";
+    if (backend == IoBackend::IO_URING)
+    {
+        metrics.AddCallback("exchange_connections", help, MetricsRegistry::Type::GAUGE, {},
+                            [this]()
+                            {
+                                std::lock_guard<std::mutex> lock(uring_loops_mutex);
+                                size_t total = 0;
+                                for (const UringConnectionLoop *loop : uring_loops)
+                                {
+                                    total += loop->GetConnectionCount();
+                                }
+                                return static_cast<double>(total);
+                            });
+    }
+    else
+    {
+        connections = &metrics.GetGauge("exchange_connections", help);
+    }
+
+    try
+    {
+        metrics_server = std::make_unique<MetricsHttpServer>(metrics, METRICS_PORT);
+        std::cout << "Metrics on port " << METRICS_PORT << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        // Trading goes on without metrics
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+// Counts a handle_order under its ticker; unknown tickers are left to fail later
+void Server::count_order(const ParsedRequest &request)
+{
+    if (request.Has(ParsedRequest::FIELD_TICKER_HANDLE))
+    {
+        if (request.ticker_handle < orders_by_handle.size())
+        {
+            orders_by_handle[request.ticker_handle]->Increment();
+        }
+        return;
+    }
+    if (request.Has(ParsedRequest::FIELD_TICKER))
+    {
+        auto orders = orders_by_ticker.find(std::string(request.ticker));
+        if (orders != orders_by_ticker.end())
+        {
+            orders->second->Increment();
+        }
+    }
+}
+
+/**
+ * Worker threads: the topology's io_threads, else one per io CPU, else
+ * available cores - 2, at least one. Gateway workers each own one engine
+ * channel, so there are at most kMaxGatewayChannels.
+ */
+int Server::worker_count() const
+{
+    int num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 2);
+    if (topology.io_threads > 0)
+    {
+        num_threads = topology.io_threads;
+    }
+    else if (!topology.io_cpus.empty())
+    {
+        num_threads = static_cast<int>(topology.io_cpus.size());
+    }
+    if (engine_region != nullptr)
+    {
+        num_threads = std::min(num_threads, static_cast<int>(kMaxGatewayChannels));
+    }
+    return num_threads;
+}
 
-void Server::start()
+// Worker i gets io CPU i (round-robin) to itself, or the inherited CPUs;
+// exits the process if the CPU cannot be used
+void Server::pin_worker(int worker_index) const
+{
+    try
+    {
+        if (topology.io_cpus.empty())
+        {
+            PinCurrentThread(inherited_cpus);
+            return;
+        }
+        PinCurrentThread({topology.io_cpus[worker_index % topology.io_cpus.size()]});
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Worker " << worker_index << ": " << e.what() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Bound and listening on PORT; exits the process on failure
+int Server::open_listener(bool reuse_port)
 {
     int server_fd;
     struct sockaddr_in address;
-    socklen_t addrlen = sizeof(address);
 
     server_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (server_fd == -1)
@@ -22,6 +260,14 @@ void Server::start()
         exit(EXIT_FAILURE);
     }
 
+    // One listener per io_uring worker; the kernel spreads connections
+    int enable = 1;
+    if (reuse_port && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0)
+    {
+        perror("SO_REUSEPORT failed");
+        exit(EXIT_FAILURE);
+    }
+
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
     address.sin_port = htons(PORT);
@@ -37,14 +283,49 @@ void Server::start()
         perror("Listen failed");
         exit(EXIT_FAILURE);
     }
+    return server_fd;
+}
+
+/**
+ * Lays the threads out as `topology` says: background threads are started
+ * on the housekeeping CPUs, then the calling thread moves to the acceptor
+ * CPUs and each worker pins itself.
+ *
+ * @throws std::runtime_error if a CPU set cannot be applied
+ */
+void Server::start(IoBackend backend, const ThreadTopology &topology)
+{
+    this->topology = topology;
+    inherited_cpus = GetThreadAffinity();
+    PinCurrentThread(topology.housekeeping_cpus);
+    start_metrics(backend);
+    PinCurrentThread(topology.acceptor_cpus.empty() ? inherited_cpus : topology.acceptor_cpus);
+
+    int num_threads = worker_count();
+    if (backend == IoBackend::IO_URING)
+    {
+        for (int i = 0; i < num_threads; i++)
+        {
+            workers.emplace_back(&Server::uring_worker_thread, this, i);
+        }
+        std::cout << "Server listening on port " << PORT << " (io_uring, "
+                  << num_threads << " threads)" << std::endl;
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        return;
+    }
+
+    struct sockaddr_in address;
+    socklen_t addrlen = sizeof(address);
+    int server_fd = open_listener(false);
 
     std::cout << "Server listening on port " << PORT << std::endl;
 
-    // Start worker threads using (available cores - 2)
-    int num_threads = std::thread::hardware_concurrency() - 2;
     for (int i = 0; i < num_threads; i++)
     {
-        workers.emplace_back(&Server::worker_thread, this);
+        workers.emplace_back(&Server::worker_thread, this, i);
     }
 
     while (true)
@@ -62,182 +343,423 @@ void Server::start()
             std::unique_lock<std::mutex> lock(queue_mutex);
             client_queue.push(new_socket);
         }
+        queue_ready.notify_one();
     }
 
     close(server_fd);
 }
 
-void Server::worker_thread()
+void Server::worker_thread(int worker_index)
 {
+    pin_worker(worker_index);
+    std::unique_ptr<EngineClient> engine;
+    if (engine_region != nullptr)
+    {
+        engine = std::make_unique<EngineClient>(*engine_region);
+    }
+
     while (true)
     {
         int client_socket;
 
         {
             std::unique_lock<std::mutex> lock(queue_mutex);
-            if (client_queue.empty())
+            if (topology.wait_strategy == WaitStrategy::BLOCKING)
+                queue_ready.wait(lock, [this]() { return !client_queue.empty(); });
+            else if (client_queue.empty())
                 continue;
             client_socket = client_queue.front();
             client_queue.pop();
         }
 
-        handle_client(client_socket);
+        handle_client(client_socket, engine.get());
     }
 }
 
-void Server::handle_client(int client_socket)
+void Server::handle_client(int client_socket, EngineClient *engine)
 {
     char buffer[2048] = {0}; // Increased buffer size for large responses
 
+    // Tickers resolved and rate budgets of this connection
+    ClientSession session;
+    connections->Add(1);
+
+    // Back-pressure: the kernel send buffer is the connection's send queue,
+    // and a client that leaves it full past the timeout is dropped
+    int send_queue_bytes = static_cast<int>(rate_limiter.GetOptions().max_send_queue_bytes);
+    setsockopt(client_socket, SOL_SOCKET, SO_SNDBUF, &send_queue_bytes, sizeof(send_queue_bytes));
+    setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, &kSendTimeout, sizeof(kSendTimeout));
+    if (topology.wait_strategy == WaitStrategy::BUSY_POLL)
+    {
+        // Best effort: raising it past net.core.busy_read needs CAP_NET_ADMIN
+        setsockopt(client_socket, SOL_SOCKET, SO_BUSY_POLL, &kBusyPollMicros, sizeof(kBusyPollMicros));
+    }
+
     while (true)
     {
-        memset(buffer, 0, sizeof(buffer));
         int bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
         if (bytes_received <= 0)
         {
-            close(client_socket);
-            return;
+            break;
         }
 
-        nlohmann::json response; // Declare outside try-catch
+        std::string_view response_str = process_request(buffer, bytes_received, session, engine);
+        size_t sent = 0;
+        while (sent < response_str.size())
+        {
+            ssize_t result = send(client_socket, response_str.data() + sent, response_str.size() - sent, MSG_NOSIGNAL);
+            if (result <= 0)
+            {
+                break;
+            }
+            sent += static_cast<size_t>(result);
+        }
+        if (sent < response_str.size())
+        {
+            break;
+        }
+    }
+    close(client_socket);
+    connections->Add(-1);
+}
+
+/**
+ * Each worker owns a listener on PORT (SO_REUSEPORT), an io_uring loop and,
+ * in gateway mode, an engine channel.
+ */
+void Server::uring_worker_thread(int worker_index)
+{
+    pin_worker(worker_index);
+    std::unique_ptr<EngineClient> engine;
+    if (engine_region != nullptr)
+    {
+        engine = std::make_unique<EngineClient>(*engine_region);
+    }
 
-        try
+    int server_fd = open_listener(true);
+    try
+    {
+        auto make_loop = [this, server_fd](auto on_request)
+        {
+            return std::make_unique<UringConnectionLoop>(server_fd, std::move(on_request),
+                                                         rate_limiter.GetOptions().max_send_queue_bytes,
+                                                         topology.wait_strategy);
+        };
+        // Gateway mode answers a round at a time, pipelined to the engine
+        std::vector<EngineRoundSlot> slots;
+        std::unique_ptr<UringConnectionLoop> loop =
+            engine != nullptr
+                ? make_loop([this, &engine, &slots](UringConnectionLoop::RoundRequest *requests, size_t count)
+                            { process_round(requests, count, *engine, slots); })
+                : make_loop([this](const char *data, size_t size, ClientSession &session)
+                            { return process_request(data, size, session, nullptr); });
         {
-            std::string received_data(buffer);
-            nlohmann::json request = nlohmann::json::parse(received_data);
+            std::lock_guard<std::mutex> lock(uring_loops_mutex);
+            uring_loops.push_back(loop.get());
+        }
+        std::atomic<bool> stop{false};
+        loop->Run(stop);
+        std::lock_guard<std::mutex> lock(uring_loops_mutex);
+        uring_loops.erase(std::find(uring_loops.begin(), uring_loops.end(), loop.get()));
+    }
+    catch (const std::exception &e)
+    {
+        // e.g. io_uring disabled on this kernel
+        std::cerr << "io_uring backend unavailable: " << e.what() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    close(server_fd);
+}
 
-            std::string action = request["action"];
+bool Server::admit_request(const char *data,
+                           size_t size,
+                           ClientSession &session,
+                           ParsedRequest &request,
+                           nlohmann::json &document,
+                           std::string &response)
+{
+    // Known request shapes are read in one pass; the DOM is only built for
+    // the rest, and stays alive with the caller because `request` views into it
+    request = ParsedRequest{};
+    if (!ParseRequest(data, size, request))
+    {
+        document = nlohmann::json::parse(data, data + size);
+        ReadRequest(document, request);
+    }
+
+    requests_by_action[static_cast<size_t>(request.action)]->Increment();
+
+    std::string user_id;
+    if (request.Has(ParsedRequest::FIELD_USER_ID))
+    {
+        user_id = request.user_id;
+    }
+    if (!rate_limiter.Admit(session.budget,
+                            request.Has(ParsedRequest::FIELD_USER_ID) ? &user_id : nullptr,
+                            RateLimiter::Classify(request.action),
+                            std::chrono::steady_clock::now()))
+    {
+        throttled_requests->Increment();
+        JsonWriter(response).BeginObject().Key(kError).String("Rate limit exceeded").Key(kThrottled).Bool(true).EndObject();
+        return false;
+    }
+
+    if (request.action == RequestAction::HANDLE_ORDER)
+    {
+        count_order(request);
+    }
+    return true;
+}
+
+void Server::write_failure(std::string &response)
+{
+    response.clear();
+    try
+    {
+        throw;
+    }
+    catch (const RiskRejection &e)
+    {
+        risk_rejects[static_cast<size_t>(e.GetReason())]->Increment();
+        JsonWriter(response)
+            .BeginObject()
+            .Key(kError)
+            .String("Order rejected by risk check")
+            .Key(kRejectReason)
+            .String(RiskCheckToString(e.GetReason()))
+            .EndObject();
+    }
+    catch (const std::exception &e)
+    {
+        failed_requests->Increment();
+        std::cerr << "Error processing request: " << e.what() << std::endl;
+        JsonWriter(response).BeginObject().Key(kError).String("Exception caught during processing").EndObject();
+    }
+}
 
-            std::cout << "Handling request: " << action << '\n';
+std::string_view Server::process_request(const char *data,
+                                         size_t size,
+                                         ClientSession &session,
+                                         EngineClient *engine)
+{
+    auto started = std::chrono::steady_clock::now();
+    std::string &response = session.response;
+    response.clear();
 
-            if (action == "get_tickers")
+    try
+    {
+        ParsedRequest request;
+        nlohmann::json document;
+        if (admit_request(data, size, session, request, document, response))
+        {
+            bool succeeded;
+            if (engine != nullptr)
             {
-                response["tickers"] = exchange.GetTickers();
+                succeeded = forward_to_engine(request, data, size, *engine, response);
             }
-            else if (action == "get_top_of_book")
+            else
             {
-                std::string ticker = request["ticker"];
-                TopOfBook top = exchange.GetTopOfBook(ticker);
-
-                response["has_top"] = top.book_has_top;
-                response["bid_price"] = top.bid_price;
-                response["ask_price"] = top.ask_price;
-                response["bid_volume"] = top.bid_volume;
-                response["ask_volume"] = top.ask_volume;
-                std::cout << "Ticker: " << ticker << "\n";
-                std::cout << "BID: " << top.bid_price << " vol: " << top.bid_volume << "\n";
-                std::cout << "ASK: " << top.ask_price << " vol: " << top.ask_volume << "\n";
+                succeeded = request_handler->Handle(request, session.ticker_cache, response);
             }
-            else if (action == "get_volume")
+            if (request.action == RequestAction::CANCEL_ORDER)
             {
-                std::string ticker = request["ticker"];
-                double price = request["price"];
-                int side = static_cast<int>(request["order_type"]);
-                OrderType order_type;
-                if (side == 1)
-                {
-                    order_type = OrderType::ASK;
-                }
-                else
-                {
-                    order_type = OrderType::BID;
-                }
-                int volume = exchange.GetVolume(ticker, price, order_type);
-                response["volume"] = volume;
+                (succeeded ? cancels_done : cancels_not_found)->Increment();
             }
-            else if (action == "get_previous_trades")
-            {
-                std::string ticker = request["ticker"];
-                int num_trades = request["num_previous_trades"];
-                std::vector<Trade> trades = exchange.GetPreviousTrades(ticker, num_trades);
+        }
+    }
+    catch (...)
+    {
+        write_failure(response);
+    }
+
+    request_duration->Observe(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+    return response;
+}
 
-                response["trades"] = nlohmann::json::array();
-                for (const auto &trade : trades)
+/**
+ * Admits and submits up to kMaxGatewayPipeline requests, then collects
+ * their answers in arrival order while the engine serves them in its own
+ * (cancels first, some possibly shed).
+ *
+ * @param slots per-request state, reused across rounds by the worker
+ */
+void Server::process_round(UringConnectionLoop::RoundRequest *requests,
+                           size_t count,
+                           EngineClient &engine,
+                           std::vector<EngineRoundSlot> &slots)
+{
+    if (slots.size() < kMaxGatewayPipeline)
+    {
+        slots.resize(kMaxGatewayPipeline);
+    }
+    for (size_t begin = 0; begin < count; begin += kMaxGatewayPipeline)
+    {
+        size_t batch = std::min(count - begin, kMaxGatewayPipeline);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            UringConnectionLoop::RoundRequest &round_request = requests[begin + i];
+            EngineRoundSlot &slot = slots[i];
+            slot.started = std::chrono::steady_clock::now();
+            slot.engine_request_id = 0;
+            slot.document = nullptr;
+            try
+            {
+                if (admit_request(round_request.data, round_request.size, *round_request.session,
+                                  slot.request, slot.document, round_request.response))
                 {
-                    response["trades"].push_back({{"bid_user_id", trade.bid_user_id},
-                                                  {"ask_user_id", trade.ask_user_id},
-                                                  {"price", trade.price},
-                                                  {"volume", trade.volume},
-                                                  {"timestamp", trade.timestamp}});
+                    slot.engine_request_id = submit_to_engine(slot.request, round_request.data, round_request.size,
+                                                              engine, round_request.response);
                 }
             }
-            else if (action == "cancel_order")
+            catch (...)
             {
-                std::string ticker = request["ticker"];
-                int order_id = request["order_id"];
-                bool success = exchange.CancelOrder(ticker, order_id);
-                response["success"] = success;
+                write_failure(round_request.response);
             }
-            else if (action == "handle_order")
-            {
-                std::string user_id = request["user_id"];
-                OrderType order_type = static_cast<OrderType>(request["order_type"]);
-
-                int volume = request["volume"];
-                double price = request["price"];
-                std::string ticker = request["ticker"];
-
-                OrderResult result = exchange.HandleOrder(user_id, order_type, volume, price, ticker);
-
-                response["order_added_to_book"] = result.order_added_to_book;
-                response["order_id"] = result.order_id;
-                response["trades_executed"] = result.trades_executed;
-                response["trades"] = nlohmann::json::array();
-
-                for (const auto &trade : result.trades)
-                {
-                    response["trades"].push_back({{"bid_user_id", trade.bid_user_id},
-                                                  {"ask_user_id", trade.ask_user_id},
-                                                  {"price", trade.price},
-                                                  {"volume", trade.volume},
-                                                  {"timestamp", trade.timestamp}});
-                }
+        }
 
-                std::cout << "ORDER ADDED TO BOOK" << result.order_added_to_book << "\n";
-                std::cout << "From: " << user_id << "\n";
-                if (order_type == OrderType::ASK)
+        for (size_t i = 0; i < batch; ++i)
+        {
+            std::string &response = requests[begin + i].response;
+            EngineRoundSlot &slot = slots[i];
+            if (slot.engine_request_id != 0)
+            {
+                try
                 {
-                    std::cout << "Side: " << "ASK" << "\n";
+                    bool succeeded = collect_from_engine(slot.request, slot.engine_request_id, engine, response);
+                    if (slot.request.action == RequestAction::CANCEL_ORDER)
+                    {
+                        (succeeded ? cancels_done : cancels_not_found)->Increment();
+                    }
                 }
-                else
+                catch (...)
                 {
-                    std::cout << "Side: " << "BID" << "\n";
+                    write_failure(response);
                 }
             }
-            else if (action == "get_trades_by_user")
-            {
-                std::string user_id = request["user_id"];
-                std::vector<Trade> trades = exchange.GetTradesByUser(user_id);
+            request_duration->Observe(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - slot.started)
+                    .count()));
+        }
+    }
+}
 
-                response["trades"] = nlohmann::json::array();
-                for (const auto &trade : trades)
-                {
-                    response["trades"].push_back({{"bid_user_id", trade.bid_user_id},
-                                                  {"ask_user_id", trade.ask_user_id},
-                                                  {"price", trade.price},
-                                                  {"volume", trade.volume},
-                                                  {"timestamp", trade.timestamp}});
-                }
-            }
-            else if (action == "register_user")
-            {
-                std::string user_id = request["user_id"];
-                bool success = exchange.RegisterUser(user_id);
-                response["success"] = success;
-            }
-            else
-            {
-                response["error"] = "Unknown action";
-            }
+bool Server::forward_to_engine(const ParsedRequest &request,
+                               const char *data,
+                               size_t size,
+                               EngineClient &engine,
+                               std::string &response)
+{
+    uint64_t engine_request_id = submit_to_engine(request, data, size, engine, response);
+    return engine_request_id == 0 || collect_from_engine(request, engine_request_id, engine, response);
+}
+
+uint64_t Server::submit_to_engine(const ParsedRequest &request,
+                                  const char *data,
+                                  size_t size,
+                                  EngineClient &engine,
+                                  std::string &response)
+{
+    // Tickers come from the table the engine published, no round trip
+    auto resolve_ticker = [&]()
+    {
+        if (request.Has(ParsedRequest::FIELD_TICKER_HANDLE))
+        {
+            return TickerHandle{request.ticker_handle};
+        }
+        request.Require(ParsedRequest::FIELD_TICKER);
+        return engine.ResolveTicker(std::string(request.ticker));
+    };
+
+    JsonWriter writer(response);
+    switch (request.action)
+    {
+    case RequestAction::GET_TICKERS:
+    {
+        response += tickers_response;
+        return 0;
+    }
+    case RequestAction::GET_ENGINE_LOAD:
+    {
+        EngineLoad load = engine.GetEngineLoad();
+        writer.BeginObject();
+        writer.Key(kQueueDepth).Uint(load.depth);
+        writer.Key(kMaxQueueDepth).Uint(load.max_depth);
+        writer.Key(kAdmitted).BeginObject();
+        for (size_t i = 0; i < kAdmissionClasses; ++i)
+        {
+            writer.Key(AdmissionClassToString(static_cast<AdmissionClass>(i))).Uint(load.admitted[i]);
         }
-        catch (const std::exception &e)
+        writer.EndObject();
+        writer.Key(kShed).BeginObject();
+        for (size_t i = 0; i < kAdmissionClasses; ++i)
         {
-            std::cerr << "Error processing request: " << e.what() << std::endl;
-            response["error"] = "Exception caught during processing";
+            writer.Key(AdmissionClassToString(static_cast<AdmissionClass>(i))).Uint(load.shed[i]);
         }
+        writer.EndObject();
+        writer.Key(kDroppedChannels).Uint(load.dropped_channels);
+        writer.EndObject();
+        return 0;
+    }
+    case RequestAction::RESOLVE_TICKER:
+    {
+        TickerHandle ticker = resolve_ticker();
+        writer.BeginObject().Key(kTickerHandle).Uint(ticker.index).EndObject();
+        return 0;
+    }
+    case RequestAction::HANDLE_ORDER:
+    {
+        request.Require(ParsedRequest::FIELD_USER_ID | ParsedRequest::FIELD_ORDER_TYPE |
+                        ParsedRequest::FIELD_VOLUME | ParsedRequest::FIELD_PRICE);
+        TickerHandle ticker = resolve_ticker();
+        return engine.SubmitOrder(std::string(request.user_id), static_cast<OrderType>(request.order_type),
+                                  request.volume, request.price, ticker);
+    }
+    case RequestAction::CANCEL_ORDER:
+    {
+        TickerHandle ticker = resolve_ticker();
+        request.Require(ParsedRequest::FIELD_ORDER_ID);
+        return engine.SubmitCancel(ticker, request.order_id);
+    }
+    default:
+    {
+        // Answered by the engine's RequestHandler from the client's JSON as is
+        return engine.SubmitQuery(std::string_view(data, size));
+    }
+    }
+}
 
-        // Send the response outside try/catch
-        std::string response_str = response.dump();
-        send(client_socket, response_str.c_str(), response_str.size(), 0);
+bool Server::collect_from_engine(const ParsedRequest &request,
+                                 uint64_t engine_request_id,
+                                 EngineClient &engine,
+                                 std::string &response)
+{
+    JsonWriter writer(response);
+    switch (request.action)
+    {
+    case RequestAction::HANDLE_ORDER:
+    {
+        writer.BeginObject().Key(kTrades).BeginArray();
+        JsonTradeWriter trade_writer(writer);
+        int64_t order_id = engine.CollectOrder(engine_request_id, trade_writer);
+        writer.EndArray();
+        writer.Key(kOrderAddedToBook).Bool(order_id > 0);
+        writer.Key(kOrderId).Int(order_id);
+        writer.Key(kTradesExecuted).Bool(trade_writer.GetFillCount() > 0);
+        writer.EndObject();
+        return true;
+    }
+    case RequestAction::CANCEL_ORDER:
+    {
+        bool cancelled = engine.CollectCancel(engine_request_id);
+        writer.BeginObject().Key(kSuccess).Bool(cancelled).EndObject();
+        return cancelled;
+    }
+    default:
+    {
+        // The engine's response is already JSON: passed through as is
+        engine.CollectQuery(engine_request_id, response);
+        return true;
+    }
     }
 }
@@ -0,0 +1,164 @@
+#include "server/thread_topology.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+
+namespace
+{
+    // Number in [0, CPU_SETSIZE); `what` names the value in the error
+    int ParseCpu(const std::string &text, const std::string &what)
+    {
+        size_t parsed = 0;
+        int cpu = -1;
+        try
+        {
+            cpu = std::stoi(text, &parsed);
+        }
+        catch (const std::exception &)
+        {
+            parsed = 0;
+        }
+        if (text.empty() || parsed != text.size() || cpu < 0 || cpu >= CPU_SETSIZE)
+        {
+            throw std::invalid_argument("Invalid " + what);
+        }
+        return cpu;
+    }
+
+    // Value following `args[index]`, which is erased along with it
+    std::string TakeValue(std::vector<std::string> &args, size_t index)
+    {
+        if (index + 1 >= args.size())
+        {
+            throw std::invalid_argument(args[index] + " needs a value");
+        }
+        std::string value = args[index + 1];
+        args.erase(args.begin() + index, args.begin() + index + 2);
+        return value;
+    }
+}
+
+std::vector<int> ParseCpuList(const std::string &list)
+{
+    std::vector<int> cpus;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+        std::string item = list.substr(start, end - start);
+        size_t dash = item.find('-');
+        if (dash == std::string::npos)
+        {
+            cpus.push_back(ParseCpu(item, "CPU list: " + list));
+        }
+        else
+        {
+            int first = ParseCpu(item.substr(0, dash), "CPU list: " + list);
+            int last = ParseCpu(item.substr(dash + 1), "CPU list: " + list);
+            if (first > last)
+            {
+                throw std::invalid_argument("Invalid CPU list: " + list);
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        start = end + 1;
+    }
+    return cpus;
+}
+
+/**
+ * @throws std::invalid_argument if a flag is missing its value or the value
+ * is malformed
+ */
+ThreadTopology ParseThreadTopology(std::vector<std::string> &args)
+{
+    ThreadTopology topology;
+    size_t i = 0;
+    while (i < args.size())
+    {
+        const std::string flag = args[i];
+        if (flag == "--acceptor-cpus")
+        {
+            topology.acceptor_cpus = ParseCpuList(TakeValue(args, i));
+        }
+        else if (flag == "--io-cpus")
+        {
+            topology.io_cpus = ParseCpuList(TakeValue(args, i));
+        }
+        else if (flag == "--engine-cpus")
+        {
+            topology.engine_cpus = ParseCpuList(TakeValue(args, i));
+        }
+        else if (flag == "--housekeeping-cpus")
+        {
+            topology.housekeeping_cpus = ParseCpuList(TakeValue(args, i));
+        }
+        else if (flag == "--io-threads")
+        {
+            std::string value = TakeValue(args, i);
+            topology.io_threads = ParseCpu(value, "thread count: " + value);
+        }
+        else if (flag == "--busy-poll")
+        {
+            topology.wait_strategy = WaitStrategy::BUSY_POLL;
+            args.erase(args.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    return topology;
+}
+
+std::vector<int> GetThreadAffinity()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &set))
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @throws std::runtime_error if none of `cpus` is usable (offline, or
+ * outside the process's cpuset)
+ */
+void PinCurrentThread(const std::vector<int> &cpus)
+{
+    if (cpus.empty())
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+        CPU_SET(cpu, &set);
+    }
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0)
+    {
+        throw std::runtime_error(std::string("Cannot pin thread: ") + std::strerror(error));
+    }
+}
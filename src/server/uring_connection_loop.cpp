@@ -0,0 +1,306 @@
+#include "server/uring_connection_loop.hpp"
+
+#include <cerrno>
+#include <iostream>
+#include <memory>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+// user_data: operation in the top byte, file descriptor below
+uint64_t UringConnectionLoop::Encode(Operation operation, int fd)
+{
+    return (static_cast<uint64_t>(operation) << 56) | static_cast<uint32_t>(fd);
+}
+
+/**
+ * @param listen_fd listening socket; with several loops on one port each
+ * should have its own SO_REUSEPORT socket so the kernel spreads connections
+ * @param callbacks produce the response for each request, one at a time
+ * or a round at a time
+ * @param max_send_queue_bytes unsent response bytes a connection may
+ * accumulate before it is disconnected as a slow consumer
+ * @param wait_strategy BUSY_POLL spins on the completion queue
+ * @throws std::runtime_error if io_uring or provided buffer rings are unavailable
+ */
+UringConnectionLoop::UringConnectionLoop(int listen_fd,
+                                         Callbacks callbacks,
+                                         size_t max_send_queue_bytes,
+                                         WaitStrategy wait_strategy)
+    : ring(kQueueDepth),
+      listen_fd(listen_fd),
+      on_request(std::move(callbacks.on_request)),
+      on_round(std::move(callbacks.on_round)),
+      max_send_queue_bytes(max_send_queue_bytes),
+      wait_strategy(wait_strategy),
+      connection_count(0),
+      slow_consumer_count(0)
+{
+    ring.RegisterBuffers(kBufferCount, kBufferSize);
+}
+
+UringConnectionLoop::~UringConnectionLoop()
+{
+    for (size_t fd = 0; fd < connections.size(); ++fd)
+    {
+        const Connection *connection = connections[fd].get();
+        if (connection != nullptr && (connection->open || connection->receiving || connection->sending))
+        {
+            close(static_cast<int>(fd));
+        }
+    }
+}
+
+void UringConnectionLoop::Run(const std::atomic<bool> &stop)
+{
+    ring.PrepareMultishotAccept(listen_fd, Encode(Operation::ACCEPT, listen_fd));
+    ring.PrepareTimeout(kStopCheckNanos, Encode(Operation::TIMEOUT, 0));
+    // Still entered when polling: with DEFER_TASKRUN the kernel only posts
+    // completions from inside io_uring_enter
+    const unsigned wait_count = wait_strategy == WaitStrategy::BUSY_POLL ? 0 : 1;
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        int result = ring.SubmitAndWait(wait_count);
+        if (result < 0 && result != -EBUSY && result != -EAGAIN)
+        {
+            std::cerr << "io_uring_enter failed: " << result << std::endl;
+            return;
+        }
+        ring.ForEachCompletion([&](const io_uring_cqe &cqe)
+                               { HandleCompletion(cqe, stop); });
+        if (!staged.empty())
+        {
+            HandleRound();
+        }
+    }
+}
+
+size_t UringConnectionLoop::GetConnectionCount() const
+{
+    return connection_count.load(std::memory_order_relaxed);
+}
+
+size_t UringConnectionLoop::GetSlowConsumerCount() const
+{
+    return slow_consumer_count.load(std::memory_order_relaxed);
+}
+
+void UringConnectionLoop::HandleCompletion(const io_uring_cqe &cqe, const std::atomic<bool> &stop)
+{
+    Operation operation = static_cast<Operation>(cqe.user_data >> 56);
+    int fd = static_cast<int>(cqe.user_data & 0xFFFFFFFF);
+    switch (operation)
+    {
+    case Operation::ACCEPT:
+        OnAccept(cqe);
+        break;
+    case Operation::RECV:
+        OnReceive(fd, cqe);
+        break;
+    case Operation::SEND:
+        OnSend(fd, cqe.res);
+        break;
+    case Operation::TIMEOUT:
+        if (!stop.load(std::memory_order_relaxed))
+        {
+            ring.PrepareTimeout(kStopCheckNanos, cqe.user_data);
+        }
+        break;
+    }
+}
+
+void UringConnectionLoop::OnAccept(const io_uring_cqe &cqe)
+{
+    if (!(cqe.flags & IORING_CQE_F_MORE))
+    {
+        // The kernel ended the multishot accept (error or CQ overflow)
+        ring.PrepareMultishotAccept(listen_fd, cqe.user_data);
+    }
+    if (cqe.res < 0)
+    {
+        return;
+    }
+
+    int fd = cqe.res;
+    if (static_cast<size_t>(fd) >= connections.size())
+    {
+        connections.resize(static_cast<size_t>(fd) + 1);
+    }
+    if (connections[fd] == nullptr)
+    {
+        connections[fd] = std::make_unique<Connection>();
+    }
+    Connection &connection = *connections[fd];
+    connection.open = true;
+    connection.receiving = true;
+    connection_count.fetch_add(1, std::memory_order_relaxed);
+    ring.PrepareMultishotRecv(fd, Encode(Operation::RECV, fd));
+}
+
+void UringConnectionLoop::OnReceive(int fd, const io_uring_cqe &cqe)
+{
+    Connection &connection = *connections[fd];
+    if (cqe.res > 0)
+    {
+        uint16_t buffer_id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        if (connection.open && on_round)
+        {
+            // The buffer stays out of the ring until the round is answered
+            staged.push_back(StagedReceive{fd, buffer_id, static_cast<size_t>(cqe.res)});
+            ++connection.staged;
+        }
+        else
+        {
+            if (connection.open)
+            {
+                QueueResponse(fd, on_request(ring.GetBuffer(buffer_id), static_cast<size_t>(cqe.res),
+                                             connection.session));
+            }
+            ring.RecycleBuffer(buffer_id);
+        }
+    }
+    if (cqe.flags & IORING_CQE_F_MORE)
+    {
+        return;
+    }
+
+    // Multishot receive ended: out of buffers (or CQ overflow) re-arms it,
+    // end of stream or an error closes the connection
+    if (connection.open && (cqe.res > 0 || cqe.res == -ENOBUFS))
+    {
+        ring.PrepareMultishotRecv(fd, cqe.user_data);
+        return;
+    }
+    connection.receiving = false;
+    connection.open = false;
+    CloseIfIdle(fd);
+}
+
+void UringConnectionLoop::OnSend(int fd, int result)
+{
+    Connection &connection = *connections[fd];
+    connection.sending = false;
+    if (result < 0)
+    {
+        Disconnect(fd);
+        CloseIfIdle(fd);
+        return;
+    }
+    connection.sent += static_cast<size_t>(result);
+    if (connection.sent == connection.in_flight.size())
+    {
+        connection.in_flight.clear();
+        connection.sent = 0;
+    }
+    SendPending(fd);
+    CloseIfIdle(fd);
+}
+
+/**
+ * Answers the requests staged during the last round of completions with
+ * one call to the round handler. Requests whose connection went away
+ * within the round are dropped unanswered.
+ */
+void UringConnectionLoop::HandleRound()
+{
+    if (round.size() < staged.size())
+    {
+        round.resize(staged.size());
+    }
+    auto release = [this](const StagedReceive &receive)
+    {
+        ring.RecycleBuffer(receive.buffer_id);
+        --connections[receive.fd]->staged;
+        CloseIfIdle(receive.fd);
+    };
+
+    size_t count = 0;
+    for (size_t i = 0; i < staged.size(); ++i)
+    {
+        StagedReceive receive = staged[i];
+        Connection &connection = *connections[receive.fd];
+        if (!connection.open)
+        {
+            release(receive);
+            continue;
+        }
+        RoundRequest &request = round[count];
+        request.data = ring.GetBuffer(receive.buffer_id);
+        request.size = receive.size;
+        request.session = &connection.session;
+        request.response.clear();
+        staged[count++] = receive;
+    }
+    staged.resize(count);
+
+    on_round(round.data(), count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (connections[staged[i].fd]->open)
+        {
+            QueueResponse(staged[i].fd, round[i].response);
+        }
+    }
+    // Buffers and connections are only let go once nothing points at them
+    for (const StagedReceive &receive : staged)
+    {
+        release(receive);
+    }
+    staged.clear();
+}
+
+void UringConnectionLoop::QueueResponse(int fd, std::string_view response)
+{
+    Connection &connection = *connections[fd];
+    connection.pending += response;
+    SendPending(fd);
+    // Still unsent past the bound: the client is not reading its responses
+    if (connection.in_flight.size() - connection.sent + connection.pending.size() > max_send_queue_bytes)
+    {
+        slow_consumer_count.fetch_add(1, std::memory_order_relaxed);
+        Disconnect(fd);
+    }
+}
+
+void UringConnectionLoop::SendPending(int fd)
+{
+    Connection &connection = *connections[fd];
+    if (connection.sending || !connection.open)
+    {
+        return;
+    }
+    if (connection.in_flight.empty())
+    {
+        if (connection.pending.empty())
+        {
+            return;
+        }
+        std::swap(connection.in_flight, connection.pending);
+    }
+    connection.sending = true;
+    ring.PrepareSend(fd, connection.in_flight.data() + connection.sent,
+                     connection.in_flight.size() - connection.sent,
+                     Encode(Operation::SEND, fd));
+}
+
+void UringConnectionLoop::Disconnect(int fd)
+{
+    // Makes the multishot receive and any send complete so the fd can go
+    connections[fd]->open = false;
+    shutdown(fd, SHUT_RDWR);
+}
+
+void UringConnectionLoop::CloseIfIdle(int fd)
+{
+    Connection &connection = *connections[fd];
+    if (connection.open || connection.receiving || connection.sending || connection.staged > 0)
+    {
+        return;
+    }
+    close(fd);
+    connection.session = ClientSession{};
+    connection.in_flight.clear();
+    connection.sent = 0;
+    connection.pending.clear();
+    connection_count.fetch_sub(1, std::memory_order_relaxed);
+}
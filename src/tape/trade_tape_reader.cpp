@@ -0,0 +1,182 @@
+#include "tape/trade_tape_reader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+    std::runtime_error TapeError(const std::string &what, const std::string &path)
+    {
+        return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+}
+
+/**
+ * Maps the tape of `ticker`.
+ *
+ * @throws std::runtime_error if the tape is missing or cannot be mapped
+ */
+TradeTapeReader::TradeTapeReader(const std::string &tape_directory, const std::string &ticker)
+    : directory(GetTapeTickerDirectory(tape_directory, ticker)), row_count(0)
+{
+    Refresh();
+}
+
+TradeTapeReader::~TradeTapeReader()
+{
+    Unmap();
+}
+
+TradeTapeReader::TradeTapeReader(TradeTapeReader &&other) noexcept
+    : directory(std::move(other.directory)),
+      columns(other.columns),
+      user_names(std::move(other.user_names)),
+      row_count(other.row_count)
+{
+    other.columns.fill(MappedColumn{});
+    other.row_count = 0;
+}
+
+TradeTapeReader &TradeTapeReader::operator=(TradeTapeReader &&other) noexcept
+{
+    if (this != &other)
+    {
+        Unmap();
+        directory = std::move(other.directory);
+        columns = other.columns;
+        user_names = std::move(other.user_names);
+        row_count = other.row_count;
+        other.columns.fill(MappedColumn{});
+        other.row_count = 0;
+    }
+    return *this;
+}
+
+void TradeTapeReader::Unmap()
+{
+    for (MappedColumn &column : columns)
+    {
+        if (column.data != nullptr)
+        {
+            munmap(const_cast<void *>(column.data), column.size);
+        }
+        column = MappedColumn{};
+    }
+}
+
+/**
+ * Maps each column at its current length and reloads the user names.
+ *
+ * The writer appends names before rows and a reader sizes the view by its
+ * shortest column, so the view never includes a partly written trade or
+ * a user index without its name.
+ *
+ * @throws std::runtime_error if a file is missing or cannot be mapped
+ */
+size_t TradeTapeReader::Refresh()
+{
+    std::array<MappedColumn, kTapeColumnCount> mapped{};
+    auto release = [&mapped]()
+    {
+        for (MappedColumn &column : mapped)
+        {
+            if (column.data != nullptr)
+            {
+                munmap(const_cast<void *>(column.data), column.size);
+            }
+        }
+    };
+    size_t rows = std::numeric_limits<size_t>::max();
+    for (size_t column = 0; column < kTapeColumnCount; ++column)
+    {
+        const std::string path = GetTapeColumnPath(directory, static_cast<TapeColumn>(column));
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) < 0)
+        {
+            std::runtime_error error = TapeError("Cannot open trade tape column", path);
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            release();
+            throw error;
+        }
+        mapped[column].size = static_cast<size_t>(info.st_size);
+        if (mapped[column].size > 0)
+        {
+            void *data = mmap(nullptr, mapped[column].size, PROT_READ, MAP_SHARED, fd, 0);
+            mapped[column].data = data == MAP_FAILED ? nullptr : data;
+        }
+        close(fd);
+        if (mapped[column].size > 0 && mapped[column].data == nullptr)
+        {
+            std::runtime_error error = TapeError("mmap failed for", path);
+            release();
+            throw error;
+        }
+        rows = std::min(rows, mapped[column].size / kTapeColumnWidths[column]);
+    }
+
+    // Names are read after the columns were sized, so every mapped row's users are in it
+    std::ifstream users(directory + "/" + kTapeUsersFile);
+    std::vector<std::string> names;
+    std::string name;
+    while (std::getline(users, name))
+    {
+        names.push_back(ParseTapeUserName(name));
+    }
+
+    Unmap();
+    columns = mapped;
+    user_names = std::move(names);
+    row_count = rows;
+    return row_count;
+}
+
+size_t TradeTapeReader::GetTradeCount() const
+{
+    return row_count;
+}
+
+TapeTrade TradeTapeReader::GetTrade(size_t row) const
+{
+    if (row >= row_count)
+    {
+        throw std::out_of_range("Tape row " + std::to_string(row) + " past the end");
+    }
+    return TapeTrade{GetTradeIds()[row], GetPrices()[row], GetVolumes()[row],
+                     GetTimestamps()[row], GetBidUsers()[row], GetAskUsers()[row]};
+}
+
+const std::string &TradeTapeReader::GetUserName(uint32_t user) const
+{
+    return user_names.at(user);
+}
+
+TapeRange TradeTapeReader::FindTimeRange(int64_t from, int64_t to) const
+{
+    const int64_t *begin = GetTimestamps();
+    const int64_t *end = begin + row_count;
+    const int64_t *first = std::lower_bound(begin, end, from);
+    const int64_t *last = std::lower_bound(first, end, std::max(from, to));
+    return TapeRange{static_cast<size_t>(first - begin), static_cast<size_t>(last - begin)};
+}
+
+TapeRange TradeTapeReader::FindTradeIdRange(int64_t first_id, int64_t end_id) const
+{
+    const int64_t *begin = GetTradeIds();
+    const int64_t *end = begin + row_count;
+    const int64_t *first = std::lower_bound(begin, end, first_id);
+    const int64_t *last = std::lower_bound(first, end, std::max(first_id, end_id));
+    return TapeRange{static_cast<size_t>(first - begin), static_cast<size_t>(last - begin)};
+}
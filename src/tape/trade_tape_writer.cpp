@@ -0,0 +1,293 @@
+#include "tape/trade_tape_writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    std::runtime_error TapeError(const std::string &what, const std::string &path)
+    {
+        return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+
+    int OpenForAppend(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throw TapeError("open failed for", path);
+        }
+        return fd;
+    }
+
+    size_t GetFileSize(int fd, const std::string &path)
+    {
+        struct stat info;
+        if (fstat(fd, &info) < 0)
+        {
+            throw TapeError("fstat failed for", path);
+        }
+        return static_cast<size_t>(info.st_size);
+    }
+
+    void ReadAt(int fd, void *data, size_t size, size_t offset, const std::string &path)
+    {
+        char *out = static_cast<char *>(data);
+        while (size > 0)
+        {
+            ssize_t got = pread(fd, out, size, static_cast<off_t>(offset));
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                throw TapeError("read failed for", path);
+            }
+            out += got;
+            size -= static_cast<size_t>(got);
+            offset += static_cast<size_t>(got);
+        }
+    }
+
+    void WriteAll(int fd, const void *data, size_t size)
+    {
+        const char *in = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            ssize_t written = write(fd, in, size);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written < 0)
+            {
+                throw std::runtime_error(std::string("Trade tape write failed: ") + std::strerror(errno));
+            }
+            in += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    template <typename T>
+    void WriteColumn(int fd, const std::vector<T> &values)
+    {
+        WriteAll(fd, values.data(), values.size() * sizeof(T));
+    }
+}
+
+/**
+ * Opens (or starts) the tape of every ticker.
+ *
+ * @param directory Root of the tape; one subdirectory per ticker.
+ * @param tickers In TickerHandle order, as passed to the Exchange.
+ * @throws std::runtime_error if a directory or file cannot be created or read.
+ */
+TradeTapeWriter::TradeTapeWriter(const std::string &directory, const std::vector<std::string> &tickers)
+{
+    tapes.reserve(tickers.size());
+    try
+    {
+        for (const std::string &ticker : tickers)
+        {
+            tapes.emplace_back();
+            TickerTape &tape = tapes.back();
+            tape.directory = GetTapeTickerDirectory(directory, ticker);
+            tape.column_fds.fill(-1);
+            tape.users_fd = -1;
+            std::filesystem::create_directories(tape.directory);
+            Open(tape);
+        }
+    }
+    catch (...)
+    {
+        Close();
+        throw;
+    }
+}
+
+TradeTapeWriter::~TradeTapeWriter()
+{
+    try
+    {
+        Flush();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+    Close();
+}
+
+/**
+ * Opens the column files of one ticker and recovers where the tape ends.
+ *
+ * A crash can leave the columns at different lengths, or the users file
+ * ending mid-name; both are cut back to the last complete trade and name
+ * so new rows line up again.
+ */
+void TradeTapeWriter::Open(TickerTape &tape)
+{
+    size_t rows = std::numeric_limits<size_t>::max();
+    for (size_t column = 0; column < kTapeColumnCount; ++column)
+    {
+        const std::string path = GetTapeColumnPath(tape.directory, static_cast<TapeColumn>(column));
+        tape.column_fds[column] = OpenForAppend(path);
+        rows = std::min(rows, GetFileSize(tape.column_fds[column], path) / kTapeColumnWidths[column]);
+    }
+    for (size_t column = 0; column < kTapeColumnCount; ++column)
+    {
+        const std::string path = GetTapeColumnPath(tape.directory, static_cast<TapeColumn>(column));
+        if (ftruncate(tape.column_fds[column], static_cast<off_t>(rows * kTapeColumnWidths[column])) < 0)
+        {
+            throw TapeError("ftruncate failed for", path);
+        }
+    }
+    tape.row_count = rows;
+
+    const std::string users_path = tape.directory + "/" + kTapeUsersFile;
+    tape.users_fd = OpenForAppend(users_path);
+    std::string users(GetFileSize(tape.users_fd, users_path), '\0');
+    ReadAt(tape.users_fd, users.data(), users.size(), 0, users_path);
+    users.resize(users.rfind('\n') + 1); // npos + 1 == 0
+    if (ftruncate(tape.users_fd, static_cast<off_t>(users.size())) < 0)
+    {
+        throw TapeError("ftruncate failed for", users_path);
+    }
+    size_t line_start = 0;
+    while (line_start < users.size())
+    {
+        size_t line_end = users.find('\n', line_start);
+        tape.user_indexes.emplace(
+            ParseTapeUserName(std::string_view(users).substr(line_start, line_end - line_start)),
+            static_cast<uint32_t>(tape.user_indexes.size()));
+        line_start = line_end + 1;
+    }
+
+    tape.last_trade_id = 0;
+    tape.last_timestamp = 0;
+    if (rows > 0)
+    {
+        const size_t trade_id = static_cast<size_t>(TapeColumn::TRADE_ID);
+        const size_t timestamp = static_cast<size_t>(TapeColumn::TIMESTAMP);
+        ReadAt(tape.column_fds[trade_id], &tape.last_trade_id, sizeof(int64_t), (rows - 1) * sizeof(int64_t),
+               GetTapeColumnPath(tape.directory, TapeColumn::TRADE_ID));
+        ReadAt(tape.column_fds[timestamp], &tape.last_timestamp, sizeof(int64_t), (rows - 1) * sizeof(int64_t),
+               GetTapeColumnPath(tape.directory, TapeColumn::TIMESTAMP));
+    }
+}
+
+void TradeTapeWriter::Close()
+{
+    for (TickerTape &tape : tapes)
+    {
+        for (int fd : tape.column_fds)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+        if (tape.users_fd >= 0)
+        {
+            close(tape.users_fd);
+        }
+        tape.column_fds.fill(-1);
+        tape.users_fd = -1;
+    }
+}
+
+uint32_t TradeTapeWriter::InternUser(TickerTape &tape, const std::string &user_id)
+{
+    auto it = tape.user_indexes.find(user_id);
+    if (it != tape.user_indexes.end())
+    {
+        return it->second;
+    }
+    const uint32_t index = static_cast<uint32_t>(tape.user_indexes.size());
+    tape.user_indexes.emplace(user_id, index);
+    AppendTapeUserName(tape.new_users, user_id);
+    tape.new_users += '\n';
+    return index;
+}
+
+/**
+ * Buffers one trade. The timestamp is held at the tape's latest if the
+ * clock stepped backwards, so the timestamp column stays sorted.
+ */
+void TradeTapeWriter::OnTrade(TickerHandle ticker, const Fill &fill)
+{
+    TickerTape &tape = tapes[ticker.index];
+    const Trade &trade = fill.trade;
+    tape.last_timestamp = std::max(tape.last_timestamp, static_cast<int64_t>(trade.timestamp));
+    tape.last_trade_id = trade.trade_id;
+
+    tape.trade_ids.push_back(trade.trade_id);
+    tape.prices.push_back(fill.price);
+    tape.volumes.push_back(trade.volume);
+    tape.timestamps.push_back(tape.last_timestamp);
+    tape.bid_users.push_back(InternUser(tape, trade.bid_user_id));
+    tape.ask_users.push_back(InternUser(tape, trade.ask_user_id));
+}
+
+/**
+ * Appends one ticker's buffered trades: new user names first, then each
+ * column, so a reader never sees a row before the names it refers to.
+ *
+ * @throws std::runtime_error if a write fails
+ */
+void TradeTapeWriter::Append(TickerTape &tape)
+{
+    WriteAll(tape.users_fd, tape.new_users.data(), tape.new_users.size());
+    WriteColumn(tape.column_fds[static_cast<size_t>(TapeColumn::TRADE_ID)], tape.trade_ids);
+    WriteColumn(tape.column_fds[static_cast<size_t>(TapeColumn::PRICE)], tape.prices);
+    WriteColumn(tape.column_fds[static_cast<size_t>(TapeColumn::VOLUME)], tape.volumes);
+    WriteColumn(tape.column_fds[static_cast<size_t>(TapeColumn::TIMESTAMP)], tape.timestamps);
+    WriteColumn(tape.column_fds[static_cast<size_t>(TapeColumn::BID_USER)], tape.bid_users);
+    WriteColumn(tape.column_fds[static_cast<size_t>(TapeColumn::ASK_USER)], tape.ask_users);
+    tape.row_count += tape.trade_ids.size();
+
+    tape.new_users.clear();
+    tape.trade_ids.clear();
+    tape.prices.clear();
+    tape.volumes.clear();
+    tape.timestamps.clear();
+    tape.bid_users.clear();
+    tape.ask_users.clear();
+}
+
+/**
+ * @throws std::runtime_error if a write fails
+ */
+size_t TradeTapeWriter::Flush()
+{
+    size_t appended = 0;
+    for (TickerTape &tape : tapes)
+    {
+        if (!tape.trade_ids.empty())
+        {
+            Append(tape);
+            ++appended;
+        }
+    }
+    return appended;
+}
+
+size_t TradeTapeWriter::GetTradeCount(TickerHandle ticker) const
+{
+    const TickerTape &tape = tapes.at(ticker.index);
+    return tape.row_count + tape.trade_ids.size();
+}
+
+int64_t TradeTapeWriter::GetLastTradeId(TickerHandle ticker) const
+{
+    return tapes.at(ticker.index).last_trade_id;
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "exchange/exchange.hpp"
 #include "utils/order_type.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+#include <chrono>
 #include <stdexcept>
 #include <iostream>
 
@@ -410,6 +413,86 @@ TEST(ExchangeTest, CancelPartialOrder)
     EXPECT_EQ(ex.GetVolume("NFLX", 300.0, OrderType::ASK), 0);
 }
 
+TEST(ExchangeTest, OrderIdsUniqueAcrossTickers)
+{
+    Exchange ex({"AAPL", "GOOG"});
+
+    // Each book issues IDs from its own shard, so same-sequence IDs must differ
+    auto aapl = ex.HandleOrder("askUser", OrderType::ASK, 10, 100.0, "AAPL");
+    auto goog = ex.HandleOrder("askUser", OrderType::ASK, 10, 100.0, "GOOG");
+    ASSERT_TRUE(aapl.order_added_to_book);
+    ASSERT_TRUE(goog.order_added_to_book);
+    EXPECT_NE(aapl.order_id, goog.order_id);
+
+    // Trade IDs come from the same per-book sequence as order IDs
+    auto fill = ex.HandleOrder("bidUser", OrderType::BID, 10, 100.0, "GOOG");
+    ASSERT_EQ(fill.trades.size(), 1u);
+    EXPECT_NE(fill.trades[0].trade_id, goog.order_id);
+    EXPECT_NE(fill.trades[0].trade_id, aapl.order_id);
+
+    EXPECT_TRUE(ex.CancelOrder("AAPL", aapl.order_id));
+}
+
+TEST(ExchangeTest, TickerHandleMatchesStringApi)
+{
+    Exchange ex({"AAPL", "GOOG"});
+
+    TickerHandle aapl = ex.ResolveTicker("AAPL");
+    TickerHandle goog = ex.ResolveTicker("GOOG");
+    EXPECT_NE(aapl, goog);
+    EXPECT_EQ(aapl, ex.ResolveTicker("AAPL")) << "Handles should be stable";
+    EXPECT_THROW(ex.ResolveTicker("MSFT"), std::runtime_error);
+
+    // Orders placed by handle are visible through the string API and vice versa
+    auto ask = ex.HandleOrder("askUser", OrderType::ASK, 10, 100.0, aapl);
+    ASSERT_TRUE(ask.order_added_to_book);
+    EXPECT_EQ(ex.GetVolume("AAPL", 100.0, OrderType::ASK), 10);
+    EXPECT_EQ(ex.GetVolume(goog, 100.0, OrderType::ASK), 0);
+
+    auto bid = ex.HandleOrder("bidUser", OrderType::BID, 4, 100.0, "AAPL");
+    ASSERT_EQ(bid.trades.size(), 1u);
+
+    TopOfBook top = ex.GetTopOfBook(aapl);
+    EXPECT_TRUE(top.book_has_top);
+    EXPECT_EQ(top.ask_volume, 6);
+    EXPECT_EQ(ex.GetPreviousTrades(aapl, 5).size(), 1u);
+
+    EXPECT_TRUE(ex.CancelOrder(aapl, ask.order_id));
+    EXPECT_EQ(ex.GetVolume(aapl, 100.0, OrderType::ASK), 0);
+}
+
+TEST(ExchangeTest, InvalidTickerHandleThrows)
+{
+    Exchange ex({"AAPL"});
+
+    TickerHandle bogus{42};
+    EXPECT_THROW(ex.GetTopOfBook(bogus), std::runtime_error);
+    EXPECT_THROW(ex.HandleOrder("user", OrderType::BID, 1, 1.0, bogus), std::runtime_error);
+}
+
+TEST(ExchangeTest, SinkOverloadRecordsTradesByUser)
+{
+    Exchange ex({"AAPL", "GOOG"});
+    TickerHandle aapl = ex.ResolveTicker("AAPL");
+    TickerHandle goog = ex.ResolveTicker("GOOG");
+
+    ex.HandleOrder("askUser", OrderType::ASK, 5, 100.0, aapl);
+    ex.HandleOrder("askUser", OrderType::ASK, 5, 200.0, goog);
+
+    TradeCollector collector;
+    EXPECT_EQ(ex.HandleOrder("bidUser", OrderType::BID, 5, 100.0, aapl, collector), -1);
+    EXPECT_EQ(ex.HandleOrder("bidUser", OrderType::BID, 5, 200.0, goog, collector), -1);
+    ASSERT_EQ(collector.trades.size(), 2u);
+
+    // History is rebuilt from the books in fill order
+    auto trades = ex.GetTradesByUser("askUser");
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].price, 100);
+    EXPECT_EQ(trades[1].price, 200);
+    EXPECT_EQ(trades[1].trade_id, collector.trades[1].trade_id);
+    EXPECT_EQ(ex.GetTradesByUser("bidUser").size(), 2u);
+}
+
 // -------------------------------------------------------------------
 // 1) Test User Registration
 // -------------------------------------------------------------------
@@ -485,6 +568,249 @@ TEST(ExchangeTest, MultipleTradesByUser)
     EXPECT_EQ(tradesX.size(), 2u);
 }
 
+// -------------------------------------------------------------------
+// 5) Portfolios maintained from fills
+// -------------------------------------------------------------------
+TEST(ExchangeTest, PortfolioUpdatedOnFill)
+{
+    Exchange ex({"AAPL"});
+    ex.RegisterUser("buyer");
+    ex.RegisterUser("seller");
+
+    ex.HandleOrder("seller", OrderType::ASK, 10, 100.5, "AAPL");
+    ex.HandleOrder("buyer", OrderType::BID, 4, 101.0, "AAPL"); // Fills 4 @ 100.5
+
+    const Portfolio &buyer = ex.GetPortfolio("buyer");
+    EXPECT_EQ(buyer.positions.at("AAPL").net_shares, 4);
+    EXPECT_DOUBLE_EQ(buyer.positions.at("AAPL").avg_cost, 100.5);
+    EXPECT_DOUBLE_EQ(buyer.cash_balance, -402.0);
+
+    const Portfolio &seller = ex.GetPortfolio("seller");
+    EXPECT_EQ(seller.positions.at("AAPL").net_shares, -4);
+    EXPECT_DOUBLE_EQ(seller.cash_balance, 402.0);
+
+    // Seller buys back at a lower price => realized PnL
+    ex.HandleOrder("buyer", OrderType::ASK, 4, 99.5, "AAPL");
+    ex.HandleOrder("seller", OrderType::BID, 4, 99.5, "AAPL");
+    EXPECT_EQ(seller.positions.at("AAPL").net_shares, 0);
+    EXPECT_DOUBLE_EQ(seller.realized_pnl, 4.0);
+    EXPECT_DOUBLE_EQ(buyer.realized_pnl, -4.0);
+}
+
+TEST(ExchangeTest, PortfolioRequiresRegistration)
+{
+    Exchange ex({"AAPL"});
+    ex.RegisterUser("registered");
+
+    // Unregistered counterparty still trades, but has no portfolio
+    ex.HandleOrder("ghost", OrderType::ASK, 5, 10.0, "AAPL");
+    ex.HandleOrder("registered", OrderType::BID, 5, 10.0, "AAPL");
+
+    EXPECT_EQ(ex.GetPortfolio("registered").positions.at("AAPL").net_shares, 5);
+    EXPECT_THROW(ex.GetPortfolio("ghost"), std::runtime_error);
+    EXPECT_EQ(ex.GetTradesByUser("ghost").size(), 1u);
+}
+
+TEST(ExchangeTest, LeaderboardMarksAtLastTrade)
+{
+    Exchange ex({"AAPL"});
+    ex.RegisterUser("long");
+    ex.RegisterUser("short");
+    ex.RegisterUser("flat");
+
+    // long buys 10 @ 100 from short
+    ex.HandleOrder("short", OrderType::ASK, 10, 100.0, "AAPL");
+    ex.HandleOrder("long", OrderType::BID, 10, 100.0, "AAPL");
+    EXPECT_DOUBLE_EQ(ex.GetEquity("long"), 0.0);
+
+    // Unregistered users move the price to 110
+    ex.HandleOrder("ghost1", OrderType::ASK, 1, 110.0, "AAPL");
+    ex.HandleOrder("ghost2", OrderType::BID, 1, 110.0, "AAPL");
+
+    EXPECT_DOUBLE_EQ(ex.GetUnrealizedPnL("long"), 100.0);
+    EXPECT_DOUBLE_EQ(ex.GetUnrealizedPnL("short"), -100.0);
+
+    auto leaderboard = ex.GetLeaderboard(3);
+    ASSERT_EQ(leaderboard.size(), 3u);
+    EXPECT_EQ(leaderboard[0].user_id, "long");
+    EXPECT_DOUBLE_EQ(leaderboard[0].equity, 100.0);
+    EXPECT_EQ(leaderboard[1].user_id, "flat");
+    EXPECT_EQ(leaderboard[2].user_id, "short");
+    EXPECT_DOUBLE_EQ(leaderboard[2].equity, -100.0);
+
+    EXPECT_THROW(ex.GetEquity("ghost1"), std::runtime_error);
+}
+
+// -------------------------------------------------------------------
+// 6) Pre-trade risk checks
+// -------------------------------------------------------------------
+TEST(ExchangeTest, RiskRejectsBeforeMatching)
+{
+    RiskLimits limits;
+    limits.max_order_volume = 50;
+    limits.max_open_orders = 1;
+    Exchange ex({"AAPL"}, limits);
+    ex.RegisterUser("trader");
+
+    EXPECT_THROW(ex.HandleOrder("trader", OrderType::BID, 51, 10.0, "AAPL"), RiskRejection);
+    EXPECT_EQ(ex.GetVolume("AAPL", 10.0, OrderType::BID), 0) << "Rejected order must not reach the book";
+
+    auto first = ex.HandleOrder("trader", OrderType::BID, 10, 10.0, "AAPL");
+    ASSERT_TRUE(first.order_added_to_book);
+    try
+    {
+        ex.HandleOrder("trader", OrderType::BID, 10, 9.0, "AAPL");
+        FAIL() << "Second resting order should breach max_open_orders";
+    }
+    catch (const RiskRejection &e)
+    {
+        EXPECT_EQ(e.GetReason(), RiskCheck::MAX_OPEN_ORDERS);
+    }
+
+    // Fully filling the resting order frees the slot
+    ex.HandleOrder("other", OrderType::ASK, 10, 10.0, "AAPL");
+    EXPECT_NO_THROW(ex.HandleOrder("trader", OrderType::BID, 10, 9.0, "AAPL"));
+}
+
+TEST(ExchangeTest, PerUserLimitsApplyWithoutRegistering)
+{
+    RiskLimits limits;
+    limits.max_open_orders = 1;
+    Exchange ex({"AAPL"}, limits);
+
+    ASSERT_TRUE(ex.HandleOrder("ghost", OrderType::BID, 10, 10.0, "AAPL").order_added_to_book);
+    try
+    {
+        ex.HandleOrder("ghost", OrderType::BID, 10, 9.0, "AAPL");
+        FAIL() << "An unregistered user's second resting order should breach max_open_orders";
+    }
+    catch (const RiskRejection &e)
+    {
+        EXPECT_EQ(e.GetReason(), RiskCheck::MAX_OPEN_ORDERS);
+    }
+    EXPECT_EQ(ex.GetVolume("AAPL", 9.0, OrderType::BID), 0);
+    EXPECT_FALSE(ex.RegisterUser("ghost")) << "The first order registered the user";
+}
+
+TEST(ExchangeTest, BuyingPowerTracksOrdersAndFills)
+{
+    RiskLimits limits;
+    limits.buying_power = 1000.0;
+    Exchange ex({"AAPL"}, limits);
+    ex.RegisterUser("buyer");
+    ex.RegisterUser("seller");
+
+    auto resting = ex.HandleOrder("buyer", OrderType::BID, 60, 10.0, "AAPL");
+    ASSERT_TRUE(resting.order_added_to_book);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("buyer"), 400.0);
+    try
+    {
+        ex.HandleOrder("buyer", OrderType::BID, 50, 10.0, "AAPL");
+        FAIL() << "Order should exceed remaining buying power";
+    }
+    catch (const RiskRejection &e)
+    {
+        EXPECT_EQ(e.GetReason(), RiskCheck::INSUFFICIENT_BUYING_POWER);
+    }
+
+    // A fill moves the notional from the resting order into the position
+    ex.HandleOrder("seller", OrderType::ASK, 20, 10.0, "AAPL");
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("buyer"), 400.0);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("seller"), 800.0);
+
+    // Cancelling the remainder releases it
+    ex.CancelOrder("AAPL", resting.order_id);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("buyer"), 800.0);
+}
+
+TEST(ExchangeTest, PositionCanBeClosedWithNoBuyingPowerLeft)
+{
+    RiskLimits limits;
+    limits.buying_power = 1000.0;
+    Exchange ex({"AAPL"}, limits);
+    ex.RegisterUser("long");
+    ex.RegisterUser("maker");
+
+    // Long 100 at 10 and short 100 at 10: both fully committed
+    ex.HandleOrder("maker", OrderType::ASK, 100, 10.0, "AAPL");
+    ex.HandleOrder("long", OrderType::BID, 100, 10.0, "AAPL");
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("long"), 0.0);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("maker"), 0.0);
+    EXPECT_THROW(ex.HandleOrder("long", OrderType::BID, 1, 10.0, "AAPL"), RiskRejection);
+
+    // Flattening orders still go through, resting or trading
+    auto closing = ex.HandleOrder("long", OrderType::ASK, 100, 10.0, "AAPL");
+    EXPECT_TRUE(closing.order_added_to_book);
+    EXPECT_NO_THROW(ex.HandleOrder("maker", OrderType::BID, 100, 10.0, "AAPL"));
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("long"), 1000.0);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("maker"), 1000.0);
+}
+
+TEST(ExchangeTest, ReducingOrderLeavesBuyingPowerUnchanged)
+{
+    RiskLimits limits;
+    limits.buying_power = 2000.0;
+    Exchange ex({"AAPL"}, limits);
+    ex.RegisterUser("long");
+    ex.RegisterUser("maker");
+
+    ex.HandleOrder("maker", OrderType::ASK, 100, 10.0, "AAPL");
+    ex.HandleOrder("long", OrderType::BID, 100, 10.0, "AAPL");
+    ASSERT_DOUBLE_EQ(ex.GetBuyingPower("long"), 1000.0);
+
+    // A resting sell that only closes the long commits nothing
+    auto closing = ex.HandleOrder("long", OrderType::ASK, 100, 10.0, "AAPL");
+    ASSERT_TRUE(closing.order_added_to_book);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("long"), 1000.0);
+    // ...so a new entry is judged against the real total
+    EXPECT_NO_THROW(ex.HandleOrder("long", OrderType::BID, 100, 9.0, "AAPL"));
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("long"), 100.0);
+
+    // Partly filling and then cancelling it moves only the position exposure
+    ex.HandleOrder("maker", OrderType::BID, 40, 10.0, "AAPL");
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("long"), 500.0);
+    ex.CancelOrder("AAPL", closing.order_id);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("long"), 500.0);
+}
+
+TEST(ExchangeTest, RiskCountersReleasedOnCancelAndSelfTrade)
+{
+    RiskLimits limits;
+    limits.max_open_orders = 2;
+    limits.max_position = 20;
+    Exchange ex({"AAPL"}, limits);
+    ex.RegisterUser("trader");
+
+    auto ask = ex.HandleOrder("trader", OrderType::ASK, 20, 10.0, "AAPL");
+    EXPECT_TRUE(ex.CancelOrder("AAPL", ask.order_id));
+
+    // Self-trade prevention cancels the resting ASK, releasing its slot
+    ex.HandleOrder("trader", OrderType::ASK, 20, 10.0, "AAPL");
+    auto bid = ex.HandleOrder("trader", OrderType::BID, 20, 11.0, "AAPL");
+    EXPECT_TRUE(bid.trades.empty());
+    EXPECT_EQ(ex.GetVolume("AAPL", 10.0, OrderType::ASK), 0);
+
+    // Resting BID of 20 uses the whole position budget
+    EXPECT_THROW(ex.HandleOrder("trader", OrderType::BID, 1, 11.0, "AAPL"), RiskRejection);
+
+    // Only the resting BID is open, so one more order fits
+    EXPECT_NO_THROW(ex.HandleOrder("trader", OrderType::ASK, 5, 12.0, "AAPL"));
+    EXPECT_THROW(ex.HandleOrder("trader", OrderType::ASK, 5, 13.0, "AAPL"), RiskRejection);
+}
+
+TEST(ExchangeTest, PriceCollarUsesLastTrade)
+{
+    RiskLimits limits;
+    limits.price_collar = 0.05;
+    Exchange ex({"AAPL"}, limits);
+
+    ex.HandleOrder("a", OrderType::ASK, 1, 100.0, "AAPL");
+    ex.HandleOrder("b", OrderType::BID, 1, 100.0, "AAPL");
+
+    EXPECT_THROW(ex.HandleOrder("a", OrderType::ASK, 1, 94.0, "AAPL"), RiskRejection);
+    EXPECT_NO_THROW(ex.HandleOrder("a", OrderType::ASK, 1, 96.0, "AAPL"));
+}
+
 // // -------------------------------------------------------------------
 // // 5) Attempting to Place Order with Unregistered User
 // // -------------------------------------------------------------------
@@ -495,3 +821,88 @@ TEST(ExchangeTest, MultipleTradesByUser)
 //     // Unregistered user attempts to place an order
 //     EXPECT_THROW(ex.HandleOrder("ghostTrader", OrderType::BID, 10, 50000.0, "BTC"), std::runtime_error);
 // }
+
+TEST(ExchangeTest, MatchingPolicyIsPerTicker)
+{
+    Exchange ex({"AAPL", "MSFT"});
+    ex.SetMatchingPolicy("MSFT", MatchingPolicy::PRO_RATA);
+    EXPECT_EQ(ex.GetMatchingPolicy("AAPL"), MatchingPolicy::FIFO);
+    EXPECT_EQ(ex.GetMatchingPolicy("MSFT"), MatchingPolicy::PRO_RATA);
+    EXPECT_THROW(ex.SetMatchingPolicy("TSLA", MatchingPolicy::PRO_RATA), std::runtime_error);
+
+    for (const std::string ticker : {"AAPL", "MSFT"})
+    {
+        ex.HandleOrder("first", OrderType::ASK, 10, 10.0, ticker);
+        ex.HandleOrder("second", OrderType::ASK, 10, 10.0, ticker);
+    }
+
+    // FIFO: the first order takes everything; pro-rata: split evenly
+    auto fifo = ex.HandleOrder("taker", OrderType::BID, 10, 10.0, "AAPL");
+    ASSERT_EQ(fifo.trades.size(), 1u);
+    EXPECT_EQ(fifo.trades[0].ask_user_id, "first");
+
+    auto pro_rata = ex.HandleOrder("taker", OrderType::BID, 10, 10.0, "MSFT");
+    ASSERT_EQ(pro_rata.trades.size(), 2u);
+    EXPECT_EQ(pro_rata.trades[0].volume, 5);
+    EXPECT_EQ(pro_rata.trades[1].volume, 5);
+}
+
+TEST(ExchangeTest, OpeningAuctionRecordsFillsAndReleasesBothSides)
+{
+    RiskLimits limits;
+    limits.buying_power = 1000.0;
+    limits.max_open_orders = 1;
+    Exchange ex({"AAPL"}, limits);
+    ex.RegisterUser("buyer");
+    ex.RegisterUser("seller");
+
+    ex.StartAuction("AAPL");
+    ex.HandleOrder("buyer", OrderType::BID, 10, 12.0, "AAPL");
+    ex.HandleOrder("seller", OrderType::ASK, 10, 11.0, "AAPL");
+    EXPECT_EQ(ex.GetTradingPhase("AAPL"), TradingPhase::AUCTION);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("buyer"), 880.0);
+
+    UncrossResult result = ex.Uncross("AAPL");
+    EXPECT_EQ(result.volume, 10);
+    EXPECT_EQ(ex.GetTradingPhase("AAPL"), TradingPhase::CONTINUOUS);
+
+    // Both orders were resting: both portfolios, order slots and margins update
+    EXPECT_EQ(ex.GetPortfolio("buyer").positions.at("AAPL").net_shares, 10);
+    EXPECT_EQ(ex.GetPortfolio("seller").positions.at("AAPL").net_shares, -10);
+    EXPECT_EQ(ex.GetTradesByUser("buyer").size(), 1u);
+    EXPECT_DOUBLE_EQ(ex.GetBuyingPower("buyer"), 1000.0 - 10 * result.price);
+    EXPECT_NO_THROW(ex.HandleOrder("buyer", OrderType::BID, 1, 5.0, "AAPL"));
+    EXPECT_NO_THROW(ex.HandleOrder("seller", OrderType::ASK, 1, 20.0, "AAPL"));
+}
+
+TEST(ExchangeTest, BatchAuctionClearsOnInterval)
+{
+    Exchange ex({"AAPL", "MSFT"});
+    ex.RegisterUser("buyer");
+    ex.RegisterUser("seller");
+    ex.SetBatchInterval("AAPL", std::chrono::hours(1));
+    EXPECT_EQ(ex.GetTradingPhase("AAPL"), TradingPhase::AUCTION);
+    EXPECT_EQ(ex.GetTradingPhase("MSFT"), TradingPhase::CONTINUOUS);
+    EXPECT_THROW(ex.SetBatchInterval("AAPL", std::chrono::nanoseconds(-1)), std::runtime_error);
+
+    ex.HandleOrder("seller", OrderType::ASK, 10, 10.0, "AAPL");
+    auto bid = ex.HandleOrder("buyer", OrderType::BID, 6, 11.0, "AAPL");
+    EXPECT_TRUE(bid.trades.empty()) << "Batch orders must not match on arrival";
+
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_EQ(ex.ClearDueBatches(now), 0u);
+    EXPECT_EQ(ex.ClearDueBatches(now + std::chrono::hours(3)), 1u);
+
+    // Fills are recorded when the batch clears; the next batch is open
+    ASSERT_EQ(ex.GetTradesByUser("buyer").size(), 1u);
+    EXPECT_EQ(ex.GetPortfolio("seller").positions.at("AAPL").net_shares, -6);
+    EXPECT_EQ(ex.GetTradingPhase("AAPL"), TradingPhase::AUCTION);
+    EXPECT_EQ(ex.ClearDueBatches(now + std::chrono::hours(3)), 0u) << "Next boundary is on the interval grid";
+
+    // Back to continuous: the pending batch clears first
+    ex.HandleOrder("buyer", OrderType::BID, 4, 10.0, "AAPL");
+    ex.SetBatchInterval("AAPL", std::chrono::nanoseconds(0));
+    EXPECT_EQ(ex.GetTradingPhase("AAPL"), TradingPhase::CONTINUOUS);
+    EXPECT_EQ(ex.GetTradesByUser("buyer").size(), 2u);
+    EXPECT_EQ(ex.GetVolume("AAPL", 10.0, OrderType::ASK), 0);
+}
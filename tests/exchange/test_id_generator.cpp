@@ -0,0 +1,72 @@
+#include "exchange/id_generator.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_set>
+
+TEST(IdGeneratorTest, StartsAtOneOnShardZero)
+{
+    IdGenerator gen;
+
+    EXPECT_EQ(gen.GetShard(), 0);
+    EXPECT_EQ(gen.Next(), 1);
+    EXPECT_EQ(gen.Next(), 2);
+}
+
+TEST(IdGeneratorTest, EncodesShard)
+{
+    IdGenerator gen(7);
+
+    int64_t id = gen.Next();
+    EXPECT_GT(id, 0);
+    EXPECT_EQ(IdGenerator::ShardOf(id), 7);
+    EXPECT_EQ(id & IdGenerator::kMaxSequence, 1);
+}
+
+TEST(IdGeneratorTest, UniqueAcrossShards)
+{
+    IdGenerator gen_a(0);
+    IdGenerator gen_b(1);
+    std::unordered_set<int64_t> seen;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_TRUE(seen.insert(gen_a.Next()).second);
+        EXPECT_TRUE(seen.insert(gen_b.Next()).second);
+    }
+}
+
+TEST(IdGeneratorTest, IdsExceed32Bits)
+{
+    IdGenerator gen(IdGenerator::kMaxShard);
+
+    int64_t id = gen.Next();
+    EXPECT_GT(id, static_cast<int64_t>(INT32_MAX)) << "Shard bits should push IDs past 32 bits";
+    EXPECT_EQ(IdGenerator::ShardOf(id), IdGenerator::kMaxShard);
+}
+
+TEST(IdGeneratorTest, InvalidShardThrows)
+{
+    EXPECT_THROW(IdGenerator(-1), std::out_of_range);
+    EXPECT_THROW(IdGenerator(IdGenerator::kMaxShard + 1), std::out_of_range);
+}
+
+TEST(IdGeneratorTest, AdvancePastResumesOwnShardOnly)
+{
+    IdGenerator previous_run(3);
+    int64_t last = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        last = previous_run.Next();
+    }
+
+    IdGenerator gen(3);
+    gen.AdvancePast(IdGenerator(4).Next());
+    EXPECT_EQ(gen.Next() & IdGenerator::kMaxSequence, 1);
+
+    gen.AdvancePast(last);
+    EXPECT_EQ(gen.Next(), last + 1);
+    gen.AdvancePast(last); // already past it
+    EXPECT_EQ(gen.Next(), last + 2);
+}
@@ -5,9 +5,12 @@
 #include "exchange/top_of_book.hpp"
 #include "exchange/order_result.hpp"
 #include "exchange/limit_order_book.hpp"
+#include "exchange/execution_sink.hpp"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <string>
+#include <thread>
 #include <variant>
 #include <ctime>
 #include <unordered_map>
@@ -971,3 +974,504 @@ TEST(LimitOrderBookTest, CancelAlreadyCancelledOrder)
         },
         std::out_of_range);
 }
+
+// Sink that keeps a copy of every fill view it receives
+class RecordingSink : public ExecutionSink
+{
+public:
+    struct Record
+    {
+        int64_t trade_id;
+        double price;
+        int volume;
+        OrderType aggressor_side;
+        int64_t resting_order_id;
+        int resting_remaining_volume;
+    };
+    std::vector<Record> fills;
+
+    void OnFill(const Fill &fill) override
+    {
+        fills.push_back({fill.trade.trade_id,
+                         fill.price,
+                         fill.trade.volume,
+                         fill.aggressor_side,
+                         fill.resting_order_id,
+                         fill.resting_remaining_volume});
+    }
+
+    struct CancelRecord
+    {
+        int64_t order_id;
+        int volume;
+        bool self_trade;
+    };
+    std::vector<CancelRecord> cancels;
+
+    void OnCancel(const Cancel &cancel) override
+    {
+        cancels.push_back({cancel.order_id, cancel.volume, cancel.self_trade});
+    }
+};
+
+TEST(LimitOrderBookSinkTest, SweepStreamsOneFillPerLevel)
+{
+    LimitOrderBook lob("AAPL");
+    int64_t ask_1 = lob.HandleOrder("asker1", OrderType::ASK, 5, 100.0, std::time(nullptr), "AAPL").order_id;
+    int64_t ask_2 = lob.HandleOrder("asker2", OrderType::ASK, 5, 101.0, std::time(nullptr), "AAPL").order_id;
+    int64_t ask_3 = lob.HandleOrder("asker3", OrderType::ASK, 5, 102.0, std::time(nullptr), "AAPL").order_id;
+
+    RecordingSink sink;
+    int64_t rest_id = lob.HandleOrder("bidder", OrderType::BID, 12, 102.0, std::time(nullptr), "AAPL", sink);
+
+    EXPECT_EQ(rest_id, -1) << "Fully filled order should not rest";
+    ASSERT_EQ(sink.fills.size(), 3u);
+
+    EXPECT_EQ(sink.fills[0].resting_order_id, ask_1);
+    EXPECT_DOUBLE_EQ(sink.fills[0].price, 100.0);
+    EXPECT_EQ(sink.fills[0].resting_remaining_volume, 0);
+    EXPECT_EQ(sink.fills[0].aggressor_side, OrderType::BID);
+
+    EXPECT_EQ(sink.fills[1].resting_order_id, ask_2);
+    EXPECT_EQ(sink.fills[2].resting_order_id, ask_3);
+    EXPECT_EQ(sink.fills[2].volume, 2);
+    EXPECT_EQ(sink.fills[2].resting_remaining_volume, 3);
+
+    // Fills reference the same trades the book keeps in its history
+    ASSERT_EQ(lob.GetTradeCount(), 3u);
+    EXPECT_EQ(lob.GetTrade(2).trade_id, sink.fills[2].trade_id);
+    EXPECT_EQ(lob.GetVolume(102.0, OrderType::ASK), 3);
+}
+
+TEST(LimitOrderBookSinkTest, NoFillsWhenOrderRests)
+{
+    LimitOrderBook lob("AAPL");
+
+    RecordingSink sink;
+    int64_t rest_id = lob.HandleOrder("bidder", OrderType::BID, 10, 50.0, std::time(nullptr), "AAPL", sink);
+
+    EXPECT_GT(rest_id, 0);
+    EXPECT_TRUE(sink.fills.empty());
+    EXPECT_EQ(lob.GetVolume(50.0, OrderType::BID), 10);
+}
+
+TEST(LimitOrderBookTest, ReAddAtPriceAfterLevelEmptied)
+{
+    LimitOrderBook lob("AAPL");
+
+    // Empty the 10.0 ASK level via cancel, then rest a new ASK there
+    int64_t first = lob.HandleOrder("asker", OrderType::ASK, 5, 10.0, std::time(nullptr), "AAPL").order_id;
+    ASSERT_TRUE(lob.CancelOrder(first));
+    lob.HandleOrder("asker", OrderType::ASK, 5, 10.0, std::time(nullptr), "AAPL");
+
+    // The new level must still be reachable by matching and top of book
+    EXPECT_EQ(lob.GetTopOfBook().ask_price, 10);
+    OrderResult result = lob.HandleOrder("bidder", OrderType::BID, 5, 10.0, std::time(nullptr), "AAPL");
+    ASSERT_EQ(result.trades.size(), 1u);
+    EXPECT_EQ(lob.GetVolume(10.0, OrderType::ASK), 0);
+}
+
+TEST(LimitOrderBookTest, PoolSlotsReleasedOnFillCancelAndSelfTrade)
+{
+    LimitOrderBook lob("AAPL");
+
+    int64_t cancelled = lob.HandleOrder("a", OrderType::ASK, 5, 10.0, std::time(nullptr), "AAPL").order_id;
+    lob.HandleOrder("b", OrderType::ASK, 5, 10.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("c", OrderType::ASK, 5, 11.0, std::time(nullptr), "AAPL");
+    EXPECT_EQ(lob.GetRestingOrderCount(), 3u);
+
+    lob.CancelOrder(cancelled);
+    EXPECT_EQ(lob.GetRestingOrderCount(), 2u);
+
+    // Fills b, self-trade cancels c's resting ask, remainder rests
+    OrderResult result = lob.HandleOrder("c", OrderType::BID, 8, 11.0, std::time(nullptr), "AAPL");
+    ASSERT_EQ(result.trades.size(), 1u);
+    EXPECT_EQ(result.trades[0].ask_user_id, "b");
+    EXPECT_EQ(lob.GetRestingOrderCount(), 1u);
+    EXPECT_EQ(lob.GetVolume(11.0, OrderType::BID), 3);
+}
+
+// -------------------------------------------------------------------
+// Matching policies
+// -------------------------------------------------------------------
+namespace
+{
+    // Rests one ask per (user, volume) at `price`, in order
+    void RestAsks(LimitOrderBook &lob, const std::vector<std::pair<std::string, int>> &asks, double price)
+    {
+        for (const auto &[user, volume] : asks)
+        {
+            lob.HandleOrder(user, OrderType::ASK, volume, price, std::time(nullptr), "AAPL");
+        }
+    }
+}
+
+TEST(LimitOrderBookPolicyTest, ProRataAllocatesBySize)
+{
+    LimitOrderBook lob("AAPL");
+    lob.SetMatchingPolicy(MatchingPolicy::PRO_RATA);
+    RestAsks(lob, {{"a", 60}, {"b", 30}, {"c", 10}}, 10.0);
+
+    OrderResult result = lob.HandleOrder("taker", OrderType::BID, 50, 10.0, std::time(nullptr), "AAPL");
+
+    ASSERT_EQ(result.trades.size(), 3u);
+    EXPECT_EQ(result.trades[0].ask_user_id, "a");
+    EXPECT_EQ(result.trades[0].volume, 30);
+    EXPECT_EQ(result.trades[1].ask_user_id, "b");
+    EXPECT_EQ(result.trades[1].volume, 15);
+    EXPECT_EQ(result.trades[2].ask_user_id, "c");
+    EXPECT_EQ(result.trades[2].volume, 5);
+    EXPECT_EQ(lob.GetVolume(10.0, OrderType::ASK), 50);
+}
+
+TEST(LimitOrderBookPolicyTest, ProRataMinimumAllocationAndRemainder)
+{
+    LimitOrderBook lob("AAPL");
+    lob.SetMatchingPolicy(MatchingPolicy::PRO_RATA, 6);
+    RestAsks(lob, {{"a", 60}, {"b", 30}, {"c", 10}}, 10.0);
+
+    // c's share of 5 is below the minimum; the 5 lots go to a in time priority
+    OrderResult result = lob.HandleOrder("taker", OrderType::BID, 50, 10.0, std::time(nullptr), "AAPL");
+
+    ASSERT_EQ(result.trades.size(), 2u);
+    EXPECT_EQ(result.trades[0].ask_user_id, "a");
+    EXPECT_EQ(result.trades[0].volume, 35);
+    EXPECT_EQ(result.trades[1].ask_user_id, "b");
+    EXPECT_EQ(result.trades[1].volume, 15);
+
+    // Sub-lot shares round down to nothing; the remainder is FIFO
+    LimitOrderBook small("AAPL");
+    small.SetMatchingPolicy(MatchingPolicy::PRO_RATA);
+    RestAsks(small, {{"a", 1}, {"b", 1}, {"c", 1}}, 10.0);
+    result = small.HandleOrder("taker", OrderType::BID, 2, 10.0, std::time(nullptr), "AAPL");
+    ASSERT_EQ(result.trades.size(), 2u);
+    EXPECT_EQ(result.trades[0].ask_user_id, "a");
+    EXPECT_EQ(result.trades[1].ask_user_id, "b");
+    EXPECT_EQ(small.GetRestingOrderCount(), 1u);
+}
+
+TEST(LimitOrderBookPolicyTest, TopOrderThenProRata)
+{
+    LimitOrderBook lob("AAPL");
+    lob.SetMatchingPolicy(MatchingPolicy::TOP_ORDER_PRO_RATA);
+    RestAsks(lob, {{"a", 20}, {"b", 40}, {"c", 40}}, 10.0);
+
+    OrderResult result = lob.HandleOrder("taker", OrderType::BID, 60, 10.0, std::time(nullptr), "AAPL");
+
+    ASSERT_EQ(result.trades.size(), 3u);
+    EXPECT_EQ(result.trades[0].ask_user_id, "a");
+    EXPECT_EQ(result.trades[0].volume, 20);
+    EXPECT_EQ(result.trades[1].volume, 20);
+    EXPECT_EQ(result.trades[2].volume, 20);
+    EXPECT_EQ(lob.GetRestingOrderCount(), 2u);
+}
+
+TEST(LimitOrderBookPolicyTest, ProRataSweepsLevelsAndWashesOwnOrders)
+{
+    LimitOrderBook lob("AAPL");
+    lob.SetMatchingPolicy(MatchingPolicy::PRO_RATA);
+    RestAsks(lob, {{"a", 10}, {"taker", 10}}, 10.0);
+    RestAsks(lob, {{"b", 30}, {"c", 10}}, 11.0);
+
+    RecordingSink sink;
+    int64_t rest_id = lob.HandleOrder("taker", OrderType::BID, 30, 11.0, std::time(nullptr), "AAPL", sink);
+
+    // Own ask cancelled, a's level taken whole, 20 pro-rata over 11.0
+    EXPECT_EQ(rest_id, -1);
+    ASSERT_EQ(sink.cancels.size(), 1u);
+    EXPECT_TRUE(sink.cancels[0].self_trade);
+    ASSERT_EQ(sink.fills.size(), 3u);
+    EXPECT_EQ(sink.fills[0].volume, 10);
+    EXPECT_EQ(sink.fills[1].volume, 15);
+    EXPECT_EQ(sink.fills[2].volume, 5);
+    EXPECT_EQ(lob.GetVolume(11.0, OrderType::ASK), 20);
+    EXPECT_THROW(lob.SetMatchingPolicy(MatchingPolicy::PRO_RATA, 0), std::runtime_error);
+}
+
+// -------------------------------------------------------------------
+// Call auction
+// -------------------------------------------------------------------
+TEST(LimitOrderBookAuctionTest, OrdersAccumulateWithoutMatching)
+{
+    LimitOrderBook lob("AAPL");
+    lob.StartAuction();
+    EXPECT_EQ(lob.GetTradingPhase(), TradingPhase::AUCTION);
+
+    OrderResult bid = lob.HandleOrder("buyer", OrderType::BID, 10, 11.0, std::time(nullptr), "AAPL");
+    OrderResult ask = lob.HandleOrder("seller", OrderType::ASK, 10, 10.0, std::time(nullptr), "AAPL");
+
+    EXPECT_TRUE(bid.order_added_to_book);
+    EXPECT_TRUE(ask.order_added_to_book);
+    EXPECT_TRUE(ask.trades.empty());
+    EXPECT_EQ(lob.GetRestingOrderCount(), 2u);
+    EXPECT_TRUE(lob.CancelOrder(bid.order_id));
+}
+
+TEST(LimitOrderBookAuctionTest, UncrossMaximizesExecutedVolume)
+{
+    LimitOrderBook lob("AAPL");
+    lob.StartAuction();
+    lob.HandleOrder("b1", OrderType::BID, 10, 12.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("b2", OrderType::BID, 20, 11.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("b3", OrderType::BID, 10, 10.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("a1", OrderType::ASK, 15, 9.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("a2", OrderType::ASK, 10, 10.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("a3", OrderType::ASK, 20, 11.0, std::time(nullptr), "AAPL");
+
+    // Executable: 15 @ 9, 25 @ 10, 30 @ 11, 10 @ 12
+    UncrossResult indicative = lob.GetIndicativeUncross();
+    EXPECT_DOUBLE_EQ(indicative.price, 11.0);
+    EXPECT_EQ(indicative.volume, 30);
+    EXPECT_EQ(indicative.imbalance, -15);
+    EXPECT_EQ(lob.GetRestingOrderCount(), 6u) << "Indication must not trade";
+
+    RecordingSink sink;
+    UncrossResult result = lob.Uncross(sink);
+
+    EXPECT_DOUBLE_EQ(result.price, 11.0);
+    EXPECT_EQ(result.volume, 30);
+    EXPECT_EQ(lob.GetTradingPhase(), TradingPhase::CONTINUOUS);
+    ASSERT_EQ(sink.fills.size(), 4u);
+    for (const auto &fill : sink.fills)
+    {
+        EXPECT_DOUBLE_EQ(fill.price, 11.0);
+    }
+
+    // Left: b3 10 @ 10 and a3 15 @ 11, no longer crossed
+    EXPECT_EQ(lob.GetRestingOrderCount(), 2u);
+    EXPECT_EQ(lob.GetVolume(10.0, OrderType::BID), 10);
+    EXPECT_EQ(lob.GetVolume(11.0, OrderType::ASK), 15);
+    EXPECT_EQ(lob.GetVolume(9.0, OrderType::ASK), 0);
+    TopOfBook top = lob.GetTopOfBook();
+    EXPECT_EQ(top.bid_price, 10);
+    EXPECT_EQ(top.ask_price, 11);
+
+    // Continuous trading resumes
+    OrderResult next = lob.HandleOrder("b4", OrderType::BID, 5, 11.0, std::time(nullptr), "AAPL");
+    ASSERT_EQ(next.trades.size(), 1u);
+}
+
+TEST(LimitOrderBookAuctionTest, UncrossWithoutCrossOnlyReopens)
+{
+    LimitOrderBook lob("AAPL");
+    lob.StartAuction();
+    lob.HandleOrder("buyer", OrderType::BID, 10, 9.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("seller", OrderType::ASK, 10, 10.0, std::time(nullptr), "AAPL");
+
+    RecordingSink sink;
+    UncrossResult result = lob.Uncross(sink);
+    EXPECT_EQ(result.volume, 0);
+    EXPECT_TRUE(sink.fills.empty());
+    EXPECT_EQ(lob.GetTradingPhase(), TradingPhase::CONTINUOUS);
+    EXPECT_EQ(lob.GetRestingOrderCount(), 2u);
+}
+
+TEST(LimitOrderBookAuctionTest, IndicativeUncrossIsPublishedWithTheBbo)
+{
+    LimitOrderBook lob("AAPL");
+    EXPECT_EQ(lob.GetBbo().phase, TradingPhase::CONTINUOUS);
+
+    lob.StartAuction();
+    lob.HandleOrder("buyer", OrderType::BID, 10, 11.0, std::time(nullptr), "AAPL");
+    OrderResult ask = lob.HandleOrder("seller", OrderType::ASK, 4, 10.0, std::time(nullptr), "AAPL");
+
+    BboSnapshot bbo = lob.GetBbo();
+    EXPECT_EQ(bbo.phase, TradingPhase::AUCTION);
+    EXPECT_DOUBLE_EQ(bbo.indicative.price, 11.0);
+    EXPECT_EQ(bbo.indicative.volume, 4);
+    EXPECT_EQ(bbo.indicative.imbalance, 6);
+    EXPECT_EQ(bbo.bid.volume, 10);
+    EXPECT_EQ(bbo.ask.volume, 4);
+
+    // A cancel republishes the indication along with the sides
+    ASSERT_TRUE(lob.CancelOrder(ask.order_id));
+    bbo = lob.GetBbo();
+    EXPECT_EQ(bbo.indicative.volume, 0);
+    EXPECT_EQ(bbo.ask.volume, 0);
+    EXPECT_EQ(lob.GetIndicativeUncross().volume, 0);
+
+    RecordingSink sink;
+    lob.Uncross(sink);
+    bbo = lob.GetBbo();
+    EXPECT_EQ(bbo.phase, TradingPhase::CONTINUOUS);
+    EXPECT_EQ(bbo.indicative.volume, 0);
+}
+
+TEST(LimitOrderBookAuctionTest, IndicationCountsOrdersRestingBeforeTheAuction)
+{
+    LimitOrderBook lob("AAPL");
+    lob.HandleOrder("buyer", OrderType::BID, 10, 10.0, std::time(nullptr), "AAPL");
+    lob.HandleOrder("seller", OrderType::ASK, 5, 12.0, std::time(nullptr), "AAPL");
+
+    lob.StartAuction();
+    lob.HandleOrder("seller", OrderType::ASK, 8, 9.0, std::time(nullptr), "AAPL");
+    UncrossResult indicative = lob.GetIndicativeUncross();
+    EXPECT_DOUBLE_EQ(indicative.price, 10.0);
+    EXPECT_EQ(indicative.volume, 8);
+    EXPECT_EQ(indicative.imbalance, 2);
+
+    RecordingSink sink;
+    UncrossResult result = lob.Uncross(sink);
+    EXPECT_DOUBLE_EQ(result.price, indicative.price);
+    EXPECT_EQ(result.volume, indicative.volume);
+
+    // The next auction starts from what is left: 2 @ 10 against 5 @ 12
+    lob.StartAuction();
+    EXPECT_EQ(lob.GetIndicativeUncross().volume, 0);
+    lob.HandleOrder("buyer", OrderType::BID, 3, 12.0, std::time(nullptr), "AAPL");
+    indicative = lob.GetIndicativeUncross();
+    EXPECT_DOUBLE_EQ(indicative.price, 12.0);
+    EXPECT_EQ(indicative.volume, 3);
+    EXPECT_EQ(indicative.imbalance, -2);
+}
+
+TEST(LimitOrderBookTest, DepthListsBestLevelsFirst)
+{
+    LimitOrderBook lob("AAPL");
+    NullExecutionSink sink;
+    lob.HandleOrder("u1", OrderType::BID, 5, 99, 0, "AAPL", sink);
+    lob.HandleOrder("u2", OrderType::BID, 3, 101, 0, "AAPL", sink);
+    lob.HandleOrder("u3", OrderType::BID, 2, 101, 0, "AAPL", sink);
+    lob.HandleOrder("u4", OrderType::BID, 7, 100, 0, "AAPL", sink);
+    int64_t emptied = lob.HandleOrder("u5", OrderType::BID, 1, 102, 0, "AAPL", sink);
+    lob.CancelOrder(emptied);
+    lob.HandleOrder("u6", OrderType::ASK, 4, 103, 0, "AAPL", sink);
+
+    DepthLevel bids[2];
+    ASSERT_EQ(lob.GetDepth(OrderType::BID, bids, 2), 2u);
+    EXPECT_DOUBLE_EQ(bids[0].price, 101);
+    EXPECT_EQ(bids[0].volume, 5);
+    EXPECT_DOUBLE_EQ(bids[1].price, 100);
+    EXPECT_EQ(bids[1].volume, 7);
+
+    DepthLevel asks[5];
+    ASSERT_EQ(lob.GetDepth(OrderType::ASK, asks, 5), 1u);
+    EXPECT_DOUBLE_EQ(asks[0].price, 103);
+    EXPECT_EQ(asks[0].volume, 4);
+
+    // Reading depth leaves matching untouched
+    lob.HandleOrder("u7", OrderType::ASK, 6, 100, 0, "AAPL", sink);
+    DepthLevel after[5];
+    ASSERT_EQ(lob.GetDepth(OrderType::BID, after, 5), 2u);
+    EXPECT_DOUBLE_EQ(after[0].price, 100);
+    EXPECT_EQ(after[0].volume, 6);
+}
+
+// Levels within one integer price must not share a volume
+TEST(LimitOrderBookTest, DepthKeepsSubIntegerLevelsApart)
+{
+    LimitOrderBook lob("AAPL");
+    NullExecutionSink sink;
+    lob.HandleOrder("u1", OrderType::BID, 5, 100.25, 0, "AAPL", sink);
+    lob.HandleOrder("u2", OrderType::BID, 7, 100.75, 0, "AAPL", sink);
+    lob.HandleOrder("u3", OrderType::ASK, 3, 100.75, 0, "AAPL", sink);
+
+    DepthLevel bids[5];
+    ASSERT_EQ(lob.GetDepth(OrderType::BID, bids, 5), 2u);
+    EXPECT_DOUBLE_EQ(bids[0].price, 100.75);
+    EXPECT_EQ(bids[0].volume, 4);
+    EXPECT_DOUBLE_EQ(bids[1].price, 100.25);
+    EXPECT_EQ(bids[1].volume, 5);
+}
+
+TEST(LimitOrderBookTest, PublishedBboTracksEveryChange)
+{
+    LimitOrderBook lob("AAPL");
+    NullExecutionSink sink;
+    EXPECT_FALSE(lob.GetTopOfBook().book_has_top);
+
+    lob.HandleOrder("u1", OrderType::BID, 5, 100, 0, "AAPL", sink);
+    int64_t best_bid = lob.HandleOrder("u2", OrderType::BID, 3, 101, 0, "AAPL", sink);
+    lob.HandleOrder("u3", OrderType::ASK, 4, 103, 0, "AAPL", sink);
+    BboSnapshot bbo = lob.GetBbo();
+    EXPECT_DOUBLE_EQ(bbo.bid.price, 101);
+    EXPECT_EQ(bbo.bid.volume, 3);
+    EXPECT_DOUBLE_EQ(bbo.ask.price, 103);
+    EXPECT_EQ(bbo.ask.volume, 4);
+    EXPECT_EQ(bbo.update_sequence, lob.GetUpdateSequence());
+
+    // Cancelling the best bid exposes the next level
+    lob.CancelOrder(best_bid);
+    TopOfBook top = lob.GetTopOfBook();
+    EXPECT_EQ(top.bid_price, 100);
+    EXPECT_EQ(top.bid_volume, 5);
+
+    // A sweep empties the ask side
+    lob.HandleOrder("u4", OrderType::BID, 4, 103, 0, "AAPL", sink);
+    TopOfBook swept = lob.GetTopOfBook();
+    EXPECT_TRUE(swept.book_has_top);
+    EXPECT_EQ(swept.ask_volume, 0);
+    EXPECT_EQ(swept.bid_price, 100);
+
+    // Auction orders rest crossed until the uncross
+    lob.StartAuction();
+    lob.HandleOrder("u5", OrderType::ASK, 5, 99, 0, "AAPL", sink);
+    EXPECT_EQ(lob.GetBbo().ask.volume, 5);
+    lob.Uncross(sink);
+    bbo = lob.GetBbo();
+    EXPECT_EQ(bbo.bid.volume, 0);
+    EXPECT_EQ(bbo.ask.volume, 0);
+    EXPECT_EQ(bbo.update_sequence, lob.GetUpdateSequence());
+}
+
+TEST(LimitOrderBookTest, PublishedBboKeepsSubIntegerLevelsApart)
+{
+    LimitOrderBook lob("AAPL");
+    NullExecutionSink sink;
+    lob.HandleOrder("u1", OrderType::BID, 5, 100.25, 0, "AAPL", sink);
+    lob.HandleOrder("u2", OrderType::BID, 7, 100.75, 0, "AAPL", sink);
+    lob.HandleOrder("u3", OrderType::ASK, 2, 101.25, 0, "AAPL", sink);
+    lob.HandleOrder("u4", OrderType::ASK, 9, 101.5, 0, "AAPL", sink);
+
+    BboSnapshot bbo = lob.GetBbo();
+    EXPECT_DOUBLE_EQ(bbo.bid.price, 100.75);
+    EXPECT_EQ(bbo.bid.volume, 7);
+    EXPECT_DOUBLE_EQ(bbo.ask.price, 101.25);
+    EXPECT_EQ(bbo.ask.volume, 2);
+
+    // A partial fill of the top level leaves the level below it alone
+    lob.HandleOrder("u5", OrderType::ASK, 3, 100.75, 0, "AAPL", sink);
+    bbo = lob.GetBbo();
+    EXPECT_DOUBLE_EQ(bbo.bid.price, 100.75);
+    EXPECT_EQ(bbo.bid.volume, 4);
+}
+
+TEST(LimitOrderBookTest, BboReadsAreConsistentAcrossThreads)
+{
+    constexpr int kOrders = 20000;
+    LimitOrderBook lob("AAPL");
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+
+    // Each best bid rests volume equal to its price, so a torn read shows up
+    std::thread reader([&]()
+    {
+        uint64_t last_sequence = 0;
+        while (!done.load())
+        {
+            BboSnapshot bbo = lob.GetBbo();
+            if ((bbo.bid.volume != 0 && bbo.bid.price != bbo.bid.volume) || bbo.update_sequence < last_sequence)
+            {
+                ++torn;
+            }
+            last_sequence = bbo.update_sequence;
+        }
+    });
+
+    NullExecutionSink sink;
+    int64_t previous = -1;
+    for (int price = 1; price <= kOrders; ++price)
+    {
+        int64_t order_id = lob.HandleOrder("u1", OrderType::BID, price, price, 0, "AAPL", sink);
+        if (previous > 0)
+        {
+            lob.CancelOrder(previous, sink);
+        }
+        previous = order_id;
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_DOUBLE_EQ(lob.GetBbo().bid.price, kOrders);
+}
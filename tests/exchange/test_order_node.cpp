@@ -1,29 +1,24 @@
 #include "exchange/order_node.hpp"
 #include "utils/order_type.hpp"
 #include <gtest/gtest.h>
-#include <ctime>
+#include <cstdint>
 
 // Test OrderNode initialization
 TEST(OrderNodeTest, Initialization)
 {
-    time_t now = time(nullptr);
-    OrderNode node(1, "user1", 100, 50.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node(1, 1, 100, nullptr, nullptr);
 
     EXPECT_EQ(node.order_id, 1);
-    EXPECT_EQ(node.user_id, "user1");
+    EXPECT_EQ(node.owner, 1u);
     EXPECT_EQ(node.volume, 100);
-    EXPECT_DOUBLE_EQ(node.price, 50.0);
-    EXPECT_EQ(node.order_type, OrderType::ASK);
-    EXPECT_EQ(node.ticker, "AAPL");
     EXPECT_EQ(node.prev, nullptr);
     EXPECT_EQ(node.next, nullptr);
 }
 
 TEST(OrderNodeTest, ForwardLinking)
 {
-    time_t now = time(nullptr);
-    OrderNode node1(1, "user1", 100, 50.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode node2(2, "user2", 200, 51.0, OrderType::ASK, now, "AAPL", &node1, nullptr);
+    OrderNode node1(1, 1, 100, nullptr, nullptr);
+    OrderNode node2(2, 2, 200, &node1, nullptr);
 
     node1.next = &node2;
 
@@ -33,14 +28,13 @@ TEST(OrderNodeTest, ForwardLinking)
 
     // Verify node2's details
     EXPECT_EQ(node2.order_id, 2);
-    EXPECT_EQ(node2.user_id, "user2");
+    EXPECT_EQ(node2.owner, 2u);
 }
 
 TEST(OrderNodeTest, BackwardLinking)
 {
-    time_t now = time(nullptr);
-    OrderNode node1(1, "user1", 100, 50.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode node2(2, "user2", 200, 51.0, OrderType::ASK, now, "AAPL", &node1, nullptr);
+    OrderNode node1(1, 1, 100, nullptr, nullptr);
+    OrderNode node2(2, 2, 200, &node1, nullptr);
 
     node1.next = &node2;
 
@@ -54,10 +48,9 @@ TEST(OrderNodeTest, BackwardLinking)
 
 TEST(OrderNodeTest, MultiNodeTraversal)
 {
-    time_t now = time(nullptr);
-    OrderNode node1(1, "user1", 100, 50.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode node2(2, "user2", 200, 51.0, OrderType::ASK, now, "AAPL", &node1, nullptr);
-    OrderNode node3(3, "user3", 300, 52.0, OrderType::ASK, now, "AAPL", &node2, nullptr);
+    OrderNode node1(1, 1, 100, nullptr, nullptr);
+    OrderNode node2(2, 2, 200, &node1, nullptr);
+    OrderNode node3(3, 3, 300, &node2, nullptr);
 
     node1.next = &node2;
     node2.next = &node3;
@@ -79,14 +72,13 @@ TEST(OrderNodeTest, MultiNodeTraversal)
 
 TEST(OrderNodeTest, InsertBetweenNodes)
 {
-    time_t now = time(nullptr);
-    OrderNode node1(1, "user1", 100, 50.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode node3(3, "user3", 300, 52.0, OrderType::ASK, now, "AAPL", &node1, nullptr);
+    OrderNode node1(1, 1, 100, nullptr, nullptr);
+    OrderNode node3(3, 3, 300, &node1, nullptr);
 
     node1.next = &node3;
 
     // Insert node2 between node1 and node3
-    OrderNode node2(2, "user2", 200, 51.0, OrderType::ASK, now, "AAPL", &node1, &node3);
+    OrderNode node2(2, 2, 200, &node1, &node3);
     node1.next = &node2;
     node3.prev = &node2;
 
@@ -96,3 +88,14 @@ TEST(OrderNodeTest, InsertBetweenNodes)
     EXPECT_EQ(node3.prev, &node2);
     EXPECT_EQ(node2.prev, &node1);
 }
+
+TEST(OrderNodeTest, HotRecordLayout)
+{
+    // Two hot records per 64-byte cache line, never straddling one
+    EXPECT_EQ(sizeof(OrderNode), 32u);
+    EXPECT_EQ(alignof(OrderNode), 32u);
+
+    OrderNode nodes[2];
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&nodes[0]) % 32, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&nodes[1]) - reinterpret_cast<uintptr_t>(&nodes[0]), 32u);
+}
@@ -0,0 +1,49 @@
+#include "exchange/order_pool.hpp"
+#include "exchange/order_node.hpp"
+#include "utils/order_type.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+TEST(OrderPoolTest, StoresHotAndColdBySlot)
+{
+    OrderPool pool;
+    uint32_t slot = pool.Allocate(OrderNode(7, 3, 100), OrderInfo{50.5, 1234, OrderType::BID});
+
+    EXPECT_EQ(pool.Hot(slot).order_id, 7);
+    EXPECT_EQ(pool.Hot(slot).owner, 3u);
+    EXPECT_EQ(pool.Hot(slot).volume, 100);
+    EXPECT_DOUBLE_EQ(pool.Cold(slot).price, 50.5);
+    EXPECT_EQ(pool.Cold(slot).timestamp, 1234);
+    EXPECT_EQ(pool.Cold(slot).order_type, OrderType::BID);
+    EXPECT_EQ(pool.GetLiveCount(), 1u);
+}
+
+TEST(OrderPoolTest, FreedSlotsAreReused)
+{
+    OrderPool pool;
+    uint32_t first = pool.Allocate(OrderNode(1), OrderInfo{1.0, 0, OrderType::ASK});
+    pool.Allocate(OrderNode(2), OrderInfo{1.0, 0, OrderType::ASK});
+
+    pool.Free(first);
+    EXPECT_EQ(pool.GetLiveCount(), 1u);
+    EXPECT_EQ(pool.Allocate(OrderNode(3), OrderInfo{2.0, 0, OrderType::ASK}), first);
+    EXPECT_EQ(pool.Hot(first).order_id, 3);
+}
+
+TEST(OrderPoolTest, NodesStayPutAcrossChunks)
+{
+    OrderPool pool;
+    std::vector<OrderNode *> nodes;
+    for (uint32_t i = 0; i < OrderPool::kChunkSize * 2 + 1; ++i)
+    {
+        uint32_t slot = pool.Allocate(OrderNode(i), OrderInfo{1.0, 0, OrderType::ASK});
+        nodes.push_back(&pool.Hot(slot));
+    }
+
+    // Growing the pool never moves a linked node
+    EXPECT_EQ(nodes[0]->order_id, 0);
+    EXPECT_EQ(nodes[OrderPool::kChunkSize]->order_id, OrderPool::kChunkSize);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(nodes.back()) % alignof(OrderNode), 0u);
+}
@@ -20,10 +20,9 @@ TEST(PriceLevelQueueTest, AddOrder)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode node(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node(1, 1, 100);
 
-    queue.AddOrder(node);
+    queue.AddOrder(node, 1.0);
 
     EXPECT_EQ(queue.HasOrders(), true);
 }
@@ -32,10 +31,9 @@ TEST(PriceLevelQueueTest, Peek)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode node(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node(1, 1, 100);
 
-    queue.AddOrder(node);
+    queue.AddOrder(node, 1.0);
 
     EXPECT_EQ(queue.HasOrders(), true);
     const OrderNode &PeakNode = queue.Peek();
@@ -53,10 +51,9 @@ TEST(PriceLevelQueueTest, PeekManipulation)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode node(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node(1, 1, 100);
 
-    queue.AddOrder(node);
+    queue.AddOrder(node, 1.0);
 
     EXPECT_EQ(queue.HasOrders(), true);
 
@@ -77,10 +74,9 @@ TEST(PriceLevelQueueTest, Pop)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode node(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node(1, 1, 100);
 
-    queue.AddOrder(node);
+    queue.AddOrder(node, 1.0);
 
     EXPECT_EQ(queue.HasOrders(), true);
     OrderNode &PopNode = queue.Pop();
@@ -93,21 +89,19 @@ TEST(PriceLevelQueueTest, AddErrorWithWrongPrice)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode error_node(1, "user1", 100, 50.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode error_node(1, 1, 100);
 
-    EXPECT_THROW(queue.AddOrder(error_node), std::runtime_error);
+    EXPECT_THROW(queue.AddOrder(error_node, 50.0), std::runtime_error);
 }
 
 TEST(PriceLevelQueueTest, RemoveOrderAndVerifyState)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode node(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node(1, 1, 100);
 
     // Add the order and store the state of the front and back nodes
-    queue.AddOrder(node);
+    queue.AddOrder(node, 1.0);
 
     const OrderNode *initial_front_next = queue.GetFrontNext(); // Store function result
     const OrderNode *initial_back_prev = queue.GetBackPrev();   // Store function result
@@ -133,13 +127,12 @@ TEST(PriceLevelQueueTest, TwoOrdersOrdering)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode order_one(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode order_two(1, "uder2", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode order_one(1, 1, 100);
+    OrderNode order_two(1, 2, 100);
 
-    queue.AddOrder(order_one);
+    queue.AddOrder(order_one, 1.0);
     EXPECT_EQ(queue.HasOrders(), true);
-    queue.AddOrder(order_two);
+    queue.AddOrder(order_two, 1.0);
     EXPECT_EQ(queue.HasOrders(), true);
 
     // Order one comes before order two
@@ -151,15 +144,14 @@ TEST(PriceLevelQueueTest, RemoveMiddleOrder)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode order_one(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode order_two(1, "user2", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode order_three(1, "user3", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode order_one(1, 1, 100);
+    OrderNode order_two(1, 2, 100);
+    OrderNode order_three(1, 3, 100);
 
-    queue.AddOrder(order_one);
+    queue.AddOrder(order_one, 1.0);
     EXPECT_EQ(queue.HasOrders(), true);
-    queue.AddOrder(order_two);
-    queue.AddOrder(order_three);
+    queue.AddOrder(order_two, 1.0);
+    queue.AddOrder(order_three, 1.0);
 
     // Expect [o1] <-> [o2] <-> [o3]
     EXPECT_EQ(order_one.next, &order_two);
@@ -182,15 +174,14 @@ TEST(PriceLevelQueueTest, PopPeekIntegration)
 {
     PriceLevelQueue queue(1.0);
 
-    time_t now = time(nullptr);
-    OrderNode node1(1, "user1", 100, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode node2(2, "user2", 200, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
-    OrderNode node3(3, "user3", 300, 1.0, OrderType::ASK, now, "AAPL", nullptr, nullptr);
+    OrderNode node1(1, 1, 100);
+    OrderNode node2(2, 2, 200);
+    OrderNode node3(3, 3, 300);
 
     // Add orders
-    queue.AddOrder(node1);
-    queue.AddOrder(node2);
-    queue.AddOrder(node3);
+    queue.AddOrder(node1, 1.0);
+    queue.AddOrder(node2, 1.0);
+    queue.AddOrder(node3, 1.0);
 
     EXPECT_EQ(queue.HasOrders(), true);
 
@@ -231,3 +222,26 @@ TEST(PriceLevelQueueTest, PopPeekIntegration)
     EXPECT_THROW(queue.Peek(), std::runtime_error);
     EXPECT_THROW(queue.Pop(), std::runtime_error);
 }
+
+TEST(PriceLevelQueueTest, VolumeFollowsAddsFillsAndRemovals)
+{
+    PriceLevelQueue queue(100.25);
+    OrderNode first(1, 1, 40);
+    OrderNode second(2, 2, 60);
+    OrderNode third(3, 3, 5);
+    queue.AddOrder(first, 100.25);
+    queue.AddOrder(second, 100.25);
+    queue.AddOrder(third, 100.25);
+    EXPECT_EQ(queue.GetVolume(), 105);
+
+    first.volume -= 15;
+    queue.ReduceVolume(15);
+    EXPECT_EQ(queue.GetVolume(), 90);
+
+    queue.RemoveOrder(second);
+    EXPECT_EQ(queue.GetVolume(), 30);
+    queue.Pop();
+    EXPECT_EQ(queue.GetVolume(), 5);
+    queue.Pop();
+    EXPECT_EQ(queue.GetVolume(), 0);
+}
@@ -0,0 +1,147 @@
+#include "exchange/exchange.hpp"
+#include "feed/feed_protocol.hpp"
+#include "feed/feed_publisher.hpp"
+#include "feed/feed_receiver.hpp"
+#include "feed/feed_snapshot_server.hpp"
+#include "utils/order_type.hpp"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+class FeedTest : public ::testing::Test
+{
+protected:
+    std::vector<std::string> tickers{"AAPL", "GOOG"};
+    FeedOptions options = MakeOptions();
+    Exchange exchange{tickers};
+    FeedPublisher publisher{options, tickers};
+    FeedSnapshotServer snapshot_server{publisher, options};
+
+    // Per-process multicast port so concurrent test runs don't hear each other
+    static FeedOptions MakeOptions()
+    {
+        FeedOptions options;
+        options.port = static_cast<uint16_t>(31000 + getpid() % 20000);
+        options.snapshot_port = 0;
+        return options;
+    }
+
+    void SetUp() override
+    {
+        exchange.AddMarketDataListener(&publisher);
+        options.snapshot_port = snapshot_server.GetPort();
+    }
+
+    // Applies every packet already sent
+    static void Drain(FeedReceiver &receiver, std::vector<FeedMessage> *trades = nullptr)
+    {
+        while (receiver.Poll(200, trades))
+        {
+        }
+    }
+};
+
+TEST_F(FeedTest, ReceiverFollowsLevelsAndTrades)
+{
+    FeedReceiver receiver(options);
+    TickerHandle goog = receiver.ResolveTicker("GOOG");
+    EXPECT_EQ(receiver.GetBook(goog).ask_levels, 0u);
+
+    exchange.HandleOrder("seller", OrderType::ASK, 10, 101, "GOOG");
+    exchange.HandleOrder("seller", OrderType::ASK, 5, 102, "GOOG");
+    int64_t bid = exchange.HandleOrder("buyer", OrderType::BID, 8, 99, "GOOG").order_id;
+    EXPECT_EQ(publisher.Flush(), 1u);
+    exchange.HandleOrder("buyer", OrderType::BID, 10, 101, "GOOG");
+    exchange.CancelOrder("GOOG", bid);
+    EXPECT_EQ(publisher.Flush(), 1u);
+
+    std::vector<FeedMessage> trades;
+    Drain(receiver, &trades);
+    const FeedBook &book = receiver.GetBook(goog);
+    ASSERT_EQ(book.ask_levels, 1u);
+    EXPECT_DOUBLE_EQ(book.asks[0].price, 102);
+    EXPECT_EQ(book.asks[0].volume, 5);
+    EXPECT_EQ(book.bid_levels, 0u);
+
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].type, FeedMessageType::EXECUTION);
+    EXPECT_EQ(trades[0].side, OrderType::BID);
+    EXPECT_EQ(trades[0].volume, 10);
+    EXPECT_DOUBLE_EQ(trades[0].price, 101);
+
+    EXPECT_EQ(receiver.GetGapCount(), 0u);
+    EXPECT_EQ(receiver.GetRecoveryCount(), 1u);
+    EXPECT_EQ(publisher.GetDroppedPackets(), 0u);
+}
+
+TEST_F(FeedTest, LevelBelowTheTopEntersWhenBestLevelLeaves)
+{
+    for (int i = 0; i <= static_cast<int>(kFeedDepth); ++i)
+    {
+        exchange.HandleOrder("seller", OrderType::ASK, 1 + i, 100 + i, "AAPL");
+    }
+    publisher.Flush();
+
+    // Joins late: starts from the snapshot, with the deepest level cut off
+    FeedReceiver receiver(options);
+    TickerHandle aapl = receiver.ResolveTicker("AAPL");
+    ASSERT_EQ(receiver.GetBook(aapl).ask_levels, kFeedDepth);
+    EXPECT_DOUBLE_EQ(receiver.GetBook(aapl).asks[kFeedDepth - 1].price, 100 + kFeedDepth - 1);
+
+    exchange.HandleOrder("buyer", OrderType::BID, 1, 100, "AAPL");
+    publisher.Flush();
+    Drain(receiver);
+
+    const FeedBook &book = receiver.GetBook(aapl);
+    ASSERT_EQ(book.ask_levels, kFeedDepth);
+    EXPECT_DOUBLE_EQ(book.asks[0].price, 101);
+    EXPECT_DOUBLE_EQ(book.asks[kFeedDepth - 1].price, 100 + kFeedDepth);
+    EXPECT_EQ(book.asks[kFeedDepth - 1].volume, 1 + static_cast<int>(kFeedDepth));
+    EXPECT_EQ(receiver.GetGapCount(), 0u);
+}
+
+TEST_F(FeedTest, GapTriggersSnapshotRecovery)
+{
+    FeedReceiver receiver(options);
+    TickerHandle aapl = receiver.ResolveTicker("AAPL");
+    exchange.HandleOrder("seller", OrderType::ASK, 3, 50, "AAPL");
+    publisher.Flush();
+    Drain(receiver);
+    ASSERT_EQ(receiver.GetBook(aapl).ask_levels, 1u);
+
+    // A heartbeat announcing messages this receiver never saw
+    FeedPacketHeader heartbeat{};
+    heartbeat.magic = kFeedMagic;
+    heartbeat.session = publisher.GetSession();
+    heartbeat.sequence = receiver.GetNextSequence() + 5;
+    sockaddr_in group{};
+    group.sin_family = AF_INET;
+    group.sin_port = htons(options.port);
+    inet_pton(AF_INET, options.group.c_str(), &group.sin_addr);
+    in_addr loopback{};
+    inet_pton(AF_INET, options.interface_address.c_str(), &loopback);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback));
+    sendto(fd, &heartbeat, sizeof(heartbeat), 0, reinterpret_cast<sockaddr *>(&group), sizeof(group));
+    close(fd);
+
+    ASSERT_TRUE(receiver.Poll(1000));
+    EXPECT_EQ(receiver.GetGapCount(), 1u);
+    // The snapshot predates the heartbeat, so recovery waits for real traffic
+    EXPECT_FALSE(receiver.IsSynced());
+
+    exchange.HandleOrder("seller", OrderType::ASK, 4, 51, "AAPL");
+    publisher.Flush();
+    Drain(receiver);
+    EXPECT_TRUE(receiver.IsSynced());
+    EXPECT_EQ(receiver.GetRecoveryCount(), 3u);
+    const FeedBook &book = receiver.GetBook(aapl);
+    ASSERT_EQ(book.ask_levels, 2u);
+    EXPECT_DOUBLE_EQ(book.asks[0].price, 50);
+    EXPECT_EQ(book.asks[1].volume, 4);
+}
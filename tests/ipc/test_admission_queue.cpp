@@ -0,0 +1,59 @@
+#include "ipc/admission_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(AdmissionQueueTest, ServesCancelsThenOrdersThenQueriesEachInArrivalOrder)
+{
+    AdmissionQueue<int> queue;
+    queue.Push(AdmissionClass::BULK_QUERY, 1);
+    queue.Push(AdmissionClass::ORDER, 2);
+    queue.Push(AdmissionClass::QUERY, 3);
+    queue.Push(AdmissionClass::CANCEL, 4);
+    queue.Push(AdmissionClass::ORDER, 5);
+    queue.Push(AdmissionClass::CANCEL, 6);
+    EXPECT_EQ(queue.GetDepth(), 6u);
+    EXPECT_EQ(queue.GetDepth(AdmissionClass::ORDER), 2u);
+
+    std::vector<int> served;
+    int value;
+    while (queue.Pop(value))
+    {
+        served.push_back(value);
+    }
+    EXPECT_EQ(served, (std::vector<int>{4, 6, 2, 5, 3, 1}));
+    EXPECT_EQ(queue.GetDepth(), 0u);
+    EXPECT_EQ(queue.GetMaxDepth(), 6u);
+}
+
+TEST(AdmissionQueueTest, ShedsByClassAtConfiguredDepths)
+{
+    AdmissionOptions options;
+    options.shed_bulk_queries_depth = 1;
+    options.shed_queries_depth = 2;
+    options.shed_orders_depth = 3;
+    AdmissionQueue<int> queue(options);
+
+    EXPECT_TRUE(queue.Push(AdmissionClass::ORDER, 1));
+    EXPECT_FALSE(queue.Push(AdmissionClass::BULK_QUERY, 2));
+    EXPECT_TRUE(queue.Push(AdmissionClass::QUERY, 3));
+    EXPECT_FALSE(queue.Push(AdmissionClass::QUERY, 4));
+    EXPECT_TRUE(queue.Push(AdmissionClass::ORDER, 5));
+    EXPECT_FALSE(queue.Push(AdmissionClass::ORDER, 6));
+    // Cancels are admitted whatever the backlog
+    EXPECT_TRUE(queue.Push(AdmissionClass::CANCEL, 7));
+
+    EXPECT_EQ(queue.GetShedCount(AdmissionClass::BULK_QUERY), 1u);
+    EXPECT_EQ(queue.GetShedCount(AdmissionClass::QUERY), 1u);
+    EXPECT_EQ(queue.GetShedCount(AdmissionClass::ORDER), 1u);
+    EXPECT_EQ(queue.GetShedCount(AdmissionClass::CANCEL), 0u);
+    EXPECT_EQ(queue.GetAdmittedCount(AdmissionClass::ORDER), 2u);
+
+    // Draining makes room again
+    int value;
+    while (queue.Pop(value))
+    {
+    }
+    EXPECT_TRUE(queue.Push(AdmissionClass::BULK_QUERY, 8));
+}
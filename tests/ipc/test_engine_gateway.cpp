@@ -0,0 +1,383 @@
+#include "exchange/exchange.hpp"
+#include "exchange/execution_sink.hpp"
+#include "ipc/engine_client.hpp"
+#include "ipc/engine_service.hpp"
+#include "ipc/gateway_protocol.hpp"
+#include "ipc/shared_memory.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+#include "utils/order_type.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    struct CopiedFill
+    {
+        std::string bid_user_id;
+        std::string ask_user_id;
+        double price;
+        int volume;
+        int64_t resting_order_id;
+        int resting_remaining_volume;
+    };
+
+    class CopyingSink : public ExecutionSink
+    {
+    public:
+        std::vector<CopiedFill> fills;
+
+        void OnFill(const Fill &fill) override
+        {
+            fills.push_back(CopiedFill{fill.trade.bid_user_id, fill.trade.ask_user_id, fill.price,
+                                       fill.trade.volume, fill.resting_order_id, fill.resting_remaining_volume});
+        }
+    };
+
+    RiskLimits TestLimits()
+    {
+        RiskLimits limits;
+        limits.max_order_volume = 100;
+        return limits;
+    }
+
+    // Engine and gateway in one process: the engine polls on its own thread,
+    // the test thread plays the gateway through the same shared mapping
+    class EngineGatewayTest : public ::testing::Test
+    {
+    protected:
+        std::vector<std::string> tickers{"AAPL", "GOOG"};
+        std::string shm_name = "/exchange_gateway_test_" + std::to_string(getpid());
+        SharedMemory engine_memory{shm_name, sizeof(GatewayRegion)};
+        Exchange exchange{tickers, TestLimits()};
+        EngineService service{exchange, CreateGatewayRegion(engine_memory, tickers)};
+        std::atomic<bool> stop{false};
+        std::thread engine_thread;
+
+        SharedMemory gateway_memory{shm_name};
+        GatewayRegion &gateway_region = AttachGatewayRegion(gateway_memory);
+
+        void SetUp() override
+        {
+            engine_thread = std::thread([this]()
+                                        {
+                while (!stop.load())
+                {
+                    if (service.PollOnce() == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                } });
+        }
+
+        void TearDown() override
+        {
+            stop.store(true);
+            engine_thread.join();
+        }
+    };
+}
+
+TEST_F(EngineGatewayTest, OrdersMatchAcrossTheRegion)
+{
+    EngineClient client(gateway_region);
+    TickerHandle goog = client.ResolveTicker("GOOG");
+    EXPECT_EQ(goog.index, 1u);
+    EXPECT_EQ(client.GetTickers(), tickers);
+
+    CopyingSink sink;
+    int64_t ask_id = client.HandleOrder("seller", OrderType::ASK, 10, 101.0, goog, sink);
+    EXPECT_GT(ask_id, 0);
+    EXPECT_TRUE(sink.fills.empty());
+
+    int64_t bid_id = client.HandleOrder("buyer", OrderType::BID, 4, 102.0, goog, sink);
+    EXPECT_EQ(bid_id, -1);
+    ASSERT_EQ(sink.fills.size(), 1u);
+    EXPECT_EQ(sink.fills[0].bid_user_id, "buyer");
+    EXPECT_EQ(sink.fills[0].ask_user_id, "seller");
+    EXPECT_DOUBLE_EQ(sink.fills[0].price, 101.0);
+    EXPECT_EQ(sink.fills[0].volume, 4);
+    EXPECT_EQ(sink.fills[0].resting_order_id, ask_id);
+    EXPECT_EQ(sink.fills[0].resting_remaining_volume, 6);
+
+    EXPECT_TRUE(client.CancelOrder(goog, ask_id));
+    // Engine-side errors come back as exceptions, the engine keeps running
+    EXPECT_THROW(client.CancelOrder(goog, ask_id), std::runtime_error);
+    EXPECT_GT(client.HandleOrder("seller", OrderType::ASK, 1, 101.0, goog, sink), 0);
+}
+
+TEST_F(EngineGatewayTest, RejectionsAndQueriesComeBack)
+{
+    EngineClient client(gateway_region);
+    TickerHandle aapl = client.ResolveTicker("AAPL");
+    EXPECT_THROW(client.ResolveTicker("MSFT"), std::out_of_range);
+
+    CopyingSink sink;
+    try
+    {
+        client.HandleOrder("trader", OrderType::BID, 500, 10.0, aapl, sink);
+        FAIL() << "Expected a risk rejection";
+    }
+    catch (const RiskRejection &e)
+    {
+        EXPECT_EQ(e.GetReason(), RiskCheck::MAX_ORDER_VOLUME);
+    }
+    EXPECT_THROW(client.HandleOrder("trader", OrderType::BID, 1, 10.0, TickerHandle{7}, sink), std::runtime_error);
+
+    // Longer than one message in both directions
+    for (int i = 0; i < 20; ++i)
+    {
+        client.HandleOrder("trader_with_a_long_name", OrderType::BID, 1, 10.0 + i, aapl, sink);
+        client.HandleOrder("other_trader", OrderType::ASK, 1, 10.0 + i, aapl, sink);
+    }
+    nlohmann::json request = {{"action", "get_previous_trades"}, {"ticker", "AAPL"},
+                              {"num_previous_trades", 20}, {"padding", std::string(300, 'x')}};
+    nlohmann::json response = nlohmann::json::parse(client.Query(request.dump()));
+    ASSERT_EQ(response["trades"].size(), 20u);
+    EXPECT_EQ(response["trades"][0]["bid_user_id"], "trader_with_a_long_name");
+}
+
+TEST_F(EngineGatewayTest, ChannelsAreClaimedOncePerClient)
+{
+    std::vector<std::unique_ptr<EngineClient>> clients;
+    for (uint32_t i = 0; i < kMaxGatewayChannels; ++i)
+    {
+        clients.push_back(std::make_unique<EngineClient>(gateway_region));
+    }
+    EXPECT_THROW(EngineClient extra(gateway_region), std::runtime_error);
+
+    // A released channel is reusable and its new owner gets its own answers
+    clients.pop_back();
+    EngineClient client(gateway_region);
+    CopyingSink sink;
+    EXPECT_GT(client.HandleOrder("trader", OrderType::ASK, 1, 50.0, client.ResolveTicker("AAPL"), sink), 0);
+}
+
+namespace
+{
+    GatewayRequest MakeQuery(uint64_t request_id, const nlohmann::json &query)
+    {
+        GatewayRequest request{};
+        request.request_id = request_id;
+        request.type = GatewayRequestType::QUERY;
+        request.last_chunk = true;
+        std::string text = query.dump();
+        text.copy(request.text, kGatewayTextSize);
+        request.text_size = static_cast<uint16_t>(text.size());
+        return request;
+    }
+}
+
+// Pipelined through EngineClient and polled by hand, so that the whole
+// burst is waiting when the engine looks
+TEST(EngineAdmissionTest, CancelsJumpTheQueueAndHistoryQueriesAreShedFirst)
+{
+    std::vector<std::string> tickers{"AAPL"};
+    std::string shm_name = "/exchange_admission_test_" + std::to_string(getpid());
+    SharedMemory memory{shm_name, sizeof(GatewayRegion)};
+    GatewayRegion &region = CreateGatewayRegion(memory, tickers);
+    Exchange exchange{tickers};
+    AdmissionOptions options;
+    options.shed_bulk_queries_depth = 2;
+    options.shed_orders_depth = 4;
+    EngineService service{exchange, region, options};
+    EngineClient client{region};
+    TickerHandle aapl = client.ResolveTicker("AAPL");
+    CopyingSink sink;
+
+    uint64_t resting = client.SubmitOrder("maker", OrderType::ASK, 1, 100.0, aapl);
+    EXPECT_EQ(service.PollOnce(), 1u);
+    int64_t resting_id = client.CollectOrder(resting, sink);
+    ASSERT_GT(resting_id, 0);
+
+    // Burst: four bids that would take the resting ask fill the queue to
+    // the order threshold, then a history query, one bid too many and the
+    // cancel of the ask
+    std::vector<uint64_t> bids;
+    for (int i = 0; i < 4; ++i)
+    {
+        bids.push_back(client.SubmitOrder("taker", OrderType::BID, 1, 100.0, aapl));
+    }
+    uint64_t history = client.SubmitQuery(
+        nlohmann::json{{"action", "get_trades_by_user"}, {"user_id", "maker"}}.dump());
+    uint64_t extra_bid = client.SubmitOrder("taker", OrderType::BID, 1, 100.0, aapl);
+    uint64_t cancel = client.SubmitCancel(aapl, resting_id);
+    EXPECT_EQ(client.GetInFlightCount(), 7u);
+    EXPECT_EQ(service.PollOnce(), 7u);
+
+    // Collected in submission order; the engine ran the cancel first, so
+    // none of the bids found the ask
+    for (uint64_t bid : bids)
+    {
+        EXPECT_GT(client.CollectOrder(bid, sink), 0);
+    }
+    EXPECT_TRUE(sink.fills.empty());
+    std::string shed_query;
+    client.CollectQuery(history, shed_query);
+    EXPECT_TRUE(nlohmann::json::parse(shed_query)["shed"].get<bool>());
+    EXPECT_THROW(client.CollectOrder(extra_bid, sink), std::runtime_error);
+    EXPECT_TRUE(client.CollectCancel(cancel));
+    EXPECT_EQ(client.GetInFlightCount(), 0u);
+
+    EngineLoad load = ReadEngineLoad(region);
+    EXPECT_EQ(load.depth, 5u);
+    EXPECT_EQ(load.max_depth, 5u);
+    EXPECT_EQ(load.shed[static_cast<size_t>(AdmissionClass::BULK_QUERY)], 1u);
+    EXPECT_EQ(load.shed[static_cast<size_t>(AdmissionClass::ORDER)], 1u);
+    EXPECT_EQ(load.shed[static_cast<size_t>(AdmissionClass::CANCEL)], 0u);
+    EXPECT_EQ(load.admitted[static_cast<size_t>(AdmissionClass::ORDER)], 5u);
+}
+
+// Every channel pipelining full bursts at a running engine: each request is
+// answered once, either served or shed, and the engine sees real backlogs
+TEST_F(EngineGatewayTest, PipelinedClientsUnderLoadAreAllAnswered)
+{
+    constexpr int kRounds = 50;
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> served{0};
+    std::atomic<uint64_t> shed{0};
+    std::vector<std::thread> gateways;
+    for (uint32_t g = 0; g < kMaxGatewayChannels; ++g)
+    {
+        gateways.emplace_back([this, g, &submitted, &served, &shed]()
+                              {
+            EngineClient client(gateway_region);
+            TickerHandle aapl = client.ResolveTicker("AAPL");
+            const std::string user = "gateway_" + std::to_string(g);
+            CopyingSink sink;
+            std::vector<uint64_t> ids;
+            int64_t resting_id = -1;
+            for (int round = 0; round < kRounds; ++round)
+            {
+                // Bids only, so everything served rests, and the cancel of
+                // a bid that rested in the previous round
+                ids.clear();
+                for (size_t i = 0; i + 1 < kMaxGatewayPipeline; ++i)
+                {
+                    ids.push_back(client.SubmitOrder(user, OrderType::BID, 1, 10.0 + static_cast<double>(i % 5), aapl));
+                }
+                uint64_t cancel = resting_id > 0 ? client.SubmitCancel(aapl, resting_id) : 0;
+                submitted += ids.size() + (cancel != 0 ? 1 : 0);
+
+                resting_id = -1;
+                for (uint64_t id : ids)
+                {
+                    try
+                    {
+                        int64_t order_id = client.CollectOrder(id, sink);
+                        EXPECT_GT(order_id, 0);
+                        resting_id = resting_id > 0 ? resting_id : order_id;
+                        ++served;
+                    }
+                    catch (const std::runtime_error &e)
+                    {
+                        EXPECT_STREQ(e.what(), "Engine overloaded");
+                        ++shed;
+                    }
+                }
+                if (cancel != 0)
+                {
+                    EXPECT_TRUE(client.CollectCancel(cancel));
+                    ++served;
+                }
+                EXPECT_EQ(client.GetInFlightCount(), 0u);
+            } });
+    }
+    for (std::thread &gateway : gateways)
+    {
+        gateway.join();
+    }
+
+    EXPECT_EQ(served.load() + shed.load(), submitted.load());
+    EngineLoad load = ReadEngineLoad(gateway_region);
+    uint64_t admitted = 0;
+    uint64_t engine_shed = 0;
+    for (size_t i = 0; i < kAdmissionClasses; ++i)
+    {
+        admitted += load.admitted[i];
+        engine_shed += load.shed[i];
+    }
+    EXPECT_EQ(admitted, served.load());
+    EXPECT_EQ(engine_shed, shed.load());
+    EXPECT_EQ(load.shed[static_cast<size_t>(AdmissionClass::CANCEL)], 0u);
+    EXPECT_GT(load.max_depth, 1u);
+}
+
+// The engine poll is the batch timer, so a due batch clears even when the
+// round holds only reads
+TEST(EngineBatchTest, DueBatchesClearWhenTheEnginePolls)
+{
+    std::vector<std::string> tickers{"AAPL"};
+    std::string shm_name = "/exchange_batch_test_" + std::to_string(getpid());
+    SharedMemory memory{shm_name, sizeof(GatewayRegion)};
+    GatewayRegion &region = CreateGatewayRegion(memory, tickers);
+    Exchange exchange{tickers};
+    EngineService service{exchange, region};
+
+    exchange.SetBatchInterval("AAPL", std::chrono::milliseconds(1));
+    exchange.HandleOrder("seller", OrderType::ASK, 5, 10.0, "AAPL");
+    exchange.HandleOrder("buyer", OrderType::BID, 5, 11.0, "AAPL");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(exchange.GetTradesByUser("buyer").empty());
+
+    GatewayChannel &channel = region.channels[0];
+    channel.gateway_pid.store(getpid());
+    ASSERT_TRUE(channel.requests.TryPush(MakeQuery(1, {{"action", "get_trades_by_user"}, {"user_id", "buyer"}})));
+    EXPECT_EQ(service.PollOnce(), 1u);
+    EXPECT_EQ(exchange.GetTradesByUser("buyer").size(), 1u);
+
+    GatewayResponse response;
+    ASSERT_TRUE(channel.responses.TryPop(response));
+    EXPECT_EQ(response.request_id, 1u);
+}
+
+// A live gateway that stops reading loses its channel instead of stalling the engine
+TEST(EngineStallTest, FullResponseRingDropsTheChannel)
+{
+    std::vector<std::string> tickers{"AAPL"};
+    std::string shm_name = "/exchange_stall_test_" + std::to_string(getpid());
+    SharedMemory memory{shm_name, sizeof(GatewayRegion)};
+    GatewayRegion &region = CreateGatewayRegion(memory, tickers);
+    Exchange exchange{tickers};
+    EngineService service{exchange, region};
+
+    GatewayChannel &stalled = region.channels[0];
+    stalled.gateway_pid.store(getpid());
+    GatewayResponse unread{};
+    while (stalled.responses.TryPush(unread))
+    {
+    }
+    ASSERT_TRUE(stalled.requests.TryPush(MakeQuery(1, {{"action", "get_tickers"}})));
+    ASSERT_TRUE(stalled.requests.TryPush(MakeQuery(2, {{"action", "get_tickers"}})));
+
+    auto started = std::chrono::steady_clock::now();
+    EXPECT_EQ(service.PollOnce(), 2u);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 20 * EngineService::kRespondTimeout)
+        << "The second request must not wait again";
+    EXPECT_EQ(stalled.dropped.load(), 1u);
+    EXPECT_EQ(ReadEngineLoad(region).dropped_channels, 1u);
+
+    // Nothing more is read from it, and new clients skip it
+    ASSERT_TRUE(stalled.requests.TryPush(MakeQuery(3, {{"action", "get_tickers"}})));
+    EXPECT_EQ(service.PollOnce(), 0u);
+    {
+        EngineClient client{region};
+        EXPECT_EQ(region.channels[1].gateway_pid.load(), getpid());
+    }
+
+    // Once the gateway lets go, the engine resets it for the next claim
+    stalled.gateway_pid.store(0);
+    for (uint64_t i = 0; i < EngineService::kReapInterval; ++i)
+    {
+        service.PollOnce();
+    }
+    EXPECT_EQ(stalled.dropped.load(), 0u);
+    EXPECT_EQ(stalled.requests.Size(), 0u);
+}
@@ -0,0 +1,162 @@
+#include "exchange/exchange.hpp"
+#include "ipc/broadcast_ring.hpp"
+#include "ipc/market_data.hpp"
+#include "ipc/market_data_publisher.hpp"
+#include "ipc/market_data_reader.hpp"
+#include "ipc/seqlock.hpp"
+#include "ipc/shared_memory.hpp"
+#include "utils/order_type.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    struct Wide
+    {
+        uint64_t values[8];
+    };
+}
+
+TEST(SeqlockTest, ReadersNeverSeeTornValues)
+{
+    auto lock = std::make_unique<Seqlock<Wide>>();
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]()
+                       {
+        Wide value{};
+        for (uint64_t i = 1; i <= 200000; ++i)
+        {
+            for (uint64_t &v : value.values)
+            {
+                v = i;
+            }
+            lock->Store(value);
+        }
+        done.store(true); });
+
+    uint64_t last = 0;
+    while (!done.load())
+    {
+        Wide value = lock->Load();
+        for (uint64_t v : value.values)
+        {
+            ASSERT_EQ(v, value.values[0]);
+        }
+        ASSERT_GE(value.values[0], last);
+        last = value.values[0];
+    }
+    writer.join();
+    EXPECT_EQ(lock->GetVersion(), 200000u);
+}
+
+TEST(BroadcastRingTest, EachReaderFollowsItsOwnCursor)
+{
+    auto ring = std::make_unique<BroadcastRing<int, 4>>();
+    uint64_t fast = 0;
+    uint64_t slow = 0;
+    int value = 0;
+    EXPECT_FALSE(ring->Read(fast, value));
+
+    ring->Publish(1);
+    ring->Publish(2);
+    ASSERT_TRUE(ring->Read(fast, value));
+    EXPECT_EQ(value, 1);
+    ASSERT_TRUE(ring->Read(fast, value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(ring->Read(fast, value));
+
+    // Lapped: the slow reader skips to the oldest entry still held
+    for (int i = 3; i <= 7; ++i)
+    {
+        ring->Publish(i);
+    }
+    ASSERT_TRUE(ring->Read(slow, value));
+    EXPECT_EQ(value, 4);
+    EXPECT_EQ(slow, 4u);
+    ASSERT_TRUE(ring->Read(fast, value));
+    EXPECT_EQ(value, 4);
+}
+
+class MarketDataTest : public ::testing::Test
+{
+protected:
+    std::vector<std::string> tickers{"AAPL", "GOOG"};
+    std::string shm_name = "/exchange_market_data_test_" + std::to_string(getpid());
+    SharedMemory memory{shm_name, sizeof(MarketDataRegion)};
+    MarketDataPublisher publisher{CreateMarketDataRegion(memory, tickers)};
+    Exchange exchange{tickers};
+
+    void SetUp() override
+    {
+        exchange.AddMarketDataListener(&publisher);
+    }
+};
+
+TEST_F(MarketDataTest, ReaderSeesDepthAndLastTrade)
+{
+    MarketDataReader reader(shm_name);
+    TickerHandle goog = reader.ResolveTicker("GOOG");
+    EXPECT_EQ(reader.GetBook(goog).update_id, 0u);
+    EXPECT_FALSE(reader.GetTopOfBook(goog).book_has_top);
+
+    exchange.HandleOrder("seller", OrderType::ASK, 10, 101, "GOOG");
+    exchange.HandleOrder("seller", OrderType::ASK, 5, 102, "GOOG");
+    exchange.HandleOrder("buyer", OrderType::BID, 8, 99, "GOOG");
+    exchange.HandleOrder("buyer", OrderType::BID, 4, 101, "GOOG");
+    EXPECT_EQ(reader.GetBook(goog).update_id, 0u); // conflated until flushed
+    EXPECT_EQ(publisher.Flush(), 1u);
+
+    BookSnapshot book = reader.GetBook(goog);
+    EXPECT_EQ(book.update_id, 1u);
+    ASSERT_EQ(book.ask_levels, 2u);
+    EXPECT_DOUBLE_EQ(book.asks[0].price, 101);
+    EXPECT_EQ(book.asks[0].volume, 6);
+    EXPECT_DOUBLE_EQ(book.asks[1].price, 102);
+    ASSERT_EQ(book.bid_levels, 1u);
+    EXPECT_DOUBLE_EQ(book.bids[0].price, 99);
+    EXPECT_EQ(book.trade_count, 1u);
+    EXPECT_DOUBLE_EQ(book.last_trade_price, 101);
+    EXPECT_EQ(book.last_trade_volume, 4);
+
+    TopOfBook top = reader.GetTopOfBook(goog);
+    EXPECT_TRUE(top.book_has_top);
+    EXPECT_EQ(top.ask_price, 101);
+    EXPECT_EQ(top.bid_volume, 8);
+
+    // The other ticker is untouched
+    EXPECT_EQ(reader.GetBook(reader.ResolveTicker("AAPL")).update_id, 0u);
+}
+
+TEST_F(MarketDataTest, TradesStreamToEveryReader)
+{
+    exchange.HandleOrder("seller", OrderType::ASK, 3, 50, "AAPL");
+    exchange.HandleOrder("buyer", OrderType::BID, 1, 50, "AAPL");
+
+    // Readers start at trades published after they attach
+    MarketDataReader first(shm_name);
+    MarketDataReader second(shm_name);
+    MarketDataTrade trade;
+    EXPECT_FALSE(first.NextTrade(trade));
+
+    exchange.HandleOrder("buyer", OrderType::BID, 2, 51, "AAPL");
+    for (MarketDataReader *reader : {&first, &second})
+    {
+        ASSERT_TRUE(reader->NextTrade(trade));
+        EXPECT_EQ(trade.ticker, 0u);
+        EXPECT_EQ(trade.aggressor_side, OrderType::BID);
+        EXPECT_EQ(trade.volume, 2);
+        EXPECT_DOUBLE_EQ(trade.price, 50);
+        EXPECT_FALSE(reader->NextTrade(trade));
+        EXPECT_EQ(reader->GetDroppedTrades(), 0u);
+    }
+    publisher.Flush();
+    EXPECT_EQ(first.GetBook(TickerHandle{0}).ask_levels, 0u);
+}
@@ -0,0 +1,70 @@
+#include "ipc/spsc_ring.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+TEST(SpscRingTest, PopsInPushOrder)
+{
+    SpscRing<int, 4> ring;
+    EXPECT_TRUE(ring.TryPush(1));
+    EXPECT_TRUE(ring.TryPush(2));
+
+    int value = 0;
+    EXPECT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+TEST(SpscRingTest, RejectsPushWhenFull)
+{
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.TryPush(i));
+    }
+    EXPECT_FALSE(ring.TryPush(4));
+    EXPECT_EQ(ring.Size(), 4u);
+
+    int value = 0;
+    EXPECT_TRUE(ring.TryPop(value));
+    EXPECT_TRUE(ring.TryPush(4)); // freed slot is reused across the wrap
+    ring.Reset();
+    EXPECT_EQ(ring.Size(), 0u);
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+TEST(SpscRingTest, TransfersAcrossThreadsInOrder)
+{
+    auto ring = std::make_unique<SpscRing<uint64_t, 64>>();
+    const uint64_t kCount = 100000;
+
+    std::thread producer([&]()
+                         {
+        for (uint64_t i = 1; i <= kCount; ++i)
+        {
+            while (!ring->TryPush(i))
+            {
+                std::this_thread::yield();
+            }
+        } });
+
+    uint64_t expected = 1;
+    uint64_t value = 0;
+    while (expected <= kCount)
+    {
+        if (ring->TryPop(value))
+        {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
@@ -0,0 +1,168 @@
+#include "exchange/exchange.hpp"
+#include "metrics/exchange_metrics.hpp"
+#include "metrics/metrics.hpp"
+#include "metrics/metrics_http_server.hpp"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    // One GET over a fresh connection; returns the whole response
+    std::string HttpGet(uint16_t port, const std::string &path)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+        {
+            close(fd);
+            return "";
+        }
+        std::string request = "GET " + path + " HTTP/1.0\r\n\r\n";
+        send(fd, request.data(), request.size(), 0);
+        std::string response;
+        char buffer[4096];
+        ssize_t received;
+        while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+        {
+            response.append(buffer, static_cast<size_t>(received));
+        }
+        close(fd);
+        return response;
+    }
+
+    bool Contains(const std::string &text, const std::string &line)
+    {
+        return text.find(line) != std::string::npos;
+    }
+}
+
+TEST(MetricsTest, CounterSumsEveryThread)
+{
+    Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&counter]()
+                             {
+                                 for (int i = 0; i < 10000; ++i)
+                                 {
+                                     counter.Increment();
+                                 }
+                             });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(counter.GetValue(), 80000u);
+}
+
+TEST(MetricsTest, HistogramBucketsByUpperBound)
+{
+    Histogram histogram;
+    histogram.Observe(1000);     // le 1 µs, bounds are inclusive
+    histogram.Observe(1001);     // le 2.5 µs
+    histogram.Observe(2000000000); // +Inf
+
+    Histogram::Snapshot snapshot = histogram.GetSnapshot();
+    EXPECT_EQ(snapshot.counts[0], 1u);
+    EXPECT_EQ(snapshot.counts[1], 1u);
+    EXPECT_EQ(snapshot.counts[Histogram::kBuckets], 1u);
+    EXPECT_EQ(snapshot.count, 3u);
+    EXPECT_EQ(snapshot.sum_nanos, 2000002001u);
+}
+
+TEST(MetricsTest, RendersPrometheusText)
+{
+    MetricsRegistry registry;
+    registry.GetCounter("requests_total", "Requests", {{"action", "get_\"tickers\""}}).Increment(3);
+    EXPECT_EQ(&registry.GetCounter("requests_total", "Requests", {{"action", "get_\"tickers\""}}),
+              &registry.GetCounter("requests_total", "Requests", {{"action", "get_\"tickers\""}}));
+    registry.GetGauge("connections", "Connections").Set(-2);
+    registry.GetHistogram("latency_seconds", "Latency").Observe(5000);
+    registry.AddCallback("depth", "Depth", MetricsRegistry::Type::GAUGE, {}, []() { return 7.0; });
+    EXPECT_THROW(registry.GetGauge("requests_total", "Requests"), std::invalid_argument);
+
+    std::string text = registry.Render();
+    EXPECT_TRUE(Contains(text, "# HELP requests_total Requests\n# TYPE requests_total counter\n"));
+    EXPECT_TRUE(Contains(text, "requests_total{action=\"get_\\\"tickers\\\"\"} 3\n"));
+    EXPECT_TRUE(Contains(text, "connections -2\n"));
+    EXPECT_TRUE(Contains(text, "# TYPE latency_seconds histogram\n"));
+    EXPECT_TRUE(Contains(text, "latency_seconds_bucket{le=\"2.5e-06\"} 0\n"));
+    EXPECT_TRUE(Contains(text, "latency_seconds_bucket{le=\"5e-06\"} 1\n"));
+    EXPECT_TRUE(Contains(text, "latency_seconds_bucket{le=\"+Inf\"} 1\n"));
+    EXPECT_TRUE(Contains(text, "latency_seconds_sum 5e-06\n"));
+    EXPECT_TRUE(Contains(text, "latency_seconds_count 1\n"));
+    EXPECT_TRUE(Contains(text, "depth 7\n"));
+}
+
+TEST(MetricsTest, ExchangeMetricsTrackFillsAndDepth)
+{
+    MetricsRegistry registry;
+    std::vector<std::string> tickers = {"AAPL", "GOOG"};
+    Exchange exchange(tickers);
+    ExchangeMetrics exchange_metrics(registry, tickers);
+    exchange.AddMarketDataListener(&exchange_metrics);
+    exchange.RegisterUser("alice");
+    exchange.RegisterUser("bob");
+
+    exchange.HandleOrder("alice", OrderType::ASK, 10, 101.0, "AAPL");
+    exchange.HandleOrder("alice", OrderType::ASK, 5, 102.0, "AAPL");
+    exchange.HandleOrder("alice", OrderType::BID, 4, 99.0, "AAPL");
+    exchange.HandleOrder("bob", OrderType::BID, 3, 101.0, "AAPL");
+    exchange.FlushMarketData();
+
+    std::string text = registry.Render();
+    EXPECT_TRUE(Contains(text, "exchange_fills_total{ticker=\"AAPL\"} 1\n"));
+    EXPECT_TRUE(Contains(text, "exchange_traded_volume_total{ticker=\"AAPL\"} 3\n"));
+    EXPECT_TRUE(Contains(text, "exchange_resting_orders{ticker=\"AAPL\"} 3\n"));
+    EXPECT_TRUE(Contains(text, "exchange_book_levels{ticker=\"AAPL\",side=\"ask\"} 2\n"));
+    EXPECT_TRUE(Contains(text, "exchange_book_depth_volume{ticker=\"AAPL\",side=\"ask\"} 12\n"));
+    EXPECT_TRUE(Contains(text, "exchange_book_depth_volume{ticker=\"AAPL\",side=\"bid\"} 4\n"));
+    EXPECT_TRUE(Contains(text, "exchange_book_levels{ticker=\"GOOG\",side=\"bid\"} 0\n"));
+}
+
+TEST(MetricsTest, ExchangeMetricsWithoutDepthLeaveTheBookAlone)
+{
+    MetricsRegistry registry;
+    std::vector<std::string> tickers = {"AAPL"};
+    Exchange exchange(tickers);
+    ExchangeMetrics exchange_metrics(registry, tickers, false);
+    exchange.AddMarketDataListener(&exchange_metrics);
+    exchange.RegisterUser("alice");
+
+    exchange.HandleOrder("alice", OrderType::ASK, 10, 101.0, "AAPL");
+    exchange.HandleOrder("alice", OrderType::BID, 4, 99.0, "AAPL");
+    exchange.FlushMarketData();
+
+    std::string text = registry.Render();
+    EXPECT_TRUE(Contains(text, "exchange_resting_orders{ticker=\"AAPL\"} 2\n"));
+    EXPECT_FALSE(Contains(text, "exchange_book_levels"));
+    EXPECT_FALSE(Contains(text, "exchange_book_depth_volume"));
+}
+
+TEST(MetricsTest, ServesScrapesOverHttp)
+{
+    MetricsRegistry registry;
+    registry.GetCounter("scrape_test_total", "Test counter").Increment(42);
+    MetricsHttpServer server(registry, 0);
+    ASSERT_NE(server.GetPort(), 0);
+
+    std::string response = HttpGet(server.GetPort(), "/metrics");
+    EXPECT_EQ(response.compare(0, 15, "HTTP/1.0 200 OK"), 0);
+    EXPECT_TRUE(Contains(response, "Content-Type: text/plain; version=0.0.4"));
+    EXPECT_TRUE(Contains(response, "\r\n\r\n# HELP scrape_test_total Test counter\n"));
+    EXPECT_TRUE(Contains(response, "scrape_test_total 42\n"));
+
+    EXPECT_EQ(HttpGet(server.GetPort(), "/").compare(0, 22, "HTTP/1.0 404 Not Found"), 0);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "portfolio/position_store.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// -------------------------------------------------------------------
+// 1) Positions are valued at the applied mark
+// -------------------------------------------------------------------
+TEST(PositionStoreTest, SetPositionAndRevalue)
+{
+    PositionStore store(2);
+    uint32_t alice = store.AddUser(1000.0);
+
+    // Long 10 @ 100, paid 1000 cash
+    store.SetPosition(0, alice, 10, 100.0);
+    store.SetCash(alice, 0.0);
+
+    // No mark yet => market value 0
+    EXPECT_DOUBLE_EQ(store.GetMarketValue(alice), 0.0);
+
+    store.UpdateMark(0, 105.0);
+    // Marks are lazy until Revalue()
+    EXPECT_DOUBLE_EQ(store.GetMark(0), 0.0);
+    store.Revalue();
+
+    EXPECT_DOUBLE_EQ(store.GetMark(0), 105.0);
+    EXPECT_DOUBLE_EQ(store.GetMarketValue(alice), 1050.0);
+    EXPECT_DOUBLE_EQ(store.GetUnrealizedPnL(alice), 50.0);
+    EXPECT_DOUBLE_EQ(store.GetEquity(alice), 1050.0);
+}
+
+// -------------------------------------------------------------------
+// 2) Short positions lose value when price rises
+// -------------------------------------------------------------------
+TEST(PositionStoreTest, ShortPosition)
+{
+    PositionStore store(1);
+    uint32_t bob = store.AddUser();
+
+    store.SetPosition(0, bob, -5, 50.0);
+    store.SetCash(bob, 250.0);
+    store.UpdateMark(0, 60.0);
+    store.Revalue();
+
+    EXPECT_DOUBLE_EQ(store.GetUnrealizedPnL(bob), -50.0);
+    EXPECT_DOUBLE_EQ(store.GetEquity(bob), 250.0 - 300.0);
+}
+
+// -------------------------------------------------------------------
+// 3) SIMD kernel agrees with the scalar definition for many users
+//    (odd count to exercise the tail loop)
+// -------------------------------------------------------------------
+TEST(PositionStoreTest, RevalueManyUsersMatchesScalar)
+{
+    const int num_users = 1001;
+    PositionStore store(3);
+    for (int i = 0; i < num_users; i++)
+    {
+        uint32_t u = store.AddUser(1000.0);
+        store.SetPosition(0, u, (i % 7) - 3, 10.0 + i % 5);
+        store.SetPosition(2, u, i % 4, 20.0);
+    }
+
+    store.UpdateMark(0, 12.5);
+    store.UpdateMark(2, 19.0);
+    store.Revalue();
+    store.UpdateMark(0, 11.0); // second revaluation must apply the delta only
+    store.Revalue();
+
+    for (int i = 0; i < num_users; i++)
+    {
+        double expected_mv = ((i % 7) - 3) * 11.0 + (i % 4) * 19.0;
+        double expected_cost = ((i % 7) - 3) * (10.0 + i % 5) + (i % 4) * 20.0;
+        EXPECT_DOUBLE_EQ(store.GetMarketValue(i), expected_mv) << "user " << i;
+        EXPECT_DOUBLE_EQ(store.GetUnrealizedPnL(i), expected_mv - expected_cost) << "user " << i;
+    }
+}
+
+// -------------------------------------------------------------------
+// 4) Leaderboard ordered by equity
+// -------------------------------------------------------------------
+TEST(PositionStoreTest, Leaderboard)
+{
+    PositionStore store(1);
+    uint32_t a = store.AddUser(100.0);
+    uint32_t b = store.AddUser(100.0);
+    uint32_t c = store.AddUser(100.0);
+
+    store.SetPosition(0, a, 1, 10.0);
+    store.SetPosition(0, b, -1, 10.0);
+    store.SetPosition(0, c, 2, 10.0);
+    store.UpdateMark(0, 20.0);
+    store.Revalue();
+
+    std::vector<UserEquity> top = store.GetLeaderboard(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].user, c);
+    EXPECT_DOUBLE_EQ(top[0].equity, 140.0);
+    EXPECT_DOUBLE_EQ(top[0].unrealized_pnl, 20.0);
+    EXPECT_EQ(top[1].user, a);
+
+    EXPECT_EQ(store.GetLeaderboard(10).size(), 3u);
+}
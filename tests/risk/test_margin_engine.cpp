@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "risk/margin_engine.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+
+#include <limits>
+
+// -------------------------------------------------------------------
+// 1) Default limits leave buying power unbounded
+// -------------------------------------------------------------------
+TEST(MarginEngineTest, DefaultLimitsAccept)
+{
+    MarginEngine margin(1);
+    uint32_t user = margin.AddUser();
+
+    margin.OnOrderAdded(user, 1, OrderType::BID, 1000000, 1e6, 0, 0);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 1000000, 1e6, 0, 0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(margin.GetBuyingPower(user), std::numeric_limits<double>::infinity());
+}
+
+// -------------------------------------------------------------------
+// 2) Resting orders commit buying power until filled or cancelled
+// -------------------------------------------------------------------
+TEST(MarginEngineTest, RestingOrdersCommitNotional)
+{
+    RiskLimits limits;
+    limits.buying_power = 1000.0;
+    limits.max_leverage = 2.0;
+    MarginEngine margin(1, limits);
+    uint32_t user = margin.AddUser();
+
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 200, 10.0, 0, 0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 201, 10.0, 0, 0), RiskCheck::INSUFFICIENT_BUYING_POWER);
+
+    margin.OnOrderAdded(user, 1, OrderType::BID, 150, 10.0, 0, 0);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 1500.0);
+    EXPECT_DOUBLE_EQ(margin.GetBuyingPower(user), 500.0);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 51, 10.0, 0, 0), RiskCheck::INSUFFICIENT_BUYING_POWER);
+
+    margin.OnOrderReduced(user, 1, 50);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 500.0);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 150, 10.0, 0, 0), RiskCheck::ACCEPTED);
+}
+
+// -------------------------------------------------------------------
+// 3) Positions count at cost, per ticker, and realized P&L adds equity
+// -------------------------------------------------------------------
+TEST(MarginEngineTest, PositionExposureAndRealizedPnL)
+{
+    RiskLimits limits;
+    limits.buying_power = 1000.0;
+    MarginEngine margin(2, limits);
+    uint32_t user = margin.AddUser();
+
+    margin.OnPositionChanged(user, 0, 50, 10.0, 0.0);
+    margin.OnPositionChanged(user, 1, -20, 5.0, 0.0);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 600.0) << "Short exposure counts at |shares|";
+
+    // Replacing a ticker's position replaces its exposure
+    margin.OnPositionChanged(user, 0, 10, 10.0, 80.0);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 200.0);
+    EXPECT_DOUBLE_EQ(margin.GetEquity(user), 1080.0);
+    EXPECT_DOUBLE_EQ(margin.GetBuyingPower(user), 880.0);
+}
+
+// -------------------------------------------------------------------
+// 4) Orders that reduce a position are accepted at the limit
+// -------------------------------------------------------------------
+TEST(MarginEngineTest, ReducingOrdersNeedNoBuyingPower)
+{
+    RiskLimits limits;
+    limits.buying_power = 1000.0;
+    MarginEngine margin(1, limits);
+    uint32_t user = margin.AddUser();
+
+    // Long 100 at 10: all buying power committed
+    margin.OnPositionChanged(user, 0, 100, 10.0, 0.0);
+    EXPECT_DOUBLE_EQ(margin.GetBuyingPower(user), 0.0);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 1, 10.0, 100, 0), RiskCheck::INSUFFICIENT_BUYING_POWER);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::ASK, 100, 10.0, 100, 0), RiskCheck::ACCEPTED);
+    // Flipping short is charged only once the short outgrows the long
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::ASK, 200, 10.0, 100, 0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::ASK, 201, 10.0, 100, 0), RiskCheck::INSUFFICIENT_BUYING_POWER);
+    // Resting asks already bring the position down to 40
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::ASK, 80, 10.0, 100, 60), RiskCheck::ACCEPTED);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::ASK, 81, 10.0, 100, 60), RiskCheck::INSUFFICIENT_BUYING_POWER);
+
+    // Buying back a short
+    margin.OnPositionChanged(user, 0, -100, 10.0, 0.0);
+    EXPECT_EQ(margin.CheckOrder(user, OrderType::BID, 100, 10.0, -100, 0), RiskCheck::ACCEPTED);
+}
+
+// -------------------------------------------------------------------
+// 5) Resting orders commit only the shares the check charged
+// -------------------------------------------------------------------
+TEST(MarginEngineTest, RestingOrdersCommitOnlyAddedExposure)
+{
+    RiskLimits limits;
+    limits.buying_power = 2000.0;
+    MarginEngine margin(1, limits);
+    uint32_t user = margin.AddUser();
+    margin.OnPositionChanged(user, 0, 100, 10.0, 0.0);
+
+    // Closing the long commits nothing while it rests
+    margin.OnOrderAdded(user, 1, OrderType::ASK, 100, 10.0, 100, 0);
+    EXPECT_DOUBLE_EQ(margin.GetBuyingPower(user), 1000.0);
+    margin.OnOrderReduced(user, 1, 0);
+    EXPECT_DOUBLE_EQ(margin.GetBuyingPower(user), 1000.0);
+
+    // Selling 250 can end short 150: the 50 shares by which the short
+    // outgrows the long are charged, as the tail of the order
+    margin.OnOrderAdded(user, 2, OrderType::ASK, 250, 10.0, 100, 0);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 1500.0);
+    margin.OnOrderReduced(user, 2, 160); // 90 filled: long 10
+    margin.OnPositionChanged(user, 0, 10, 10.0, 0.0);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 600.0);
+    margin.OnOrderReduced(user, 2, 40); // 120 more: short 110, 40 still charged
+    margin.OnPositionChanged(user, 0, -110, 10.0, 0.0);
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 1500.0);
+    margin.OnOrderReduced(user, 2, 0); // cancelled
+    EXPECT_DOUBLE_EQ(margin.GetCommitted(user), 1100.0);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "risk/risk_engine.hpp"
+#include "risk/risk_check.hpp"
+#include "risk/risk_limits.hpp"
+#include "utils/order_type.hpp"
+
+// -------------------------------------------------------------------
+// 1) Default limits accept everything
+// -------------------------------------------------------------------
+TEST(RiskEngineTest, DefaultLimitsAccept)
+{
+    RiskEngine risk(1);
+    uint32_t user = risk.AddUser();
+
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::BID, 1000000, 1e6), RiskCheck::ACCEPTED);
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::ASK, 1, 1.0), RiskCheck::ACCEPTED);
+}
+
+// -------------------------------------------------------------------
+// 2) Per-order size and notional
+// -------------------------------------------------------------------
+TEST(RiskEngineTest, OrderSizeAndNotional)
+{
+    RiskLimits limits;
+    limits.max_order_volume = 100;
+    limits.max_order_notional = 5000.0;
+    RiskEngine risk(1, limits);
+
+    // Stateless checks also apply to unregistered users
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::BID, 101, 1.0), RiskCheck::MAX_ORDER_VOLUME);
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::BID, 100, 50.0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::BID, 100, 50.5), RiskCheck::MAX_ORDER_NOTIONAL);
+}
+
+// -------------------------------------------------------------------
+// 3) Price collar around the last trade
+// -------------------------------------------------------------------
+TEST(RiskEngineTest, PriceCollar)
+{
+    RiskLimits limits;
+    limits.price_collar = 0.10;
+    RiskEngine risk(2, limits);
+
+    // No reference price yet
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::BID, 1, 1000.0), RiskCheck::ACCEPTED);
+
+    risk.OnTrade(0, 100.0);
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::BID, 1, 110.0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 0, OrderType::ASK, 1, 89.0), RiskCheck::PRICE_COLLAR);
+    // Collars are per ticker
+    EXPECT_EQ(risk.CheckOrder(RiskEngine::kUnregistered, 1, OrderType::ASK, 1, 89.0), RiskCheck::ACCEPTED);
+}
+
+// -------------------------------------------------------------------
+// 4) Open orders counted on add, released on fill/cancel
+// -------------------------------------------------------------------
+TEST(RiskEngineTest, MaxOpenOrders)
+{
+    RiskLimits limits;
+    limits.max_open_orders = 2;
+    RiskEngine risk(1, limits);
+    uint32_t user = risk.AddUser();
+
+    risk.OnOrderAdded(user, 0, OrderType::BID, 10);
+    risk.OnOrderAdded(user, 0, OrderType::ASK, 10);
+    EXPECT_EQ(risk.GetOpenOrders(user), 2);
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::BID, 1, 1.0), RiskCheck::MAX_OPEN_ORDERS);
+
+    // Partial fill keeps the order open
+    risk.OnOrderReduced(user, 0, OrderType::BID, 5, false);
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::BID, 1, 1.0), RiskCheck::MAX_OPEN_ORDERS);
+
+    // Cancel releases it
+    risk.OnOrderReduced(user, 0, OrderType::BID, 5, true);
+    EXPECT_EQ(risk.GetOpenOrders(user), 1);
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::BID, 1, 1.0), RiskCheck::ACCEPTED);
+}
+
+// -------------------------------------------------------------------
+// 5) Position limit includes resting orders on the same side
+// -------------------------------------------------------------------
+TEST(RiskEngineTest, MaxPosition)
+{
+    RiskLimits limits;
+    limits.max_position = 100;
+    RiskEngine risk(1, limits);
+    uint32_t user = risk.AddUser();
+
+    risk.OnExecution(user, 0, OrderType::BID, 60);
+    EXPECT_EQ(risk.GetPosition(user, 0), 60);
+
+    risk.OnOrderAdded(user, 0, OrderType::BID, 30);
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::BID, 10, 1.0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::BID, 11, 1.0), RiskCheck::MAX_POSITION);
+
+    // Selling reduces a long, so a large ASK is allowed up to 100 short
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::ASK, 160, 1.0), RiskCheck::ACCEPTED);
+    EXPECT_EQ(risk.CheckOrder(user, 0, OrderType::ASK, 161, 1.0), RiskCheck::MAX_POSITION);
+}
+
+TEST(RiskEngineTest, RejectionCarriesReason)
+{
+    RiskRejection rejection(RiskCheck::PRICE_COLLAR);
+    EXPECT_EQ(rejection.GetReason(), RiskCheck::PRICE_COLLAR);
+    EXPECT_STREQ(RiskCheckToString(RiskCheck::PRICE_COLLAR), "price_collar");
+}
@@ -0,0 +1,147 @@
+#include "exchange/exchange.hpp"
+#include "server/json_writer.hpp"
+#include "server/request_handler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    constexpr JsonKey kName("name");
+    constexpr JsonKey kValues("values");
+    constexpr JsonKey kNested("nested");
+    constexpr JsonKey kEmpty("empty");
+
+    ParsedRequest MakeRequest(RequestAction action)
+    {
+        ParsedRequest request;
+        request.action = action;
+        request.action_name = RequestActionToString(action);
+        return request;
+    }
+}
+
+TEST(JsonWriterTest, MatchesNlohmannDump)
+{
+    std::string out;
+    JsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key(kName).String("tab\there \"quoted\" back\\slash \x01 caf\xc3\xa9");
+    writer.Key(kValues).BeginArray();
+    writer.Int(-42).Uint(18446744073709551615ULL).Int(0);
+    writer.Double(100.0).Double(0.1).Double(-2.5).Double(1e-7).Double(1e300);
+    writer.Double(std::numeric_limits<double>::quiet_NaN()).Double(std::numeric_limits<double>::infinity());
+    writer.Bool(true).Bool(false).Null();
+    writer.EndArray();
+    writer.Key(kNested).BeginObject();
+    writer.Key("dynamic\nkey").BeginArray().BeginObject().EndObject().BeginArray().EndArray().EndArray();
+    writer.EndObject();
+    writer.Key(kEmpty).Raw("{\"raw\":1}");
+    writer.EndObject();
+
+    nlohmann::ordered_json expected;
+    expected["name"] = "tab\there \"quoted\" back\\slash \x01 caf\xc3\xa9";
+    expected["values"] = {-42, 18446744073709551615ULL, 0, 100.0, 0.1, -2.5, 1e-7, 1e300,
+                          std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+                          true, false, nullptr};
+    expected["nested"]["dynamic\nkey"] = {nlohmann::ordered_json::object(), nlohmann::ordered_json::array()};
+    expected["empty"] = {{"raw", 1}};
+    EXPECT_EQ(out, expected.dump());
+}
+
+TEST(JsonWriterTest, AppendsAfterExistingContent)
+{
+    std::string out = "prefix ";
+    JsonWriter(out).BeginArray().String("a").String("b").EndArray();
+    EXPECT_EQ(out, "prefix [\"a\",\"b\"]");
+}
+
+TEST(JsonWriterTest, HandlerResponsesReuseTheBuffer)
+{
+    Exchange exchange({"AAPL"});
+    RequestHandler handler(exchange);
+    RequestHandler::TickerCache ticker_cache;
+    std::string response;
+
+    for (int i = 0; i < 50; ++i)
+    {
+        ParsedRequest order = MakeRequest(RequestAction::HANDLE_ORDER);
+        order.fields = ParsedRequest::FIELD_USER_ID | ParsedRequest::FIELD_ORDER_TYPE | ParsedRequest::FIELD_VOLUME |
+                       ParsedRequest::FIELD_PRICE | ParsedRequest::FIELD_TICKER;
+        order.ticker = "AAPL";
+        order.user_id = i % 2 == 0 ? "maker" : "taker";
+        order.order_type = i % 2 == 0 ? 1 : 0;
+        order.volume = 10;
+        order.price = 100.0;
+        ASSERT_TRUE(handler.Handle(order, ticker_cache, response));
+    }
+    nlohmann::json last_order = nlohmann::json::parse(response);
+    EXPECT_EQ(last_order["trades"].size(), 1u);
+    EXPECT_TRUE(last_order["trades_executed"].get<bool>());
+    EXPECT_EQ(last_order["order_id"], -1);
+
+    ParsedRequest trades = MakeRequest(RequestAction::GET_PREVIOUS_TRADES);
+    trades.fields = ParsedRequest::FIELD_TICKER | ParsedRequest::FIELD_NUM_PREVIOUS_TRADES;
+    trades.ticker = "AAPL";
+    trades.num_previous_trades = 20;
+    ASSERT_TRUE(handler.Handle(trades, ticker_cache, response));
+    nlohmann::json parsed = nlohmann::json::parse(response);
+    ASSERT_EQ(parsed["trades"].size(), 20u);
+    EXPECT_EQ(parsed["trades"][0]["bid_user_id"], "taker");
+    EXPECT_EQ(parsed["trades"][0]["ask_user_id"], "maker");
+    EXPECT_EQ(parsed["trades"][0]["price"], 100);
+    EXPECT_EQ(parsed["trades"][0]["volume"], 10);
+
+    // Same response again: written over the same storage
+    const char *storage = response.data();
+    size_t capacity = response.capacity();
+    ASSERT_TRUE(handler.Handle(trades, ticker_cache, response));
+    EXPECT_EQ(response.data(), storage);
+    EXPECT_EQ(response.capacity(), capacity);
+
+    ParsedRequest by_user = MakeRequest(RequestAction::GET_TRADES_BY_USER);
+    by_user.fields = ParsedRequest::FIELD_USER_ID;
+    by_user.user_id = "maker";
+    ASSERT_TRUE(handler.Handle(by_user, ticker_cache, response));
+    EXPECT_EQ(nlohmann::json::parse(response)["trades"].size(), 25u);
+}
+
+TEST(JsonWriterTest, HandlerReplacesPartialResponsesWithErrors)
+{
+    Exchange exchange({"AAPL"});
+    RequestHandler handler(exchange);
+    RequestHandler::TickerCache ticker_cache;
+    std::string response = "left over from the last request";
+
+    ParsedRequest order = MakeRequest(RequestAction::HANDLE_ORDER);
+    order.fields = ParsedRequest::FIELD_USER_ID | ParsedRequest::FIELD_ORDER_TYPE | ParsedRequest::FIELD_VOLUME |
+                   ParsedRequest::FIELD_PRICE | ParsedRequest::FIELD_TICKER;
+    order.ticker = "AAPL";
+    order.user_id = "maker";
+    order.order_type = 1;
+    order.volume = 10;
+    order.price = 100.0;
+    ASSERT_TRUE(handler.Handle(order, ticker_cache, response));
+    int64_t order_id = nlohmann::json::parse(response)["order_id"];
+    EXPECT_EQ(response, "{\"trades\":[],\"order_added_to_book\":true,\"order_id\":" + std::to_string(order_id) +
+                            ",\"trades_executed\":false}");
+
+    ParsedRequest cancel = MakeRequest(RequestAction::CANCEL_ORDER);
+    cancel.fields = ParsedRequest::FIELD_TICKER | ParsedRequest::FIELD_ORDER_ID;
+    cancel.ticker = "AAPL";
+    cancel.order_id = order_id;
+    EXPECT_TRUE(handler.Handle(cancel, ticker_cache, response));
+    EXPECT_EQ(response, "{\"success\":true}");
+
+    // The ticker fails to resolve after the object was opened
+    cancel.ticker = "MSFT";
+    EXPECT_FALSE(handler.Handle(cancel, ticker_cache, response));
+    EXPECT_EQ(response, "{\"error\":\"Exception caught during processing\"}");
+
+    EXPECT_FALSE(handler.Handle(MakeRequest(RequestAction::UNKNOWN), ticker_cache, response));
+    EXPECT_EQ(response, "{\"error\":\"Unknown action\"}");
+}
@@ -0,0 +1,130 @@
+#include "server/rate_limiter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+TEST(TokenBucketTest, StartsFullAndRefillsAtTheConfiguredRate)
+{
+    RateLimit limit{10, 3};
+    TokenBucket bucket;
+    Clock::time_point now = Clock::now();
+
+    EXPECT_TRUE(bucket.TryConsume(limit, now));
+    EXPECT_TRUE(bucket.TryConsume(limit, now));
+    EXPECT_TRUE(bucket.TryConsume(limit, now));
+    EXPECT_FALSE(bucket.TryConsume(limit, now));
+
+    // 10 per second: one token back after 100 ms
+    now += std::chrono::milliseconds(50);
+    EXPECT_FALSE(bucket.TryConsume(limit, now));
+    now += std::chrono::milliseconds(50);
+    EXPECT_TRUE(bucket.TryConsume(limit, now));
+    EXPECT_FALSE(bucket.TryConsume(limit, now));
+
+    // Never refills past the burst
+    now += std::chrono::seconds(10);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(bucket.TryConsume(limit, now));
+    }
+    EXPECT_FALSE(bucket.TryConsume(limit, now));
+}
+
+TEST(TokenBucketTest, NonPositiveRateIsUnlimited)
+{
+    TokenBucket bucket;
+    Clock::time_point now = Clock::now();
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(bucket.TryConsume(RateLimit{0, 0}, now));
+    }
+}
+
+TEST(RateLimiterTest, ClassifiesActions)
+{
+    EXPECT_EQ(RateLimiter::Classify("handle_order"), RequestClass::ORDER);
+    EXPECT_EQ(RateLimiter::Classify("cancel_order"), RequestClass::CANCEL);
+    EXPECT_EQ(RateLimiter::Classify("get_top_of_book"), RequestClass::QUERY);
+}
+
+TEST(RateLimiterTest, OrdersAndQueriesHaveSeparateConnectionBudgets)
+{
+    RateLimitOptions options;
+    options.connection_orders = {1, 2};
+    options.connection_queries = {1, 1};
+    RateLimiter limiter(options);
+    ClientBudget connection;
+    Clock::time_point now = Clock::now();
+
+    EXPECT_TRUE(limiter.Admit(connection, nullptr, RequestClass::ORDER, now));
+    EXPECT_TRUE(limiter.Admit(connection, nullptr, RequestClass::ORDER, now));
+    EXPECT_FALSE(limiter.Admit(connection, nullptr, RequestClass::ORDER, now));
+
+    EXPECT_TRUE(limiter.Admit(connection, nullptr, RequestClass::QUERY, now));
+    EXPECT_FALSE(limiter.Admit(connection, nullptr, RequestClass::QUERY, now));
+
+    // Cancels always go through
+    EXPECT_TRUE(limiter.Admit(connection, nullptr, RequestClass::CANCEL, now));
+
+    // Another connection has its own budget
+    ClientBudget other;
+    EXPECT_TRUE(limiter.Admit(other, nullptr, RequestClass::ORDER, now));
+}
+
+TEST(RateLimiterTest, UserBudgetSpansConnections)
+{
+    RateLimitOptions options;
+    options.connection_orders = {100, 100};
+    options.user_orders = {1, 3};
+    RateLimiter limiter(options);
+    ClientBudget first;
+    ClientBudget second;
+    const std::string flooder = "bot";
+    const std::string other = "alice";
+    Clock::time_point now = Clock::now();
+
+    EXPECT_TRUE(limiter.Admit(first, &flooder, RequestClass::ORDER, now));
+    EXPECT_TRUE(limiter.Admit(second, &flooder, RequestClass::ORDER, now));
+    EXPECT_TRUE(limiter.Admit(first, &flooder, RequestClass::ORDER, now));
+    EXPECT_FALSE(limiter.Admit(second, &flooder, RequestClass::ORDER, now));
+
+    // Other users are unaffected, even on the same connection
+    EXPECT_TRUE(limiter.Admit(second, &other, RequestClass::ORDER, now));
+
+    now += std::chrono::seconds(1);
+    EXPECT_TRUE(limiter.Admit(second, &flooder, RequestClass::ORDER, now));
+}
+
+TEST(RateLimiterTest, UnknownUserIdsCannotGrowTheTable)
+{
+    RateLimitOptions options;
+    options.connection_queries = {0, 0};
+    options.user_queries = {1, 2};
+    options.max_tracked_users = 16; // one per shard
+    RateLimiter limiter(options);
+    ClientBudget connection;
+    Clock::time_point now = Clock::now();
+
+    // Past the first id of each shard, new ids share the shard's overflow bucket
+    auto flood = [&](const std::string &prefix)
+    {
+        size_t admitted = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::string user_id = prefix + std::to_string(i);
+            admitted += limiter.Admit(connection, &user_id, RequestClass::QUERY, now);
+        }
+        return admitted;
+    };
+    EXPECT_EQ(flood("bot"), 16u + 16u * 2);
+    EXPECT_EQ(limiter.GetTrackedUserCount(), 16u);
+
+    // Refilled users are evicted to make room again
+    now += std::chrono::seconds(10);
+    EXPECT_EQ(flood("other"), 16u + 16u * 2);
+    EXPECT_EQ(limiter.GetTrackedUserCount(), 16u);
+}
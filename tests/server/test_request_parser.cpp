@@ -0,0 +1,109 @@
+#include "server/request_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    bool Parse(const std::string &text, ParsedRequest &request)
+    {
+        return ParseRequest(text.data(), text.size(), request);
+    }
+}
+
+TEST(RequestParserTest, LooksUpEveryAction)
+{
+    for (size_t i = 1; i < kRequestActions; ++i)
+    {
+        RequestAction action = static_cast<RequestAction>(i);
+        EXPECT_EQ(LookupRequestAction(RequestActionToString(action)), action);
+    }
+    EXPECT_EQ(LookupRequestAction(""), RequestAction::UNKNOWN);
+    EXPECT_EQ(LookupRequestAction("handle_orders"), RequestAction::UNKNOWN);
+    EXPECT_EQ(LookupRequestAction("handle_ordex"), RequestAction::UNKNOWN);
+    EXPECT_EQ(LookupRequestAction("unknown"), RequestAction::UNKNOWN);
+}
+
+TEST(RequestParserTest, ReadsAnOrder)
+{
+    std::string text = R"( {"action": "handle_order", "user_id":"alice", "order_type":1,
+                            "volume": 25, "price": 101.25, "ticker": "AAPL", "client_tag": [1]} )";
+    ParsedRequest request;
+    // Nested values are left to nlohmann
+    EXPECT_FALSE(Parse(text, request));
+
+    text = R"( {"action": "handle_order", "user_id":"alice", "order_type":1,
+                "volume": 25, "price": 101.25e0, "ticker": "AAPL", "client_tag": "a\"b", "test": null} )";
+    ASSERT_TRUE(Parse(text, request));
+    EXPECT_EQ(request.action, RequestAction::HANDLE_ORDER);
+    EXPECT_EQ(request.action_name, "handle_order");
+    EXPECT_EQ(request.user_id, "alice");
+    EXPECT_EQ(request.ticker, "AAPL");
+    EXPECT_EQ(request.order_type, 1);
+    EXPECT_EQ(request.volume, 25);
+    EXPECT_DOUBLE_EQ(request.price, 101.25);
+    EXPECT_TRUE(request.Has(ParsedRequest::FIELD_USER_ID | ParsedRequest::FIELD_TICKER |
+                            ParsedRequest::FIELD_ORDER_TYPE | ParsedRequest::FIELD_VOLUME |
+                            ParsedRequest::FIELD_PRICE));
+    EXPECT_FALSE(request.Has(ParsedRequest::FIELD_TICKER_HANDLE));
+    EXPECT_THROW(request.Require(ParsedRequest::FIELD_ORDER_ID), std::invalid_argument);
+
+    ASSERT_TRUE(Parse(R"({"ticker_handle":3,"order_id":-12,"action":"cancel_order"})", request));
+    EXPECT_EQ(request.action, RequestAction::CANCEL_ORDER);
+    EXPECT_EQ(request.ticker_handle, 3u);
+    EXPECT_EQ(request.order_id, -12);
+    EXPECT_FALSE(request.Has(ParsedRequest::FIELD_TICKER));
+
+    text = R"({"action":"something_else"})";
+    ASSERT_TRUE(Parse(text, request));
+    EXPECT_EQ(request.action, RequestAction::UNKNOWN);
+    EXPECT_EQ(request.action_name, "something_else");
+}
+
+TEST(RequestParserTest, DeclinesOtherShapes)
+{
+    ParsedRequest request;
+    for (const char *text : {
+             R"({"user_id":"alice"})",                               // no action
+             R"({"action":5})",                                      // action not a string
+             R"({"action":"register_user","user_id":"ali\u0063e"})", // escaped known field
+             R"({"action":"handle_order","volume":2.5})",            // integer field with a fraction
+             R"({"action":"handle_order","volume":"25"})",           // number as a string
+             R"({"action":"handle_order","volume":025})",            // leading zero
+             R"({"action":"get_tickers"} x)",                        // trailing text
+             R"({"action":"get_tickers",})",                         // trailing comma
+             R"({"action":"get_tickers")",                           // truncated
+             R"({"action":"get_tickers","x":tru})",                  // bad literal
+             R"(["get_tickers"])"})
+    {
+        EXPECT_FALSE(Parse(text, request)) << text;
+    }
+}
+
+TEST(RequestParserTest, ReadsTheSameFieldsFromADom)
+{
+    std::string text = R"({"action":"handle_order","user_id":"bob","order_type":0,"volume":7,
+                           "price":99,"ticker_handle":2})";
+    ParsedRequest parsed;
+    ASSERT_TRUE(Parse(text, parsed));
+    nlohmann::json document = nlohmann::json::parse(text);
+    ParsedRequest read;
+    ReadRequest(document, read);
+
+    EXPECT_EQ(read.action, parsed.action);
+    EXPECT_EQ(read.fields, parsed.fields);
+    EXPECT_EQ(read.user_id, parsed.user_id);
+    EXPECT_EQ(read.ticker_handle, parsed.ticker_handle);
+    EXPECT_EQ(read.volume, parsed.volume);
+    EXPECT_DOUBLE_EQ(read.price, parsed.price);
+
+    // Shapes the fast parser declines still convert as nlohmann does
+    document = nlohmann::json::parse(R"({"action":"handle_order","volume":2.5,"count":"x","tags":{"a":1}})");
+    ReadRequest(document, read);
+    EXPECT_EQ(read.volume, 2);
+    EXPECT_FALSE(read.Has(ParsedRequest::FIELD_COUNT));
+    EXPECT_THROW(ReadRequest(nlohmann::json::parse(R"({"volume":1})"), read), std::invalid_argument);
+}
@@ -0,0 +1,125 @@
+#include "exchange/exchange.hpp"
+#include "server/request_handler.hpp"
+#include "server/response_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+    ParsedRequest MakeTopOfBook(const char *ticker)
+    {
+        ParsedRequest request;
+        request.action = RequestAction::GET_TOP_OF_BOOK;
+        request.action_name = RequestActionToString(request.action);
+        request.fields = ParsedRequest::FIELD_TICKER;
+        request.ticker = ticker;
+        return request;
+    }
+
+    ParsedRequest MakeOrder(const char *user_id, int order_type, double price)
+    {
+        ParsedRequest request;
+        request.action = RequestAction::HANDLE_ORDER;
+        request.action_name = RequestActionToString(request.action);
+        request.fields = ParsedRequest::FIELD_USER_ID | ParsedRequest::FIELD_ORDER_TYPE | ParsedRequest::FIELD_VOLUME |
+                         ParsedRequest::FIELD_PRICE | ParsedRequest::FIELD_TICKER;
+        request.user_id = user_id;
+        request.order_type = order_type;
+        request.volume = 10;
+        request.price = price;
+        request.ticker = "AAPL";
+        return request;
+    }
+}
+
+TEST(ResponseCacheTest, ServesOnlyTheStoredSequence)
+{
+    ResponseCache cache;
+    std::string response = "untouched";
+    EXPECT_FALSE(cache.Lookup(RequestAction::GET_TOP_OF_BOOK, 3, 0, response));
+    EXPECT_EQ(response, "untouched");
+
+    cache.Store(RequestAction::GET_TOP_OF_BOOK, 3, 7, "{\"v\":7}");
+    EXPECT_TRUE(cache.Lookup(RequestAction::GET_TOP_OF_BOOK, 3, 7, response));
+    EXPECT_EQ(response, "{\"v\":7}");
+    EXPECT_FALSE(cache.Lookup(RequestAction::GET_TOP_OF_BOOK, 3, 8, response));
+    EXPECT_FALSE(cache.Lookup(RequestAction::GET_AUCTION_STATE, 3, 7, response));
+    EXPECT_FALSE(cache.Lookup(RequestAction::GET_TOP_OF_BOOK, 2, 7, response));
+
+    cache.Store(RequestAction::GET_TOP_OF_BOOK, 3, 8, "{\"v\":8}");
+    EXPECT_FALSE(cache.Lookup(RequestAction::GET_TOP_OF_BOOK, 3, 7, response));
+    EXPECT_TRUE(cache.Lookup(RequestAction::GET_TOP_OF_BOOK, 3, 8, response));
+    EXPECT_EQ(response, "{\"v\":8}");
+    EXPECT_EQ(cache.GetHitCount(), 2u);
+    EXPECT_EQ(cache.GetMissCount(), 5u);
+}
+
+TEST(ResponseCacheTest, BookChangesInvalidateTopOfBook)
+{
+    Exchange exchange({"AAPL", "MSFT"});
+    RequestHandler handler(exchange);
+    RequestHandler::TickerCache ticker_cache;
+    const ResponseCache &cache = handler.GetResponseCache();
+    std::string response;
+
+    uint64_t sequence = exchange.GetBbo(exchange.ResolveTicker("AAPL")).update_sequence;
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("AAPL"), ticker_cache, response));
+    std::string empty_book = response;
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("AAPL"), ticker_cache, response));
+    EXPECT_EQ(response, empty_book);
+    EXPECT_EQ(cache.GetHitCount(), 1u);
+
+    // A resting order moves the sequence and the next poll rebuilds
+    ASSERT_TRUE(handler.Handle(MakeOrder("maker", 1, 101.0), ticker_cache, response));
+    EXPECT_GT(exchange.GetBbo(exchange.ResolveTicker("AAPL")).update_sequence, sequence);
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("AAPL"), ticker_cache, response));
+    EXPECT_NE(response, empty_book);
+    EXPECT_NE(response.find("\"ask_price\":101"), std::string::npos);
+    EXPECT_EQ(cache.GetHitCount(), 1u);
+
+    // Other books are versioned separately
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("MSFT"), ticker_cache, response));
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("MSFT"), ticker_cache, response));
+    EXPECT_EQ(response, empty_book);
+    EXPECT_EQ(cache.GetHitCount(), 2u);
+
+    // Cancelling also moves it
+    ParsedRequest cancel;
+    cancel.action = RequestAction::CANCEL_ORDER;
+    cancel.fields = ParsedRequest::FIELD_TICKER | ParsedRequest::FIELD_ORDER_ID;
+    cancel.ticker = "AAPL";
+    ASSERT_TRUE(handler.Handle(MakeOrder("maker", 1, 100.0), ticker_cache, response));
+    cancel.order_id = std::stoll(response.substr(response.find("\"order_id\":") + 11));
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("AAPL"), ticker_cache, response));
+    std::string before_cancel = response;
+    ASSERT_TRUE(handler.Handle(cancel, ticker_cache, response));
+    ASSERT_TRUE(handler.Handle(MakeTopOfBook("AAPL"), ticker_cache, response));
+    EXPECT_NE(response, before_cancel);
+    EXPECT_EQ(cache.GetHitCount(), 2u);
+}
+
+TEST(ResponseCacheTest, AuctionPhaseChangesInvalidateAuctionState)
+{
+    Exchange exchange({"AAPL"});
+    RequestHandler handler(exchange);
+    RequestHandler::TickerCache ticker_cache;
+    std::string response;
+
+    ParsedRequest state;
+    state.action = RequestAction::GET_AUCTION_STATE;
+    state.fields = ParsedRequest::FIELD_TICKER;
+    state.ticker = "AAPL";
+    ASSERT_TRUE(handler.Handle(state, ticker_cache, response));
+    EXPECT_EQ(response, "{\"phase\":\"continuous\"}");
+
+    exchange.StartAuction("AAPL");
+    ASSERT_TRUE(handler.Handle(state, ticker_cache, response));
+    EXPECT_NE(response.find("\"phase\":\"auction\""), std::string::npos);
+
+    exchange.Uncross("AAPL");
+    ASSERT_TRUE(handler.Handle(state, ticker_cache, response));
+    EXPECT_EQ(response, "{\"phase\":\"continuous\"}");
+    EXPECT_EQ(handler.GetResponseCache().GetHitCount(), 0u);
+}
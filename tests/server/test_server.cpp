@@ -18,13 +18,13 @@ public:
     MockExchange() : Exchange({}) {}
 
     MOCK_METHOD(std::unordered_set<std::string>, GetTickers, (), (override));
-    MOCK_METHOD(TopOfBook, GetTopOfBook, (std::string ticker), (override));
-    MOCK_METHOD(int, GetVolume, (std::string ticker, double price, OrderType order_type), (override));
-    MOCK_METHOD(std::vector<Trade>, GetPreviousTrades, (std::string ticker, int num_previous_trades), (override));
-    MOCK_METHOD(bool, CancelOrder, (std::string ticker, int order_id), (override));
-    MOCK_METHOD(OrderResult, HandleOrder, (std::string user_id, OrderType order_type, int volume, double price, std::string ticker), (override));
-    MOCK_METHOD(std::vector<Trade>, GetTradesByUser, (std::string user_id), (override));
-    MOCK_METHOD(bool, RegisterUser, (std::string user_id), (override));
+    MOCK_METHOD(TopOfBook, GetTopOfBook, (const std::string &ticker), (override));
+    MOCK_METHOD(int, GetVolume, (const std::string &ticker, double price, OrderType order_type), (override));
+    MOCK_METHOD(std::vector<Trade>, GetPreviousTrades, (const std::string &ticker, int num_previous_trades), (override));
+    MOCK_METHOD(bool, CancelOrder, (const std::string &ticker, int64_t order_id), (override));
+    MOCK_METHOD(OrderResult, HandleOrder, (const std::string &user_id, OrderType order_type, int volume, double price, const std::string &ticker), (override));
+    MOCK_METHOD(std::vector<Trade>, GetTradesByUser, (const std::string &user_id), (override));
+    MOCK_METHOD(bool, RegisterUser, (const std::string &user_id), (override));
 };
 
 // **Test Case 1: Test GetTickers**
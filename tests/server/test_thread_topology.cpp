@@ -0,0 +1,53 @@
+#include "server/thread_topology.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ThreadTopologyTest, ParsesCpuLists)
+{
+    EXPECT_EQ(ParseCpuList("3"), std::vector<int>({3}));
+    EXPECT_EQ(ParseCpuList("0,2-4,7"), std::vector<int>({0, 2, 3, 4, 7}));
+    EXPECT_THROW(ParseCpuList(""), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("1,"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("4-2"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("a"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("-1"), std::invalid_argument);
+}
+
+TEST(ThreadTopologyTest, TakesItsFlagsAndLeavesTheRest)
+{
+    std::vector<std::string> args = {"--engine", "--engine-cpus", "1", "/shm", "--io-cpus", "2-3",
+                                     "--busy-poll", "--io-threads", "4", "--housekeeping-cpus", "0"};
+    ThreadTopology topology = ParseThreadTopology(args);
+    EXPECT_EQ(args, std::vector<std::string>({"--engine", "/shm"}));
+    EXPECT_EQ(topology.engine_cpus, std::vector<int>({1}));
+    EXPECT_EQ(topology.io_cpus, std::vector<int>({2, 3}));
+    EXPECT_EQ(topology.housekeeping_cpus, std::vector<int>({0}));
+    EXPECT_TRUE(topology.acceptor_cpus.empty());
+    EXPECT_EQ(topology.io_threads, 4);
+    EXPECT_EQ(topology.wait_strategy, WaitStrategy::BUSY_POLL);
+
+    std::vector<std::string> missing = {"--io-cpus"};
+    EXPECT_THROW(ParseThreadTopology(missing), std::invalid_argument);
+}
+
+TEST(ThreadTopologyTest, PinsTheCallingThreadOnly)
+{
+    std::vector<int> inherited = GetThreadAffinity();
+    ASSERT_FALSE(inherited.empty());
+    std::thread([&inherited]()
+                {
+                    PinCurrentThread({inherited.back()});
+                    EXPECT_EQ(GetThreadAffinity(), std::vector<int>({inherited.back()}));
+                    // Empty leaves the affinity alone
+                    PinCurrentThread({});
+                    EXPECT_EQ(GetThreadAffinity(), std::vector<int>({inherited.back()}));
+                })
+        .join();
+    EXPECT_EQ(GetThreadAffinity(), inherited);
+    EXPECT_THROW(PinCurrentThread({1023}), std::runtime_error);
+}
@@ -0,0 +1,249 @@
+#include "server/uring_connection_loop.hpp"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+class UringConnectionLoopTest : public ::testing::Test
+{
+protected:
+    int listen_fd = -1;
+    sockaddr_in address{};
+    std::atomic<bool> stop{false};
+    size_t max_send_queue_bytes = UringConnectionLoop::kDefaultMaxSendQueueBytes;
+    WaitStrategy wait_strategy = WaitStrategy::BLOCKING;
+    bool per_round = false;
+    std::atomic<size_t> rounds{0};
+    std::unique_ptr<UringConnectionLoop> loop;
+    std::thread thread;
+
+    // Answers "<request>#<requests seen on this connection>"; requests
+    // starting with '!' get 1 KiB of response per request byte instead.
+    // Written into the session, as the server does, so the view outlives the call
+    static std::string_view Respond(const char *data, size_t size, ClientSession &session)
+    {
+        std::string &response = session.response;
+        if (data[0] == '!')
+        {
+            response.assign(size * 1024, 'x');
+            return response;
+        }
+        uint32_t count = ++session.ticker_cache["requests"].index;
+        response.assign(data, size);
+        response += "#" + std::to_string(count);
+        return response;
+    }
+
+    // Same answers, a round at a time, each written into its own slot
+    void RespondToRound(UringConnectionLoop::RoundRequest *requests, size_t count)
+    {
+        ++rounds;
+        for (size_t i = 0; i < count; ++i)
+        {
+            requests[i].response = Respond(requests[i].data, requests[i].size, *requests[i].session);
+        }
+    }
+
+    void SetUp() override
+    {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        ASSERT_EQ(bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+        ASSERT_EQ(listen(listen_fd, 16), 0);
+        ASSERT_EQ(getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &length), 0);
+
+        // The ring belongs to the thread that creates it
+        std::atomic<bool> ready{false};
+        thread = std::thread([this, &ready]
+                             {
+                                 if (per_round)
+                                 {
+                                     loop = std::make_unique<UringConnectionLoop>(
+                                         listen_fd,
+                                         [this](UringConnectionLoop::RoundRequest *requests, size_t count)
+                                         { RespondToRound(requests, count); },
+                                         max_send_queue_bytes, wait_strategy);
+                                 }
+                                 else
+                                 {
+                                     loop = std::make_unique<UringConnectionLoop>(listen_fd, &Respond,
+                                                                                  max_send_queue_bytes, wait_strategy);
+                                 }
+                                 ready.store(true);
+                                 loop->Run(stop);
+                                 loop.reset(); });
+        while (!ready.load())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void TearDown() override
+    {
+        stop.store(true);
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+        close(listen_fd);
+    }
+
+    int Connect()
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+        return fd;
+    }
+
+    static std::string RoundTrip(int fd, const std::string &request)
+    {
+        EXPECT_EQ(send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+        char buffer[256];
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        return received > 0 ? std::string(buffer, received) : "";
+    }
+};
+
+TEST_F(UringConnectionLoopTest, ServesRequestsWithPerConnectionState)
+{
+    int first = Connect();
+    int second = Connect();
+    EXPECT_EQ(RoundTrip(first, "a"), "a#1");
+    EXPECT_EQ(RoundTrip(first, "b"), "b#2");
+    EXPECT_EQ(RoundTrip(second, "c"), "c#1");
+    EXPECT_EQ(RoundTrip(first, "d"), "d#3");
+    close(first);
+    close(second);
+}
+
+TEST_F(UringConnectionLoopTest, ClosedConnectionsAreReleased)
+{
+    int fd = Connect();
+    EXPECT_EQ(RoundTrip(fd, "x"), "x#1");
+    EXPECT_EQ(loop->GetConnectionCount(), 1u);
+    close(fd);
+
+    // The loop notices the end of stream on its own thread
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (loop->GetConnectionCount() != 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(loop->GetConnectionCount(), 0u);
+
+    // A new connection (likely reusing the fd) starts from fresh state
+    fd = Connect();
+    EXPECT_EQ(RoundTrip(fd, "y"), "y#1");
+    close(fd);
+}
+
+class UringSlowConsumerTest : public UringConnectionLoopTest
+{
+protected:
+    void SetUp() override
+    {
+        max_send_queue_bytes = 64 * 1024;
+        UringConnectionLoopTest::SetUp();
+    }
+};
+
+TEST_F(UringSlowConsumerTest, ClientThatStopsReadingIsDisconnected)
+{
+    int fd = Connect();
+    EXPECT_EQ(RoundTrip(fd, "a"), "a#1");
+
+    // Tens of MB of responses, more than both socket buffers hold, never read
+    const std::string flood(1000, '!');
+    for (int i = 0; i < 64 && loop->GetSlowConsumerCount() == 0; ++i)
+    {
+        if (send(fd, flood.data(), flood.size(), MSG_NOSIGNAL) < 0)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (loop->GetConnectionCount() != 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(loop->GetSlowConsumerCount(), 1u);
+    EXPECT_EQ(loop->GetConnectionCount(), 0u);
+    close(fd);
+
+    // Well-behaved clients are still served
+    fd = Connect();
+    EXPECT_EQ(RoundTrip(fd, "b"), "b#1");
+    close(fd);
+}
+
+class UringBusyPollTest : public UringConnectionLoopTest
+{
+protected:
+    void SetUp() override
+    {
+        wait_strategy = WaitStrategy::BUSY_POLL;
+        UringConnectionLoopTest::SetUp();
+    }
+};
+
+TEST_F(UringBusyPollTest, ServesRequestsWithoutWaitingInTheKernel)
+{
+    int fd = Connect();
+    for (int i = 1; i <= 20; ++i)
+    {
+        EXPECT_EQ(RoundTrip(fd, "p"), "p#" + std::to_string(i));
+    }
+    close(fd);
+}
+
+class UringRoundTest : public UringConnectionLoopTest
+{
+protected:
+    void SetUp() override
+    {
+        per_round = true;
+        UringConnectionLoopTest::SetUp();
+    }
+};
+
+TEST_F(UringRoundTest, AnswersEachRequestOfARoundOnItsConnection)
+{
+    int first = Connect();
+    int second = Connect();
+    EXPECT_EQ(RoundTrip(first, "a"), "a#1");
+    EXPECT_EQ(RoundTrip(second, "b"), "b#1");
+
+    // Both connections send before either reads: whether they land in one
+    // round or two, each gets its own answer
+    ASSERT_EQ(send(first, "c", 1, 0), 1);
+    ASSERT_EQ(send(second, "d", 1, 0), 1);
+    char buffer[16];
+    ssize_t received = recv(first, buffer, sizeof(buffer), 0);
+    EXPECT_EQ(std::string(buffer, received > 0 ? received : 0), "c#2");
+    received = recv(second, buffer, sizeof(buffer), 0);
+    EXPECT_EQ(std::string(buffer, received > 0 ? received : 0), "d#2");
+    EXPECT_GE(rounds.load(), 1u);
+    close(first);
+    close(second);
+
+    // Connections closed with requests staged are still released
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (loop->GetConnectionCount() != 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(loop->GetConnectionCount(), 0u);
+}
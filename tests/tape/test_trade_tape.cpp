@@ -0,0 +1,192 @@
+#include "exchange/exchange.hpp"
+#include "tape/trade_tape_reader.hpp"
+#include "tape/trade_tape_writer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Fresh directory per test, removed with the fixture
+    class TradeTapeTest : public ::testing::Test
+    {
+    protected:
+        std::string directory;
+
+        void SetUp() override
+        {
+            char path[] = "/tmp/trade_tape_XXXXXX";
+            ASSERT_NE(mkdtemp(path), nullptr);
+            directory = path;
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(directory);
+        }
+    };
+
+    void Record(TradeTapeWriter &writer, TickerHandle ticker, int64_t trade_id, double price, int volume,
+                time_t timestamp, const std::string &bid_user, const std::string &ask_user)
+    {
+        Trade trade(trade_id, static_cast<int>(price), volume, timestamp, bid_user, ask_user);
+        writer.OnTrade(ticker, Fill{trade, price, OrderType::BID, trade_id + 1000, 0, price});
+    }
+}
+
+TEST_F(TradeTapeTest, QueriesTimeAndTradeIdRanges)
+{
+    {
+        TradeTapeWriter writer(directory, {"AAPL", "MSFT"});
+        for (int i = 0; i < 100; ++i)
+        {
+            // Ten trades per second, starting at t=1000
+            Record(writer, TickerHandle{0}, 10 + i, 100.25 + i, i + 1, 1000 + i / 10,
+                   i % 2 == 0 ? "alice" : "bob", "carol");
+        }
+        Record(writer, TickerHandle{1}, 7, 50.0, 3, 1000, "bob", "alice");
+        EXPECT_EQ(writer.GetTradeCount(TickerHandle{0}), 100u);
+        EXPECT_EQ(writer.Flush(), 2u);
+        EXPECT_EQ(writer.Flush(), 0u);
+    }
+
+    TradeTapeReader reader(directory, "AAPL");
+    ASSERT_EQ(reader.GetTradeCount(), 100u);
+    TapeTrade trade = reader.GetTrade(41);
+    EXPECT_EQ(trade.trade_id, 51);
+    EXPECT_DOUBLE_EQ(trade.price, 141.25);
+    EXPECT_EQ(trade.volume, 42);
+    EXPECT_EQ(trade.timestamp, 1004);
+    EXPECT_EQ(reader.GetUserName(trade.bid_user), "bob");
+    EXPECT_EQ(reader.GetUserName(trade.ask_user), "carol");
+
+    TapeRange seconds = reader.FindTimeRange(1003, 1005);
+    EXPECT_EQ(seconds.begin, 30u);
+    EXPECT_EQ(seconds.end, 50u);
+    EXPECT_EQ(reader.FindTimeRange(0, 1000).GetSize(), 0u);
+    EXPECT_EQ(reader.FindTimeRange(1009, 2000).GetSize(), 10u);
+    EXPECT_EQ(reader.FindTimeRange(1005, 1003).GetSize(), 0u);
+
+    TapeRange ids = reader.FindTradeIdRange(15, 20);
+    EXPECT_EQ(ids.begin, 5u);
+    EXPECT_EQ(ids.end, 10u);
+    EXPECT_EQ(reader.FindTradeIdRange(500, 600).begin, 100u);
+
+    // Column scans over a range
+    int64_t volume = 0;
+    for (size_t row = seconds.begin; row < seconds.end; ++row)
+    {
+        volume += reader.GetVolumes()[row];
+    }
+    EXPECT_EQ(volume, (31 + 50) * 20 / 2);
+
+    TradeTapeReader other(directory, "MSFT");
+    ASSERT_EQ(other.GetTradeCount(), 1u);
+    EXPECT_EQ(other.GetUserName(other.GetTrade(0).bid_user), "bob");
+    EXPECT_THROW(other.GetTrade(1), std::out_of_range);
+    EXPECT_THROW(TradeTapeReader(directory, "GOOG"), std::runtime_error);
+}
+
+TEST_F(TradeTapeTest, ReopeningDropsTornTailAndAppends)
+{
+    {
+        TradeTapeWriter writer(directory, {"AAPL"});
+        Record(writer, TickerHandle{0}, 1, 100.0, 5, 2000, "alice", "bob");
+        Record(writer, TickerHandle{0}, 2, 101.0, 6, 2001, "bob", "alice");
+    }
+    TradeTapeReader reader(directory, "AAPL");
+    ASSERT_EQ(reader.GetTradeCount(), 2u);
+
+    // A crash mid-flush: half a row in one column and half a user name
+    {
+        std::ofstream column(directory + "/AAPL/trade_id.i64", std::ios::binary | std::ios::app);
+        int64_t partial = 3;
+        column.write(reinterpret_cast<const char *>(&partial), sizeof(partial));
+        std::ofstream users(directory + "/AAPL/users.txt", std::ios::app);
+        users << "dav";
+    }
+    EXPECT_EQ(reader.Refresh(), 2u);
+
+    {
+        TradeTapeWriter writer(directory, {"AAPL"});
+        EXPECT_EQ(writer.GetTradeCount(TickerHandle{0}), 2u);
+        EXPECT_EQ(writer.GetLastTradeId(TickerHandle{0}), 2);
+        // The clock stepped back: the tape keeps its timestamps sorted
+        Record(writer, TickerHandle{0}, 3, 102.0, 7, 1990, "dave", "alice");
+    }
+
+    EXPECT_EQ(reader.Refresh(), 3u);
+    TapeTrade appended = reader.GetTrade(2);
+    EXPECT_EQ(appended.trade_id, 3);
+    EXPECT_EQ(appended.timestamp, 2001);
+    EXPECT_EQ(reader.GetUserName(appended.bid_user), "dave");
+    EXPECT_EQ(reader.GetUserName(appended.ask_user), "alice");
+}
+
+TEST_F(TradeTapeTest, RecordsExchangeTradesAndResumesIds)
+{
+    int64_t last_trade_id;
+    {
+        Exchange exchange({"AAPL"});
+        TradeTapeWriter writer(directory, {"AAPL"});
+        exchange.AddMarketDataListener(&writer);
+        for (int i = 0; i < 5; ++i)
+        {
+            exchange.HandleOrder("maker", OrderType::ASK, 10, 100.0, "AAPL");
+            exchange.HandleOrder("taker", OrderType::BID, 10, 100.0, "AAPL");
+        }
+        exchange.FlushMarketData();
+        last_trade_id = exchange.GetPreviousTrades("AAPL", 1).front().trade_id;
+        EXPECT_EQ(writer.GetLastTradeId(TickerHandle{0}), last_trade_id);
+    }
+
+    TradeTapeReader reader(directory, "AAPL");
+    ASSERT_EQ(reader.GetTradeCount(), 5u);
+    EXPECT_EQ(reader.GetTradeIds()[4], last_trade_id);
+    EXPECT_EQ(reader.GetUserName(reader.GetTrade(0).ask_user), "maker");
+
+    // A restarted engine continues after the tape, so IDs stay sorted
+    Exchange restarted({"AAPL"});
+    TradeTapeWriter writer(directory, {"AAPL"});
+    restarted.ResumeIdsAfter(TickerHandle{0}, writer.GetLastTradeId(TickerHandle{0}));
+    restarted.AddMarketDataListener(&writer);
+    restarted.HandleOrder("maker", OrderType::ASK, 10, 100.0, "AAPL");
+    restarted.HandleOrder("taker", OrderType::BID, 10, 100.0, "AAPL");
+    restarted.FlushMarketData();
+
+    ASSERT_EQ(reader.Refresh(), 6u);
+    EXPECT_GT(reader.GetTradeIds()[5], last_trade_id);
+    EXPECT_EQ(reader.FindTradeIdRange(last_trade_id + 1, INT64_MAX).GetSize(), 1u);
+}
+
+TEST_F(TradeTapeTest, UserNamesWithNewlinesKeepTheirIndexes)
+{
+    const std::string split_user = "eve\nmallory";
+    const std::string slashed_user = "eve\\nmallory";
+    {
+        TradeTapeWriter writer(directory, {"AAPL"});
+        Record(writer, TickerHandle{0}, 1, 100.0, 5, 2000, split_user, "alice");
+        Record(writer, TickerHandle{0}, 2, 101.0, 6, 2001, slashed_user, "bob");
+    }
+
+    TradeTapeReader reader(directory, "AAPL");
+    ASSERT_EQ(reader.GetTradeCount(), 2u);
+    EXPECT_EQ(reader.GetUserName(reader.GetTrade(0).bid_user), split_user);
+    EXPECT_EQ(reader.GetUserName(reader.GetTrade(0).ask_user), "alice");
+    EXPECT_EQ(reader.GetUserName(reader.GetTrade(1).bid_user), slashed_user);
+    EXPECT_EQ(reader.GetUserName(reader.GetTrade(1).ask_user), "bob");
+
+    // A reopened writer reads the names back and reuses their indexes
+    {
+        TradeTapeWriter writer(directory, {"AAPL"});
+        Record(writer, TickerHandle{0}, 3, 102.0, 7, 2002, split_user, "bob");
+    }
+    ASSERT_EQ(reader.Refresh(), 3u);
+    EXPECT_EQ(reader.GetTrade(2).bid_user, reader.GetTrade(0).bid_user);
+    EXPECT_EQ(reader.GetTrade(2).ask_user, reader.GetTrade(1).ask_user);
+}